@@ -74,6 +74,8 @@ namespace Google.Cloud.Diagnostics.Debug.Tests
             Assert.Null(options.SourceContext);
             Assert.False(options.PropertyEvaluation);
             Assert.False(options.MethodEvaluation);
+            Assert.False(options.StackOnly);
+            Assert.Null(options.MaxExpressionCollectionSize);
         }
 
         [Fact]
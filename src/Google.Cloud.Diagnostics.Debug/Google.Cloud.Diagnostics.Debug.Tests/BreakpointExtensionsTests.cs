@@ -128,6 +128,24 @@ namespace Google.Cloud.Diagnostics.Debug.Tests
                 sdBreakpoint.EvaluatedExpressions.Where(ee => ee.Name.Equals("second-expression")));
         }
 
+        [Fact]
+        public void Convert_StackdriverBreakpointHitCount()
+        {
+            var breakpoint = new Breakpoint
+            {
+                Id = _id,
+                HitCount = 1,
+                StackFingerprint = 0xabc
+            };
+
+            var sdBreakpoint = breakpoint.Convert();
+            Assert.Equal("1", sdBreakpoint.Labels[BreakpointExtensions.HitCountLabel]);
+            Assert.Equal("0000000000000abc",
+                sdBreakpoint.Labels[BreakpointExtensions.StackFingerprintLabel]);
+
+            Assert.Empty(new Breakpoint { Id = _id }.Convert().Labels);
+        }
+
         [Fact]
         public void Convert_StackdriverBreakpointWithError()
         {
@@ -58,6 +58,57 @@ namespace Google.Cloud.Diagnostics.Debug.Tests
             _mockDebuggerClient.Verify(c => c.UpdateBreakpoint(sdBreakpoint), Times.Once);
         }
 
+        [Fact]
+        public void MainAction_DeduplicatedHits()
+        {
+            var capturedBreakpoint = new Breakpoint
+            {
+                Id = "some-id",
+                Location = new SourceLocation
+                {
+                    Line = 1,
+                    Path = "some-path"
+                },
+                HitCount = 1,
+                StackFingerprint = 42
+            };
+            var hitCountBreakpoint = new Breakpoint
+            {
+                Id = "some-id",
+                Location = capturedBreakpoint.Location,
+                HitCount = 3,
+                StackFingerprint = 42
+            };
+            _mockBreakpointServer.SetupSequence(s => s.ReadBreakpointAsync(It.IsAny<CancellationToken>()))
+                .Returns(Task.FromResult(capturedBreakpoint))
+                .Returns(Task.FromResult(hitCountBreakpoint));
+            _server.MainAction();
+            _server.MainAction();
+
+            _mockDebuggerClient.Verify(c => c.UpdateBreakpoint(It.Is<Debugger.V2.Breakpoint>(
+                b => b.Id == "some-id" && b.Labels[BreakpointExtensions.HitCountLabel] == "1")), Times.Once);
+            _mockDebuggerClient.Verify(c => c.UpdateBreakpoint(It.Is<Debugger.V2.Breakpoint>(
+                b => b.Id == "some-id" && b.IsFinalState && b.Location.Line == 1 &&
+                    b.Labels[BreakpointExtensions.HitCountLabel] == "3")), Times.Once);
+        }
+
+        [Fact]
+        public void MainAction_DeduplicatedHitsNotCaptured()
+        {
+            var breakpoint = new Breakpoint
+            {
+                Id = "some-id",
+                HitCount = 2,
+                StackFingerprint = 42
+            };
+            _mockBreakpointServer.Setup(s => s.ReadBreakpointAsync(It.IsAny<CancellationToken>()))
+                .Returns(Task.FromResult(breakpoint));
+            _server.MainAction();
+
+            _mockDebuggerClient.Verify(c => c.UpdateBreakpoint(
+                It.IsAny<Debugger.V2.Breakpoint>()), Times.Never);
+        }
+
         [Fact]
         public void MainAction_KillServer()
         {
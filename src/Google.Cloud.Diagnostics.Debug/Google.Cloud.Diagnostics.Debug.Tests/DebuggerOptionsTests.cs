@@ -33,6 +33,8 @@ namespace Google.Cloud.Diagnostics.Debug.Tests
 
             Assert.False(options.PropertyEvaluation);
             Assert.False(options.MethodEvaluation);
+            Assert.False(options.StackOnly);
+            Assert.Null(options.MaxExpressionCollectionSize);
             Assert.Null(options.ApplicationStartCommand);
             Assert.Equal(_processId, options.ApplicationId);
             Assert.StartsWith(Constants.PipeName, options.PipeName);
@@ -72,6 +74,34 @@ namespace Google.Cloud.Diagnostics.Debug.Tests
             Assert.StartsWith(Constants.PipeName, options.PipeName);
         }
 
+        [Fact]
+        public void FromAgentOptions_StackOnly()
+        {
+            var agentOptions = new AgentOptions
+            {
+                ApplicationStartCommand = _startCmd,
+                StackOnly = true
+            };
+            var options = DebuggerOptions.FromAgentOptions(agentOptions);
+
+            Assert.True(options.StackOnly);
+            Assert.Contains(DebuggerOptions.StackOnlyOption, options.ToString());
+        }
+
+        [Fact]
+        public void FromAgentOptions_MaxExpressionCollectionSize()
+        {
+            var agentOptions = new AgentOptions
+            {
+                ApplicationStartCommand = _startCmd,
+                MaxExpressionCollectionSize = 5000
+            };
+            var options = DebuggerOptions.FromAgentOptions(agentOptions);
+
+            Assert.Equal(5000, options.MaxExpressionCollectionSize);
+            Assert.Contains($"{DebuggerOptions.MaxExpressionCollectionSizeOption}=5000", options.ToString());
+        }
+
         [Fact]
         public void FromAgentOptionsThrows_None() =>
             Assert.Throws<ArgumentException>(() => DebuggerOptions.FromAgentOptions(new AgentOptions()));
@@ -119,6 +149,8 @@ namespace Google.Cloud.Diagnostics.Debug.Tests
             Assert.Contains($"{DebuggerOptions.ApplicationStartCommandOption}=\"{_startCmd}\"", optionsString);
             Assert.DoesNotContain(DebuggerOptions.PropertyEvaluationOption, optionsString);
             Assert.DoesNotContain(DebuggerOptions.MethodEvaluationOption, optionsString);
+            Assert.DoesNotContain(DebuggerOptions.StackOnlyOption, optionsString);
+            Assert.DoesNotContain(DebuggerOptions.MaxExpressionCollectionSizeOption, optionsString);
             Assert.DoesNotContain(DebuggerOptions.ApplicationIdOption, optionsString);
         }
     }
@@ -131,5 +131,56 @@ namespace Google.Cloud.Diagnostics.Debug.Tests
                 sdVariable = sdVariable.Members.Single();
             }
         }
+
+        [Fact]
+        public void Convert_VariableTable()
+        {
+            var variable = new Variable
+            {
+                Name = _name,
+                Value = _value,
+                Type = _type,
+                ObjectId = 1,
+                Members = { new Variable { Name = _name + 1, Value = _value + 1 } },
+            };
+            var reference = new Variable
+            {
+                Name = _name + 2,
+                Type = _type,
+                ObjectId = 1,
+                IsReference = true,
+            };
+
+            var table = new VariableTable();
+            var sdReference = reference.Convert(table);
+            var sdVariable = variable.Convert(table);
+
+            Assert.Equal(_name, sdVariable.Name);
+            Assert.Equal(0, sdVariable.VarTableIndex);
+            Assert.Empty(sdVariable.Members);
+            Assert.Equal(_name + 2, sdReference.Name);
+            Assert.Equal(0, sdReference.VarTableIndex);
+
+            var entry = Assert.Single(table.Entries);
+            Assert.Equal(_value, entry.Value);
+            Assert.Equal(_type, entry.Type);
+            Assert.Equal(_name + 1, entry.Members.Single().Name);
+        }
+
+        [Fact]
+        public void Convert_NoVariableTable()
+        {
+            var variable = new Variable
+            {
+                Name = _name,
+                Value = _value,
+                ObjectId = 1,
+            };
+
+            var sdVariable = variable.Convert();
+            Assert.Equal(_name, sdVariable.Name);
+            Assert.Equal(_value, sdVariable.Value);
+            Assert.Null(sdVariable.VarTableIndex);
+        }
     }
 }
@@ -80,6 +80,16 @@ namespace Google.Cloud.Diagnostics.Debug
             " evaluating breakpoint's condition or expression.")]
         public bool MethodEvaluation { get; set; }
 
+        [Option("stack-only",
+            HelpText = "If set, breakpoints only capture the call stack," +
+            " without any variables or expressions.")]
+        public bool StackOnly { get; set; }
+
+        [Option("max-expression-collection-size",
+            HelpText = "The maximum number of items captured from a collection" +
+            " in a breakpoint's expression, including slices such as items[100..200].")]
+        public int? MaxExpressionCollectionSize { get; set; }
+
         [Option("source-context",
             HelpText = "The location of the source context file. See: " +
             "https://cloud.google.com/debugger/docs/source-context")]
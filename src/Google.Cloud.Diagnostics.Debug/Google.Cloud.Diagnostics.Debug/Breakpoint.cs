@@ -23,7 +23,7 @@ namespace Google.Cloud.Diagnostics.Debug {
       byte[] descriptorData = global::System.Convert.FromBase64String(
           string.Concat(
             "ChBicmVha3BvaW50LnByb3RvEh5nb29nbGUuY2xvdWQuZGlhZ25vc3RpY3Mu",
-            "ZGVidWcaH2dvb2dsZS9wcm90b2J1Zi90aW1lc3RhbXAucHJvdG8izgMKCkJy",
+            "ZGVidWcaH2dvb2dsZS9wcm90b2J1Zi90aW1lc3RhbXAucHJvdG8izwUKCkJy",
             "ZWFrcG9pbnQSCgoCaWQYASABKAkSQAoIbG9jYXRpb24YAiABKAsyLi5nb29n",
             "bGUuY2xvdWQuZGlhZ25vc3RpY3MuZGVidWcuU291cmNlTG9jYXRpb24SQAoM",
             "c3RhY2tfZnJhbWVzGAMgAygLMiouZ29vZ2xlLmNsb3VkLmRpYWdub3N0aWNz",
@@ -34,25 +34,31 @@ namespace Google.Cloud.Diagnostics.Debug {
             "b25kaXRpb24YCSABKAkSRwoVZXZhbHVhdGVkX2V4cHJlc3Npb25zGAogAygL",
             "MiguZ29vZ2xlLmNsb3VkLmRpYWdub3N0aWNzLmRlYnVnLlZhcmlhYmxlEjYK",
             "BnN0YXR1cxgLIAEoCzImLmdvb2dsZS5jbG91ZC5kaWFnbm9zdGljcy5kZWJ1",
-            "Zy5TdGF0dXMi2gEKClN0YWNrRnJhbWUSEwoLbWV0aG9kX25hbWUYASABKAkS",
-            "QAoIbG9jYXRpb24YAiABKAsyLi5nb29nbGUuY2xvdWQuZGlhZ25vc3RpY3Mu",
-            "ZGVidWcuU291cmNlTG9jYXRpb24SOwoJYXJndW1lbnRzGAMgAygLMiguZ29v",
-            "Z2xlLmNsb3VkLmRpYWdub3N0aWNzLmRlYnVnLlZhcmlhYmxlEjgKBmxvY2Fs",
-            "cxgEIAMoCzIoLmdvb2dsZS5jbG91ZC5kaWFnbm9zdGljcy5kZWJ1Zy5WYXJp",
-            "YWJsZSIsCg5Tb3VyY2VMb2NhdGlvbhIMCgRwYXRoGAEgASgJEgwKBGxpbmUY",
-            "AiABKAUiqAEKCFZhcmlhYmxlEgwKBG5hbWUYASABKAkSDAoEdHlwZRgCIAEo",
-            "CRINCgV2YWx1ZRgDIAEoCRI5CgdtZW1iZXJzGAQgAygLMiguZ29vZ2xlLmNs",
-            "b3VkLmRpYWdub3N0aWNzLmRlYnVnLlZhcmlhYmxlEjYKBnN0YXR1cxgFIAEo",
-            "CzImLmdvb2dsZS5jbG91ZC5kaWFnbm9zdGljcy5kZWJ1Zy5TdGF0dXMiKgoG",
-            "U3RhdHVzEg8KB2lzZXJyb3IYASABKAgSDwoHbWVzc2FnZRgCIAEoCWIGcHJv",
-            "dG8z"));
+            "Zy5TdGF0dXMSGAoQbWF4X3N0YWNrX2ZyYW1lcxgMIAEoBRInCh9tYXhfc3Rh",
+            "Y2tfZnJhbWVzX3dpdGhfdmFyaWFibGVzGA0gASgFEhgKEG1heF9vYmplY3Rf",
+            "ZGVwdGgYDiABKAUSGwoTbWF4X2NvbGxlY3Rpb25fc2l6ZRgPIAEoBRIbChNt",
+            "YXhfYnJlYWtwb2ludF9zaXplGBAgASgFEhIKCnN0YWNrX29ubHkYESABKAgS",
+            "EQoJaGl0X2NvdW50GBIgASgFEhkKEXN0YWNrX2ZpbmdlcnByaW50GBMgASgE",
+            "EiYKHm1heF9leHByZXNzaW9uX2NvbGxlY3Rpb25fc2l6ZRgUIAEoBSLaAQoK",
+            "U3RhY2tGcmFtZRITCgttZXRob2RfbmFtZRgBIAEoCRJACghsb2NhdGlvbhgC",
+            "IAEoCzIuLmdvb2dsZS5jbG91ZC5kaWFnbm9zdGljcy5kZWJ1Zy5Tb3VyY2VM",
+            "b2NhdGlvbhI7Cglhcmd1bWVudHMYAyADKAsyKC5nb29nbGUuY2xvdWQuZGlh",
+            "Z25vc3RpY3MuZGVidWcuVmFyaWFibGUSOAoGbG9jYWxzGAQgAygLMiguZ29v",
+            "Z2xlLmNsb3VkLmRpYWdub3N0aWNzLmRlYnVnLlZhcmlhYmxlIiwKDlNvdXJj",
+            "ZUxvY2F0aW9uEgwKBHBhdGgYASABKAkSDAoEbGluZRgCIAEoBSLRAQoIVmFy",
+            "aWFibGUSDAoEbmFtZRgBIAEoCRIMCgR0eXBlGAIgASgJEg0KBXZhbHVlGAMg",
+            "ASgJEjkKB21lbWJlcnMYBCADKAsyKC5nb29nbGUuY2xvdWQuZGlhZ25vc3Rp",
+            "Y3MuZGVidWcuVmFyaWFibGUSNgoGc3RhdHVzGAUgASgLMiYuZ29vZ2xlLmNs",
+            "b3VkLmRpYWdub3N0aWNzLmRlYnVnLlN0YXR1cxIRCglvYmplY3RfaWQYBiAB",
+            "KAUSFAoMaXNfcmVmZXJlbmNlGAcgASgIIioKBlN0YXR1cxIPCgdpc2Vycm9y",
+            "GAEgASgIEg8KB21lc3NhZ2UYAiABKAliBnByb3RvMw=="));
       descriptor = pbr::FileDescriptor.FromGeneratedCode(descriptorData,
           new pbr::FileDescriptor[] { global::Google.Protobuf.WellKnownTypes.TimestampReflection.Descriptor, },
           new pbr::GeneratedClrTypeInfo(null, new pbr::GeneratedClrTypeInfo[] {
-            new pbr::GeneratedClrTypeInfo(typeof(global::Google.Cloud.Diagnostics.Debug.Breakpoint), global::Google.Cloud.Diagnostics.Debug.Breakpoint.Parser, new[]{ "Id", "Location", "StackFrames", "Activated", "CreateTime", "FinalTime", "KillServer", "Expressions", "Condition", "EvaluatedExpressions", "Status" }, null, null, null),
+            new pbr::GeneratedClrTypeInfo(typeof(global::Google.Cloud.Diagnostics.Debug.Breakpoint), global::Google.Cloud.Diagnostics.Debug.Breakpoint.Parser, new[]{ "Id", "Location", "StackFrames", "Activated", "CreateTime", "FinalTime", "KillServer", "Expressions", "Condition", "EvaluatedExpressions", "Status", "MaxStackFrames", "MaxStackFramesWithVariables", "MaxObjectDepth", "MaxCollectionSize", "MaxBreakpointSize", "StackOnly", "HitCount", "StackFingerprint", "MaxExpressionCollectionSize" }, null, null, null),
             new pbr::GeneratedClrTypeInfo(typeof(global::Google.Cloud.Diagnostics.Debug.StackFrame), global::Google.Cloud.Diagnostics.Debug.StackFrame.Parser, new[]{ "MethodName", "Location", "Arguments", "Locals" }, null, null, null),
             new pbr::GeneratedClrTypeInfo(typeof(global::Google.Cloud.Diagnostics.Debug.SourceLocation), global::Google.Cloud.Diagnostics.Debug.SourceLocation.Parser, new[]{ "Path", "Line" }, null, null, null),
-            new pbr::GeneratedClrTypeInfo(typeof(global::Google.Cloud.Diagnostics.Debug.Variable), global::Google.Cloud.Diagnostics.Debug.Variable.Parser, new[]{ "Name", "Type", "Value", "Members", "Status" }, null, null, null),
+            new pbr::GeneratedClrTypeInfo(typeof(global::Google.Cloud.Diagnostics.Debug.Variable), global::Google.Cloud.Diagnostics.Debug.Variable.Parser, new[]{ "Name", "Type", "Value", "Members", "Status", "ObjectId", "IsReference" }, null, null, null),
             new pbr::GeneratedClrTypeInfo(typeof(global::Google.Cloud.Diagnostics.Debug.Status), global::Google.Cloud.Diagnostics.Debug.Status.Parser, new[]{ "Iserror", "Message" }, null, null, null)
           }));
     }
@@ -95,6 +101,15 @@ namespace Google.Cloud.Diagnostics.Debug {
       condition_ = other.condition_;
       evaluatedExpressions_ = other.evaluatedExpressions_.Clone();
       Status = other.status_ != null ? other.Status.Clone() : null;
+      maxStackFrames_ = other.maxStackFrames_;
+      maxStackFramesWithVariables_ = other.maxStackFramesWithVariables_;
+      maxObjectDepth_ = other.maxObjectDepth_;
+      maxCollectionSize_ = other.maxCollectionSize_;
+      maxBreakpointSize_ = other.maxBreakpointSize_;
+      stackOnly_ = other.stackOnly_;
+      hitCount_ = other.hitCount_;
+      stackFingerprint_ = other.stackFingerprint_;
+      maxExpressionCollectionSize_ = other.maxExpressionCollectionSize_;
     }
 
     [global::System.Diagnostics.DebuggerNonUserCodeAttribute]
@@ -220,6 +235,126 @@ namespace Google.Cloud.Diagnostics.Debug {
       }
     }
 
+    /// <summary>Field number for the "max_stack_frames" field.</summary>
+    public const int MaxStackFramesFieldNumber = 12;
+    private int maxStackFrames_;
+    /// <summary>
+    /// Capture limits of the breakpoint. 0 means the debugger default.
+    /// </summary>
+    [global::System.Diagnostics.DebuggerNonUserCodeAttribute]
+    public int MaxStackFrames {
+      get { return maxStackFrames_; }
+      set {
+        maxStackFrames_ = value;
+      }
+    }
+
+    /// <summary>Field number for the "max_stack_frames_with_variables" field.</summary>
+    public const int MaxStackFramesWithVariablesFieldNumber = 13;
+    private int maxStackFramesWithVariables_;
+    [global::System.Diagnostics.DebuggerNonUserCodeAttribute]
+    public int MaxStackFramesWithVariables {
+      get { return maxStackFramesWithVariables_; }
+      set {
+        maxStackFramesWithVariables_ = value;
+      }
+    }
+
+    /// <summary>Field number for the "max_object_depth" field.</summary>
+    public const int MaxObjectDepthFieldNumber = 14;
+    private int maxObjectDepth_;
+    [global::System.Diagnostics.DebuggerNonUserCodeAttribute]
+    public int MaxObjectDepth {
+      get { return maxObjectDepth_; }
+      set {
+        maxObjectDepth_ = value;
+      }
+    }
+
+    /// <summary>Field number for the "max_collection_size" field.</summary>
+    public const int MaxCollectionSizeFieldNumber = 15;
+    private int maxCollectionSize_;
+    [global::System.Diagnostics.DebuggerNonUserCodeAttribute]
+    public int MaxCollectionSize {
+      get { return maxCollectionSize_; }
+      set {
+        maxCollectionSize_ = value;
+      }
+    }
+
+    /// <summary>Field number for the "max_breakpoint_size" field.</summary>
+    public const int MaxBreakpointSizeFieldNumber = 16;
+    private int maxBreakpointSize_;
+    [global::System.Diagnostics.DebuggerNonUserCodeAttribute]
+    public int MaxBreakpointSize {
+      get { return maxBreakpointSize_; }
+      set {
+        maxBreakpointSize_ = value;
+      }
+    }
+
+    /// <summary>Field number for the "stack_only" field.</summary>
+    public const int StackOnlyFieldNumber = 17;
+    private bool stackOnly_;
+    /// <summary>
+    /// If true, only the call stack is captured, without any variables
+    /// or expressions.
+    /// </summary>
+    [global::System.Diagnostics.DebuggerNonUserCodeAttribute]
+    public bool StackOnly {
+      get { return stackOnly_; }
+      set {
+        stackOnly_ = value;
+      }
+    }
+
+    /// <summary>Field number for the "hit_count" field.</summary>
+    public const int HitCountFieldNumber = 18;
+    private int hitCount_;
+    /// <summary>
+    /// Number of hits of the breakpoint with the same call stack in the
+    /// deduplication window. Only the first hit of a window is captured, with
+    /// a count of 1. If the window had more hits, a breakpoint with only the
+    /// id, location, stack fingerprint and the total count of the window is
+    /// sent when it ends or when the breakpoint is removed.
+    /// </summary>
+    [global::System.Diagnostics.DebuggerNonUserCodeAttribute]
+    public int HitCount {
+      get { return hitCount_; }
+      set {
+        hitCount_ = value;
+      }
+    }
+
+    /// <summary>Field number for the "stack_fingerprint" field.</summary>
+    public const int StackFingerprintFieldNumber = 19;
+    private ulong stackFingerprint_;
+    /// <summary>
+    /// Fingerprint of the call stack of the hit.
+    /// </summary>
+    [global::System.Diagnostics.DebuggerNonUserCodeAttribute]
+    public ulong StackFingerprint {
+      get { return stackFingerprint_; }
+      set {
+        stackFingerprint_ = value;
+      }
+    }
+
+    /// <summary>Field number for the "max_expression_collection_size" field.</summary>
+    public const int MaxExpressionCollectionSizeFieldNumber = 20;
+    private int maxExpressionCollectionSize_;
+    /// <summary>
+    /// Maximum number of items captured from a collection in an expression.
+    /// 0 means the debugger default.
+    /// </summary>
+    [global::System.Diagnostics.DebuggerNonUserCodeAttribute]
+    public int MaxExpressionCollectionSize {
+      get { return maxExpressionCollectionSize_; }
+      set {
+        maxExpressionCollectionSize_ = value;
+      }
+    }
+
     [global::System.Diagnostics.DebuggerNonUserCodeAttribute]
     public override bool Equals(object other) {
       return Equals(other as Breakpoint);
@@ -244,6 +379,15 @@ namespace Google.Cloud.Diagnostics.Debug {
       if (Condition != other.Condition) return false;
       if(!evaluatedExpressions_.Equals(other.evaluatedExpressions_)) return false;
       if (!object.Equals(Status, other.Status)) return false;
+      if (MaxStackFrames != other.MaxStackFrames) return false;
+      if (MaxStackFramesWithVariables != other.MaxStackFramesWithVariables) return false;
+      if (MaxObjectDepth != other.MaxObjectDepth) return false;
+      if (MaxCollectionSize != other.MaxCollectionSize) return false;
+      if (MaxBreakpointSize != other.MaxBreakpointSize) return false;
+      if (StackOnly != other.StackOnly) return false;
+      if (HitCount != other.HitCount) return false;
+      if (StackFingerprint != other.StackFingerprint) return false;
+      if (MaxExpressionCollectionSize != other.MaxExpressionCollectionSize) return false;
       return true;
     }
 
@@ -261,6 +405,15 @@ namespace Google.Cloud.Diagnostics.Debug {
       if (Condition.Length != 0) hash ^= Condition.GetHashCode();
       hash ^= evaluatedExpressions_.GetHashCode();
       if (status_ != null) hash ^= Status.GetHashCode();
+      if (MaxStackFrames != 0) hash ^= MaxStackFrames.GetHashCode();
+      if (MaxStackFramesWithVariables != 0) hash ^= MaxStackFramesWithVariables.GetHashCode();
+      if (MaxObjectDepth != 0) hash ^= MaxObjectDepth.GetHashCode();
+      if (MaxCollectionSize != 0) hash ^= MaxCollectionSize.GetHashCode();
+      if (MaxBreakpointSize != 0) hash ^= MaxBreakpointSize.GetHashCode();
+      if (StackOnly != false) hash ^= StackOnly.GetHashCode();
+      if (HitCount != 0) hash ^= HitCount.GetHashCode();
+      if (StackFingerprint != 0UL) hash ^= StackFingerprint.GetHashCode();
+      if (MaxExpressionCollectionSize != 0) hash ^= MaxExpressionCollectionSize.GetHashCode();
       return hash;
     }
 
@@ -306,6 +459,42 @@ namespace Google.Cloud.Diagnostics.Debug {
         output.WriteRawTag(90);
         output.WriteMessage(Status);
       }
+      if (MaxStackFrames != 0) {
+        output.WriteRawTag(96);
+        output.WriteInt32(MaxStackFrames);
+      }
+      if (MaxStackFramesWithVariables != 0) {
+        output.WriteRawTag(104);
+        output.WriteInt32(MaxStackFramesWithVariables);
+      }
+      if (MaxObjectDepth != 0) {
+        output.WriteRawTag(112);
+        output.WriteInt32(MaxObjectDepth);
+      }
+      if (MaxCollectionSize != 0) {
+        output.WriteRawTag(120);
+        output.WriteInt32(MaxCollectionSize);
+      }
+      if (MaxBreakpointSize != 0) {
+        output.WriteRawTag(128, 1);
+        output.WriteInt32(MaxBreakpointSize);
+      }
+      if (StackOnly != false) {
+        output.WriteRawTag(136, 1);
+        output.WriteBool(StackOnly);
+      }
+      if (HitCount != 0) {
+        output.WriteRawTag(144, 1);
+        output.WriteInt32(HitCount);
+      }
+      if (StackFingerprint != 0UL) {
+        output.WriteRawTag(152, 1);
+        output.WriteUInt64(StackFingerprint);
+      }
+      if (MaxExpressionCollectionSize != 0) {
+        output.WriteRawTag(160, 1);
+        output.WriteInt32(MaxExpressionCollectionSize);
+      }
     }
 
     [global::System.Diagnostics.DebuggerNonUserCodeAttribute]
@@ -338,6 +527,33 @@ namespace Google.Cloud.Diagnostics.Debug {
       if (status_ != null) {
         size += 1 + pb::CodedOutputStream.ComputeMessageSize(Status);
       }
+      if (MaxStackFrames != 0) {
+        size += 1 + pb::CodedOutputStream.ComputeInt32Size(MaxStackFrames);
+      }
+      if (MaxStackFramesWithVariables != 0) {
+        size += 1 + pb::CodedOutputStream.ComputeInt32Size(MaxStackFramesWithVariables);
+      }
+      if (MaxObjectDepth != 0) {
+        size += 1 + pb::CodedOutputStream.ComputeInt32Size(MaxObjectDepth);
+      }
+      if (MaxCollectionSize != 0) {
+        size += 1 + pb::CodedOutputStream.ComputeInt32Size(MaxCollectionSize);
+      }
+      if (MaxBreakpointSize != 0) {
+        size += 2 + pb::CodedOutputStream.ComputeInt32Size(MaxBreakpointSize);
+      }
+      if (StackOnly != false) {
+        size += 2 + 1;
+      }
+      if (HitCount != 0) {
+        size += 2 + pb::CodedOutputStream.ComputeInt32Size(HitCount);
+      }
+      if (StackFingerprint != 0UL) {
+        size += 2 + pb::CodedOutputStream.ComputeUInt64Size(StackFingerprint);
+      }
+      if (MaxExpressionCollectionSize != 0) {
+        size += 2 + pb::CodedOutputStream.ComputeInt32Size(MaxExpressionCollectionSize);
+      }
       return size;
     }
 
@@ -385,6 +601,33 @@ namespace Google.Cloud.Diagnostics.Debug {
         }
         Status.MergeFrom(other.Status);
       }
+      if (other.MaxStackFrames != 0) {
+        MaxStackFrames = other.MaxStackFrames;
+      }
+      if (other.MaxStackFramesWithVariables != 0) {
+        MaxStackFramesWithVariables = other.MaxStackFramesWithVariables;
+      }
+      if (other.MaxObjectDepth != 0) {
+        MaxObjectDepth = other.MaxObjectDepth;
+      }
+      if (other.MaxCollectionSize != 0) {
+        MaxCollectionSize = other.MaxCollectionSize;
+      }
+      if (other.MaxBreakpointSize != 0) {
+        MaxBreakpointSize = other.MaxBreakpointSize;
+      }
+      if (other.StackOnly != false) {
+        StackOnly = other.StackOnly;
+      }
+      if (other.HitCount != 0) {
+        HitCount = other.HitCount;
+      }
+      if (other.StackFingerprint != 0UL) {
+        StackFingerprint = other.StackFingerprint;
+      }
+      if (other.MaxExpressionCollectionSize != 0) {
+        MaxExpressionCollectionSize = other.MaxExpressionCollectionSize;
+      }
     }
 
     [global::System.Diagnostics.DebuggerNonUserCodeAttribute]
@@ -451,6 +694,42 @@ namespace Google.Cloud.Diagnostics.Debug {
             input.ReadMessage(status_);
             break;
           }
+          case 96: {
+            MaxStackFrames = input.ReadInt32();
+            break;
+          }
+          case 104: {
+            MaxStackFramesWithVariables = input.ReadInt32();
+            break;
+          }
+          case 112: {
+            MaxObjectDepth = input.ReadInt32();
+            break;
+          }
+          case 120: {
+            MaxCollectionSize = input.ReadInt32();
+            break;
+          }
+          case 128: {
+            MaxBreakpointSize = input.ReadInt32();
+            break;
+          }
+          case 136: {
+            StackOnly = input.ReadBool();
+            break;
+          }
+          case 144: {
+            HitCount = input.ReadInt32();
+            break;
+          }
+          case 152: {
+            StackFingerprint = input.ReadUInt64();
+            break;
+          }
+          case 160: {
+            MaxExpressionCollectionSize = input.ReadInt32();
+            break;
+          }
         }
       }
     }
@@ -822,6 +1101,8 @@ namespace Google.Cloud.Diagnostics.Debug {
       value_ = other.value_;
       members_ = other.members_.Clone();
       Status = other.status_ != null ? other.Status.Clone() : null;
+      objectId_ = other.objectId_;
+      isReference_ = other.isReference_;
     }
 
     [global::System.Diagnostics.DebuggerNonUserCodeAttribute]
@@ -883,6 +1164,36 @@ namespace Google.Cloud.Diagnostics.Debug {
       }
     }
 
+    /// <summary>Field number for the "object_id" field.</summary>
+    public const int ObjectIdFieldNumber = 6;
+    private int objectId_;
+    /// <summary>
+    /// Set if the object of this variable is reached through more than one
+    /// variable. All the variables of the object have the same ID.
+    /// </summary>
+    [global::System.Diagnostics.DebuggerNonUserCodeAttribute]
+    public int ObjectId {
+      get { return objectId_; }
+      set {
+        objectId_ = value;
+      }
+    }
+
+    /// <summary>Field number for the "is_reference" field.</summary>
+    public const int IsReferenceFieldNumber = 7;
+    private bool isReference_;
+    /// <summary>
+    /// If true, the members of the object are not captured in this variable
+    /// but in the variable with the same object_id where this is false.
+    /// </summary>
+    [global::System.Diagnostics.DebuggerNonUserCodeAttribute]
+    public bool IsReference {
+      get { return isReference_; }
+      set {
+        isReference_ = value;
+      }
+    }
+
     [global::System.Diagnostics.DebuggerNonUserCodeAttribute]
     public override bool Equals(object other) {
       return Equals(other as Variable);
@@ -901,6 +1212,8 @@ namespace Google.Cloud.Diagnostics.Debug {
       if (Value != other.Value) return false;
       if(!members_.Equals(other.members_)) return false;
       if (!object.Equals(Status, other.Status)) return false;
+      if (ObjectId != other.ObjectId) return false;
+      if (IsReference != other.IsReference) return false;
       return true;
     }
 
@@ -912,6 +1225,8 @@ namespace Google.Cloud.Diagnostics.Debug {
       if (Value.Length != 0) hash ^= Value.GetHashCode();
       hash ^= members_.GetHashCode();
       if (status_ != null) hash ^= Status.GetHashCode();
+      if (ObjectId != 0) hash ^= ObjectId.GetHashCode();
+      if (IsReference != false) hash ^= IsReference.GetHashCode();
       return hash;
     }
 
@@ -939,6 +1254,14 @@ namespace Google.Cloud.Diagnostics.Debug {
         output.WriteRawTag(42);
         output.WriteMessage(Status);
       }
+      if (ObjectId != 0) {
+        output.WriteRawTag(48);
+        output.WriteInt32(ObjectId);
+      }
+      if (IsReference != false) {
+        output.WriteRawTag(56);
+        output.WriteBool(IsReference);
+      }
     }
 
     [global::System.Diagnostics.DebuggerNonUserCodeAttribute]
@@ -957,6 +1280,12 @@ namespace Google.Cloud.Diagnostics.Debug {
       if (status_ != null) {
         size += 1 + pb::CodedOutputStream.ComputeMessageSize(Status);
       }
+      if (ObjectId != 0) {
+        size += 1 + pb::CodedOutputStream.ComputeInt32Size(ObjectId);
+      }
+      if (IsReference != false) {
+        size += 1 + 1;
+      }
       return size;
     }
 
@@ -981,6 +1310,12 @@ namespace Google.Cloud.Diagnostics.Debug {
         }
         Status.MergeFrom(other.Status);
       }
+      if (other.ObjectId != 0) {
+        ObjectId = other.ObjectId;
+      }
+      if (other.IsReference != false) {
+        IsReference = other.IsReference;
+      }
     }
 
     [global::System.Diagnostics.DebuggerNonUserCodeAttribute]
@@ -1014,6 +1349,14 @@ namespace Google.Cloud.Diagnostics.Debug {
             input.ReadMessage(status_);
             break;
           }
+          case 48: {
+            ObjectId = input.ReadInt32();
+            break;
+          }
+          case 56: {
+            IsReference = input.ReadBool();
+            break;
+          }
         }
       }
     }
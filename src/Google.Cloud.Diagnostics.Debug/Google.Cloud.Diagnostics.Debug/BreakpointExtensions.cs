@@ -24,9 +24,18 @@ namespace Google.Cloud.Diagnostics.Debug
     /// </summary>
     internal static class BreakpointExtensions
     {
+        /// <summary>The label holding the number of hits from the captured call stack.</summary>
+        public const string HitCountLabel = "hit_count";
+
+        /// <summary>The label holding the fingerprint of the captured call stack.</summary>
+        public const string StackFingerprintLabel = "stack_fingerprint";
+
         /// <summary>
         /// Converts a <see cref="StackdriverBreakpoint"/> to a <see cref="Breakpoint"/>.
         /// Converts ID and location and sets "Activated" to true.
+        /// The Stackdriver breakpoint has no capture limits, so the limits of the
+        /// <see cref="Breakpoint"/> are left unset and the debugger uses the defaults
+        /// from its command line.
         /// </summary>
         public static Breakpoint Convert(this StackdriverBreakpoint breakpoint)
         {
@@ -49,10 +58,13 @@ namespace Google.Cloud.Diagnostics.Debug
         /// Converts a <see cref="Breakpoint"/> to a <see cref="StackdriverBreakpoint"/>.
         /// </summary>
         /// Converts CreateTime, FinalTime, ID, Location and StackFrames.
+        /// Objects captured once for several variables are moved to the variable table.
+        /// The hit count and stack fingerprint, when set, are reported as labels.
         public static StackdriverBreakpoint Convert(this Breakpoint breakpoint)
         {
             GaxPreconditions.CheckNotNull(breakpoint, nameof(breakpoint));
-            return new StackdriverBreakpoint
+            var table = new VariableTable();
+            var sdBreakpoint = new StackdriverBreakpoint
             {
                 CreateTime = breakpoint.CreateTime,
                 FinalTime = breakpoint.FinalTime,
@@ -68,13 +80,27 @@ namespace Google.Cloud.Diagnostics.Debug
                     Common.CreateStatusMessage(breakpoint.Status.Message,
                                                breakpoint.Status.Iserror) : null,
 
-                StackFrames = { breakpoint.StackFrames?.Select(frame => frame.Convert()).ToList() },
+                StackFrames = { breakpoint.StackFrames?.Select(frame => frame.Convert(table)).ToList() },
 
                 EvaluatedExpressions =
                 {
-                    breakpoint.EvaluatedExpressions?.Select(variable => variable.Convert()).ToList()
-                }
+                    breakpoint.EvaluatedExpressions?.Select(variable => variable.Convert(table)).ToList()
+                },
+
+                // Initialized last as converting the frames and expressions fills the table.
+                VariableTable = { table.Entries }
             };
+
+            if (breakpoint.HitCount > 0)
+            {
+                sdBreakpoint.Labels[HitCountLabel] = breakpoint.HitCount.ToString();
+            }
+
+            if (breakpoint.StackFingerprint != 0)
+            {
+                sdBreakpoint.Labels[StackFingerprintLabel] = breakpoint.StackFingerprint.ToString("x16");
+            }
+            return sdBreakpoint;
         }
     }
 }
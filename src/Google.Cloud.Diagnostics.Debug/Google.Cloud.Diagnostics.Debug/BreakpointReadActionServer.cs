@@ -13,6 +13,8 @@
 // limitations under the License.
 
 using Google.Api.Gax;
+using System;
+using System.Collections.Generic;
 using System.Threading;
 using StackdriverBreakpoint = Google.Cloud.Debugger.V2.Breakpoint;
 
@@ -24,9 +26,22 @@ namespace Google.Cloud.Diagnostics.Debug
     /// </summary>
     public class BreakpointReadActionServer : BreakpointActionServer
     {
+        /// <summary>
+        /// The maximum number of captured breakpoints kept to report the hit counts
+        /// of their deduplicated hits.
+        /// </summary>
+        internal const int MaxCapturedBreakpoints = 100;
+
         private readonly IDebuggerClient _client;
         private readonly BreakpointManager _breakpointManager;
 
+        // Captured breakpoints by id and stack fingerprint, with the order
+        // they were captured in so the oldest can be dropped.
+        private readonly Dictionary<Tuple<string, ulong>, StackdriverBreakpoint> _capturedBreakpoints =
+            new Dictionary<Tuple<string, ulong>, StackdriverBreakpoint>();
+        private readonly Queue<Tuple<string, ulong>> _capturedBreakpointKeys =
+            new Queue<Tuple<string, ulong>>();
+
         /// <summary>
         /// Create a new <see cref="BreakpointReadActionServer"/>.
         /// </summary>
@@ -44,6 +59,9 @@ namespace Google.Cloud.Diagnostics.Debug
         /// <summary>
         /// Blocks and reads a breakpoint from the <see cref="IBreakpointServer"/>
         /// and then sends the sends the breakpoint to the debugger API.
+        /// A breakpoint with a hit count greater than 1 only reports the number of hits
+        /// from the call stack of a captured breakpoint: the captured breakpoint is sent
+        /// again with the new hit count.
         /// </summary>
         internal override void MainAction()
         {
@@ -53,9 +71,46 @@ namespace Google.Cloud.Diagnostics.Debug
                 _cts.Cancel();
                 return;
             }
+
+            var key = Tuple.Create(readBreakpoint.Id, readBreakpoint.StackFingerprint);
+            if (readBreakpoint.HitCount > 1)
+            {
+                StackdriverBreakpoint capturedBreakpoint;
+                if (!_capturedBreakpoints.TryGetValue(key, out capturedBreakpoint))
+                {
+                    return;
+                }
+                StackdriverBreakpoint updatedBreakpoint = capturedBreakpoint.Clone();
+                updatedBreakpoint.Labels[BreakpointExtensions.HitCountLabel] = readBreakpoint.HitCount.ToString();
+                _client.UpdateBreakpoint(updatedBreakpoint);
+                return;
+            }
+
             StackdriverBreakpoint breakpoint = readBreakpoint.Convert();
             breakpoint.IsFinalState = true;
             _client.UpdateBreakpoint(breakpoint);
+
+            if (readBreakpoint.HitCount == 1)
+            {
+                KeepCapturedBreakpoint(key, breakpoint);
+            }
+        }
+
+        /// <summary>
+        /// Keeps a captured breakpoint so the hit count of its call stack can
+        /// be reported, dropping the oldest one if there are too many.
+        /// </summary>
+        private void KeepCapturedBreakpoint(Tuple<string, ulong> key, StackdriverBreakpoint breakpoint)
+        {
+            if (!_capturedBreakpoints.ContainsKey(key))
+            {
+                if (_capturedBreakpointKeys.Count >= MaxCapturedBreakpoints)
+                {
+                    _capturedBreakpoints.Remove(_capturedBreakpointKeys.Dequeue());
+                }
+                _capturedBreakpointKeys.Enqueue(key);
+            }
+            _capturedBreakpoints[key] = breakpoint;
         }
     }
 }
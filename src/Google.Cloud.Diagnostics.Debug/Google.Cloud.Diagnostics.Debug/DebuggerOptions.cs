@@ -27,6 +27,12 @@ namespace Google.Cloud.Diagnostics.Debug
         // If given this option, the debugger will perform method call when evaluating condition.
         public const string MethodEvaluationOption = "--method-evaluation";
 
+        // If given this option, breakpoints only capture their call stack.
+        public const string StackOnlyOption = "--stack-only";
+
+        // The maximum number of items captured from a collection in an expression.
+        public const string MaxExpressionCollectionSizeOption = "--max-expression-collection-size";
+
         // If given this option, the debugger will use this command to start the application to debug.
         public const string ApplicationStartCommandOption = "--application-start-command";
 
@@ -46,6 +52,17 @@ namespace Google.Cloud.Diagnostics.Debug
         /// </summary>
         public bool MethodEvaluation { get; private set; }
 
+        /// <summary>
+        /// If true, breakpoints only capture their call stack, without any variables.
+        /// </summary>
+        public bool StackOnly { get; private set; }
+
+        /// <summary>
+        /// The maximum number of items captured from a collection in an expression,
+        /// or null for the debugger default.
+        /// </summary>
+        public int? MaxExpressionCollectionSize { get; private set; }
+
         /// <summary>
         /// A command to start a .NET Core application the debugger will attach to.
         /// </summary>
@@ -78,6 +95,8 @@ namespace Google.Cloud.Diagnostics.Debug
             {
                 PropertyEvaluation = options.PropertyEvaluation,
                 MethodEvaluation = options.MethodEvaluation,
+                StackOnly = options.StackOnly,
+                MaxExpressionCollectionSize = options.MaxExpressionCollectionSize,
                 ApplicationStartCommand = options.ApplicationStartCommand,
                 ApplicationId = options.ApplicationId,
                 PipeName = CreatePipeName()
@@ -119,6 +138,16 @@ namespace Google.Cloud.Diagnostics.Debug
             {
                 options += $"{MethodEvaluationOption} ";
             }
+
+            if (StackOnly)
+            {
+                options += $"{StackOnlyOption} ";
+            }
+
+            if (MaxExpressionCollectionSize.HasValue)
+            {
+                options += $"{MaxExpressionCollectionSizeOption}={MaxExpressionCollectionSize} ";
+            }
             return options;
         }
 
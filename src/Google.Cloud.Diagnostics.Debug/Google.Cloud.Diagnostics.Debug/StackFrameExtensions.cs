@@ -26,8 +26,9 @@ namespace Google.Cloud.Diagnostics.Debug
     {
         /// <summary>
         /// Converts a <see cref="StackFrame"/> to a <see cref="StackdriverStackFrame"/>.
+        /// Objects captured with an ID are added to <paramref name="table"/>, if one is given.
         /// </summary>
-        public static StackdriverStackFrame Convert(this StackFrame stackframe)
+        public static StackdriverStackFrame Convert(this StackFrame stackframe, VariableTable table = null)
         {
             GaxPreconditions.CheckNotNull(stackframe, nameof(stackframe));
             return new StackdriverStackFrame
@@ -40,8 +41,8 @@ namespace Google.Cloud.Diagnostics.Debug
                 },
                 
                 Function = stackframe.MethodName,
-                Arguments = { stackframe.Arguments?.Select(arg => arg.Convert()).ToList() },
-                Locals = { stackframe.Locals?.Select(localVar => localVar.Convert()).ToList() }
+                Arguments = { stackframe.Arguments?.Select(arg => arg.Convert(table)).ToList() },
+                Locals = { stackframe.Locals?.Select(localVar => localVar.Convert(table)).ToList() }
             };
         }
     }
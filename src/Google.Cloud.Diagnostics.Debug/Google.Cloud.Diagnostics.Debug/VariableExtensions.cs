@@ -25,16 +25,41 @@ namespace Google.Cloud.Diagnostics.Debug
     {
         /// <summary>
         /// Converts a <see cref="Variable"/> to a <see cref="StackdriverVariable"/>.
+        /// Variables of an object captured with an ID only keep their name and point to
+        /// the entry of the object in <paramref name="table"/>, if one is given.
         /// </summary>
-        public static StackdriverVariable Convert(this Variable variable)
+        public static StackdriverVariable Convert(this Variable variable, VariableTable table = null)
         {
             GaxPreconditions.CheckNotNull(variable, nameof(variable));
+            if (table != null && variable.ObjectId != 0)
+            {
+                int index = table.GetIndex(variable.ObjectId);
+                if (!variable.IsReference)
+                {
+                    table.Entries[index] = ConvertValue(variable, table);
+                }
+                return new StackdriverVariable
+                {
+                    Name = variable.Name,
+                    VarTableIndex = index,
+                };
+            }
+
+            var sdVariable = ConvertValue(variable, table);
+            sdVariable.Name = variable.Name;
+            return sdVariable;
+        }
+
+        /// <summary>
+        /// Converts everything but the name of a <see cref="Variable"/>.
+        /// </summary>
+        private static StackdriverVariable ConvertValue(Variable variable, VariableTable table)
+        {
             return new StackdriverVariable
             {
-                Name = variable.Name,
                 Value = variable.Value,
                 Type = variable.Type,
-                Members = { variable.Members?.Select(x => x.Convert()).ToList() },
+                Members = { variable.Members?.Select(x => x.Convert(table)).ToList() },
                 Status = variable.Status == null ? null : Common.CreateStatusMessage(
                     variable.Status.Message, variable.Status.Iserror),
             };
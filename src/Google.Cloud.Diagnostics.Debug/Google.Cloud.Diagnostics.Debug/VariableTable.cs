@@ -0,0 +1,51 @@
+﻿// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+using System.Collections.Generic;
+using StackdriverVariable = Google.Cloud.Debugger.V2.Variable;
+
+namespace Google.Cloud.Diagnostics.Debug
+{
+    /// <summary>
+    /// The variable table of a <see cref="Debugger.V2.Breakpoint"/>. Objects reached
+    /// through several variables are captured once by the debugger and given an
+    /// object ID, each of them is stored once in the table and the variables
+    /// refer to it by index.
+    /// </summary>
+    internal class VariableTable
+    {
+        private readonly Dictionary<int, int> _indexes = new Dictionary<int, int>();
+
+        /// <summary>
+        /// The entries of the table, in index order.
+        /// </summary>
+        public List<StackdriverVariable> Entries { get; } = new List<StackdriverVariable>();
+
+        /// <summary>
+        /// Gets the index of the entry of the object with the given ID, adding
+        /// an empty entry if the object is not in the table yet.
+        /// </summary>
+        public int GetIndex(int objectId)
+        {
+            int index;
+            if (!_indexes.TryGetValue(objectId, out index))
+            {
+                index = Entries.Count;
+                Entries.Add(new StackdriverVariable());
+                _indexes[objectId] = index;
+            }
+            return index;
+        }
+    }
+}
@@ -3,18 +3,24 @@
 
 // TODO: Add cleanup to release pointer.
 
+#include <chrono>
 #include <iostream>
+#include <memory>
 #include <string>
 #include <thread>
 #include <vector>
 
+#include "capture_profile.h"
 #include "debugger.h"
+#include "metrics.h"
 #include "optionparser.h"
 #include "string_stream_wrapper.h"
 #include "winerror.h"
 
+using google_cloud_debugger::CaptureProfile;
 using google_cloud_debugger::ConvertStringToWCharPtr;
 using google_cloud_debugger::Debugger;
+using google_cloud_debugger::MetricsFileExporter;
 using std::cerr;
 using std::cin;
 using std::endl;
@@ -39,13 +45,54 @@ const string kApplicationIDOption = "application-id";
 // The name of the pipe the debugger will use to communicate with the agent.
 const string kPipeNameOption = "pipe-name";
 
+// If given this option, the debugger will periodically write latency
+// histograms of breakpoint hits to this file.
+const string kMetricsFileOption = "metrics-file";
+
+// The following options override the default capture limits of
+// breakpoints that do not set their own.
+const string kMaxStackFramesOption = "max-stack-frames";
+const string kMaxStackFramesWithVariablesOption =
+    "max-stack-frames-with-variables";
+const string kMaxObjectDepthOption = "max-object-depth";
+const string kMaxCollectionSizeOption = "max-collection-size";
+const string kMaxExpressionCollectionSizeOption =
+    "max-expression-collection-size";
+const string kMaxStringLengthOption = "max-string-length";
+const string kMaxBreakpointSizeOption = "max-breakpoint-size";
+
+// If given this option, breakpoints only capture their call stack,
+// without any variables or expressions.
+const string kStackOnlyOption = "stack-only";
+
+// If given this option, a breakpoint hit from a call stack that was captured
+// within this many milliseconds only reports a hit count.
+const string kStackDedupWindowOption = "stack-dedup-window-ms";
+
+// If given these options, the debugger will sample the stacks of the
+// application every this many milliseconds and write them to this file.
+const string kProfileIntervalOption = "profile-interval-ms";
+const string kProfileFileOption = "profile-file";
+
 enum optionIndex {
   UNKNOWN,
   APPLICATIONSTARTCOMMAND,
   APPLICATIONID,
   PROPERTYEVALUATION,
   METHODEVALUATION,
-  PIPENAME
+  PIPENAME,
+  METRICSFILE,
+  MAXSTACKFRAMES,
+  MAXSTACKFRAMESWITHVARIABLES,
+  MAXOBJECTDEPTH,
+  MAXCOLLECTIONSIZE,
+  MAXEXPRESSIONCOLLECTIONSIZE,
+  MAXSTRINGLENGTH,
+  MAXBREAKPOINTSIZE,
+  STACKONLY,
+  STACKDEDUPWINDOW,
+  PROFILEINTERVAL,
+  PROFILEFILE
 };
 const option::Descriptor usage[] = {
     // The first dummy Descriptor is used for unknown options,
@@ -74,9 +121,81 @@ const option::Descriptor usage[] = {
     {PIPENAME, 0, "", kPipeNameOption.c_str(), option::Arg::Optional,
      "  --pipe-name  \tThe name of the pipe the debugger will use to"
      "communicate with the agent."},
+    {METRICSFILE, 0, "", kMetricsFileOption.c_str(), option::Arg::Optional,
+     "  --metrics-file  \tIf used, the debugger will periodically write "
+     "the latency histograms of breakpoint hits to this file."},
+    {MAXSTACKFRAMES, 0, "", kMaxStackFramesOption.c_str(),
+     option::Arg::Optional,
+     "  --max-stack-frames  \tDefault maximum number of stack frames "
+     "captured when a breakpoint is hit."},
+    {MAXSTACKFRAMESWITHVARIABLES, 0, "",
+     kMaxStackFramesWithVariablesOption.c_str(), option::Arg::Optional,
+     "  --max-stack-frames-with-variables  \tDefault maximum number of "
+     "stack frames whose variables are captured."},
+    {MAXOBJECTDEPTH, 0, "", kMaxObjectDepthOption.c_str(),
+     option::Arg::Optional,
+     "  --max-object-depth  \tDefault maximum depth to which the members of "
+     "an object are captured."},
+    {MAXCOLLECTIONSIZE, 0, "", kMaxCollectionSizeOption.c_str(),
+     option::Arg::Optional,
+     "  --max-collection-size  \tDefault maximum number of items captured "
+     "from a collection."},
+    {MAXEXPRESSIONCOLLECTIONSIZE, 0, "",
+     kMaxExpressionCollectionSizeOption.c_str(), option::Arg::Optional,
+     "  --max-expression-collection-size  \tDefault maximum number of items "
+     "captured from a collection in an expression, including slices such as "
+     "items[100..200]."},
+    {MAXSTRINGLENGTH, 0, "", kMaxStringLengthOption.c_str(),
+     option::Arg::Optional,
+     "  --max-string-length  \tDefault maximum number of characters captured "
+     "from a string. Longer strings are truncated."},
+    {MAXBREAKPOINTSIZE, 0, "", kMaxBreakpointSizeOption.c_str(),
+     option::Arg::Optional,
+     "  --max-breakpoint-size  \tDefault maximum size in bytes of "
+     "a captured breakpoint."},
+    {STACKONLY, 0, "", kStackOnlyOption.c_str(), option::Arg::None,
+     "  --stack-only  \tIf used, breakpoints only capture the method names "
+     "and locations of their stack frames, without reading any variables."},
+    {STACKDEDUPWINDOW, 0, "", kStackDedupWindowOption.c_str(),
+     option::Arg::Optional,
+     "  --stack-dedup-window-ms  \tIf used, a breakpoint hit from the same "
+     "call stack as a hit captured within this many milliseconds is not "
+     "captured again, only counted."},
+    {PROFILEINTERVAL, 0, "", kProfileIntervalOption.c_str(),
+     option::Arg::Optional,
+     "  --profile-interval-ms  \tIf used with --profile-file, the debugger "
+     "will briefly stop the application this often to sample the stacks of "
+     "its managed threads."},
+    {PROFILEFILE, 0, "", kProfileFileOption.c_str(), option::Arg::Optional,
+     "  --profile-file  \tFile the sampled stacks are written to, in the "
+     "folded format read by flame graph tools."},
     {0, 0, 0, 0, 0, 0}  // Needs this, otherwise the parser throws error.
 };
 
+// Parses the capture limit given by option into limit. Leaves limit
+// unchanged if option is not given. Returns false if the option is not
+// a valid positive number.
+template <typename LimitType>
+bool ParseCaptureLimit(const option::Option &option, const string &name,
+                       LimitType *limit) {
+  if (!option.count() || !option.arg) {
+    return true;
+  }
+
+  try {
+    int value = stoi(string(option.arg));
+    if (value <= 0) {
+      cerr << "--" << name << " has to be a positive number.";
+      return false;
+    }
+    *limit = static_cast<LimitType>(value);
+    return true;
+  } catch (std::exception &ex) {
+    cerr << "--" << name << " is not a valid positive number.";
+    return false;
+  }
+}
+
 int main(int argc, char *argv[]) {
   if (argc > 0) {
     // Skips first argument.
@@ -122,9 +241,58 @@ int main(int argc, char *argv[]) {
   }
 
   string pipe_name = string(options[PIPENAME].arg);
+
+  std::unique_ptr<MetricsFileExporter> metrics_exporter;
+  if (options[METRICSFILE].count() && options[METRICSFILE].arg) {
+    metrics_exporter = std::unique_ptr<MetricsFileExporter>(
+        new MetricsFileExporter(string(options[METRICSFILE].arg)));
+  }
+
+  CaptureProfile capture_profile;
+  if (!ParseCaptureLimit(options[MAXSTACKFRAMES], kMaxStackFramesOption,
+                         &capture_profile.max_stack_frames) ||
+      !ParseCaptureLimit(options[MAXSTACKFRAMESWITHVARIABLES],
+                         kMaxStackFramesWithVariablesOption,
+                         &capture_profile.max_stack_frames_with_variables) ||
+      !ParseCaptureLimit(options[MAXOBJECTDEPTH], kMaxObjectDepthOption,
+                         &capture_profile.max_object_depth) ||
+      !ParseCaptureLimit(options[MAXCOLLECTIONSIZE], kMaxCollectionSizeOption,
+                         &capture_profile.max_collection_size) ||
+      !ParseCaptureLimit(options[MAXEXPRESSIONCOLLECTIONSIZE],
+                         kMaxExpressionCollectionSizeOption,
+                         &capture_profile.max_expression_collection_size) ||
+      !ParseCaptureLimit(options[MAXSTRINGLENGTH], kMaxStringLengthOption,
+                         &capture_profile.max_string_length) ||
+      !ParseCaptureLimit(options[MAXBREAKPOINTSIZE], kMaxBreakpointSizeOption,
+                         &capture_profile.max_breakpoint_size) ||
+      !ParseCaptureLimit(options[STACKDEDUPWINDOW], kStackDedupWindowOption,
+                         &capture_profile.stack_dedup_window_ms)) {
+    return -1;
+  }
+  capture_profile.stack_only = options[STACKONLY].count() > 0;
+  CaptureProfile::SetDefault(capture_profile);
+
   Debugger debugger(pipe_name);
   HRESULT hr;
 
+  if (options[PROFILEFILE].count() && options[PROFILEFILE].arg) {
+    std::uint32_t profile_interval_ms = 0;
+    if (!ParseCaptureLimit(options[PROFILEINTERVAL], kProfileIntervalOption,
+                           &profile_interval_ms)) {
+      return -1;
+    }
+
+    if (profile_interval_ms == 0) {
+      cerr << "--" << kProfileFileOption << " needs --"
+           << kProfileIntervalOption << ".";
+      return -1;
+    }
+
+    debugger.EnableSamplingProfiler(
+        std::chrono::milliseconds(profile_interval_ms),
+        string(options[PROFILEFILE].arg));
+  }
+
   if (options[APPLICATIONSTARTCOMMAND].count()) {
     string command_line = string(options[APPLICATIONSTARTCOMMAND].arg);
     std::vector<WCHAR> wchar_command_line =
@@ -76,6 +76,15 @@ const ::google::protobuf::uint32 TableStruct::offsets[] = {
   GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(Breakpoint, condition_),
   GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(Breakpoint, evaluated_expressions_),
   GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(Breakpoint, status_),
+  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(Breakpoint, max_stack_frames_),
+  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(Breakpoint, max_stack_frames_with_variables_),
+  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(Breakpoint, max_object_depth_),
+  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(Breakpoint, max_collection_size_),
+  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(Breakpoint, max_breakpoint_size_),
+  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(Breakpoint, stack_only_),
+  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(Breakpoint, hit_count_),
+  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(Breakpoint, stack_fingerprint_),
+  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(Breakpoint, max_expression_collection_size_),
   ~0u,  // no _has_bits_
   GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(StackFrame, _internal_metadata_),
   ~0u,  // no _extensions_
@@ -102,6 +111,8 @@ const ::google::protobuf::uint32 TableStruct::offsets[] = {
   GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(Variable, value_),
   GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(Variable, members_),
   GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(Variable, status_),
+  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(Variable, object_id_),
+  GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(Variable, is_reference_),
   ~0u,  // no _has_bits_
   GOOGLE_PROTOBUF_GENERATED_MESSAGE_FIELD_OFFSET(Status, _internal_metadata_),
   ~0u,  // no _extensions_
@@ -113,10 +124,10 @@ const ::google::protobuf::uint32 TableStruct::offsets[] = {
 
 static const ::google::protobuf::internal::MigrationSchema schemas[] = {
   { 0, -1, sizeof(Breakpoint)},
-  { 16, -1, sizeof(StackFrame)},
-  { 25, -1, sizeof(SourceLocation)},
-  { 32, -1, sizeof(Variable)},
-  { 42, -1, sizeof(Status)},
+  { 25, -1, sizeof(StackFrame)},
+  { 34, -1, sizeof(SourceLocation)},
+  { 41, -1, sizeof(Variable)},
+  { 53, -1, sizeof(Status)},
 };
 
 static ::google::protobuf::Message const * const file_default_instances[] = {
@@ -197,7 +208,7 @@ void AddDescriptorsImpl() {
   static const char descriptor[] = {
       "\n\020breakpoint.proto\022\036google.cloud.diagnos"
       "tics.debug\032\037google/protobuf/timestamp.pr"
-      "oto\"\316\003\n\nBreakpoint\022\n\n\002id\030\001 \001(\t\022@\n\010locati"
+      "oto\"\317\005\n\nBreakpoint\022\n\n\002id\030\001 \001(\t\022@\n\010locati"
       "on\030\002 \001(\0132..google.cloud.diagnostics.debu"
       "g.SourceLocation\022@\n\014stack_frames\030\003 \003(\0132*"
       ".google.cloud.diagnostics.debug.StackFra"
@@ -208,22 +219,30 @@ void AddDescriptorsImpl() {
       "\022\021\n\tcondition\030\t \001(\t\022G\n\025evaluated_express"
       "ions\030\n \003(\0132(.google.cloud.diagnostics.de"
       "bug.Variable\0226\n\006status\030\013 \001(\0132&.google.cl"
-      "oud.diagnostics.debug.Status\"\332\001\n\nStackFr"
-      "ame\022\023\n\013method_name\030\001 \001(\t\022@\n\010location\030\002 \001"
-      "(\0132..google.cloud.diagnostics.debug.Sour"
-      "ceLocation\022;\n\targuments\030\003 \003(\0132(.google.c"
-      "loud.diagnostics.debug.Variable\0228\n\006local"
-      "s\030\004 \003(\0132(.google.cloud.diagnostics.debug"
-      ".Variable\",\n\016SourceLocation\022\014\n\004path\030\001 \001("
-      "\t\022\014\n\004line\030\002 \001(\005\"\250\001\n\010Variable\022\014\n\004name\030\001 \001"
-      "(\t\022\014\n\004type\030\002 \001(\t\022\r\n\005value\030\003 \001(\t\0229\n\007membe"
-      "rs\030\004 \003(\0132(.google.cloud.diagnostics.debu"
-      "g.Variable\0226\n\006status\030\005 \001(\0132&.google.clou"
-      "d.diagnostics.debug.Status\"*\n\006Status\022\017\n\007"
-      "iserror\030\001 \001(\010\022\017\n\007message\030\002 \001(\tb\006proto3"
+      "oud.diagnostics.debug.Status\022\030\n\020max_stac"
+      "k_frames\030\014 \001(\005\022\'\n\037max_stack_frames_with_"
+      "variables\030\r \001(\005\022\030\n\020max_object_depth\030\016 \001("
+      "\005\022\033\n\023max_collection_size\030\017 \001(\005\022\033\n\023max_br"
+      "eakpoint_size\030\020 \001(\005\022\022\n\nstack_only\030\021 \001(\010\022"
+      "\021\n\thit_count\030\022 \001(\005\022\031\n\021stack_fingerprint\030"
+      "\023 \001(\004\022&\n\036max_expression_collection_size\030\024 \001"
+      "(\005\"\332\001\n\nStackFrame\022\023\n\013method_name\030\001 \001("
+      "\t\022@\n\010location\030\002 \001(\0132..google.cloud.diagn"
+      "ostics.debug.SourceLocation\022;\n\targuments"
+      "\030\003 \003(\0132(.google.cloud.diagnostics.debug."
+      "Variable\0228\n\006locals\030\004 \003(\0132(.google.cloud."
+      "diagnostics.debug.Variable\",\n\016SourceLoca"
+      "tion\022\014\n\004path\030\001 \001(\t\022\014\n\004line\030\002 \001(\005\"\321\001\n\010Var"
+      "iable\022\014\n\004name\030\001 \001(\t\022\014\n\004type\030\002 \001(\t\022\r\n\005val"
+      "ue\030\003 \001(\t\0229\n\007members\030\004 \003(\0132(.google.cloud"
+      ".diagnostics.debug.Variable\0226\n\006status\030\005 "
+      "\001(\0132&.google.cloud.diagnostics.debug.Sta"
+      "tus\022\021\n\tobject_id\030\006 \001(\005\022\024\n\014is_reference\030\007"
+      " \001(\010\"*\n\006Status\022\017\n\007iserror\030\001 \001(\010\022\017\n\007messa"
+      "ge\030\002 \001(\tb\006proto3"
   };
   ::google::protobuf::DescriptorPool::InternalAddGeneratedFile(
-      descriptor, 1038);
+      descriptor, 1336);
   ::google::protobuf::MessageFactory::InternalRegisterGeneratedFile(
     "breakpoint.proto", &protobuf_RegisterTypes);
   ::google::protobuf::protobuf_google_2fprotobuf_2ftimestamp_2eproto::AddDescriptors();
@@ -259,6 +278,15 @@ const int Breakpoint::kExpressionsFieldNumber;
 const int Breakpoint::kConditionFieldNumber;
 const int Breakpoint::kEvaluatedExpressionsFieldNumber;
 const int Breakpoint::kStatusFieldNumber;
+const int Breakpoint::kMaxStackFramesFieldNumber;
+const int Breakpoint::kMaxStackFramesWithVariablesFieldNumber;
+const int Breakpoint::kMaxObjectDepthFieldNumber;
+const int Breakpoint::kMaxCollectionSizeFieldNumber;
+const int Breakpoint::kMaxBreakpointSizeFieldNumber;
+const int Breakpoint::kStackOnlyFieldNumber;
+const int Breakpoint::kHitCountFieldNumber;
+const int Breakpoint::kStackFingerprintFieldNumber;
+const int Breakpoint::kMaxExpressionCollectionSizeFieldNumber;
 #endif  // !defined(_MSC_VER) || _MSC_VER >= 1900
 
 Breakpoint::Breakpoint()
@@ -305,9 +333,9 @@ Breakpoint::Breakpoint(const Breakpoint& from)
   } else {
     status_ = NULL;
   }
-  ::memcpy(&activated_, &from.activated_,
-    static_cast<size_t>(reinterpret_cast<char*>(&kill_server_) -
-    reinterpret_cast<char*>(&activated_)) + sizeof(kill_server_));
+  ::memcpy(&stack_fingerprint_, &from.stack_fingerprint_,
+    static_cast<size_t>(reinterpret_cast<char*>(&stack_only_) -
+    reinterpret_cast<char*>(&stack_fingerprint_)) + sizeof(stack_only_));
   // @@protoc_insertion_point(copy_constructor:google.cloud.diagnostics.debug.Breakpoint)
 }
 
@@ -315,8 +343,8 @@ void Breakpoint::SharedCtor() {
   id_.UnsafeSetDefault(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
   condition_.UnsafeSetDefault(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
   ::memset(&location_, 0, static_cast<size_t>(
-      reinterpret_cast<char*>(&kill_server_) -
-      reinterpret_cast<char*>(&location_)) + sizeof(kill_server_));
+      reinterpret_cast<char*>(&stack_only_) -
+      reinterpret_cast<char*>(&location_)) + sizeof(stack_only_));
   _cached_size_ = 0;
 }
 
@@ -388,9 +416,9 @@ void Breakpoint::Clear() {
     delete status_;
   }
   status_ = NULL;
-  ::memset(&activated_, 0, static_cast<size_t>(
-      reinterpret_cast<char*>(&kill_server_) -
-      reinterpret_cast<char*>(&activated_)) + sizeof(kill_server_));
+  ::memset(&stack_fingerprint_, 0, static_cast<size_t>(
+      reinterpret_cast<char*>(&stack_only_) -
+      reinterpret_cast<char*>(&stack_fingerprint_)) + sizeof(stack_only_));
 }
 
 bool Breakpoint::MergePartialFromCodedStream(
@@ -399,7 +427,7 @@ bool Breakpoint::MergePartialFromCodedStream(
   ::google::protobuf::uint32 tag;
   // @@protoc_insertion_point(parse_start:google.cloud.diagnostics.debug.Breakpoint)
   for (;;) {
-    ::std::pair< ::google::protobuf::uint32, bool> p = input->ReadTagWithCutoffNoLastTag(127u);
+    ::std::pair< ::google::protobuf::uint32, bool> p = input->ReadTagWithCutoffNoLastTag(16383u);
     tag = p.first;
     if (!p.second) goto handle_unusual;
     switch (::google::protobuf::internal::WireFormatLite::GetTagFieldNumber(tag)) {
@@ -552,6 +580,132 @@ bool Breakpoint::MergePartialFromCodedStream(
         break;
       }
 
+      // int32 max_stack_frames = 12;
+      case 12: {
+        if (static_cast< ::google::protobuf::uint8>(tag) ==
+            static_cast< ::google::protobuf::uint8>(96u)) {
+
+          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
+                   ::google::protobuf::int32, ::google::protobuf::internal::WireFormatLite::TYPE_INT32>(
+                 input, &max_stack_frames_)));
+        } else {
+          goto handle_unusual;
+        }
+        break;
+      }
+
+      // int32 max_stack_frames_with_variables = 13;
+      case 13: {
+        if (static_cast< ::google::protobuf::uint8>(tag) ==
+            static_cast< ::google::protobuf::uint8>(104u)) {
+
+          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
+                   ::google::protobuf::int32, ::google::protobuf::internal::WireFormatLite::TYPE_INT32>(
+                 input, &max_stack_frames_with_variables_)));
+        } else {
+          goto handle_unusual;
+        }
+        break;
+      }
+
+      // int32 max_object_depth = 14;
+      case 14: {
+        if (static_cast< ::google::protobuf::uint8>(tag) ==
+            static_cast< ::google::protobuf::uint8>(112u)) {
+
+          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
+                   ::google::protobuf::int32, ::google::protobuf::internal::WireFormatLite::TYPE_INT32>(
+                 input, &max_object_depth_)));
+        } else {
+          goto handle_unusual;
+        }
+        break;
+      }
+
+      // int32 max_collection_size = 15;
+      case 15: {
+        if (static_cast< ::google::protobuf::uint8>(tag) ==
+            static_cast< ::google::protobuf::uint8>(120u)) {
+
+          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
+                   ::google::protobuf::int32, ::google::protobuf::internal::WireFormatLite::TYPE_INT32>(
+                 input, &max_collection_size_)));
+        } else {
+          goto handle_unusual;
+        }
+        break;
+      }
+
+      // int32 max_breakpoint_size = 16;
+      case 16: {
+        if (static_cast< ::google::protobuf::uint8>(tag) ==
+            static_cast< ::google::protobuf::uint8>(128u)) {
+
+          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
+                   ::google::protobuf::int32, ::google::protobuf::internal::WireFormatLite::TYPE_INT32>(
+                 input, &max_breakpoint_size_)));
+        } else {
+          goto handle_unusual;
+        }
+        break;
+      }
+
+      // bool stack_only = 17;
+      case 17: {
+        if (static_cast< ::google::protobuf::uint8>(tag) ==
+            static_cast< ::google::protobuf::uint8>(136u)) {
+
+          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
+                   bool, ::google::protobuf::internal::WireFormatLite::TYPE_BOOL>(
+                 input, &stack_only_)));
+        } else {
+          goto handle_unusual;
+        }
+        break;
+      }
+
+      // int32 hit_count = 18;
+      case 18: {
+        if (static_cast< ::google::protobuf::uint8>(tag) ==
+            static_cast< ::google::protobuf::uint8>(144u)) {
+
+          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
+                   ::google::protobuf::int32, ::google::protobuf::internal::WireFormatLite::TYPE_INT32>(
+                 input, &hit_count_)));
+        } else {
+          goto handle_unusual;
+        }
+        break;
+      }
+
+      // uint64 stack_fingerprint = 19;
+      case 19: {
+        if (static_cast< ::google::protobuf::uint8>(tag) ==
+            static_cast< ::google::protobuf::uint8>(152u)) {
+
+          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
+                   ::google::protobuf::uint64, ::google::protobuf::internal::WireFormatLite::TYPE_UINT64>(
+                 input, &stack_fingerprint_)));
+        } else {
+          goto handle_unusual;
+        }
+        break;
+      }
+
+      // int32 max_expression_collection_size = 20;
+      case 20: {
+        if (static_cast< ::google::protobuf::uint8>(tag) ==
+            static_cast< ::google::protobuf::uint8>(160u)) {
+
+          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
+                   ::google::protobuf::int32, ::google::protobuf::internal::WireFormatLite::TYPE_INT32>(
+                 input, &max_expression_collection_size_)));
+        } else {
+          goto handle_unusual;
+        }
+        break;
+      }
+
       default: {
       handle_unusual:
         if (tag == 0 ||
@@ -657,6 +811,51 @@ void Breakpoint::SerializeWithCachedSizes(
       11, *this->status_, output);
   }
 
+  // int32 max_stack_frames = 12;
+  if (this->max_stack_frames() != 0) {
+    ::google::protobuf::internal::WireFormatLite::WriteInt32(12, this->max_stack_frames(), output);
+  }
+
+  // int32 max_stack_frames_with_variables = 13;
+  if (this->max_stack_frames_with_variables() != 0) {
+    ::google::protobuf::internal::WireFormatLite::WriteInt32(13, this->max_stack_frames_with_variables(), output);
+  }
+
+  // int32 max_object_depth = 14;
+  if (this->max_object_depth() != 0) {
+    ::google::protobuf::internal::WireFormatLite::WriteInt32(14, this->max_object_depth(), output);
+  }
+
+  // int32 max_collection_size = 15;
+  if (this->max_collection_size() != 0) {
+    ::google::protobuf::internal::WireFormatLite::WriteInt32(15, this->max_collection_size(), output);
+  }
+
+  // int32 max_breakpoint_size = 16;
+  if (this->max_breakpoint_size() != 0) {
+    ::google::protobuf::internal::WireFormatLite::WriteInt32(16, this->max_breakpoint_size(), output);
+  }
+
+  // bool stack_only = 17;
+  if (this->stack_only() != 0) {
+    ::google::protobuf::internal::WireFormatLite::WriteBool(17, this->stack_only(), output);
+  }
+
+  // int32 hit_count = 18;
+  if (this->hit_count() != 0) {
+    ::google::protobuf::internal::WireFormatLite::WriteInt32(18, this->hit_count(), output);
+  }
+
+  // uint64 stack_fingerprint = 19;
+  if (this->stack_fingerprint() != 0) {
+    ::google::protobuf::internal::WireFormatLite::WriteUInt64(19, this->stack_fingerprint(), output);
+  }
+
+  // int32 max_expression_collection_size = 20;
+  if (this->max_expression_collection_size() != 0) {
+    ::google::protobuf::internal::WireFormatLite::WriteInt32(20, this->max_expression_collection_size(), output);
+  }
+
   // @@protoc_insertion_point(serialize_end:google.cloud.diagnostics.debug.Breakpoint)
 }
 
@@ -753,6 +952,51 @@ void Breakpoint::SerializeWithCachedSizes(
         11, *this->status_, deterministic, target);
   }
 
+  // int32 max_stack_frames = 12;
+  if (this->max_stack_frames() != 0) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteInt32ToArray(12, this->max_stack_frames(), target);
+  }
+
+  // int32 max_stack_frames_with_variables = 13;
+  if (this->max_stack_frames_with_variables() != 0) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteInt32ToArray(13, this->max_stack_frames_with_variables(), target);
+  }
+
+  // int32 max_object_depth = 14;
+  if (this->max_object_depth() != 0) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteInt32ToArray(14, this->max_object_depth(), target);
+  }
+
+  // int32 max_collection_size = 15;
+  if (this->max_collection_size() != 0) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteInt32ToArray(15, this->max_collection_size(), target);
+  }
+
+  // int32 max_breakpoint_size = 16;
+  if (this->max_breakpoint_size() != 0) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteInt32ToArray(16, this->max_breakpoint_size(), target);
+  }
+
+  // bool stack_only = 17;
+  if (this->stack_only() != 0) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteBoolToArray(17, this->stack_only(), target);
+  }
+
+  // int32 hit_count = 18;
+  if (this->hit_count() != 0) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteInt32ToArray(18, this->hit_count(), target);
+  }
+
+  // uint64 stack_fingerprint = 19;
+  if (this->stack_fingerprint() != 0) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteUInt64ToArray(19, this->stack_fingerprint(), target);
+  }
+
+  // int32 max_expression_collection_size = 20;
+  if (this->max_expression_collection_size() != 0) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteInt32ToArray(20, this->max_expression_collection_size(), target);
+  }
+
   // @@protoc_insertion_point(serialize_to_array_end:google.cloud.diagnostics.debug.Breakpoint)
   return target;
 }
@@ -833,6 +1077,62 @@ size_t Breakpoint::ByteSizeLong() const {
         *this->status_);
   }
 
+  // uint64 stack_fingerprint = 19;
+  if (this->stack_fingerprint() != 0) {
+    total_size += 2 +
+      ::google::protobuf::internal::WireFormatLite::UInt64Size(
+        this->stack_fingerprint());
+  }
+
+  // int32 max_stack_frames = 12;
+  if (this->max_stack_frames() != 0) {
+    total_size += 1 +
+      ::google::protobuf::internal::WireFormatLite::Int32Size(
+        this->max_stack_frames());
+  }
+
+  // int32 max_stack_frames_with_variables = 13;
+  if (this->max_stack_frames_with_variables() != 0) {
+    total_size += 1 +
+      ::google::protobuf::internal::WireFormatLite::Int32Size(
+        this->max_stack_frames_with_variables());
+  }
+
+  // int32 max_object_depth = 14;
+  if (this->max_object_depth() != 0) {
+    total_size += 1 +
+      ::google::protobuf::internal::WireFormatLite::Int32Size(
+        this->max_object_depth());
+  }
+
+  // int32 max_collection_size = 15;
+  if (this->max_collection_size() != 0) {
+    total_size += 1 +
+      ::google::protobuf::internal::WireFormatLite::Int32Size(
+        this->max_collection_size());
+  }
+
+  // int32 max_breakpoint_size = 16;
+  if (this->max_breakpoint_size() != 0) {
+    total_size += 2 +
+      ::google::protobuf::internal::WireFormatLite::Int32Size(
+        this->max_breakpoint_size());
+  }
+
+  // int32 hit_count = 18;
+  if (this->hit_count() != 0) {
+    total_size += 2 +
+      ::google::protobuf::internal::WireFormatLite::Int32Size(
+        this->hit_count());
+  }
+
+  // int32 max_expression_collection_size = 20;
+  if (this->max_expression_collection_size() != 0) {
+    total_size += 2 +
+      ::google::protobuf::internal::WireFormatLite::Int32Size(
+        this->max_expression_collection_size());
+  }
+
   // bool activated = 4;
   if (this->activated() != 0) {
     total_size += 1 + 1;
@@ -843,6 +1143,11 @@ size_t Breakpoint::ByteSizeLong() const {
     total_size += 1 + 1;
   }
 
+  // bool stack_only = 17;
+  if (this->stack_only() != 0) {
+    total_size += 2 + 1;
+  }
+
   int cached_size = ::google::protobuf::internal::ToCachedSize(total_size);
   GOOGLE_SAFE_CONCURRENT_WRITES_BEGIN();
   _cached_size_ = cached_size;
@@ -895,12 +1200,39 @@ void Breakpoint::MergeFrom(const Breakpoint& from) {
   if (from.has_status()) {
     mutable_status()->::google::cloud::diagnostics::debug::Status::MergeFrom(from.status());
   }
+  if (from.stack_fingerprint() != 0) {
+    set_stack_fingerprint(from.stack_fingerprint());
+  }
+  if (from.max_stack_frames() != 0) {
+    set_max_stack_frames(from.max_stack_frames());
+  }
+  if (from.max_stack_frames_with_variables() != 0) {
+    set_max_stack_frames_with_variables(from.max_stack_frames_with_variables());
+  }
+  if (from.max_object_depth() != 0) {
+    set_max_object_depth(from.max_object_depth());
+  }
+  if (from.max_collection_size() != 0) {
+    set_max_collection_size(from.max_collection_size());
+  }
+  if (from.max_breakpoint_size() != 0) {
+    set_max_breakpoint_size(from.max_breakpoint_size());
+  }
+  if (from.hit_count() != 0) {
+    set_hit_count(from.hit_count());
+  }
+  if (from.max_expression_collection_size() != 0) {
+    set_max_expression_collection_size(from.max_expression_collection_size());
+  }
   if (from.activated() != 0) {
     set_activated(from.activated());
   }
   if (from.kill_server() != 0) {
     set_kill_server(from.kill_server());
   }
+  if (from.stack_only() != 0) {
+    set_stack_only(from.stack_only());
+  }
 }
 
 void Breakpoint::CopyFrom(const ::google::protobuf::Message& from) {
@@ -935,8 +1267,17 @@ void Breakpoint::InternalSwap(Breakpoint* other) {
   std::swap(create_time_, other->create_time_);
   std::swap(final_time_, other->final_time_);
   std::swap(status_, other->status_);
+  std::swap(stack_fingerprint_, other->stack_fingerprint_);
+  std::swap(max_stack_frames_, other->max_stack_frames_);
+  std::swap(max_stack_frames_with_variables_, other->max_stack_frames_with_variables_);
+  std::swap(max_object_depth_, other->max_object_depth_);
+  std::swap(max_collection_size_, other->max_collection_size_);
+  std::swap(max_breakpoint_size_, other->max_breakpoint_size_);
+  std::swap(hit_count_, other->hit_count_);
+  std::swap(max_expression_collection_size_, other->max_expression_collection_size_);
   std::swap(activated_, other->activated_);
   std::swap(kill_server_, other->kill_server_);
+  std::swap(stack_only_, other->stack_only_);
   std::swap(_cached_size_, other->_cached_size_);
 }
 
@@ -1377,6 +1718,132 @@ void Breakpoint::set_allocated_status(::google::cloud::diagnostics::debug::Statu
   // @@protoc_insertion_point(field_set_allocated:google.cloud.diagnostics.debug.Breakpoint.status)
 }
 
+// int32 max_stack_frames = 12;
+void Breakpoint::clear_max_stack_frames() {
+  max_stack_frames_ = 0;
+}
+::google::protobuf::int32 Breakpoint::max_stack_frames() const {
+  // @@protoc_insertion_point(field_get:google.cloud.diagnostics.debug.Breakpoint.max_stack_frames)
+  return max_stack_frames_;
+}
+void Breakpoint::set_max_stack_frames(::google::protobuf::int32 value) {
+  
+  max_stack_frames_ = value;
+  // @@protoc_insertion_point(field_set:google.cloud.diagnostics.debug.Breakpoint.max_stack_frames)
+}
+
+// int32 max_stack_frames_with_variables = 13;
+void Breakpoint::clear_max_stack_frames_with_variables() {
+  max_stack_frames_with_variables_ = 0;
+}
+::google::protobuf::int32 Breakpoint::max_stack_frames_with_variables() const {
+  // @@protoc_insertion_point(field_get:google.cloud.diagnostics.debug.Breakpoint.max_stack_frames_with_variables)
+  return max_stack_frames_with_variables_;
+}
+void Breakpoint::set_max_stack_frames_with_variables(::google::protobuf::int32 value) {
+  
+  max_stack_frames_with_variables_ = value;
+  // @@protoc_insertion_point(field_set:google.cloud.diagnostics.debug.Breakpoint.max_stack_frames_with_variables)
+}
+
+// int32 max_object_depth = 14;
+void Breakpoint::clear_max_object_depth() {
+  max_object_depth_ = 0;
+}
+::google::protobuf::int32 Breakpoint::max_object_depth() const {
+  // @@protoc_insertion_point(field_get:google.cloud.diagnostics.debug.Breakpoint.max_object_depth)
+  return max_object_depth_;
+}
+void Breakpoint::set_max_object_depth(::google::protobuf::int32 value) {
+  
+  max_object_depth_ = value;
+  // @@protoc_insertion_point(field_set:google.cloud.diagnostics.debug.Breakpoint.max_object_depth)
+}
+
+// int32 max_collection_size = 15;
+void Breakpoint::clear_max_collection_size() {
+  max_collection_size_ = 0;
+}
+::google::protobuf::int32 Breakpoint::max_collection_size() const {
+  // @@protoc_insertion_point(field_get:google.cloud.diagnostics.debug.Breakpoint.max_collection_size)
+  return max_collection_size_;
+}
+void Breakpoint::set_max_collection_size(::google::protobuf::int32 value) {
+  
+  max_collection_size_ = value;
+  // @@protoc_insertion_point(field_set:google.cloud.diagnostics.debug.Breakpoint.max_collection_size)
+}
+
+// int32 max_breakpoint_size = 16;
+void Breakpoint::clear_max_breakpoint_size() {
+  max_breakpoint_size_ = 0;
+}
+::google::protobuf::int32 Breakpoint::max_breakpoint_size() const {
+  // @@protoc_insertion_point(field_get:google.cloud.diagnostics.debug.Breakpoint.max_breakpoint_size)
+  return max_breakpoint_size_;
+}
+void Breakpoint::set_max_breakpoint_size(::google::protobuf::int32 value) {
+  
+  max_breakpoint_size_ = value;
+  // @@protoc_insertion_point(field_set:google.cloud.diagnostics.debug.Breakpoint.max_breakpoint_size)
+}
+
+// bool stack_only = 17;
+void Breakpoint::clear_stack_only() {
+  stack_only_ = false;
+}
+bool Breakpoint::stack_only() const {
+  // @@protoc_insertion_point(field_get:google.cloud.diagnostics.debug.Breakpoint.stack_only)
+  return stack_only_;
+}
+void Breakpoint::set_stack_only(bool value) {
+  
+  stack_only_ = value;
+  // @@protoc_insertion_point(field_set:google.cloud.diagnostics.debug.Breakpoint.stack_only)
+}
+
+// int32 hit_count = 18;
+void Breakpoint::clear_hit_count() {
+  hit_count_ = 0;
+}
+::google::protobuf::int32 Breakpoint::hit_count() const {
+  // @@protoc_insertion_point(field_get:google.cloud.diagnostics.debug.Breakpoint.hit_count)
+  return hit_count_;
+}
+void Breakpoint::set_hit_count(::google::protobuf::int32 value) {
+  
+  hit_count_ = value;
+  // @@protoc_insertion_point(field_set:google.cloud.diagnostics.debug.Breakpoint.hit_count)
+}
+
+// uint64 stack_fingerprint = 19;
+void Breakpoint::clear_stack_fingerprint() {
+  stack_fingerprint_ = GOOGLE_ULONGLONG(0);
+}
+::google::protobuf::uint64 Breakpoint::stack_fingerprint() const {
+  // @@protoc_insertion_point(field_get:google.cloud.diagnostics.debug.Breakpoint.stack_fingerprint)
+  return stack_fingerprint_;
+}
+void Breakpoint::set_stack_fingerprint(::google::protobuf::uint64 value) {
+  
+  stack_fingerprint_ = value;
+  // @@protoc_insertion_point(field_set:google.cloud.diagnostics.debug.Breakpoint.stack_fingerprint)
+}
+
+// int32 max_expression_collection_size = 20;
+void Breakpoint::clear_max_expression_collection_size() {
+  max_expression_collection_size_ = 0;
+}
+::google::protobuf::int32 Breakpoint::max_expression_collection_size() const {
+  // @@protoc_insertion_point(field_get:google.cloud.diagnostics.debug.Breakpoint.max_expression_collection_size)
+  return max_expression_collection_size_;
+}
+void Breakpoint::set_max_expression_collection_size(::google::protobuf::int32 value) {
+  
+  max_expression_collection_size_ = value;
+  // @@protoc_insertion_point(field_set:google.cloud.diagnostics.debug.Breakpoint.max_expression_collection_size)
+}
+
 #endif  // PROTOBUF_INLINE_NOT_IN_HEADERS
 
 // ===================================================================
@@ -2259,6 +2726,8 @@ const int Variable::kTypeFieldNumber;
 const int Variable::kValueFieldNumber;
 const int Variable::kMembersFieldNumber;
 const int Variable::kStatusFieldNumber;
+const int Variable::kObjectIdFieldNumber;
+const int Variable::kIsReferenceFieldNumber;
 #endif  // !defined(_MSC_VER) || _MSC_VER >= 1900
 
 Variable::Variable()
@@ -2292,6 +2761,9 @@ Variable::Variable(const Variable& from)
   } else {
     status_ = NULL;
   }
+  ::memcpy(&object_id_, &from.object_id_,
+    static_cast<size_t>(reinterpret_cast<char*>(&is_reference_) -
+    reinterpret_cast<char*>(&object_id_)) + sizeof(is_reference_));
   // @@protoc_insertion_point(copy_constructor:google.cloud.diagnostics.debug.Variable)
 }
 
@@ -2299,7 +2771,9 @@ void Variable::SharedCtor() {
   name_.UnsafeSetDefault(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
   type_.UnsafeSetDefault(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
   value_.UnsafeSetDefault(&::google::protobuf::internal::GetEmptyStringAlreadyInited());
-  status_ = NULL;
+  ::memset(&status_, 0, static_cast<size_t>(
+      reinterpret_cast<char*>(&is_reference_) -
+      reinterpret_cast<char*>(&status_)) + sizeof(is_reference_));
   _cached_size_ = 0;
 }
 
@@ -2350,6 +2824,9 @@ void Variable::Clear() {
     delete status_;
   }
   status_ = NULL;
+  ::memset(&object_id_, 0, static_cast<size_t>(
+      reinterpret_cast<char*>(&is_reference_) -
+      reinterpret_cast<char*>(&object_id_)) + sizeof(is_reference_));
 }
 
 bool Variable::MergePartialFromCodedStream(
@@ -2434,6 +2911,34 @@ bool Variable::MergePartialFromCodedStream(
         break;
       }
 
+      // int32 object_id = 6;
+      case 6: {
+        if (static_cast< ::google::protobuf::uint8>(tag) ==
+            static_cast< ::google::protobuf::uint8>(48u)) {
+
+          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
+                   ::google::protobuf::int32, ::google::protobuf::internal::WireFormatLite::TYPE_INT32>(
+                 input, &object_id_)));
+        } else {
+          goto handle_unusual;
+        }
+        break;
+      }
+
+      // bool is_reference = 7;
+      case 7: {
+        if (static_cast< ::google::protobuf::uint8>(tag) ==
+            static_cast< ::google::protobuf::uint8>(56u)) {
+
+          DO_((::google::protobuf::internal::WireFormatLite::ReadPrimitive<
+                   bool, ::google::protobuf::internal::WireFormatLite::TYPE_BOOL>(
+                 input, &is_reference_)));
+        } else {
+          goto handle_unusual;
+        }
+        break;
+      }
+
       default: {
       handle_unusual:
         if (tag == 0 ||
@@ -2504,6 +3009,16 @@ void Variable::SerializeWithCachedSizes(
       5, *this->status_, output);
   }
 
+  // int32 object_id = 6;
+  if (this->object_id() != 0) {
+    ::google::protobuf::internal::WireFormatLite::WriteInt32(6, this->object_id(), output);
+  }
+
+  // bool is_reference = 7;
+  if (this->is_reference() != 0) {
+    ::google::protobuf::internal::WireFormatLite::WriteBool(7, this->is_reference(), output);
+  }
+
   // @@protoc_insertion_point(serialize_end:google.cloud.diagnostics.debug.Variable)
 }
 
@@ -2562,6 +3077,16 @@ void Variable::SerializeWithCachedSizes(
         5, *this->status_, deterministic, target);
   }
 
+  // int32 object_id = 6;
+  if (this->object_id() != 0) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteInt32ToArray(6, this->object_id(), target);
+  }
+
+  // bool is_reference = 7;
+  if (this->is_reference() != 0) {
+    target = ::google::protobuf::internal::WireFormatLite::WriteBoolToArray(7, this->is_reference(), target);
+  }
+
   // @@protoc_insertion_point(serialize_to_array_end:google.cloud.diagnostics.debug.Variable)
   return target;
 }
@@ -2609,6 +3134,18 @@ size_t Variable::ByteSizeLong() const {
         *this->status_);
   }
 
+  // int32 object_id = 6;
+  if (this->object_id() != 0) {
+    total_size += 1 +
+      ::google::protobuf::internal::WireFormatLite::Int32Size(
+        this->object_id());
+  }
+
+  // bool is_reference = 7;
+  if (this->is_reference() != 0) {
+    total_size += 1 + 1;
+  }
+
   int cached_size = ::google::protobuf::internal::ToCachedSize(total_size);
   GOOGLE_SAFE_CONCURRENT_WRITES_BEGIN();
   _cached_size_ = cached_size;
@@ -2654,6 +3191,12 @@ void Variable::MergeFrom(const Variable& from) {
   if (from.has_status()) {
     mutable_status()->::google::cloud::diagnostics::debug::Status::MergeFrom(from.status());
   }
+  if (from.object_id() != 0) {
+    set_object_id(from.object_id());
+  }
+  if (from.is_reference() != 0) {
+    set_is_reference(from.is_reference());
+  }
 }
 
 void Variable::CopyFrom(const ::google::protobuf::Message& from) {
@@ -2684,6 +3227,8 @@ void Variable::InternalSwap(Variable* other) {
   type_.Swap(&other->type_);
   value_.Swap(&other->value_);
   std::swap(status_, other->status_);
+  std::swap(object_id_, other->object_id_);
+  std::swap(is_reference_, other->is_reference_);
   std::swap(_cached_size_, other->_cached_size_);
 }
 
@@ -2923,6 +3468,34 @@ void Variable::set_allocated_status(::google::cloud::diagnostics::debug::Status*
   // @@protoc_insertion_point(field_set_allocated:google.cloud.diagnostics.debug.Variable.status)
 }
 
+// int32 object_id = 6;
+void Variable::clear_object_id() {
+  object_id_ = 0;
+}
+::google::protobuf::int32 Variable::object_id() const {
+  // @@protoc_insertion_point(field_get:google.cloud.diagnostics.debug.Variable.object_id)
+  return object_id_;
+}
+void Variable::set_object_id(::google::protobuf::int32 value) {
+  
+  object_id_ = value;
+  // @@protoc_insertion_point(field_set:google.cloud.diagnostics.debug.Variable.object_id)
+}
+
+// bool is_reference = 7;
+void Variable::clear_is_reference() {
+  is_reference_ = false;
+}
+bool Variable::is_reference() const {
+  // @@protoc_insertion_point(field_get:google.cloud.diagnostics.debug.Variable.is_reference)
+  return is_reference_;
+}
+void Variable::set_is_reference(bool value) {
+  
+  is_reference_ = value;
+  // @@protoc_insertion_point(field_set:google.cloud.diagnostics.debug.Variable.is_reference)
+}
+
 #endif  // PROTOBUF_INLINE_NOT_IN_HEADERS
 
 // ===================================================================
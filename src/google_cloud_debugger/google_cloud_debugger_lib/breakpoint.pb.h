@@ -250,6 +250,54 @@ class Breakpoint : public ::google::protobuf::Message /* @@protoc_insertion_poin
   ::google::cloud::diagnostics::debug::Status* release_status();
   void set_allocated_status(::google::cloud::diagnostics::debug::Status* status);
 
+  // uint64 stack_fingerprint = 19;
+  void clear_stack_fingerprint();
+  static const int kStackFingerprintFieldNumber = 19;
+  ::google::protobuf::uint64 stack_fingerprint() const;
+  void set_stack_fingerprint(::google::protobuf::uint64 value);
+
+  // int32 max_stack_frames = 12;
+  void clear_max_stack_frames();
+  static const int kMaxStackFramesFieldNumber = 12;
+  ::google::protobuf::int32 max_stack_frames() const;
+  void set_max_stack_frames(::google::protobuf::int32 value);
+
+  // int32 max_stack_frames_with_variables = 13;
+  void clear_max_stack_frames_with_variables();
+  static const int kMaxStackFramesWithVariablesFieldNumber = 13;
+  ::google::protobuf::int32 max_stack_frames_with_variables() const;
+  void set_max_stack_frames_with_variables(::google::protobuf::int32 value);
+
+  // int32 max_object_depth = 14;
+  void clear_max_object_depth();
+  static const int kMaxObjectDepthFieldNumber = 14;
+  ::google::protobuf::int32 max_object_depth() const;
+  void set_max_object_depth(::google::protobuf::int32 value);
+
+  // int32 max_collection_size = 15;
+  void clear_max_collection_size();
+  static const int kMaxCollectionSizeFieldNumber = 15;
+  ::google::protobuf::int32 max_collection_size() const;
+  void set_max_collection_size(::google::protobuf::int32 value);
+
+  // int32 max_breakpoint_size = 16;
+  void clear_max_breakpoint_size();
+  static const int kMaxBreakpointSizeFieldNumber = 16;
+  ::google::protobuf::int32 max_breakpoint_size() const;
+  void set_max_breakpoint_size(::google::protobuf::int32 value);
+
+  // int32 hit_count = 18;
+  void clear_hit_count();
+  static const int kHitCountFieldNumber = 18;
+  ::google::protobuf::int32 hit_count() const;
+  void set_hit_count(::google::protobuf::int32 value);
+
+  // int32 max_expression_collection_size = 20;
+  void clear_max_expression_collection_size();
+  static const int kMaxExpressionCollectionSizeFieldNumber = 20;
+  ::google::protobuf::int32 max_expression_collection_size() const;
+  void set_max_expression_collection_size(::google::protobuf::int32 value);
+
   // bool activated = 4;
   void clear_activated();
   static const int kActivatedFieldNumber = 4;
@@ -262,6 +310,12 @@ class Breakpoint : public ::google::protobuf::Message /* @@protoc_insertion_poin
   bool kill_server() const;
   void set_kill_server(bool value);
 
+  // bool stack_only = 17;
+  void clear_stack_only();
+  static const int kStackOnlyFieldNumber = 17;
+  bool stack_only() const;
+  void set_stack_only(bool value);
+
   // @@protoc_insertion_point(class_scope:google.cloud.diagnostics.debug.Breakpoint)
  private:
 
@@ -275,8 +329,17 @@ class Breakpoint : public ::google::protobuf::Message /* @@protoc_insertion_poin
   ::google::protobuf::Timestamp* create_time_;
   ::google::protobuf::Timestamp* final_time_;
   ::google::cloud::diagnostics::debug::Status* status_;
+  ::google::protobuf::uint64 stack_fingerprint_;
+  ::google::protobuf::int32 max_stack_frames_;
+  ::google::protobuf::int32 max_stack_frames_with_variables_;
+  ::google::protobuf::int32 max_object_depth_;
+  ::google::protobuf::int32 max_collection_size_;
+  ::google::protobuf::int32 max_breakpoint_size_;
+  ::google::protobuf::int32 hit_count_;
+  ::google::protobuf::int32 max_expression_collection_size_;
   bool activated_;
   bool kill_server_;
+  bool stack_only_;
   mutable int _cached_size_;
   friend struct protobuf_breakpoint_2eproto::TableStruct;
 };
@@ -628,6 +691,18 @@ class Variable : public ::google::protobuf::Message /* @@protoc_insertion_point(
   ::google::cloud::diagnostics::debug::Status* release_status();
   void set_allocated_status(::google::cloud::diagnostics::debug::Status* status);
 
+  // int32 object_id = 6;
+  void clear_object_id();
+  static const int kObjectIdFieldNumber = 6;
+  ::google::protobuf::int32 object_id() const;
+  void set_object_id(::google::protobuf::int32 value);
+
+  // bool is_reference = 7;
+  void clear_is_reference();
+  static const int kIsReferenceFieldNumber = 7;
+  bool is_reference() const;
+  void set_is_reference(bool value);
+
   // @@protoc_insertion_point(class_scope:google.cloud.diagnostics.debug.Variable)
  private:
 
@@ -637,6 +712,8 @@ class Variable : public ::google::protobuf::Message /* @@protoc_insertion_point(
   ::google::protobuf::internal::ArenaStringPtr type_;
   ::google::protobuf::internal::ArenaStringPtr value_;
   ::google::cloud::diagnostics::debug::Status* status_;
+  ::google::protobuf::int32 object_id_;
+  bool is_reference_;
   mutable int _cached_size_;
   friend struct protobuf_breakpoint_2eproto::TableStruct;
 };
@@ -1172,6 +1249,132 @@ inline void Breakpoint::set_allocated_status(::google::cloud::diagnostics::debug
   // @@protoc_insertion_point(field_set_allocated:google.cloud.diagnostics.debug.Breakpoint.status)
 }
 
+// int32 max_stack_frames = 12;
+inline void Breakpoint::clear_max_stack_frames() {
+  max_stack_frames_ = 0;
+}
+inline ::google::protobuf::int32 Breakpoint::max_stack_frames() const {
+  // @@protoc_insertion_point(field_get:google.cloud.diagnostics.debug.Breakpoint.max_stack_frames)
+  return max_stack_frames_;
+}
+inline void Breakpoint::set_max_stack_frames(::google::protobuf::int32 value) {
+  
+  max_stack_frames_ = value;
+  // @@protoc_insertion_point(field_set:google.cloud.diagnostics.debug.Breakpoint.max_stack_frames)
+}
+
+// int32 max_stack_frames_with_variables = 13;
+inline void Breakpoint::clear_max_stack_frames_with_variables() {
+  max_stack_frames_with_variables_ = 0;
+}
+inline ::google::protobuf::int32 Breakpoint::max_stack_frames_with_variables() const {
+  // @@protoc_insertion_point(field_get:google.cloud.diagnostics.debug.Breakpoint.max_stack_frames_with_variables)
+  return max_stack_frames_with_variables_;
+}
+inline void Breakpoint::set_max_stack_frames_with_variables(::google::protobuf::int32 value) {
+  
+  max_stack_frames_with_variables_ = value;
+  // @@protoc_insertion_point(field_set:google.cloud.diagnostics.debug.Breakpoint.max_stack_frames_with_variables)
+}
+
+// int32 max_object_depth = 14;
+inline void Breakpoint::clear_max_object_depth() {
+  max_object_depth_ = 0;
+}
+inline ::google::protobuf::int32 Breakpoint::max_object_depth() const {
+  // @@protoc_insertion_point(field_get:google.cloud.diagnostics.debug.Breakpoint.max_object_depth)
+  return max_object_depth_;
+}
+inline void Breakpoint::set_max_object_depth(::google::protobuf::int32 value) {
+  
+  max_object_depth_ = value;
+  // @@protoc_insertion_point(field_set:google.cloud.diagnostics.debug.Breakpoint.max_object_depth)
+}
+
+// int32 max_collection_size = 15;
+inline void Breakpoint::clear_max_collection_size() {
+  max_collection_size_ = 0;
+}
+inline ::google::protobuf::int32 Breakpoint::max_collection_size() const {
+  // @@protoc_insertion_point(field_get:google.cloud.diagnostics.debug.Breakpoint.max_collection_size)
+  return max_collection_size_;
+}
+inline void Breakpoint::set_max_collection_size(::google::protobuf::int32 value) {
+  
+  max_collection_size_ = value;
+  // @@protoc_insertion_point(field_set:google.cloud.diagnostics.debug.Breakpoint.max_collection_size)
+}
+
+// int32 max_breakpoint_size = 16;
+inline void Breakpoint::clear_max_breakpoint_size() {
+  max_breakpoint_size_ = 0;
+}
+inline ::google::protobuf::int32 Breakpoint::max_breakpoint_size() const {
+  // @@protoc_insertion_point(field_get:google.cloud.diagnostics.debug.Breakpoint.max_breakpoint_size)
+  return max_breakpoint_size_;
+}
+inline void Breakpoint::set_max_breakpoint_size(::google::protobuf::int32 value) {
+  
+  max_breakpoint_size_ = value;
+  // @@protoc_insertion_point(field_set:google.cloud.diagnostics.debug.Breakpoint.max_breakpoint_size)
+}
+
+// bool stack_only = 17;
+inline void Breakpoint::clear_stack_only() {
+  stack_only_ = false;
+}
+inline bool Breakpoint::stack_only() const {
+  // @@protoc_insertion_point(field_get:google.cloud.diagnostics.debug.Breakpoint.stack_only)
+  return stack_only_;
+}
+inline void Breakpoint::set_stack_only(bool value) {
+  
+  stack_only_ = value;
+  // @@protoc_insertion_point(field_set:google.cloud.diagnostics.debug.Breakpoint.stack_only)
+}
+
+// int32 hit_count = 18;
+inline void Breakpoint::clear_hit_count() {
+  hit_count_ = 0;
+}
+inline ::google::protobuf::int32 Breakpoint::hit_count() const {
+  // @@protoc_insertion_point(field_get:google.cloud.diagnostics.debug.Breakpoint.hit_count)
+  return hit_count_;
+}
+inline void Breakpoint::set_hit_count(::google::protobuf::int32 value) {
+  
+  hit_count_ = value;
+  // @@protoc_insertion_point(field_set:google.cloud.diagnostics.debug.Breakpoint.hit_count)
+}
+
+// uint64 stack_fingerprint = 19;
+inline void Breakpoint::clear_stack_fingerprint() {
+  stack_fingerprint_ = GOOGLE_ULONGLONG(0);
+}
+inline ::google::protobuf::uint64 Breakpoint::stack_fingerprint() const {
+  // @@protoc_insertion_point(field_get:google.cloud.diagnostics.debug.Breakpoint.stack_fingerprint)
+  return stack_fingerprint_;
+}
+inline void Breakpoint::set_stack_fingerprint(::google::protobuf::uint64 value) {
+  
+  stack_fingerprint_ = value;
+  // @@protoc_insertion_point(field_set:google.cloud.diagnostics.debug.Breakpoint.stack_fingerprint)
+}
+
+// int32 max_expression_collection_size = 20;
+inline void Breakpoint::clear_max_expression_collection_size() {
+  max_expression_collection_size_ = 0;
+}
+inline ::google::protobuf::int32 Breakpoint::max_expression_collection_size() const {
+  // @@protoc_insertion_point(field_get:google.cloud.diagnostics.debug.Breakpoint.max_expression_collection_size)
+  return max_expression_collection_size_;
+}
+inline void Breakpoint::set_max_expression_collection_size(::google::protobuf::int32 value) {
+  
+  max_expression_collection_size_ = value;
+  // @@protoc_insertion_point(field_set:google.cloud.diagnostics.debug.Breakpoint.max_expression_collection_size)
+}
+
 // -------------------------------------------------------------------
 
 // StackFrame
@@ -1631,6 +1834,34 @@ inline void Variable::set_allocated_status(::google::cloud::diagnostics::debug::
   // @@protoc_insertion_point(field_set_allocated:google.cloud.diagnostics.debug.Variable.status)
 }
 
+// int32 object_id = 6;
+inline void Variable::clear_object_id() {
+  object_id_ = 0;
+}
+inline ::google::protobuf::int32 Variable::object_id() const {
+  // @@protoc_insertion_point(field_get:google.cloud.diagnostics.debug.Variable.object_id)
+  return object_id_;
+}
+inline void Variable::set_object_id(::google::protobuf::int32 value) {
+  
+  object_id_ = value;
+  // @@protoc_insertion_point(field_set:google.cloud.diagnostics.debug.Variable.object_id)
+}
+
+// bool is_reference = 7;
+inline void Variable::clear_is_reference() {
+  is_reference_ = false;
+}
+inline bool Variable::is_reference() const {
+  // @@protoc_insertion_point(field_get:google.cloud.diagnostics.debug.Variable.is_reference)
+  return is_reference_;
+}
+inline void Variable::set_is_reference(bool value) {
+  
+  is_reference_ = value;
+  // @@protoc_insertion_point(field_set:google.cloud.diagnostics.debug.Variable.is_reference)
+}
+
 // -------------------------------------------------------------------
 
 // Status
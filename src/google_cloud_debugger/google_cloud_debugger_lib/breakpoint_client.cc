@@ -17,6 +17,7 @@
 #include <mutex>
 
 #include "constants.h"
+#include "metrics.h"
 
 using std::cerr;
 using std::string;
@@ -73,12 +74,17 @@ HRESULT BreakpointClient::ReadBreakpoint(Breakpoint *breakpoint) {
 
 HRESULT BreakpointClient::WriteBreakpoint(const Breakpoint &breakpoint) {
   string bp_str;
-  if (!breakpoint.SerializeToString(&bp_str)) {
-    cerr << "failed to serialize to protobuf" << std::endl;
-    return E_FAIL;
+  {
+    ScopedPhaseTimer timer(MetricPhase::kSerialize, breakpoint.id());
+    if (!breakpoint.SerializeToString(&bp_str)) {
+      cerr << "failed to serialize to protobuf" << std::endl;
+      return E_FAIL;
+    }
+    bp_str.insert(0, kStartBreakpointMessage);
+    bp_str.append(kEndBreakpointMessage);
   }
-  bp_str.insert(0, kStartBreakpointMessage);
-  bp_str.append(kEndBreakpointMessage);
+
+  ScopedPhaseTimer timer(MetricPhase::kPipeWrite, breakpoint.id());
   return pipe_->Write(bp_str);
 }
 
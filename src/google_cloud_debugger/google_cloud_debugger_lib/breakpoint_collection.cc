@@ -23,7 +23,9 @@
 #include "dbg_object.h"
 #include "debugger_callback.h"
 #include "i_eval_coordinator.h"
+#include "metrics.h"
 #include "named_pipe_client.h"
+#include "pdb_file_index.h"
 
 using google::cloud::diagnostics::debug::Breakpoint;
 using google::cloud::diagnostics::debug::SourceLocation;
@@ -87,6 +89,9 @@ HRESULT BreakpointCollection::CreateAndInitializeBreakpointClient(
 }
 
 HRESULT BreakpointCollection::WriteBreakpoint(const Breakpoint &breakpoint) {
+  // Breakpoints are written after the debuggee is continued so the
+  // capture of the next breakpoint hit may be writing at the same time.
+  std::lock_guard<std::mutex> lock(write_mutex_);
   if (!breakpoint_client_write_) {
     HRESULT hr = CreateAndInitializeBreakpointClient(
         &breakpoint_client_write_, debugger_callback_->GetPipeName());
@@ -115,13 +120,12 @@ HRESULT BreakpointCollection::ReadBreakpoint(Breakpoint *breakpoint) {
 HRESULT BreakpointCollection::EvaluateAndPrintBreakpoint(
     mdMethodDef function_token, ULONG32 il_offset,
     IEvalCoordinator *eval_coordinator, ICorDebugThread *debug_thread,
-    const std::vector<
-        std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>>
-        &pdb_files) {
+    std::shared_ptr<const PdbFileIndex> pdb_index) {
   HRESULT hr = S_FALSE;
   std::vector<std::shared_ptr<DbgBreakpoint>> matched_breakpoints;
 
   {
+    ScopedPhaseTimer timer(MetricPhase::kBreakpointDispatch);
     std::lock_guard<std::mutex> lock(mutex_);
     for (auto &&kvp : location_to_breakpoints_) {
       // Since the breakpoints are grouped by location, if
@@ -139,7 +143,7 @@ HRESULT BreakpointCollection::EvaluateAndPrintBreakpoint(
   }
 
   hr = eval_coordinator->ProcessBreakpoints(
-      debug_thread, this, std::move(matched_breakpoints), pdb_files);
+      debug_thread, this, std::move(matched_breakpoints), pdb_index);
   if (FAILED(hr)) {
     cerr << "Failed to get stack frame's information.";
   }
@@ -168,6 +172,8 @@ HRESULT BreakpointCollection::ReadAndParseBreakpoint(
                                breakpoint_read.expressions().end()));
   breakpoint->SetActivated(breakpoint_read.activated());
   breakpoint->SetKillServer(breakpoint_read.kill_server());
+  breakpoint->SetCaptureProfile(
+      CaptureProfile::FromBreakpoint(breakpoint_read));
 
   return S_OK;
 }
@@ -175,25 +181,54 @@ HRESULT BreakpointCollection::ReadAndParseBreakpoint(
 HRESULT BreakpointCollection::UpdateBreakpoint(
     const DbgBreakpoint &breakpoint) {
   HRESULT hr;
+  // The agent deactivates a breakpoint once it is finalized or deleted,
+  // so its histograms will not be recorded into again.
+  if (!breakpoint.Activated()) {
+    Metrics::GetInstance()->RemoveBreakpoint(breakpoint.GetId());
+  }
+
   // Find group of breakpoints at the same location.
   std::string breakpoint_location = breakpoint.GetBreakpointLocation();
 
+  // Hit counts of the deduplicated hits of the breakpoint if it
+  // is removed. They are written once the lock is released.
+  vector<Breakpoint> hit_count_updates;
+  bool updated_existing_breakpoint = false;
   {
     std::lock_guard<std::mutex> lock(mutex_);  
     if (location_to_breakpoints_.find(breakpoint_location)
       != location_to_breakpoints_.end()) {
+      if (!breakpoint.Activated()) {
+        for (auto &&existing_breakpoint :
+             location_to_breakpoints_[breakpoint_location]->GetBreakpoints()) {
+          if (existing_breakpoint->GetId() == breakpoint.GetId()) {
+            existing_breakpoint->TakeHitCountUpdates(true, &hit_count_updates);
+          }
+        }
+      }
+
       hr = location_to_breakpoints_[breakpoint_location]->UpdateBreakpoints(breakpoint);
       if (FAILED(hr)) {
         cerr << "Failed to activate breakpoint.";
         return hr;
       }
 
-      if (hr == S_OK) {
-        return hr;
-      }
+      updated_existing_breakpoint = hr == S_OK;
+    }
+  }
+
+  for (auto &&hit_count_update : hit_count_updates) {
+    // Failing to report a hit count should not fail the update.
+    if (FAILED(WriteBreakpoint(hit_count_update))) {
+      cerr << "Failed to write hit count of breakpoint " << breakpoint.GetId();
+      break;
     }
   }
 
+  if (updated_existing_breakpoint) {
+    return S_OK;
+  }
+
   // Otherwise, we have to create a new breakpoint from scratch.
   std::shared_ptr<DbgBreakpoint> new_breakpoint(new (std::nothrow)
                                                     DbgBreakpoint);
@@ -207,15 +242,9 @@ HRESULT BreakpointCollection::UpdateBreakpoint(
   // try to set and activate the breakpoint by searching through PDB files
   // for a matching location.
   bool found_bp = false;
-  for (auto pdb_file : debugger_callback_->GetPdbFiles()) {
-    if (!pdb_file) {
-      continue;
-    }
-
-    if (!pdb_file->ParsePdbFile()) {
-      continue;
-    }
-
+  std::shared_ptr<const PdbFileIndex> pdb_index =
+      debugger_callback_->GetPdbFileIndex();
+  for (auto &&pdb_file : pdb_index->GetPdbFiles()) {
     if (!new_breakpoint->TrySetBreakpoint(pdb_file.get())) {
       continue;
     }
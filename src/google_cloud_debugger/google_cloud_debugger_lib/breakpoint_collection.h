@@ -81,9 +81,7 @@ class BreakpointCollection : public IBreakpointCollection {
   HRESULT EvaluateAndPrintBreakpoint(
       mdMethodDef function_token, ULONG32 il_offset,
       IEvalCoordinator *eval_coordinator, ICorDebugThread *debug_thread,
-      const std::vector<
-          std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>>
-          &pdb_files) override;
+      std::shared_ptr<const PdbFileIndex> pdb_index) override;
 
  private:
   // Reads an incoming breakpoint from the named pipe and populates
@@ -127,6 +125,9 @@ class BreakpointCollection : public IBreakpointCollection {
   std::unique_ptr<BreakpointClient> breakpoint_client_write_;
 
   std::mutex mutex_;
+
+  // Serializes writes to breakpoint_client_write_.
+  std::mutex write_mutex_;
 };
 
 // Returns true if the first string and the second string are equal
@@ -0,0 +1,105 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "capture_planner.h"
+
+#include "dbg_object.h"
+
+using google::cloud::diagnostics::debug::Variable;
+using std::shared_ptr;
+using std::vector;
+
+namespace google_cloud_debugger {
+
+bool CapturePlanner::PlannedVariableLess::operator()(
+    const PlannedVariable &left, const PlannedVariable &right) const {
+  std::int32_t left_level = left.variable.GetBFSLevel();
+  std::int32_t right_level = right.variable.GetBFSLevel();
+  if (left_level != right_level) {
+    return left_level > right_level;
+  }
+
+  if (left.cost != right.cost) {
+    return left.cost > right.cost;
+  }
+
+  return left.order > right.order;
+}
+
+void CapturePlanner::AddVariable(const VariableWrapper &variable) {
+  // All the top-level variables are on the first level and, until
+  // they are loaded, cost nothing. They are reached first and in the
+  // order they were added.
+  PlannedVariable planned_variable{variable, 0, queued_count_++, false};
+  expansion_queue_.push(planned_variable);
+}
+
+HRESULT CapturePlanner::Capture(int size, int max_size) {
+  while (!expansion_queue_.empty()) {
+    if (size > max_size) {
+      return S_OK;
+    }
+
+    PlannedVariable planned_variable = expansion_queue_.top();
+    expansion_queue_.pop();
+
+    // Variables without members cost no more than their own value,
+    // so they are captured right away. Objects go back to the queue
+    // with their cost and are expanded after the variables without
+    // members of all the frames.
+    if (!planned_variable.loaded) {
+      shared_ptr<DbgObject> value = planned_variable.variable.LoadValue();
+      if (value && !value->GetIsNull() &&
+          value->GetEstimatedCaptureCost() > 0) {
+        QueueVariable(planned_variable.variable);
+        continue;
+      }
+    }
+
+    size += CaptureVariable(&planned_variable.variable);
+  }
+
+  return S_OK;
+}
+
+int CapturePlanner::CaptureVariable(VariableWrapper *variable) {
+  // Only the proto of the variable is measured instead of the whole
+  // proto. The length prefixes of the enclosing messages and the object
+  // ID of an expanded variable that gets referenced are not counted,
+  // which only misses a few bytes per variable.
+  Variable *variable_proto = variable->GetVariableProto();
+  int size_before = variable_proto ? variable_proto->ByteSize() : 0;
+
+  VariableWrapperVector members;
+  variable->Capture(&members, eval_coordinator_, max_object_depth_,
+                    &captured_objects_);
+  for (auto &member : members) {
+    QueueVariable(member);
+  }
+
+  int size_after = variable_proto ? variable_proto->ByteSize() : 0;
+  return size_after - size_before;
+}
+
+void CapturePlanner::QueueVariable(const VariableWrapper &variable) {
+  PlannedVariable planned_variable{variable, 0, queued_count_++, true};
+  shared_ptr<DbgObject> value = planned_variable.variable.GetVariableValue();
+  if (value) {
+    planned_variable.cost = value->GetEstimatedCaptureCost();
+  }
+  expansion_queue_.push(planned_variable);
+}
+
+}  //  namespace google_cloud_debugger
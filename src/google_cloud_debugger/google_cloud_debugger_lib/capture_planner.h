@@ -0,0 +1,115 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef CAPTURE_PLANNER_H_
+#define CAPTURE_PLANNER_H_
+
+#include <cstdint>
+#include <queue>
+#include <vector>
+
+#include "captured_object_table.h"
+#include "constants.h"
+#include "variable_wrapper.h"
+
+namespace google_cloud_debugger {
+
+class IEvalCoordinator;
+
+// Captures the variables of one or more stack frames within a budget.
+//
+// Capturing the variables of each frame breadth-first in declaration
+// order lets a large object early in a frame use up the budget (and the
+// function evaluations) before the variables after it are reached.
+// Instead, the planner first captures the variables without members
+// (primitives, strings, enums and nulls) of all the frames, which only
+// cost their own value. It then expands the other objects level by
+// level and, within a level, from the cheapest to the most expensive
+// according to DbgObject::GetEstimatedCaptureCost. Ties keep the order
+// the variables were added in. An object reached through several
+// variables is only expanded in the first of them to be captured.
+//
+// The value of a top-level variable is only loaded when the planner
+// reaches it within the budget, so the variables past the budget are
+// never loaded.
+class CapturePlanner {
+ public:
+  // eval_coordinator is used to evaluate the properties of objects.
+  // Objects are not inspected deeper than max_object_depth.
+  CapturePlanner(IEvalCoordinator *eval_coordinator,
+                 int max_object_depth = kDefaultObjectEvalDepth)
+      : eval_coordinator_(eval_coordinator),
+        max_object_depth_(max_object_depth) {}
+
+  // Adds a top-level variable to capture.
+  void AddVariable(const VariableWrapper &variable);
+
+  // Captures the variables added until they are all captured or the
+  // size of the proto they are in exceeds max_size. size is the size
+  // of that proto before the capture. The size is checked before each
+  // variable is loaded or captured.
+  HRESULT Capture(int size, int max_size);
+
+ private:
+  // A variable waiting to be expanded.
+  struct PlannedVariable {
+    VariableWrapper variable;
+
+    // Estimated cost of capturing the members of variable.
+    std::uint32_t cost;
+
+    // Number of variables planned before this one.
+    std::uint64_t order;
+
+    // False for a top-level variable whose value is not loaded yet.
+    // Its cost is only known once it is loaded.
+    bool loaded;
+  };
+
+  // Orders planned variables so that the shallowest, then cheapest,
+  // then earliest variable is on top of a priority queue.
+  struct PlannedVariableLess {
+    bool operator()(const PlannedVariable &left,
+                    const PlannedVariable &right) const;
+  };
+
+  // Captures variable and queues its members. Returns the number of
+  // bytes the capture added to the proto of variable.
+  int CaptureVariable(VariableWrapper *variable);
+
+  // Queues variable to be expanded.
+  void QueueVariable(const VariableWrapper &variable);
+
+  // Variables waiting to be expanded.
+  std::priority_queue<
+      PlannedVariable,
+      std::vector<PlannedVariable, SnapshotAllocator<PlannedVariable>>,
+      PlannedVariableLess>
+      expansion_queue_;
+
+  // Number of variables queued so far.
+  std::uint64_t queued_count_ = 0;
+
+  // Objects already expanded in the variables captured so far.
+  CapturedObjectTable captured_objects_;
+
+  IEvalCoordinator *eval_coordinator_;
+
+  int max_object_depth_;
+};
+
+}  //  namespace google_cloud_debugger
+
+#endif  //  CAPTURE_PLANNER_H_
@@ -0,0 +1,91 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "capture_profile.h"
+
+#include <algorithm>
+
+#include "breakpoint.pb.h"
+
+using google::cloud::diagnostics::debug::Breakpoint;
+using std::max;
+
+namespace google_cloud_debugger {
+
+CaptureProfile CaptureProfile::default_profile_;
+
+CaptureProfile CaptureProfile::Union(const CaptureProfile &other) const {
+  CaptureProfile result;
+  result.max_stack_frames = max(max_stack_frames, other.max_stack_frames);
+  result.max_stack_frames_with_variables =
+      max(max_stack_frames_with_variables,
+          other.max_stack_frames_with_variables);
+  result.max_object_depth = max(max_object_depth, other.max_object_depth);
+  result.max_collection_size =
+      max(max_collection_size, other.max_collection_size);
+  result.max_expression_collection_size = max(
+      max_expression_collection_size, other.max_expression_collection_size);
+  result.max_string_length = max(max_string_length, other.max_string_length);
+  result.max_breakpoint_size =
+      max(max_breakpoint_size, other.max_breakpoint_size);
+  result.stack_only = stack_only && other.stack_only;
+  result.stack_dedup_window_ms =
+      max(stack_dedup_window_ms, other.stack_dedup_window_ms);
+  return result;
+}
+
+CaptureProfile CaptureProfile::FromBreakpoint(const Breakpoint &breakpoint) {
+  // Proto3 does not distinguish unset fields from 0, so a limit that
+  // is not positive means the default.
+  CaptureProfile result = default_profile_;
+  if (breakpoint.max_stack_frames() > 0) {
+    result.max_stack_frames = breakpoint.max_stack_frames();
+  }
+
+  if (breakpoint.max_stack_frames_with_variables() > 0) {
+    result.max_stack_frames_with_variables =
+        breakpoint.max_stack_frames_with_variables();
+  }
+
+  if (breakpoint.max_object_depth() > 0) {
+    result.max_object_depth = breakpoint.max_object_depth();
+  }
+
+  if (breakpoint.max_collection_size() > 0) {
+    result.max_collection_size = breakpoint.max_collection_size();
+  }
+
+  if (breakpoint.max_expression_collection_size() > 0) {
+    result.max_expression_collection_size =
+        breakpoint.max_expression_collection_size();
+  }
+
+  if (breakpoint.max_breakpoint_size() > 0) {
+    result.max_breakpoint_size = breakpoint.max_breakpoint_size();
+  }
+
+  if (breakpoint.stack_only()) {
+    result.stack_only = true;
+  }
+
+  return result;
+}
+
+const CaptureProfile &CaptureProfile::GetDefault() { return default_profile_; }
+
+void CaptureProfile::SetDefault(const CaptureProfile &profile) {
+  default_profile_ = profile;
+}
+
+}  //  namespace google_cloud_debugger
@@ -0,0 +1,98 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CAPTURE_PROFILE_H_
+#define CAPTURE_PROFILE_H_
+
+#include <cstdint>
+
+#include "constants.h"
+
+namespace google {
+namespace cloud {
+namespace diagnostics {
+namespace debug {
+class Breakpoint;
+}  // namespace debug
+}  // namespace diagnostics
+}  // namespace cloud
+}  // namespace google
+
+namespace google_cloud_debugger {
+
+// Limits on how much of the application state is captured when
+// a breakpoint is hit. A latency-sensitive service can use a shallow
+// profile while a batch job can use a deep one.
+struct CaptureProfile {
+  // Maximum number of stack frames captured.
+  std::uint32_t max_stack_frames = 20;
+
+  // Maximum number of stack frames whose local variables and method
+  // arguments are captured.
+  std::uint32_t max_stack_frames_with_variables = 4;
+
+  // Maximum depth to which the members of an object are captured.
+  int max_object_depth = kDefaultObjectEvalDepth;
+
+  // Maximum number of items captured from a collection.
+  std::uint32_t max_collection_size = 10;
+
+  // Maximum number of items captured from a collection that is the value
+  // of an expression, including slices of collections. This is larger than
+  // max_collection_size since expressions ask for the collection, but still
+  // bounded so an expression on a huge collection cannot keep the
+  // application paused while millions of items are read.
+  std::uint32_t max_expression_collection_size = 1000;
+
+  // Maximum number of characters captured from a string. Longer strings
+  // are truncated and only this many characters are read from them.
+  std::uint32_t max_string_length = 256;
+
+  // Maximum size of the breakpoint proto in bytes (65536 bytes = 64kb).
+  std::uint32_t max_breakpoint_size = 65536;
+
+  // If true, only the method names and locations of the stack frames
+  // are captured. No variables are read from the debuggee, which makes
+  // this cheap enough for breakpoints that are hit often.
+  bool stack_only = false;
+
+  // Window in milliseconds in which the hits of a breakpoint from the same
+  // call stack are only counted after the first one is captured. 0 captures
+  // every hit.
+  std::uint32_t stack_dedup_window_ms = 0;
+
+  // Returns a profile that has the larger of each limit of this
+  // profile and other. The union is only stack-only if both profiles are.
+  CaptureProfile Union(const CaptureProfile &other) const;
+
+  // Returns the capture profile of breakpoint. The limits that are
+  // not set in breakpoint are taken from the default profile.
+  static CaptureProfile FromBreakpoint(
+      const google::cloud::diagnostics::debug::Breakpoint &breakpoint);
+
+  // Returns the process-wide default profile.
+  static const CaptureProfile &GetDefault();
+
+  // Sets the process-wide default profile. This is not thread-safe
+  // and has to be called before the debugger starts.
+  static void SetDefault(const CaptureProfile &profile);
+
+ private:
+  // The process-wide default profile.
+  static CaptureProfile default_profile_;
+};
+
+}  //  namespace google_cloud_debugger
+
+#endif  //  CAPTURE_PROFILE_H_
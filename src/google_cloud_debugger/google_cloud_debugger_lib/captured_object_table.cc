@@ -0,0 +1,68 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "captured_object_table.h"
+
+#include <utility>
+
+#include "dbg_object.h"
+
+using google::cloud::diagnostics::debug::Variable;
+
+namespace google_cloud_debugger {
+
+bool CapturedObjectTable::IsTracked(const DbgObject &object) {
+  if (object.GetIsNull() || object.GetAddress() == 0) {
+    return false;
+  }
+
+  switch (object.GetCorElementType()) {
+    case CorElementType::ELEMENT_TYPE_CLASS:
+    case CorElementType::ELEMENT_TYPE_OBJECT:
+    case CorElementType::ELEMENT_TYPE_SZARRAY:
+    case CorElementType::ELEMENT_TYPE_ARRAY:
+      return true;
+    default:
+      return false;
+  }
+}
+
+bool CapturedObjectTable::ReferenceOrAdd(const DbgObject &object,
+                                         Variable *variable_proto) {
+  if (!variable_proto || !IsTracked(object)) {
+    return false;
+  }
+
+  auto inserted = expanded_objects_.insert(std::make_pair(
+      std::make_pair(object.GetAddress(), object.GetAddressEvalCount()),
+      variable_proto));
+  if (inserted.second) {
+    return false;
+  }
+
+  // The expanded variable only gets an ID once it is referenced, so
+  // objects reached once do not pay for it.
+  Variable *expanded_proto = inserted.first->second;
+  if (expanded_proto->object_id() == 0) {
+    expanded_proto->set_object_id(next_object_id_++);
+  }
+
+  variable_proto->set_object_id(expanded_proto->object_id());
+  variable_proto->set_is_reference(true);
+  ++reference_count_;
+  return true;
+}
+
+}  //  namespace google_cloud_debugger
@@ -0,0 +1,80 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef CAPTURED_OBJECT_TABLE_H_
+#define CAPTURED_OBJECT_TABLE_H_
+
+#include <cstdint>
+#include <map>
+#include <utility>
+
+#include "breakpoint.pb.h"
+#include "cor.h"
+#include "cordebug.h"
+
+namespace google_cloud_debugger {
+
+class DbgObject;
+
+// Heap objects whose members are already captured in a snapshot.
+//
+// Objects such as a logger, a configuration singleton or the parent of
+// a child that points back to it are reachable through many variables.
+// Instead of capturing their members again under every path, the first
+// variable of an object that is expanded is recorded here and every
+// later variable of the object only references it. Both variables are
+// then given the same object_id and the later one is marked
+// is_reference.
+//
+// Objects are identified by their address together with the eval count
+// it was read at (see DbgObject::GetAddressEvalCount). A function
+// evaluation runs the debuggee and the garbage collector may move
+// objects, so the same address read at different eval counts may be
+// different objects.
+// This class is NOT thread-safe.
+class CapturedObjectTable {
+ public:
+  // Returns true if object is a heap object that can be reached through
+  // more than one variable. Value types are copied into their variables
+  // (and may share the address of their first field) so they are not.
+  static bool IsTracked(const DbgObject &object);
+
+  // If object was already expanded in variable_proto of another
+  // variable, marks variable_proto as a reference to it and returns
+  // true. Otherwise records variable_proto as the variable object is
+  // expanded in and returns false.
+  bool ReferenceOrAdd(const DbgObject &object,
+                      google::cloud::diagnostics::debug::Variable
+                          *variable_proto);
+
+  // Returns the number of references made so far.
+  std::uint32_t GetReferenceCount() const { return reference_count_; }
+
+ private:
+  // The variable each object is expanded in, by object address and
+  // the eval count the address was read at.
+  std::map<std::pair<CORDB_ADDRESS, std::uint64_t>,
+           google::cloud::diagnostics::debug::Variable *>
+      expanded_objects_;
+
+  // Object ID given to the next object that is referenced.
+  std::int32_t next_object_id_ = 1;
+
+  // Number of references made so far.
+  std::uint32_t reference_count_ = 0;
+};
+
+}  //  namespace google_cloud_debugger
+
+#endif  //  CAPTURED_OBJECT_TABLE_H_
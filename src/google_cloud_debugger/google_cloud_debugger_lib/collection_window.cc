@@ -0,0 +1,116 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "collection_window.h"
+
+#include <cctype>
+
+using std::string;
+
+namespace google_cloud_debugger {
+
+// Returns text without its leading and trailing whitespaces.
+static string Trim(const string &text) {
+  size_t first = 0;
+  while (first < text.size() && std::isspace(text[first])) {
+    ++first;
+  }
+
+  size_t last = text.size();
+  while (last > first && std::isspace(text[last - 1])) {
+    --last;
+  }
+
+  return text.substr(first, last - first);
+}
+
+// Parses the index text of a slice into index. An empty text is parsed
+// as default_index. Returns false if text is not a non-negative number
+// that fits in 32 bits.
+static bool ParseSliceIndex(const string &text, std::uint32_t default_index,
+                            std::uint32_t *index) {
+  if (text.empty()) {
+    *index = default_index;
+    return true;
+  }
+
+  std::uint64_t result = 0;
+  for (char digit : text) {
+    if (!std::isdigit(digit)) {
+      return false;
+    }
+
+    result = result * 10 + (digit - '0');
+    if (result > UINT32_MAX) {
+      return false;
+    }
+  }
+
+  *index = static_cast<std::uint32_t>(result);
+  return true;
+}
+
+bool CollectionWindow::ParseSlice(const string &expression,
+                                  string *collection_expression,
+                                  CollectionWindow *window) {
+  string slice = Trim(expression);
+  if (slice.empty() || slice.back() != ']') {
+    return false;
+  }
+
+  // Finds the bracket that opens the last one so indexers inside
+  // the slice, such as a[b[0]..], are not mistaken for it.
+  int depth = 0;
+  size_t open_bracket = string::npos;
+  for (size_t i = slice.size(); i > 0; --i) {
+    if (slice[i - 1] == ']') {
+      ++depth;
+    } else if (slice[i - 1] == '[') {
+      --depth;
+      if (depth == 0) {
+        open_bracket = i - 1;
+        break;
+      }
+    }
+  }
+
+  if (open_bracket == string::npos) {
+    return false;
+  }
+
+  string collection = Trim(slice.substr(0, open_bracket));
+  string range =
+      slice.substr(open_bracket + 1, slice.size() - open_bracket - 2);
+  size_t range_operator = range.find("..");
+  if (collection.empty() || range_operator == string::npos) {
+    return false;
+  }
+
+  std::uint32_t first = 0;
+  std::uint32_t last = 0;
+  if (!ParseSliceIndex(Trim(range.substr(0, range_operator)), 0, &first) ||
+      !ParseSliceIndex(Trim(range.substr(range_operator + 2)), UINT32_MAX,
+                       &last) ||
+      last < first) {
+    return false;
+  }
+
+  *collection_expression = collection;
+  window->first_item = first;
+  window->max_items = last - first;
+  return true;
+}
+
+}  //  namespace google_cloud_debugger
@@ -0,0 +1,47 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef COLLECTION_WINDOW_H_
+#define COLLECTION_WINDOW_H_
+
+#include <cstdint>
+#include <string>
+
+namespace google_cloud_debugger {
+
+// The items of a collection that are captured, starting at first_item.
+// An expression such as items[1000..1020] only captures the window
+// of items 1000 to 1019 of the collection items.
+struct CollectionWindow {
+  // Index of the first item captured.
+  std::uint32_t first_item = 0;
+
+  // Maximum number of items captured from first_item. The current
+  // maximum collection size of DbgBreakpoint applies on top of it.
+  std::uint32_t max_items = UINT32_MAX;
+
+  // Parses expression if it is a slice collection[first..last] of
+  // a collection. As with C# ranges, last is exclusive and first or last
+  // can be omitted. If expression is a slice, returns true and sets
+  // collection_expression to the expression of the collection and window
+  // to the items of the slice. Otherwise returns false.
+  static bool ParseSlice(const std::string &expression,
+                         std::string *collection_expression,
+                         CollectionWindow *window);
+};
+
+}  //  namespace google_cloud_debugger
+
+#endif  //  COLLECTION_WINDOW_H_
@@ -15,6 +15,7 @@
 #include "cor_debug_helper.h"
 
 #include <assert.h>
+#include <algorithm>
 #include <iostream>
 #include <vector>
 
@@ -331,9 +332,10 @@ HRESULT CorDebugHelper::CreateStrongHandle(ICorDebugValue *debug_value,
 }
 
 HRESULT CorDebugHelper::ExtractStringFromICorDebugStringValue(
-    ICorDebugStringValue *debug_string, std::string *returned_string,
+    ICorDebugStringValue *debug_string, ULONG32 max_length,
+    std::string *returned_string, ULONG32 *original_length,
     std::ostream *err_stream) {
-  if (!returned_string || !debug_string || !err_stream) {
+  if (!returned_string || !debug_string || !original_length || !err_stream) {
     return E_INVALIDARG;
   }
 
@@ -347,21 +349,35 @@ HRESULT CorDebugHelper::ExtractStringFromICorDebugStringValue(
     return hr;
   }
 
-  if (str_len == 0) {
+  *original_length = str_len;
+  if (str_len == 0 || max_length == 0) {
     *returned_string = "";
     return S_OK;
   }
 
+  // Only reads the prefix that is captured. GetString fills in as many
+  // characters as fit in the buffer, so a large string is never copied
+  // out of the debuggee as a whole.
+  ULONG32 read_len = std::min(str_len, max_length);
+
   // Plus 1 for the NULL at the end of the string.
-  str_len += 1;
-  std::vector<WCHAR> string_value(str_len, 0);
+  std::vector<WCHAR> string_value(read_len + 1, 0);
 
-  hr = debug_string->GetString(str_len, &str_returned_len, string_value.data());
+  hr = debug_string->GetString(read_len + 1, &str_returned_len,
+                               string_value.data());
   if (FAILED(hr)) {
     *err_stream << "Failed to extract the string.";
     return hr;
   }
 
+  // Does not leave half of a surrogate pair at the end of a truncated
+  // string since it cannot be converted to UTF-8.
+  string_value[read_len] = 0;
+  if (read_len < str_len && string_value[read_len - 1] >= 0xD800 &&
+      string_value[read_len - 1] <= 0xDBFF) {
+    string_value[read_len - 1] = 0;
+  }
+
   *returned_string = ConvertWCharPtrToString(string_value);
   return S_OK;
 }
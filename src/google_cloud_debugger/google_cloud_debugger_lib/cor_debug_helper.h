@@ -89,9 +89,11 @@ class CorDebugHelper : public ICorDebugHelper {
                                      ICorDebugHandleValue **handle,
                                      std::ostream *err_stream) override;
 
-  // Extracts out a string from ICorDebugStringValue.
+  // Extracts out at most max_length characters from the start of
+  // ICorDebugStringValue.
   virtual HRESULT ExtractStringFromICorDebugStringValue(
-      ICorDebugStringValue *debug_string, std::string *returned_string,
+      ICorDebugStringValue *debug_string, ULONG32 max_length,
+      std::string *returned_string, ULONG32 *original_length,
       std::ostream *err_stream) override;
 
   // Given a metadata token for the parameter param_token,
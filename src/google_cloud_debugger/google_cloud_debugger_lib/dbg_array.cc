@@ -14,12 +14,14 @@
 
 #include "dbg_array.h"
 
+#include <algorithm>
 #include <iostream>
 
 #include "class_names.h"
 #include "dbg_breakpoint.h"
 #include "i_dbg_object_factory.h"
 #include "i_cor_debug_helper.h"
+#include "i_eval_coordinator.h"
 #include "type_signature.h"
 #include "variable_wrapper.h"
 
@@ -51,7 +53,7 @@ void DbgArray::Initialize(ICorDebugValue *debug_value, BOOL is_null) {
   // Create an empty object for the type.
   initialize_hr_ =
       object_factory_->CreateDbgObject(array_type_, &empty_object_,
-                                       GetErrorStream());
+                                       ErrorStream(this));
   if (FAILED(initialize_hr_)) {
     WriteError("Failed to create an empty object for the array type.");
     if (empty_object_) {
@@ -78,8 +80,7 @@ void DbgArray::Initialize(ICorDebugValue *debug_value, BOOL is_null) {
     return;
   }
 
-  initialize_hr_ = debug_helper_->CreateStrongHandle(
-      debug_value, &object_handle_, GetErrorStream());
+  initialize_hr_ = CreateObjectHandle(debug_value);
   if (FAILED(initialize_hr_)) {
     WriteError("Failed to create a handle for the array.");
     return;
@@ -119,12 +120,12 @@ HRESULT DbgArray::GetArrayItem(int position, ICorDebugValue **array_item) {
   CComPtr<ICorDebugArrayValue> array_value;
   CComPtr<ICorDebugValue> dereferenced_value;
 
-  if (!object_handle_) {
+  if (!GetObjectValue()) {
     WriteError("Cannot retrieve the array.");
     return E_FAIL;
   }
 
-  hr = object_handle_->Dereference(&dereferenced_value);
+  hr = DereferenceObject(&dereferenced_value);
   if (FAILED(hr)) {
     WriteError("Failed to dereference array handle.");
     return hr;
@@ -140,9 +141,109 @@ HRESULT DbgArray::GetArrayItem(int position, ICorDebugValue **array_item) {
   return array_value->GetElementAtPosition(position, array_item);
 }
 
+HRESULT DbgArray::ReadPrimitiveItems(IEvalCoordinator *eval_coordinator,
+                                     int first_position, int count,
+                                     vector<unique_ptr<DbgObject>> *items) {
+  if (!array_type_ || count <= 0) {
+    return E_NOTIMPL;
+  }
+
+  CorElementType item_type;
+  HRESULT hr = array_type_->GetType(&item_type);
+  if (FAILED(hr)) {
+    return hr;
+  }
+
+  switch (item_type) {
+    case CorElementType::ELEMENT_TYPE_BOOLEAN:
+    case CorElementType::ELEMENT_TYPE_CHAR:
+    case CorElementType::ELEMENT_TYPE_I1:
+    case CorElementType::ELEMENT_TYPE_U1:
+    case CorElementType::ELEMENT_TYPE_I2:
+    case CorElementType::ELEMENT_TYPE_U2:
+    case CorElementType::ELEMENT_TYPE_I4:
+    case CorElementType::ELEMENT_TYPE_U4:
+    case CorElementType::ELEMENT_TYPE_I8:
+    case CorElementType::ELEMENT_TYPE_U8:
+    case CorElementType::ELEMENT_TYPE_R4:
+    case CorElementType::ELEMENT_TYPE_R8:
+      break;
+    default:
+      return E_NOTIMPL;
+  }
+
+  CComPtr<ICorDebugThread> active_thread;
+  hr = eval_coordinator->GetActiveDebugThread(&active_thread);
+  if (FAILED(hr) || !active_thread) {
+    return E_FAIL;
+  }
+
+  CComPtr<ICorDebugProcess> debug_process;
+  hr = active_thread->GetProcess(&debug_process);
+  if (FAILED(hr) || !debug_process) {
+    return E_FAIL;
+  }
+
+  // The items of an array are stored next to each other, so the items
+  // from first_position start at its address.
+  CComPtr<ICorDebugValue> first_item;
+  hr = GetArrayItem(first_position, &first_item);
+  if (FAILED(hr)) {
+    return hr;
+  }
+
+  CORDB_ADDRESS first_item_address = 0;
+  hr = first_item->GetAddress(&first_item_address);
+  if (FAILED(hr) || first_item_address == 0) {
+    return E_FAIL;
+  }
+
+  switch (item_type) {
+    case CorElementType::ELEMENT_TYPE_BOOLEAN:
+      return ReadPrimitiveItemsHelper<bool, uint8_t>(
+          debug_process, first_item_address, count, items);
+    case CorElementType::ELEMENT_TYPE_CHAR:
+      // .NET chars are UTF-16 code units.
+      return ReadPrimitiveItemsHelper<char, uint16_t>(
+          debug_process, first_item_address, count, items);
+    case CorElementType::ELEMENT_TYPE_I1:
+      return ReadPrimitiveItemsHelper<int8_t, int8_t>(
+          debug_process, first_item_address, count, items);
+    case CorElementType::ELEMENT_TYPE_U1:
+      return ReadPrimitiveItemsHelper<uint8_t, uint8_t>(
+          debug_process, first_item_address, count, items);
+    case CorElementType::ELEMENT_TYPE_I2:
+      return ReadPrimitiveItemsHelper<int16_t, int16_t>(
+          debug_process, first_item_address, count, items);
+    case CorElementType::ELEMENT_TYPE_U2:
+      return ReadPrimitiveItemsHelper<uint16_t, uint16_t>(
+          debug_process, first_item_address, count, items);
+    case CorElementType::ELEMENT_TYPE_I4:
+      return ReadPrimitiveItemsHelper<int32_t, int32_t>(
+          debug_process, first_item_address, count, items);
+    case CorElementType::ELEMENT_TYPE_U4:
+      return ReadPrimitiveItemsHelper<uint32_t, uint32_t>(
+          debug_process, first_item_address, count, items);
+    case CorElementType::ELEMENT_TYPE_I8:
+      return ReadPrimitiveItemsHelper<int64_t, int64_t>(
+          debug_process, first_item_address, count, items);
+    case CorElementType::ELEMENT_TYPE_U8:
+      return ReadPrimitiveItemsHelper<uint64_t, uint64_t>(
+          debug_process, first_item_address, count, items);
+    case CorElementType::ELEMENT_TYPE_R4:
+      return ReadPrimitiveItemsHelper<float, float>(
+          debug_process, first_item_address, count, items);
+    case CorElementType::ELEMENT_TYPE_R8:
+      return ReadPrimitiveItemsHelper<double, double>(
+          debug_process, first_item_address, count, items);
+    default:
+      return E_NOTIMPL;
+  }
+}
+
 HRESULT DbgArray::PopulateMembers(
     google::cloud::diagnostics::debug::Variable *variable_proto,
-    std::vector<VariableWrapper> *members,
+    VariableWrapperVector *members,
     IEvalCoordinator *eval_coordinator) {
   if (FAILED(initialize_hr_)) {
     return initialize_hr_;
@@ -156,22 +257,29 @@ HRESULT DbgArray::PopulateMembers(
     return S_OK;
   }
 
-  int total_items = 1;
-  for (int i = 0; i < dimensions_.size(); ++i) {
-    total_items *= dimensions_[i];
+  int total_items = GetArraySize();
+  int item_count = GetItemCountInWindow();
+  if (item_count == 0) {
+    return S_OK;
   }
 
   // We use this dimensions_tracker to help us track which combination
   // of the array dimensions we are currently at (see comments just before the
-  // while loop).
+  // while loop). It starts at the combination of the first item in window_.
+  int current_index = window_.first_item;
   vector<ULONG32> dimensions_tracker(dimensions_.size(), 0);
-
-  int current_index = 0;
-  // If this was not set yet, use the current maximum collection size
-  // from DbgBreakpoint.
-  if (max_items_to_retrieved_ == 0) {
-    max_items_to_retrieved_ = DbgBreakpoint::GetMaximumCollectionSize();
+  int remaining_index = current_index;
+  for (int index = dimensions_.size() - 1; index >= 0; --index) {
+    dimensions_tracker[index] = remaining_index % dimensions_[index];
+    remaining_index /= dimensions_[index];
   }
+  int last_index = current_index + item_count;
+
+  // Arrays of primitives (including the items of a List<T>) are read
+  // all at once. Other arrays fall back to reading item by item.
+  vector<unique_ptr<DbgObject>> primitive_items;
+  bool has_primitive_items = SUCCEEDED(ReadPrimitiveItems(
+      eval_coordinator, current_index, item_count, &primitive_items));
 
   // In this while loop, we visit all possible combinations of the dimensions_
   // array to print out all the items. For example, let's assume that the array
@@ -185,8 +293,7 @@ HRESULT DbgArray::PopulateMembers(
   // 2 0 0 -> 2 0 1 -> 2 0 2 -> 2 0 3 ->
   // 2 1 0 -> 2 1 1 -> 2 1 2 -> 2 1 3 ->
   // 2 2 0 -> 2 2 1 -> 2 2 2 -> 2 2 3
-  while (current_index < total_items &&
-         current_index < max_items_to_retrieved_) {
+  while (current_index < last_index) {
     // Uses the current combination as the name.
     string name = "[";
     for (int index = 0; index < dimensions_tracker.size(); ++index) {
@@ -220,6 +327,13 @@ HRESULT DbgArray::PopulateMembers(
     Variable *member = variable_proto->add_members();
     member->set_name(name);
 
+    if (has_primitive_items) {
+      members->push_back(VariableWrapper(
+          member, std::move(primitive_items[current_index - 1 -
+                                            window_.first_item])));
+      continue;
+    }
+
     CComPtr<ICorDebugValue> array_item;
     // Minus one here since we increase it above.
     HRESULT hr = GetArrayItem(current_index - 1, &array_item);
@@ -233,7 +347,7 @@ HRESULT DbgArray::PopulateMembers(
     unique_ptr<DbgObject> result_object;
     hr = object_factory_->CreateDbgObject(
         array_item, GetCreationDepth() - 1,
-        &result_object, GetErrorStream());
+        &result_object, ErrorStream(this));
     if (FAILED(hr)) {
       if (result_object) {
         WriteError(result_object->GetErrorString());
@@ -284,6 +398,30 @@ int DbgArray::GetArraySize() {
   return result;
 }
 
+std::uint32_t DbgArray::GetEstimatedCaptureCost() const {
+  if (GetIsNull()) {
+    return 0;
+  }
+
+  return GetItemCountInWindow();
+}
+
+std::uint32_t DbgArray::GetItemCountInWindow() const {
+  std::uint64_t total_items = 1;
+  for (ULONG32 dimension : dimensions_) {
+    total_items *= dimension;
+  }
+
+  if (total_items <= window_.first_item) {
+    return 0;
+  }
+
+  std::uint64_t max_items =
+      std::min(window_.max_items, DbgBreakpoint::GetMaximumCollectionSize());
+  return static_cast<std::uint32_t>(
+      std::min(total_items - window_.first_item, max_items));
+}
+
 HRESULT DbgArray::GetTypeSignature(TypeSignature *type_signature) {
   if (!type_signature || !empty_object_) {
     return E_INVALIDARG;
@@ -15,9 +15,11 @@
 #ifndef DBG_ARRAY_H_
 #define DBG_ARRAY_H_
 
+#include <cstring>
 #include <memory>
 #include <vector>
 
+#include "dbg_primitive.h"
 #include "dbg_reference_object.h"
 
 namespace google_cloud_debugger {
@@ -71,7 +73,7 @@ class DbgArray : public DbgReferenceObject {
   // be used to populate the members vector.
   HRESULT PopulateMembers(
       google::cloud::diagnostics::debug::Variable *variable_proto,
-      std::vector<VariableWrapper> *members,
+      VariableWrapperVector *members,
       IEvalCoordinator *eval_coordinator) override;
 
   // Gets the type of the array.
@@ -82,7 +84,15 @@ class DbgArray : public DbgReferenceObject {
   // Sets the maximum amount of items that the array will retrieve
   // when PopulateMembers is called.
   void SetMaxArrayItemsToRetrieve(std::uint32_t target) {
-    max_items_to_retrieved_ = target;
+    window_.max_items = target;
+  }
+
+  // Makes PopulateMembers retrieve the items in window, starting directly
+  // at its first item. The current maximum collection size of
+  // DbgBreakpoint still applies.
+  HRESULT SetCollectionWindow(const CollectionWindow &window) override {
+    window_ = window;
+    return S_OK;
   }
 
   // Returns the size of the array.
@@ -93,10 +103,57 @@ class DbgArray : public DbgReferenceObject {
   //   3D array of 3x3x3 would have a size of 27.
   int GetArraySize();
 
+  // Estimates the cost of populating the items of this array, which
+  // is the number of items retrieved.
+  std::uint32_t GetEstimatedCaptureCost() const override;
+
   // Returns TypeSignature of this array.
   HRESULT GetTypeSignature(TypeSignature *type_signature) override;
 
  private:
+  // Reads count items from position first_position of an array of
+  // primitive types (except IntPtr and UIntPtr) with a single read of
+  // the debuggee's memory instead of dereferencing the array and creating
+  // a DbgObject from an ICorDebugValue for every item. Items of
+  // multi-dimensional arrays are read in the same order as GetArrayItem.
+  // Returns E_NOTIMPL if the items are not primitives.
+  HRESULT ReadPrimitiveItems(IEvalCoordinator *eval_coordinator,
+                             int first_position, int count,
+                             std::vector<std::unique_ptr<DbgObject>> *items);
+
+  // Returns the number of items retrieved by PopulateMembers, which is
+  // the number of items in window_ capped by the maximum collection size.
+  std::uint32_t GetItemCountInWindow() const;
+
+  // Reads count items of type T, stored in the debuggee as StoredT,
+  // from the memory of debug_process at address into items.
+  template <typename T, typename StoredT>
+  HRESULT ReadPrimitiveItemsHelper(
+      ICorDebugProcess *debug_process, CORDB_ADDRESS address, int count,
+      std::vector<std::unique_ptr<DbgObject>> *items) {
+    std::vector<BYTE> buffer(count * sizeof(StoredT));
+    SIZE_T bytes_read = 0;
+    HRESULT hr = debug_process->ReadMemory(address, buffer.size(),
+                                           buffer.data(), &bytes_read);
+    if (FAILED(hr) || bytes_read != buffer.size()) {
+      return FAILED(hr) ? hr : E_FAIL;
+    }
+
+    items->reserve(count);
+    for (int i = 0; i < count; ++i) {
+      StoredT stored_value;
+      memcpy(&stored_value, buffer.data() + i * sizeof(StoredT),
+             sizeof(StoredT));
+      std::unique_ptr<DbgObject> item(new (std::nothrow) DbgPrimitive<T>(
+          static_cast<T>(stored_value)));
+      if (!item) {
+        return E_OUTOFMEMORY;
+      }
+      items->push_back(std::move(item));
+    }
+    return S_OK;
+  }
+
   // The type of the array.
   CComPtr<ICorDebugType> array_type_;
 
@@ -109,8 +166,8 @@ class DbgArray : public DbgReferenceObject {
   // a dimension in this array.
   std::vector<ULONG32> dimensions_;
 
-  // The maximum amount of items to retrieve in an array.
-  std::uint32_t max_items_to_retrieved_ = 0;
+  // The items to retrieve in an array.
+  CollectionWindow window_;
 };
 
 }  //  namespace google_cloud_debugger
@@ -16,8 +16,10 @@
 
 #include <algorithm>
 #include <cctype>
+#include <chrono>
 #include <queue>
 
+#include "collection_window.h"
 #include "compiler_helpers.h"
 #include "document_index.h"
 #include "expression_evaluator.h"
@@ -27,6 +29,7 @@
 #include "i_eval_coordinator.h"
 #include "i_portable_pdb_file.h"
 #include "i_stack_frame_collection.h"
+#include "metrics.h"
 #include "variable_wrapper.h"
 
 using google::cloud::diagnostics::debug::Breakpoint;
@@ -39,15 +42,21 @@ using google_cloud_debugger_portable_pdb::LocalVariableRow;
 using std::string;
 using std::unique_ptr;
 using std::vector;
+using std::chrono::milliseconds;
+using std::chrono::steady_clock;
 
 namespace google_cloud_debugger {
 
 std::int32_t DbgBreakpoint::current_max_collection_size_ =
-    DbgBreakpoint::kMaximumCollectionSize;
+    CaptureProfile().max_collection_size;
+
+std::uint32_t DbgBreakpoint::current_max_string_length_ =
+    CaptureProfile().max_string_length;
 
 void DbgBreakpoint::Initialize(const DbgBreakpoint &other) {
   Initialize(other.file_name_, other.id_, other.line_, other.column_,
              other.condition_, other.expressions_);
+  capture_profile_ = other.capture_profile_;
 }
 
 void DbgBreakpoint::Initialize(const string &file_name, const string &id,
@@ -153,8 +162,17 @@ bool DbgBreakpoint::TrySetBreakpoint(
 HRESULT DbgBreakpoint::EvaluateExpressions(IDbgStackFrame *stack_frame,
                                            IEvalCoordinator *eval_coordinator,
                                            IDbgObjectFactory *obj_factory) {
+  ScopedPhaseTimer timer(MetricPhase::kExpressionEvaluate, id_);
   for (auto &expression : expressions_) {
-    CompiledExpression compiled_expression = CompileExpression(expression);
+    // A slice such as items[1000..1020] is evaluated as its collection
+    // and only the items in the window of the slice are captured.
+    std::string collection_expression;
+    CollectionWindow window;
+    bool is_slice = CollectionWindow::ParseSlice(
+        expression, &collection_expression, &window);
+
+    CompiledExpression compiled_expression =
+        CompileExpression(is_slice ? collection_expression : expression);
     if (compiled_expression.evaluator == nullptr) {
       WriteError("Failed to compile expression: " + expression);
       return E_FAIL;
@@ -171,7 +189,7 @@ HRESULT DbgBreakpoint::EvaluateExpressions(IDbgStackFrame *stack_frame,
     }
 
     hr = compiled_expression.evaluator->Compile(stack_frame, active_frame,
-                                                GetErrorStream());
+                                                ErrorStream(this));
     if (FAILED(hr)) {
       WriteError("Failed to evaluate expression: " + expression + ".");
       return hr;
@@ -179,12 +197,21 @@ HRESULT DbgBreakpoint::EvaluateExpressions(IDbgStackFrame *stack_frame,
 
     std::shared_ptr<DbgObject> expression_obj;
     hr = compiled_expression.evaluator->Evaluate(
-        &expression_obj, eval_coordinator, obj_factory, GetErrorStream());
+        &expression_obj, eval_coordinator, obj_factory, ErrorStream(this));
     if (FAILED(hr)) {
       WriteError("Failed to evaluate expression: " + expression + ".");
       return hr;
     }
 
+    if (is_slice && expression_obj) {
+      hr = expression_obj->SetCollectionWindow(window);
+      if (FAILED(hr)) {
+        WriteError("Expression " + collection_expression +
+                   " is not a collection that can be sliced.");
+        return hr;
+      }
+    }
+
     expressions_map_[expression] = expression_obj;
   }
 
@@ -199,22 +226,27 @@ HRESULT DbgBreakpoint::EvaluateCondition(IDbgStackFrame *stack_frame,
     return S_OK;
   }
 
-  CompiledExpression compiled_expression = CompileExpression(condition_);
-  if (compiled_expression.evaluator == nullptr) {
-    // TODO(quoct): Get the error from CompileExpression.
-    return E_FAIL;
-  }
+  CompiledExpression compiled_expression;
+  HRESULT hr;
+  {
+    ScopedPhaseTimer timer(MetricPhase::kConditionCompile, id_);
+    compiled_expression = CompileExpression(condition_);
+    if (compiled_expression.evaluator == nullptr) {
+      // TODO(quoct): Get the error from CompileExpression.
+      return E_FAIL;
+    }
 
-  CComPtr<ICorDebugILFrame> active_frame;
-  HRESULT hr = eval_coordinator->GetActiveDebugFrame(&active_frame);
-  if (FAILED(hr)) {
-    return hr;
-  }
+    CComPtr<ICorDebugILFrame> active_frame;
+    hr = eval_coordinator->GetActiveDebugFrame(&active_frame);
+    if (FAILED(hr)) {
+      return hr;
+    }
 
-  hr = compiled_expression.evaluator->Compile(stack_frame, active_frame,
-                                              GetErrorStream());
-  if (FAILED(hr)) {
-    return hr;
+    hr = compiled_expression.evaluator->Compile(stack_frame, active_frame,
+                                                ErrorStream(this));
+    if (FAILED(hr)) {
+      return hr;
+    }
   }
 
   const TypeSignature &type_sig =
@@ -225,10 +257,13 @@ HRESULT DbgBreakpoint::EvaluateCondition(IDbgStackFrame *stack_frame,
   }
 
   std::shared_ptr<DbgObject> condition_result;
-  hr = compiled_expression.evaluator->Evaluate(
-      &condition_result, eval_coordinator, obj_factory, GetErrorStream());
-  if (FAILED(hr)) {
-    return hr;
+  {
+    ScopedPhaseTimer timer(MetricPhase::kConditionEvaluate, id_);
+    hr = compiled_expression.evaluator->Evaluate(
+        &condition_result, eval_coordinator, obj_factory, ErrorStream(this));
+    if (FAILED(hr)) {
+      return hr;
+    }
   }
 
   return NumericCompilerHelper::ExtractPrimitiveValue<bool>(
@@ -263,21 +298,56 @@ HRESULT DbgBreakpoint::PopulateBreakpoint(Breakpoint *breakpoint,
   location->set_line(line_);
   location->set_path(file_name_);
 
+  std::uint64_t stack_fingerprint = stack_frames->GetStackFingerprint();
+  breakpoint->set_stack_fingerprint(stack_fingerprint);
+  if (capture_profile_.stack_dedup_window_ms > 0) {
+    std::uint32_t hit_count = stack_hit_counter_.RecordHit(
+        stack_fingerprint,
+        milliseconds(capture_profile_.stack_dedup_window_ms),
+        steady_clock::now());
+    breakpoint->set_hit_count(hit_count);
+    if (hit_count > 1) {
+      return S_FALSE;
+    }
+  }
+
   eval_coordinator->WaitForReadySignal();
 
-  if (!expressions_map_.empty()) {
+  ScopedPhaseTimer timer(MetricPhase::kVariableCapture, id_);
+  current_max_collection_size_ = capture_profile_.max_collection_size;
+  current_max_string_length_ = capture_profile_.max_string_length;
+  if (!expressions_map_.empty() && !capture_profile_.stack_only) {
     HRESULT hr = PopulateExpression(breakpoint, eval_coordinator);
     if (FAILED(hr)) {
       return hr;
     }
   }
 
-  return stack_frames->PopulateStackFrames(breakpoint, eval_coordinator);
+  return stack_frames->PopulateStackFrames(breakpoint, capture_profile_,
+                                           eval_coordinator);
+}
+
+void DbgBreakpoint::TakeHitCountUpdates(bool flush_all,
+                                        vector<Breakpoint> *updates) {
+  vector<std::pair<std::uint64_t, std::uint32_t>> ended_windows;
+  stack_hit_counter_.TakeEndedWindows(
+      milliseconds(capture_profile_.stack_dedup_window_ms),
+      steady_clock::now(), flush_all, &ended_windows);
+
+  for (auto &&ended_window : ended_windows) {
+    Breakpoint update;
+    update.set_id(id_);
+    update.mutable_location()->set_line(line_);
+    update.mutable_location()->set_path(file_name_);
+    update.set_stack_fingerprint(ended_window.first);
+    update.set_hit_count(ended_window.second);
+    updates->push_back(std::move(update));
+  }
 }
 
 HRESULT DbgBreakpoint::PopulateExpression(Breakpoint *breakpoint,
                                           IEvalCoordinator *eval_coordinator) {
-  std::queue<VariableWrapper> bfs_queue;
+  VariableWrapperQueue bfs_queue;
 
   for (auto &&kvp : expressions_map_) {
     Variable *expression_proto = breakpoint->add_evaluated_expressions();
@@ -292,14 +362,16 @@ HRESULT DbgBreakpoint::PopulateExpression(Breakpoint *breakpoint,
   }
 
   if (bfs_queue.size() != 0) {
-    current_max_collection_size_ = kMaximumCollectionExpressionSize;
+    current_max_collection_size_ =
+        capture_profile_.max_expression_collection_size;
+    std::uint32_t max_breakpoint_size = capture_profile_.max_breakpoint_size;
     HRESULT hr = VariableWrapper::PerformBFS(
         &bfs_queue,
-        [breakpoint]() {
-          return breakpoint->ByteSize() > DbgBreakpoint::kMaximumBreakpointSize;
+        [breakpoint, max_breakpoint_size]() {
+          return breakpoint->ByteSize() > max_breakpoint_size;
         },
-        eval_coordinator);
-    current_max_collection_size_ = kMaximumCollectionSize;
+        eval_coordinator, capture_profile_.max_object_depth);
+    current_max_collection_size_ = capture_profile_.max_collection_size;
     return hr;
   }
 
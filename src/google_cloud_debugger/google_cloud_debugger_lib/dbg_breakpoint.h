@@ -21,9 +21,11 @@
 #include <vector>
 
 #include "breakpoint.pb.h"
+#include "capture_profile.h"
 #include "ccomptr.h"
 #include "cor.h"
 #include "cordebug.h"
+#include "stack_fingerprint.h"
 #include "string_stream_wrapper.h"
 
 namespace google_cloud_debugger_portable_pdb {
@@ -122,6 +124,14 @@ class DbgBreakpoint : public StringStreamWrapper {
   // Sets whether this breakpoint should kill the server.
   void SetKillServer(bool kill_server) { kill_server_ = kill_server; }
 
+  // Returns the capture limits of the breakpoint.
+  const CaptureProfile &GetCaptureProfile() const { return capture_profile_; }
+
+  // Sets the capture limits of the breakpoint.
+  void SetCaptureProfile(const CaptureProfile &capture_profile) {
+    capture_profile_ = capture_profile;
+  }
+
   // Returns the condition of the breakpoint.
   const std::string &GetCondition() const { return condition_; }
 
@@ -167,23 +177,40 @@ class DbgBreakpoint : public StringStreamWrapper {
   //
   // This function assumes that the Initialize function of stack_frames
   // are already called (so stack_frames are already populated with variables).
+  // If the same call stack was already captured in the deduplication window
+  // of the breakpoint, the hit is only counted and S_FALSE is returned
+  // with only the id, location, stack fingerprint and hit count populated.
+  // Such a breakpoint should not be written: the count is reported once
+  // the window ends by TakeHitCountUpdates.
   HRESULT PopulateBreakpoint(
       google::cloud::diagnostics::debug::Breakpoint *breakpoint,
       IStackFrameCollection *stack_frames, IEvalCoordinator *eval_coordinator);
 
-  // Breakpoint proto's size should not contain more bytes of
-  // information than this number. (65536 bytes = 64kb).
-  static const std::uint32_t kMaximumBreakpointSize = 65536;
+  // Appends to updates a Breakpoint proto with the id, location, stack
+  // fingerprint and hit count of every deduplication window that ended
+  // with more than one hit. If flush_all is true, the windows that
+  // have not ended yet are reported too (used when the breakpoint
+  // is removed).
+  void TakeHitCountUpdates(
+      bool flush_all,
+      std::vector<google::cloud::diagnostics::debug::Breakpoint> *updates);
 
   // Gets the maximum collection size for breakpoints.
   static std::uint32_t GetMaximumCollectionSize() {
     return current_max_collection_size_;
   }
 
+  // Gets the maximum number of characters captured from a string.
+  static std::uint32_t GetMaximumStringLength() {
+    return current_max_string_length_;
+  }
+
  private:
   // Populates breakpoint with the evaluated expressions stored
   // in the dictionary expression_map_.
-  // This will sets the maximum collection size of DbgBreakpoint to 1000.
+  // The maximum collection size of DbgBreakpoint is the maximum expression
+  // collection size of the capture profile while the expressions are
+  // populated.
   HRESULT PopulateExpression(
       google::cloud::diagnostics::debug::Breakpoint *breakpoint,
       IEvalCoordinator *eval_coordinator);
@@ -238,16 +265,18 @@ class DbgBreakpoint : public StringStreamWrapper {
   // True if this breakpoint should kill the server it was sent to.
   bool kill_server_ = false;
 
+  // The capture limits of this breakpoint.
+  CaptureProfile capture_profile_ = CaptureProfile::GetDefault();
+
+  // Hits of this breakpoint per call stack in the deduplication window.
+  StackHitCounter stack_hit_counter_;
+
   // The current maximum number of items in a collection that we will expand.
   static std::int32_t current_max_collection_size_;
 
-  // Maximum amount of items returned in a collection when not evaluating
-  // an expression.
-  static const std::uint32_t kMaximumCollectionSize = 10;
-
-  // Maximum amount of items returned in a collection when evaluating
-  // an expression.
-  static const std::uint32_t kMaximumCollectionExpressionSize = UINT32_MAX;
+  // The current maximum number of characters captured from a string.
+  // Unlike the collection size, this also applies to expressions.
+  static std::uint32_t current_max_string_length_;
 };
 
 }  // namespace google_cloud_debugger
@@ -25,9 +25,11 @@
 #include "i_cor_debug_helper.h"
 #include "i_dbg_object_factory.h"
 #include "i_eval_coordinator.h"
+#include "string_stream_wrapper.h"
 #include "variable_wrapper.h"
 
 using google::cloud::diagnostics::debug::Variable;
+using std::make_pair;
 using std::min;
 using std::shared_ptr;
 using std::string;
@@ -49,6 +51,64 @@ const string DbgBuiltinCollection::kHashSetAndDictHashCodeFieldName =
     "hashCode";
 const string DbgBuiltinCollection::kCountProtoFieldName = "Count";
 
+// Fields of Queue<T> and Stack<T>. The size is kListSizeFieldName.
+static const string kQueueAndStackArrayFieldName = "_array";
+static const string kQueueHeadFieldName = "_head";
+
+// Fields of LinkedList<T> and LinkedListNode<T>.
+static const string kLinkedListHeadFieldName = "head";
+static const string kLinkedListCountFieldName = "count";
+static const string kLinkedListNodeNextFieldName = "next";
+static const string kLinkedListNodeItemFieldName = "item";
+
+// Fields of SortedDictionary<TKey, TValue>, of the SortedSet it uses
+// and of the nodes of the SortedSet.
+static const string kSortedDictionarySetFieldName = "_set";
+static const string kSortedSetRootFieldName = "root";
+static const string kSortedSetCountFieldName = "count";
+static const string kSortedSetNodeLeftFieldName = "Left";
+static const string kSortedSetNodeRightFieldName = "Right";
+static const string kSortedSetNodeItemFieldName = "Item";
+
+// Fields of ConcurrentDictionary<TKey, TValue>, of its tables and of
+// the nodes in the buckets of the tables.
+static const string kConcurrentDictionaryTablesFieldName = "_tables";
+static const string kConcurrentTablesBucketsFieldName = "_buckets";
+static const string kConcurrentTablesCountPerLockFieldName = "_countPerLock";
+static const string kConcurrentNodeKeyFieldName = "_key";
+static const string kConcurrentNodeValueFieldName = "_value";
+static const string kConcurrentNodeNextFieldName = "_next";
+
+// Field of ImmutableArray<T>.
+static const string kImmutableArrayArrayFieldName = "array";
+
+// Fields of ImmutableList<T> and of the nodes of its tree.
+static const string kImmutableListRootFieldName = "_root";
+static const string kImmutableListNodeLeftFieldName = "_left";
+static const string kImmutableListNodeRightFieldName = "_right";
+static const string kImmutableListNodeKeyFieldName = "_key";
+static const string kImmutableListNodeCountFieldName = "_count";
+
+// Fields of ArraySegment<T>.
+static const string kArraySegmentArrayFieldName = "_array";
+static const string kArraySegmentOffsetFieldName = "_offset";
+static const string kArraySegmentCountFieldName = "_count";
+
+bool DbgBuiltinCollection::IsBuiltinCollection(const string &class_name) {
+  static const std::array<const string *, 11> kCollectionClassNames = {
+      {&kListClassName, &kHashSetClassName, &kDictionaryClassName,
+       &kQueueClassName, &kStackClassName, &kLinkedListClassName,
+       &kSortedDictionaryClassName, &kConcurrentDictionaryClassName,
+       &kImmutableArrayClassName, &kImmutableListClassName,
+       &kArraySegmentClassName}};
+  for (const string *collection_class_name : kCollectionClassNames) {
+    if (collection_class_name->compare(class_name) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
 HRESULT DbgBuiltinCollection::ProcessClassMembersHelper(
     ICorDebugValue *debug_value, ICorDebugClass *debug_class,
     IMetaDataImport *metadata_import) {
@@ -66,15 +126,6 @@ HRESULT DbgBuiltinCollection::ProcessClassMembersHelper(
     class_type_ = ClassType::LIST;
     hr = ProcessCollectionType(debug_obj_value, debug_class, metadata_import,
                                kListSizeFieldName, kListItemsFieldName);
-    if (SUCCEEDED(hr)) {
-      // Makes sure we don't grab more items than we need (this can happen
-      // because if a list size is 2, the underlying items_ array can have 4
-      // items).
-      if (count_ < DbgBreakpoint::GetMaximumCollectionSize()) {
-        (reinterpret_cast<DbgArray *>(collection_items_.get()))
-            ->SetMaxArrayItemsToRetrieve(count_);
-      }
-    }
     return hr;
   }
 
@@ -114,6 +165,47 @@ HRESULT DbgBuiltinCollection::ProcessClassMembersHelper(
                                  kDictionaryItemsFieldName);
   }
 
+  // The collections below are read item by item into entries_.
+  if (kQueueClassName.compare(class_name_) == 0) {
+    class_type_ = ClassType::QUEUE;
+    return DecodeQueueOrStack(debug_value);
+  }
+
+  if (kStackClassName.compare(class_name_) == 0) {
+    class_type_ = ClassType::STACK;
+    return DecodeQueueOrStack(debug_value);
+  }
+
+  if (kLinkedListClassName.compare(class_name_) == 0) {
+    class_type_ = ClassType::LINKED_LIST;
+    return DecodeLinkedList(debug_value);
+  }
+
+  if (kSortedDictionaryClassName.compare(class_name_) == 0) {
+    class_type_ = ClassType::SORTED_DICTIONARY;
+    return DecodeSortedDictionary(debug_value);
+  }
+
+  if (kConcurrentDictionaryClassName.compare(class_name_) == 0) {
+    class_type_ = ClassType::CONCURRENT_DICTIONARY;
+    return DecodeConcurrentDictionary(debug_value);
+  }
+
+  if (kImmutableArrayClassName.compare(class_name_) == 0) {
+    class_type_ = ClassType::IMMUTABLE_ARRAY;
+    return DecodeImmutableArray(debug_value);
+  }
+
+  if (kImmutableListClassName.compare(class_name_) == 0) {
+    class_type_ = ClassType::IMMUTABLE_LIST;
+    return DecodeImmutableList(debug_value);
+  }
+
+  if (kArraySegmentClassName.compare(class_name_) == 0) {
+    class_type_ = ClassType::ARRAY_SEGMENT;
+    return DecodeArraySegment(debug_value);
+  }
+
   return E_NOTIMPL;
 }
 
@@ -148,7 +240,7 @@ HRESULT DbgBuiltinCollection::ProcessCollectionType(
 }
 
 HRESULT DbgBuiltinCollection::PopulateMembers(
-    Variable *variable_proto, vector<VariableWrapper> *members,
+    Variable *variable_proto, VariableWrapperVector *members,
     IEvalCoordinator *eval_coordinator) {
   if (!members) {
     return E_INVALIDARG;
@@ -183,7 +275,38 @@ HRESULT DbgBuiltinCollection::PopulateMembers(
   list_count->set_value(std::to_string(count_));
   list_count->set_type(kInt32ClassName);
 
+  switch (class_type_) {
+    case ClassType::QUEUE:
+    case ClassType::STACK:
+    case ClassType::IMMUTABLE_ARRAY:
+    case ClassType::ARRAY_SEGMENT:
+      return PopulateBackingArrayItems(variable_proto, members);
+    case ClassType::LINKED_LIST:
+    case ClassType::SORTED_DICTIONARY:
+    case ClassType::CONCURRENT_DICTIONARY:
+    case ClassType::IMMUTABLE_LIST:
+      return PopulateEntries(variable_proto, members);
+    default:
+      break;
+  }
+
   if (class_type_ == ClassType::LIST && collection_items_) {
+    // Makes sure we don't grab more items than we need (this can happen
+    // because if a list size is 2, the underlying items_ array can have 4
+    // items).
+    CollectionWindow items_window;
+    items_window.first_item = window_.first_item;
+    items_window.max_items = 0;
+    if (static_cast<int32_t>(window_.first_item) < count_) {
+      uint32_t items_left = static_cast<uint32_t>(count_) - window_.first_item;
+      items_window.max_items = min(window_.max_items, items_left);
+    }
+
+    hr = collection_items_->SetCollectionWindow(items_window);
+    if (FAILED(hr)) {
+      return hr;
+    }
+
     return collection_items_->PopulateMembers(variable_proto, members,
                                               eval_coordinator);
   }
@@ -201,13 +324,22 @@ HRESULT DbgBuiltinCollection::PopulateMembers(
 
 HRESULT DbgBuiltinCollection::PopulateHashSetOrDictionary(
     google::cloud::diagnostics::debug::Variable *variable_proto,
-    vector<VariableWrapper> *members, IEvalCoordinator *eval_coordinator) {
+    VariableWrapperVector *members, IEvalCoordinator *eval_coordinator) {
   // Start fetching items from the hash set or dictionary.
   HRESULT hr;
   int32_t index = 0;
-  int32_t current_max_size = DbgBreakpoint::GetMaximumCollectionSize();
-  int32_t max_items_to_fetch = min(count_, current_max_size);
-  int32_t items_fetched_so_far = 0;
+  // Items before window_ are skipped since the slots are not contiguous.
+  if (count_ <= static_cast<int32_t>(window_.first_item)) {
+    return S_OK;
+  }
+  uint32_t max_items_to_fetch =
+      min(static_cast<uint32_t>(count_) - window_.first_item,
+          GetMaximumItemsInWindow());
+  if (max_items_to_fetch == 0) {
+    return S_OK;
+  }
+  uint32_t items_fetched_so_far = 0;
+  uint32_t items_skipped_so_far = 0;
   // Casts the collection_items_ to an array.
   DbgArray *slots_array = reinterpret_cast<DbgArray *>(collection_items_.get());
   // We get items from the _items array. If this is a hash set, we have to make
@@ -238,7 +370,7 @@ HRESULT DbgBuiltinCollection::PopulateHashSetOrDictionary(
     // that the dictionary entry has a key.
     unique_ptr<DbgObject> slot_item_obj;
     hr = object_factory_->CreateDbgObject(array_item, GetCreationDepth(),
-                                          &slot_item_obj, GetErrorStream());
+                                          &slot_item_obj, ErrorStream(this));
     if (FAILED(hr)) {
       WriteError("Failed to create DbgObject for item at index " +
                  std::to_string(index));
@@ -269,6 +401,11 @@ HRESULT DbgBuiltinCollection::PopulateHashSetOrDictionary(
       continue;
     }
 
+    if (items_skipped_so_far < window_.first_item) {
+      ++items_skipped_so_far;
+      continue;
+    }
+
     // Gets the underlying DbgObject that represents value field.
     shared_ptr<DbgObject> value_obj = nullptr;
     hr =
@@ -292,7 +429,8 @@ HRESULT DbgBuiltinCollection::PopulateHashSetOrDictionary(
 
     // Now creates a member that represents this item.
     Variable *item_proto = variable_proto->add_members();
-    item_proto->set_name("[" + std::to_string(items_fetched_so_far) + "]");
+    item_proto->set_name(
+        "[" + std::to_string(window_.first_item + items_fetched_so_far) + "]");
 
     // For hash set, just display item as [index]: value.
     if (class_type_ == ClassType::SET) {
@@ -319,4 +457,711 @@ HRESULT DbgBuiltinCollection::PopulateHashSetOrDictionary(
   return S_OK;
 }
 
+HRESULT DbgBuiltinCollection::PopulateEntries(
+    Variable *variable_proto, VariableWrapperVector *members) {
+  for (size_t index = 0; index < entries_.size(); ++index) {
+    const CollectionEntry &entry = entries_[index];
+    Variable *item_proto = variable_proto->add_members();
+    item_proto->set_name("[" + std::to_string(window_.first_item + index) +
+                         "]");
+
+    if (!entry.key) {
+      members->push_back(VariableWrapper(item_proto, entry.value));
+      continue;
+    }
+
+    // Items of dictionaries are displayed the same way as the items of
+    // Dictionary: [index]: { "key": Key, "value": Value }
+    Variable *key_proto = item_proto->add_members();
+    key_proto->set_name(kDictionaryKeyFieldName);
+    members->push_back(VariableWrapper(key_proto, entry.key));
+
+    Variable *value_proto = item_proto->add_members();
+    value_proto->set_name(kHashSetAndDictValueFieldName);
+    members->push_back(VariableWrapper(value_proto, entry.value));
+  }
+
+  return S_OK;
+}
+
+HRESULT DbgBuiltinCollection::PopulateBackingArrayItems(
+    Variable *variable_proto, VariableWrapperVector *members) {
+  DbgArray *backing_array =
+      reinterpret_cast<DbgArray *>(collection_items_.get());
+  if (!backing_array || backing_array_length_ <= 0 ||
+      count_ <= static_cast<int32_t>(window_.first_item)) {
+    return S_OK;
+  }
+
+  uint32_t item_count = min(static_cast<uint32_t>(count_) - window_.first_item,
+                            GetMaximumItemsInWindow());
+  for (uint32_t item = 0; item < item_count; ++item) {
+    // Seeks directly to the first item of window_.
+    int64_t position = window_.first_item + item;
+    int64_t index = backing_array_reversed_
+                        ? backing_array_first_index_ - position
+                        : backing_array_first_index_ + position;
+    index %= backing_array_length_;
+    if (index < 0) {
+      index += backing_array_length_;
+    }
+
+    Variable *item_proto = variable_proto->add_members();
+    item_proto->set_name("[" + std::to_string(position) + "]");
+
+    CComPtr<ICorDebugValue> array_item;
+    HRESULT hr =
+        backing_array->GetArrayItem(static_cast<int>(index), &array_item);
+    if (FAILED(hr)) {
+      WriteError("Failed to get item at index " + std::to_string(index));
+      return hr;
+    }
+
+    unique_ptr<DbgObject> item_obj;
+    hr = object_factory_->CreateDbgObject(array_item, GetCreationDepth() - 1,
+                                          &item_obj, ErrorStream(this));
+    if (FAILED(hr)) {
+      WriteError("Failed to create DbgObject for item at index " +
+                 std::to_string(index));
+      return hr;
+    }
+
+    members->push_back(VariableWrapper(item_proto, std::move(item_obj)));
+  }
+
+  return S_OK;
+}
+
+HRESULT DbgBuiltinCollection::DecodeQueueOrStack(ICorDebugValue *debug_value) {
+  CComPtr<ICorDebugArrayValue> array_value;
+  int32_t length = 0;
+  HRESULT hr = GetArrayFieldValue(debug_value, kQueueAndStackArrayFieldName,
+                                  &array_value, &length);
+  if (FAILED(hr)) {
+    return hr;
+  }
+
+  hr = GetInt32FieldValue(debug_value, kListSizeFieldName, &count_);
+  if (FAILED(hr) || !array_value || length == 0) {
+    return hr;
+  }
+
+  if (class_type_ == ClassType::STACK) {
+    // The top of the stack is the last item of the array.
+    return SetBackingArray(array_value, length, count_ - 1, true);
+  }
+
+  int32_t head = 0;
+  hr = GetInt32FieldValue(debug_value, kQueueHeadFieldName, &head);
+  if (FAILED(hr)) {
+    return hr;
+  }
+
+  return SetBackingArray(array_value, length, head, false);
+}
+
+HRESULT DbgBuiltinCollection::DecodeLinkedList(ICorDebugValue *debug_value) {
+  HRESULT hr =
+      GetInt32FieldValue(debug_value, kLinkedListCountFieldName, &count_);
+  if (FAILED(hr)) {
+    return hr;
+  }
+
+  BOOL is_null = FALSE;
+  CComPtr<ICorDebugValue> node;
+  hr = GetDereferencedFieldValue(debug_value, kLinkedListHeadFieldName, &node,
+                                 &is_null);
+  if (FAILED(hr)) {
+    return hr;
+  }
+
+  // The list is circular so it is only walked count_ times.
+  for (int32_t index = 0; index < count_ && !is_null && !EntriesFull();
+       ++index) {
+    if (!SkipItem()) {
+      CComPtr<ICorDebugValue> item;
+      hr = GetFieldValue(node, kLinkedListNodeItemFieldName, &item);
+      if (FAILED(hr)) {
+        return hr;
+      }
+
+      hr = AddEntry(nullptr, item);
+      if (FAILED(hr)) {
+        return hr;
+      }
+    }
+
+    CComPtr<ICorDebugValue> next_node;
+    hr = GetDereferencedFieldValue(node, kLinkedListNodeNextFieldName,
+                                   &next_node, &is_null);
+    if (FAILED(hr)) {
+      return hr;
+    }
+    node = next_node;
+  }
+
+  return S_OK;
+}
+
+HRESULT DbgBuiltinCollection::DecodeSortedDictionary(
+    ICorDebugValue *debug_value) {
+  BOOL is_null = FALSE;
+  CComPtr<ICorDebugValue> sorted_set;
+  HRESULT hr = GetDereferencedFieldValue(
+      debug_value, kSortedDictionarySetFieldName, &sorted_set, &is_null);
+  if (FAILED(hr) || is_null) {
+    return hr;
+  }
+
+  hr = GetInt32FieldValue(sorted_set, kSortedSetCountFieldName, &count_);
+  if (FAILED(hr)) {
+    return hr;
+  }
+
+  CComPtr<ICorDebugValue> root;
+  hr = GetDereferencedFieldValue(sorted_set, kSortedSetRootFieldName, &root,
+                                 &is_null);
+  if (FAILED(hr) || is_null) {
+    return hr;
+  }
+
+  return DecodeBinaryTree(root, kSortedSetNodeLeftFieldName,
+                          kSortedSetNodeRightFieldName,
+                          kSortedSetNodeItemFieldName, "", false, true);
+}
+
+HRESULT DbgBuiltinCollection::DecodeConcurrentDictionary(
+    ICorDebugValue *debug_value) {
+  BOOL is_null = FALSE;
+  CComPtr<ICorDebugValue> tables;
+  HRESULT hr = GetDereferencedFieldValue(
+      debug_value, kConcurrentDictionaryTablesFieldName, &tables, &is_null);
+  if (FAILED(hr) || is_null) {
+    return hr;
+  }
+
+  // The count of the dictionary is split across its locks.
+  CComPtr<ICorDebugArrayValue> count_per_lock;
+  int32_t lock_count = 0;
+  hr = GetArrayFieldValue(tables, kConcurrentTablesCountPerLockFieldName,
+                          &count_per_lock, &lock_count);
+  if (FAILED(hr)) {
+    return hr;
+  }
+
+  count_ = 0;
+  for (int32_t index = 0; index < lock_count; ++index) {
+    CComPtr<ICorDebugValue> lock_count_value;
+    hr = count_per_lock->GetElementAtPosition(index, &lock_count_value);
+    if (FAILED(hr)) {
+      WriteError("Failed to get the count of lock " + std::to_string(index));
+      return hr;
+    }
+
+    CComPtr<ICorDebugGenericValue> generic_value;
+    hr = lock_count_value->QueryInterface(
+        __uuidof(ICorDebugGenericValue),
+        reinterpret_cast<void **>(&generic_value));
+    if (FAILED(hr)) {
+      WriteError("Failed to get the count of lock " + std::to_string(index));
+      return hr;
+    }
+
+    int32_t count = 0;
+    hr = generic_value->GetValue(&count);
+    if (FAILED(hr)) {
+      WriteError("Failed to get the count of lock " + std::to_string(index));
+      return hr;
+    }
+    count_ += count;
+  }
+
+  CComPtr<ICorDebugArrayValue> buckets;
+  int32_t bucket_count = 0;
+  hr = GetArrayFieldValue(tables, kConcurrentTablesBucketsFieldName, &buckets,
+                          &bucket_count);
+  if (FAILED(hr)) {
+    return hr;
+  }
+
+  // Stops once all the items are read so the empty buckets at the end
+  // of the table are not read.
+  for (int32_t index = 0;
+       index < bucket_count && !EntriesFull() &&
+       entries_.size() + skipped_items_ < static_cast<size_t>(count_);
+       ++index) {
+    CComPtr<ICorDebugValue> bucket;
+    hr = buckets->GetElementAtPosition(index, &bucket);
+    if (FAILED(hr)) {
+      WriteError("Failed to get bucket " + std::to_string(index));
+      return hr;
+    }
+
+    CComPtr<ICorDebugValue> node;
+    hr = debug_helper_->Dereference(bucket, &node, &is_null, ErrorStream(this));
+    if (FAILED(hr)) {
+      return hr;
+    }
+
+    while (!is_null && !EntriesFull()) {
+      if (!SkipItem()) {
+        CComPtr<ICorDebugValue> key;
+        hr = GetFieldValue(node, kConcurrentNodeKeyFieldName, &key);
+        if (FAILED(hr)) {
+          return hr;
+        }
+
+        CComPtr<ICorDebugValue> value;
+        hr = GetFieldValue(node, kConcurrentNodeValueFieldName, &value);
+        if (FAILED(hr)) {
+          return hr;
+        }
+
+        hr = AddEntry(key, value);
+        if (FAILED(hr)) {
+          return hr;
+        }
+      }
+
+      CComPtr<ICorDebugValue> next_node;
+      hr = GetDereferencedFieldValue(node, kConcurrentNodeNextFieldName,
+                                     &next_node, &is_null);
+      if (FAILED(hr)) {
+        return hr;
+      }
+      node = next_node;
+    }
+  }
+
+  return S_OK;
+}
+
+HRESULT DbgBuiltinCollection::DecodeImmutableArray(
+    ICorDebugValue *debug_value) {
+  // The array of a default ImmutableArray is null.
+  CComPtr<ICorDebugArrayValue> array_value;
+  HRESULT hr = GetArrayFieldValue(debug_value, kImmutableArrayArrayFieldName,
+                                  &array_value, &count_);
+  if (FAILED(hr) || !array_value) {
+    return hr;
+  }
+
+  return SetBackingArray(array_value, count_, 0, false);
+}
+
+HRESULT DbgBuiltinCollection::DecodeImmutableList(ICorDebugValue *debug_value) {
+  BOOL is_null = FALSE;
+  CComPtr<ICorDebugValue> root;
+  HRESULT hr = GetDereferencedFieldValue(
+      debug_value, kImmutableListRootFieldName, &root, &is_null);
+  if (FAILED(hr) || is_null) {
+    return hr;
+  }
+
+  hr = GetInt32FieldValue(root, kImmutableListNodeCountFieldName, &count_);
+  if (FAILED(hr)) {
+    return hr;
+  }
+
+  return DecodeBinaryTree(root, kImmutableListNodeLeftFieldName,
+                          kImmutableListNodeRightFieldName,
+                          kImmutableListNodeKeyFieldName,
+                          kImmutableListNodeCountFieldName, true, false);
+}
+
+HRESULT DbgBuiltinCollection::DecodeArraySegment(ICorDebugValue *debug_value) {
+  CComPtr<ICorDebugArrayValue> array_value;
+  int32_t length = 0;
+  HRESULT hr = GetArrayFieldValue(debug_value, kArraySegmentArrayFieldName,
+                                  &array_value, &length);
+  if (FAILED(hr) || !array_value) {
+    return hr;
+  }
+
+  int32_t offset = 0;
+  hr = GetInt32FieldValue(debug_value, kArraySegmentOffsetFieldName, &offset);
+  if (FAILED(hr)) {
+    return hr;
+  }
+
+  hr = GetInt32FieldValue(debug_value, kArraySegmentCountFieldName, &count_);
+  if (FAILED(hr) || length == 0) {
+    return hr;
+  }
+
+  return SetBackingArray(array_value, length, offset, false);
+}
+
+HRESULT DbgBuiltinCollection::SetBackingArray(ICorDebugArrayValue *array_value,
+                                              int32_t length,
+                                              int32_t first_index,
+                                              bool reverse) {
+  // The DbgArray holds a handle to the array so its items can still be
+  // read by PopulateMembers after functions are evaluated.
+  HRESULT hr = object_factory_->CreateDbgObject(
+      array_value, GetCreationDepth(), &collection_items_, ErrorStream(this));
+  if (FAILED(hr)) {
+    WriteError("Failed to create DbgObject for the items of the collection.");
+    return hr;
+  }
+
+  backing_array_length_ = length;
+  backing_array_first_index_ = first_index;
+  backing_array_reversed_ = reverse;
+  return S_OK;
+}
+
+HRESULT DbgBuiltinCollection::DecodeBinaryTree(ICorDebugValue *root,
+                                               const string &left_field,
+                                               const string &right_field,
+                                               const string &item_field,
+                                               const string &count_field,
+                                               bool has_empty_nodes,
+                                               bool items_are_pairs) {
+  // Nodes whose left subtree is read but not the node itself.
+  vector<CComPtr<ICorDebugValue>> path;
+  CComPtr<ICorDebugValue> node;
+  node = root;
+  HRESULT hr;
+
+  while (!EntriesFull()) {
+    // Goes down to the leftmost node that is not read yet.
+    while (node) {
+      BOOL left_is_null = FALSE;
+      CComPtr<ICorDebugValue> left_node;
+      hr = GetDereferencedFieldValue(node, left_field, &left_node,
+                                     &left_is_null);
+      if (FAILED(hr)) {
+        return hr;
+      }
+
+      // Only empty nodes have no left node if there are empty nodes.
+      if (has_empty_nodes && left_is_null) {
+        break;
+      }
+
+      if (path.size() >= kMaximumTreeDepth) {
+        WriteError("The tree of the collection is too deep.");
+        return E_FAIL;
+      }
+
+      // Skips the whole left subtree if all its items are before window_.
+      if (!left_is_null && !count_field.empty() &&
+          skipped_items_ < window_.first_item) {
+        int32_t left_count = 0;
+        hr = GetInt32FieldValue(left_node, count_field, &left_count);
+        if (FAILED(hr)) {
+          return hr;
+        }
+
+        if (static_cast<std::uint32_t>(left_count) <=
+            window_.first_item - skipped_items_) {
+          skipped_items_ += left_count;
+          left_is_null = TRUE;
+        }
+      }
+
+      path.push_back(node);
+      if (left_is_null) {
+        node.Release();
+      } else {
+        node = left_node;
+      }
+    }
+
+    if (path.empty()) {
+      break;
+    }
+
+    node = path.back();
+    path.pop_back();
+
+    if (!SkipItem()) {
+      CComPtr<ICorDebugValue> item;
+      hr = GetFieldValue(node, item_field, &item);
+      if (FAILED(hr)) {
+        return hr;
+      }
+
+      hr = items_are_pairs ? AddKeyValuePairEntry(item)
+                           : AddEntry(nullptr, item);
+      if (FAILED(hr)) {
+        return hr;
+      }
+    }
+
+    BOOL right_is_null = FALSE;
+    CComPtr<ICorDebugValue> right_node;
+    hr = GetDereferencedFieldValue(node, right_field, &right_node,
+                                   &right_is_null);
+    if (FAILED(hr)) {
+      return hr;
+    }
+
+    if (right_is_null) {
+      node.Release();
+    } else {
+      node = right_node;
+    }
+  }
+
+  return S_OK;
+}
+
+HRESULT DbgBuiltinCollection::GetFieldValue(ICorDebugValue *debug_value,
+                                            const string &field_name,
+                                            ICorDebugValue **field_value) {
+  BOOL is_null = FALSE;
+  CComPtr<ICorDebugValue> object_value;
+  HRESULT hr = debug_helper_->Dereference(debug_value, &object_value, &is_null,
+                                          ErrorStream(this));
+  if (FAILED(hr)) {
+    return hr;
+  }
+
+  if (is_null) {
+    WriteError("Cannot get field " + field_name + " of a null object.");
+    return E_FAIL;
+  }
+
+  CComPtr<ICorDebugObjectValue> debug_obj_value;
+  hr = object_value->QueryInterface(
+      __uuidof(ICorDebugObjectValue),
+      reinterpret_cast<void **>(&debug_obj_value));
+  if (FAILED(hr)) {
+    WriteError("Failed to cast ICorDebugValue to ICorDebugObjValue.");
+    return hr;
+  }
+
+  CComPtr<ICorDebugClass> object_class;
+  hr = debug_obj_value->GetClass(&object_class);
+  if (FAILED(hr)) {
+    WriteError("Failed to get the class of the object.");
+    return hr;
+  }
+
+  auto field_def_key =
+      make_pair(static_cast<ICorDebugClass *>(object_class), field_name);
+  auto field_def = field_defs_.find(field_def_key);
+  if (field_def == field_defs_.end()) {
+    // The field is looked up in the class of the object, then in its base
+    // classes. Fields of generic classes are declared by the open class
+    // returned by ICorDebugType::GetClass.
+    CComPtr<ICorDebugValue2> debug_value_2;
+    hr = object_value->QueryInterface(
+        __uuidof(ICorDebugValue2), reinterpret_cast<void **>(&debug_value_2));
+    if (FAILED(hr)) {
+      WriteError("Failed to cast ICorDebugValue to ICorDebugValue2.");
+      return hr;
+    }
+
+    CComPtr<ICorDebugType> current_type;
+    hr = debug_value_2->GetExactType(&current_type);
+    if (FAILED(hr)) {
+      WriteError("Failed to get the type of the object.");
+      return hr;
+    }
+
+    std::vector<WCHAR> wchar_field_name = ConvertStringToWCharPtr(field_name);
+    std::vector<WCHAR> wchar_backing_field_name =
+        ConvertStringToWCharPtr("<" + field_name + ">k__BackingField");
+    std::pair<CComPtr<ICorDebugClass>, mdFieldDef> found_field;
+    while (current_type) {
+      CComPtr<ICorDebugClass> current_class;
+      hr = current_type->GetClass(&current_class);
+      if (FAILED(hr)) {
+        WriteError("Failed to get the class of the type.");
+        return hr;
+      }
+
+      mdTypeDef class_token;
+      hr = current_class->GetToken(&class_token);
+      if (FAILED(hr)) {
+        WriteError("Failed to get class token.");
+        return hr;
+      }
+
+      CComPtr<IMetaDataImport> metadata_import;
+      hr = debug_helper_->GetMetadataImportFromICorDebugClass(
+          current_class, &metadata_import, ErrorStream(this));
+      if (FAILED(hr)) {
+        return hr;
+      }
+
+      mdFieldDef current_field_def;
+      if (SUCCEEDED(metadata_import->FindField(
+              class_token, wchar_field_name.data(), nullptr, 0,
+              &current_field_def)) ||
+          SUCCEEDED(metadata_import->FindField(
+              class_token, wchar_backing_field_name.data(), nullptr, 0,
+              &current_field_def))) {
+        found_field.first = current_class;
+        found_field.second = current_field_def;
+        break;
+      }
+
+      CComPtr<ICorDebugType> base_type;
+      hr = current_type->GetBase(&base_type);
+      if (FAILED(hr)) {
+        break;
+      }
+      current_type = base_type;
+    }
+
+    if (!found_field.first) {
+      WriteError("Class " + class_name_ + " does not have field " +
+                 field_name);
+      return E_FAIL;
+    }
+
+    field_def_classes_.push_back(object_class);
+    field_defs_[field_def_key] = found_field;
+    field_def = field_defs_.find(field_def_key);
+  }
+
+  hr = debug_obj_value->GetFieldValue(field_def->second.first,
+                                      field_def->second.second, field_value);
+  if (FAILED(hr)) {
+    WriteError("Failed to get field " + field_name);
+  }
+  return hr;
+}
+
+HRESULT DbgBuiltinCollection::GetDereferencedFieldValue(
+    ICorDebugValue *debug_value, const string &field_name,
+    ICorDebugValue **field_value, BOOL *is_null) {
+  CComPtr<ICorDebugValue> reference_value;
+  HRESULT hr = GetFieldValue(debug_value, field_name, &reference_value);
+  if (FAILED(hr)) {
+    return hr;
+  }
+
+  return debug_helper_->Dereference(reference_value, field_value, is_null,
+                                    ErrorStream(this));
+}
+
+HRESULT DbgBuiltinCollection::GetInt32FieldValue(ICorDebugValue *debug_value,
+                                                 const string &field_name,
+                                                 int32_t *value) {
+  CComPtr<ICorDebugValue> field_value;
+  HRESULT hr = GetFieldValue(debug_value, field_name, &field_value);
+  if (FAILED(hr)) {
+    return hr;
+  }
+
+  CComPtr<ICorDebugGenericValue> generic_value;
+  hr = field_value->QueryInterface(__uuidof(ICorDebugGenericValue),
+                                   reinterpret_cast<void **>(&generic_value));
+  if (FAILED(hr)) {
+    WriteError("Failed to cast field " + field_name +
+               " to ICorDebugGenericValue.");
+    return hr;
+  }
+
+  hr = generic_value->GetValue(value);
+  if (FAILED(hr)) {
+    WriteError("Failed to get the value of field " + field_name);
+  }
+  return hr;
+}
+
+HRESULT DbgBuiltinCollection::GetArrayFieldValue(
+    ICorDebugValue *debug_value, const string &field_name,
+    ICorDebugArrayValue **array_value, int32_t *length) {
+  *length = 0;
+
+  BOOL is_null = FALSE;
+  CComPtr<ICorDebugValue> field_value;
+  HRESULT hr = GetDereferencedFieldValue(debug_value, field_name,
+                                         &field_value, &is_null);
+  if (FAILED(hr) || is_null) {
+    return hr;
+  }
+
+  CComPtr<ICorDebugArrayValue> field_array_value;
+  hr = field_value->QueryInterface(
+      __uuidof(ICorDebugArrayValue),
+      reinterpret_cast<void **>(&field_array_value));
+  if (FAILED(hr)) {
+    WriteError("Failed to cast field " + field_name +
+               " to ICorDebugArrayValue.");
+    return hr;
+  }
+
+  ULONG32 count = 0;
+  hr = field_array_value->GetCount(&count);
+  if (FAILED(hr)) {
+    WriteError("Failed to get the length of field " + field_name);
+    return hr;
+  }
+
+  *length = static_cast<int32_t>(count);
+  *array_value = field_array_value;
+  field_array_value->AddRef();
+  return S_OK;
+}
+
+HRESULT DbgBuiltinCollection::AddEntry(ICorDebugValue *key,
+                                       ICorDebugValue *value) {
+  CollectionEntry entry;
+  HRESULT hr;
+  if (key) {
+    unique_ptr<DbgObject> key_obj;
+    hr = object_factory_->CreateDbgObject(key, GetCreationDepth() - 1,
+                                          &key_obj, ErrorStream(this));
+    if (FAILED(hr)) {
+      WriteError("Failed to create DbgObject for the key of item " +
+                 std::to_string(entries_.size()));
+      return hr;
+    }
+    entry.key = std::move(key_obj);
+  }
+
+  unique_ptr<DbgObject> value_obj;
+  hr = object_factory_->CreateDbgObject(value, GetCreationDepth() - 1,
+                                        &value_obj, ErrorStream(this));
+  if (FAILED(hr)) {
+    WriteError("Failed to create DbgObject for item " +
+               std::to_string(entries_.size()));
+    return hr;
+  }
+  entry.value = std::move(value_obj);
+
+  entries_.push_back(std::move(entry));
+  return S_OK;
+}
+
+HRESULT DbgBuiltinCollection::AddKeyValuePairEntry(ICorDebugValue *pair) {
+  CComPtr<ICorDebugValue> key;
+  HRESULT hr = GetFieldValue(pair, kDictionaryKeyFieldName, &key);
+  if (FAILED(hr)) {
+    return hr;
+  }
+
+  CComPtr<ICorDebugValue> value;
+  hr = GetFieldValue(pair, kHashSetAndDictValueFieldName, &value);
+  if (FAILED(hr)) {
+    return hr;
+  }
+
+  return AddEntry(key, value);
+}
+
+bool DbgBuiltinCollection::SkipItem() {
+  if (skipped_items_ >= window_.first_item) {
+    return false;
+  }
+
+  ++skipped_items_;
+  return true;
+}
+
+std::uint32_t DbgBuiltinCollection::GetMaximumItemsInWindow() const {
+  return min(window_.max_items, DbgBreakpoint::GetMaximumCollectionSize());
+}
+
+bool DbgBuiltinCollection::EntriesFull() const {
+  return entries_.size() >= GetMaximumItemsInWindow();
+}
+
 }  // namespace google_cloud_debugger
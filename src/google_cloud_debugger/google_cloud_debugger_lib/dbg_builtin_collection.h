@@ -15,7 +15,10 @@
 #ifndef DBG_BUILTIN_COLLECTION_
 #define DBG_BUILTIN_COLLECTION_
 
+#include <map>
 #include <memory>
+#include <string>
+#include <utility>
 #include <vector>
 
 #include "dbg_class.h"
@@ -23,7 +26,10 @@
 namespace google_cloud_debugger {
 
 // Class that represents a .NET built-in collection (List, HashSet,
-// Dictionary).
+// Dictionary, Queue, Stack, LinkedList, SortedDictionary,
+// ConcurrentDictionary, ImmutableArray, ImmutableList and ArraySegment).
+// The items are read from the private fields of the collection so no
+// function evaluation is needed to display them.
 class DbgBuiltinCollection : public DbgClass {
  public:
   DbgBuiltinCollection(ICorDebugType *debug_type, int depth,
@@ -31,11 +37,24 @@ class DbgBuiltinCollection : public DbgClass {
                        std::shared_ptr<IDbgObjectFactory> obj_factory)
       : DbgClass(debug_type, depth, debug_helper, obj_factory) {}
 
+  // Returns true if class_name is the name of a collection this class
+  // can read.
+  static bool IsBuiltinCollection(const std::string &class_name);
+
   HRESULT PopulateMembers(
       google::cloud::diagnostics::debug::Variable *variable_proto,
-      std::vector<VariableWrapper> *members,
+      VariableWrapperVector *members,
       IEvalCoordinator *eval_coordinator) override;
 
+  // Makes PopulateMembers only populate the items of the collection in
+  // window. Collections backed by an array seek directly to the first
+  // item of the window; the others skip the items before it without
+  // creating DbgObjects for them.
+  HRESULT SetCollectionWindow(const CollectionWindow &window) override {
+    window_ = window;
+    return S_OK;
+  }
+
  protected:
   // Stores the items in the collection depending on whether
   // this is a list, set or dictionary.
@@ -47,10 +66,156 @@ class DbgBuiltinCollection : public DbgClass {
   // or dictionary) and the members of this hash set or dictionary.
   HRESULT PopulateHashSetOrDictionary(
       google::cloud::diagnostics::debug::Variable *variable_proto,
-      std::vector<VariableWrapper> *members,
+      VariableWrapperVector *members,
       IEvalCoordinator *eval_coordinator);
 
+  // Populates variables with the items read by one of the decoders
+  // below into entries_.
+  HRESULT PopulateEntries(
+      google::cloud::diagnostics::debug::Variable *variable_proto,
+      VariableWrapperVector *members);
+
+  // Populates variables with the items in window_ of the collection
+  // backed by the array collection_items_ (see SetBackingArray).
+  HRESULT PopulateBackingArrayItems(
+      google::cloud::diagnostics::debug::Variable *variable_proto,
+      VariableWrapperVector *members);
+
  private:
+  // An item of a collection read by one of the decoders. key is only set
+  // for dictionaries.
+  struct CollectionEntry {
+    std::shared_ptr<DbgObject> key;
+    std::shared_ptr<DbgObject> value;
+  };
+
+  // The decoders below read the count and the items in window_ of the
+  // collection debug_value into count_ and entries_. The items are read
+  // in the order the collection enumerates them. Collections backed by
+  // an array only keep the array (see SetBackingArray) so value types,
+  // which are decoded as soon as they are created, still honor a window
+  // that is set afterward.
+
+  // Queue<T> and Stack<T> keep their items in the array _array.
+  // A queue is a circular buffer starting at _head and a stack is
+  // enumerated from its top, the end of the array.
+  HRESULT DecodeQueueOrStack(ICorDebugValue *debug_value);
+
+  // LinkedList<T> is a circular list of nodes starting at head.
+  HRESULT DecodeLinkedList(ICorDebugValue *debug_value);
+
+  // SortedDictionary<TKey, TValue> keeps its KeyValuePairs in the
+  // red-black tree of the SortedSet _set.
+  HRESULT DecodeSortedDictionary(ICorDebugValue *debug_value);
+
+  // ConcurrentDictionary<TKey, TValue> keeps its items in the linked
+  // lists of the buckets of _tables, and its count in the counts of each
+  // lock of _tables.
+  HRESULT DecodeConcurrentDictionary(ICorDebugValue *debug_value);
+
+  // ImmutableArray<T> is a struct that wraps the array array.
+  HRESULT DecodeImmutableArray(ICorDebugValue *debug_value);
+
+  // ImmutableList<T> keeps its items in the AVL tree _root. The leaves
+  // of the tree point to an empty node instead of null.
+  HRESULT DecodeImmutableList(ICorDebugValue *debug_value);
+
+  // ArraySegment<T> is a struct for the _count items of _array starting
+  // at _offset.
+  HRESULT DecodeArraySegment(ICorDebugValue *debug_value);
+
+  // Keeps array_value, the array of length items backing this collection,
+  // in collection_items_. The items of the collection are the items of
+  // the array from first_index and wrapping around at the end of the
+  // array. If reverse is true, they are read backward from first_index.
+  HRESULT SetBackingArray(ICorDebugArrayValue *array_value,
+                          std::int32_t length, std::int32_t first_index,
+                          bool reverse);
+
+  // Reads the items of the binary tree root in order. Nodes have the
+  // fields left_field, right_field and item_field. If count_field is not
+  // empty, it is the field with the number of items in the subtree of
+  // a node, which is used to skip the subtrees before window_. If
+  // has_empty_nodes is true, a node whose left_field is null is empty,
+  // otherwise nodes are only empty if they are null. If items_are_pairs
+  // is true, the items are KeyValuePairs.
+  HRESULT DecodeBinaryTree(ICorDebugValue *root, const std::string &left_field,
+                           const std::string &right_field,
+                           const std::string &item_field,
+                           const std::string &count_field,
+                           bool has_empty_nodes, bool items_are_pairs);
+
+  // Returns in field_value the value of the non-static field field_name
+  // of the object debug_value. The field can be declared in a base class
+  // of the object or be the backing field of a property named
+  // field_name.
+  HRESULT GetFieldValue(ICorDebugValue *debug_value,
+                        const std::string &field_name,
+                        ICorDebugValue **field_value);
+
+  // Returns in field_value the dereferenced value of the field field_name
+  // of debug_value. is_null is set to true if the field is null.
+  HRESULT GetDereferencedFieldValue(ICorDebugValue *debug_value,
+                                    const std::string &field_name,
+                                    ICorDebugValue **field_value,
+                                    BOOL *is_null);
+
+  // Returns in value the int field field_name of debug_value.
+  HRESULT GetInt32FieldValue(ICorDebugValue *debug_value,
+                             const std::string &field_name,
+                             std::int32_t *value);
+
+  // Returns the array field field_name of debug_value in array_value and
+  // its length in length. array_value is null if the field is null.
+  HRESULT GetArrayFieldValue(ICorDebugValue *debug_value,
+                             const std::string &field_name,
+                             ICorDebugArrayValue **array_value,
+                             std::int32_t *length);
+
+  // Adds an entry with key (if not null) and value to entries_.
+  HRESULT AddEntry(ICorDebugValue *key, ICorDebugValue *value);
+
+  // Adds the key and value of the KeyValuePair pair to entries_.
+  HRESULT AddKeyValuePairEntry(ICorDebugValue *pair);
+
+  // Returns true if the next item read by a decoder is before window_
+  // and should be skipped, counting it in skipped_items_.
+  bool SkipItem();
+
+  // Returns the maximum number of items populated from window_, capped
+  // by the maximum collection size of DbgBreakpoint.
+  std::uint32_t GetMaximumItemsInWindow() const;
+
+  // Returns true if no more items should be read into entries_.
+  bool EntriesFull() const;
+
+  // Fields found by GetFieldValue, by the class of the object and the
+  // name of the field, with the class that declares them. Nodes of
+  // a collection all have the same class so each field is only looked
+  // up once.
+  std::map<std::pair<ICorDebugClass *, std::string>,
+           std::pair<CComPtr<ICorDebugClass>, mdFieldDef>>
+      field_defs_;
+
+  // Classes the field_defs_ are keyed by, kept alive for the keys.
+  std::vector<CComPtr<ICorDebugClass>> field_def_classes_;
+
+  // Items read by the decoders.
+  std::vector<CollectionEntry> entries_;
+
+  // Number of items before window_ skipped by the decoders.
+  std::uint32_t skipped_items_ = 0;
+
+  // Length of the array backing this collection, index of the first item
+  // of the collection in the array and whether the collection is read
+  // backward (see SetBackingArray).
+  std::int32_t backing_array_length_ = 0;
+  std::int32_t backing_array_first_index_ = 0;
+  bool backing_array_reversed_ = false;
+
+  // The items of the collection that are populated.
+  CollectionWindow window_;
+
   // Processes the case where the object is a collection (list, hash set
   // or a dictionary).
   // This function extracts out these fields:
@@ -65,8 +230,8 @@ class DbgBuiltinCollection : public DbgClass {
                                 const std::string &count_field,
                                 const std::string &entries_field);
 
-  // Number of items in this object if this is a list, dictionary or hash set.
-  std::int32_t count_;
+  // Number of items in this collection.
+  std::int32_t count_ = 0;
 
   // Any number greater than or equal to this number won't be a valid index
   // into the _slots array.= of the hash set.
@@ -113,6 +278,10 @@ class DbgBuiltinCollection : public DbgClass {
   // "Count", which is the proto field that represents the number
   // of items in this object.
   static const std::string kCountProtoFieldName;
+
+  // Maximum depth of the trees of a SortedDictionary or ImmutableList.
+  // Both are balanced so this is only reached if the tree is corrupted.
+  static const std::size_t kMaximumTreeDepth = 128;
 };
 
 }  //  namespace google_cloud_debugger
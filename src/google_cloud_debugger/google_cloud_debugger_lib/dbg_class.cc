@@ -15,7 +15,6 @@
 #include "dbg_class.h"
 
 #include <algorithm>
-#include <array>
 #include <cstdint>
 #include <iostream>
 
@@ -25,10 +24,10 @@
 #include "i_cor_debug_helper.h"
 #include "i_dbg_object_factory.h"
 #include "i_eval_coordinator.h"
+#include "type_layout_cache.h"
 #include "variable_wrapper.h"
 
 using google::cloud::diagnostics::debug::Variable;
-using std::array;
 using std::char_traits;
 using std::min;
 using std::shared_ptr;
@@ -119,7 +118,7 @@ HRESULT DbgClass::ProcessParameterizedType() {
     for (int i = 0; i < num_types_fetched; ++i) {
       unique_ptr<DbgObject> empty_object;
       hr = object_factory_->CreateDbgObject(generic_types_[i], &empty_object,
-                                            GetErrorStream());
+                                            ErrorStream(this));
       if (SUCCEEDED(hr)) {
         empty_generic_objects_[i] = std::move(empty_object);
       } else {
@@ -152,126 +151,106 @@ HRESULT DbgClass::ProcessFields(IMetaDataImport *metadata_import,
                                 ICorDebugObjectValue *debug_obj_value,
                                 ICorDebugClass *debug_class) {
   CComPtr<ICorDebugType> debug_type;
-  HCORENUM cor_enum = nullptr;
-
   debug_type = GetDebugType();
-  while (true) {
-    HRESULT hr;
-    array<mdFieldDef, 100> field_defs;
-    ULONG field_defs_returned = 0;
-
-    hr = metadata_import->EnumFields(&cor_enum, class_token_, field_defs.data(),
-                                     field_defs.size(), &field_defs_returned);
-    if (FAILED(hr)) {
-      WriteError("Failed to enumerate class fields.");
-      return hr;
-    }
 
-    if (field_defs_returned != 0) {
-      class_fields_.reserve(class_fields_.size() + field_defs_returned);
-
-      for (int i = 0; i < field_defs_returned; ++i) {
-        unique_ptr<DbgClassField> class_field(new (std::nothrow) DbgClassField(
-            field_defs[i], GetCreationDepth() - 1, debug_type, debug_helper_,
-            object_factory_));
-        if (!class_field) {
-          WriteError("Run out of memory when trying to create field ");
-          WriteError(std::to_string(field_defs[i]));
-          return E_OUTOFMEMORY;
-        }
+  vector<FieldLayout> read_fields;
+  const vector<FieldLayout> *fields = &read_fields;
+  HRESULT hr;
+  if (type_layout_) {
+    hr = type_layout_->GetFields(metadata_import, &fields);
+  } else {
+    hr = TypeLayoutCache::ReadFieldLayouts(metadata_import, class_token_,
+                                           &read_fields);
+  }
+  if (FAILED(hr)) {
+    WriteError("Failed to enumerate class fields.");
+    return hr;
+  }
 
-        class_field->Initialize(debug_module_, metadata_import, debug_obj_value,
-                                debug_class);
-        if (class_field->IsBackingField()) {
-          // Insert class names into set so we can use it to check later
-          // for backing fields.
-          class_backing_fields_names_.insert(class_field->GetMemberName());
-        }
+  class_fields_.reserve(class_fields_.size() + fields->size());
+  for (const FieldLayout &field : *fields) {
+    unique_ptr<DbgClassField> class_field(new (std::nothrow) DbgClassField(
+        field.field_def, GetCreationDepth() - 1, debug_type, debug_helper_,
+        object_factory_));
+    if (!class_field) {
+      WriteError("Run out of memory when trying to create field ");
+      WriteError(std::to_string(field.field_def));
+      return E_OUTOFMEMORY;
+    }
 
-        AddStaticClassMemberToVector(std::move(class_field), &class_fields_);
-      }
-    } else {
-      break;
+    class_field->Initialize(field, debug_module_, metadata_import,
+                            debug_obj_value, debug_class);
+    if (class_field->IsBackingField()) {
+      // Insert class names into set so we can use it to check later
+      // for backing fields.
+      class_backing_fields_names_.insert(class_field->GetMemberName());
     }
-  }
 
-  if (cor_enum) {
-    metadata_import->CloseEnum(cor_enum);
+    AddStaticClassMemberToVector(std::move(class_field), &class_fields_);
   }
 
   return S_OK;
 }
 
 HRESULT DbgClass::ProcessProperties(IMetaDataImport *metadata_import) {
+  vector<PropertyLayout> read_properties;
+  const vector<PropertyLayout> *properties = &read_properties;
   HRESULT hr;
-  array<mdProperty, 100> property_defs;
-  HCORENUM cor_enum = nullptr;
-  ULONG property_defs_returned = 0;
-
-  while (true) {
-    hr = metadata_import->EnumProperties(
-        &cor_enum, class_token_, property_defs.data(), property_defs.size(),
-        &property_defs_returned);
-    if (FAILED(hr)) {
-      WriteError("Failed to enumerate class properties.");
-      return hr;
-    }
+  if (type_layout_) {
+    hr = type_layout_->GetProperties(metadata_import, &properties);
+  } else {
+    hr = TypeLayoutCache::ReadPropertyLayouts(metadata_import, class_token_,
+                                              &read_properties);
+  }
+  if (FAILED(hr)) {
+    WriteError("Failed to enumerate class properties.");
+    return hr;
+  }
 
-    if (property_defs_returned != 0) {
-      class_properties_.reserve(class_properties_.size() +
-                                property_defs_returned);
-
-      for (int i = 0; i < property_defs_returned; ++i) {
-        unique_ptr<DbgClassProperty> class_property(new (
-            std::nothrow) DbgClassProperty(debug_helper_, object_factory_));
-        if (!class_property) {
-          WriteError(
-              "Ran out of memory while trying to initialize class property ");
-          WriteError(std::to_string(property_defs[i]));
-          return E_OUTOFMEMORY;
-        }
+  class_properties_.reserve(class_properties_.size() + properties->size());
+  for (const PropertyLayout &property : *properties) {
+    unique_ptr<DbgClassProperty> class_property(
+        new (std::nothrow) DbgClassProperty(debug_helper_, object_factory_));
+    if (!class_property) {
+      WriteError(
+          "Ran out of memory while trying to initialize class property ");
+      WriteError(std::to_string(property.property_def));
+      return E_OUTOFMEMORY;
+    }
 
-        class_property->Initialize(property_defs[i], metadata_import,
-                                   debug_module_, GetCreationDepth() - 1);
-        // If property name is MyProperty, checks whether there is a backing
-        // field with the name <MyProperty>k__BackingField. Note that we have
-        // logic to process backing fields' names to strip out the "<" and
-        // ">k__BackingField" of the field name and places them in the set
-        // class_backing_fields_names. Hence, we only need to check whether
-        // MyProperty is in this set or not. If it is, then it is backed
-        // by a field already, so don't add it to class_properties_.
-        if (class_backing_fields_names_.find(class_property->GetMemberName()) !=
-            class_backing_fields_names_.end()) {
-          continue;
-        }
+    class_property->Initialize(property, debug_module_,
+                               GetCreationDepth() - 1);
+    // If property name is MyProperty, checks whether there is a backing
+    // field with the name <MyProperty>k__BackingField. Note that we have
+    // logic to process backing fields' names to strip out the "<" and
+    // ">k__BackingField" of the field name and places them in the set
+    // class_backing_fields_names. Hence, we only need to check whether
+    // MyProperty is in this set or not. If it is, then it is backed
+    // by a field already, so don't add it to class_properties_.
+    if (class_backing_fields_names_.find(class_property->GetMemberName()) !=
+        class_backing_fields_names_.end()) {
+      continue;
+    }
 
-        if (class_property->IsStatic()) {
-          // Checks whether we already have a shared pointer of this property
-          // in the cache. If not, moves the unique_ptr there.
-          shared_ptr<IDbgClassMember> static_property_value =
-              GetStaticClassMember(module_name_, class_name_,
-                                   class_property->GetMemberName());
-          if (!static_property_value) {
-            std::string property_name = class_property->GetMemberName();
-            static_property_value =
-                shared_ptr<IDbgClassMember>(class_property.release());
-            StoreStaticClassMember(module_name_, class_name_, property_name,
-                                   static_property_value);
-          }
-          class_properties_.emplace_back(static_property_value);
-        } else {
-          class_properties_.push_back(std::move(class_property));
-        }
+    if (class_property->IsStatic()) {
+      // Checks whether we already have a shared pointer of this property
+      // in the cache. If not, moves the unique_ptr there.
+      shared_ptr<IDbgClassMember> static_property_value = GetStaticClassMember(
+          module_name_, class_name_, class_property->GetMemberName());
+      if (!static_property_value) {
+        std::string property_name = class_property->GetMemberName();
+        static_property_value =
+            shared_ptr<IDbgClassMember>(class_property.release());
+        StoreStaticClassMember(module_name_, class_name_, property_name,
+                               static_property_value);
       }
+      class_properties_.emplace_back(static_property_value);
     } else {
-      break;
+      class_property->SetObject(this);
+      class_properties_.push_back(std::move(class_property));
     }
   }
 
-  if (cor_enum != nullptr) {
-    metadata_import->CloseEnum(cor_enum);
-  }
-
   return S_OK;
 }
 
@@ -282,8 +261,8 @@ HRESULT DbgClass::ProcessClassMembers() {
 
   BOOL is_null = FALSE;
   CComPtr<ICorDebugValue> debug_value;
-  HRESULT hr = debug_helper_->Dereference(object_handle_, &debug_value,
-                                          &is_null, GetErrorStream());
+  HRESULT hr = debug_helper_->Dereference(GetObjectValue(), &debug_value,
+                                          &is_null, ErrorStream(this));
   // Error already written into the error stream.
   if (FAILED(hr)) {
     return hr;
@@ -310,7 +289,7 @@ HRESULT DbgClass::ProcessClassMembers() {
 
   CComPtr<IMetaDataImport> metadata_import;
   hr = debug_helper_->GetMetadataImportFromICorDebugClass(
-      debug_class, &metadata_import, GetErrorStream());
+      debug_class, &metadata_import, ErrorStream(this));
   if (FAILED(hr)) {
     return hr;
   }
@@ -388,8 +367,9 @@ HRESULT DbgClass::ExtractField(ICorDebugObjectValue *debug_obj_value,
     return hr;
   }
 
-  hr = object_factory_->CreateDbgObject(
-      debug_field_value, GetCreationDepth() - 1, field_value, GetErrorStream());
+  hr = object_factory_->CreateDbgObject(debug_field_value,
+                                        GetCreationDepth() - 1, field_value,
+                                        ErrorStream(this));
   if (FAILED(hr)) {
     WriteError("Failed to evaluate the items of the list.");
   }
@@ -418,8 +398,7 @@ void DbgClass::Initialize(ICorDebugValue *debug_value, BOOL is_null) {
 
     // Create a handle if it is a class so we won't lose the object.
     if (cor_type_ != CorElementType::ELEMENT_TYPE_VALUETYPE && !is_null) {
-      initialize_hr_ = debug_helper_->CreateStrongHandle(
-          debug_value, &object_handle_, GetErrorStream());
+      initialize_hr_ = CreateObjectHandle(debug_value);
       // E_NOINTERFACE is returned if object is a value type. In that
       // case, we don't need to create a handle.
       if (FAILED(initialize_hr_)) {
@@ -493,7 +472,7 @@ void DbgClass::AddStaticClassMemberToVector(
 }
 
 void DbgClass::PopulateClassMembers(
-    Variable *variable_proto, std::vector<VariableWrapper> *members,
+    Variable *variable_proto, VariableWrapperVector *members,
     IEvalCoordinator *eval_coordinator,
     vector<shared_ptr<IDbgClassMember>> *class_members) {
   for (auto it = class_members->begin(); it != class_members->end(); ++it) {
@@ -502,7 +481,7 @@ void DbgClass::PopulateClassMembers(
       class_member_var->set_name((*it)->GetMemberName());
 
       HRESULT hr =
-          (*it)->Evaluate(object_handle_, eval_coordinator, &generic_types_);
+          (*it)->Evaluate(GetObjectValue(), eval_coordinator, &generic_types_);
       if (FAILED(hr)) {
         SetErrorStatusMessage(class_member_var, (*it).get());
         continue;
@@ -528,7 +507,7 @@ shared_ptr<IDbgClassMember> DbgClass::GetStaticClassMember(
 }
 
 HRESULT DbgClass::PopulateMembers(Variable *variable_proto,
-                                  std::vector<VariableWrapper> *members,
+                                  VariableWrapperVector *members,
                                   IEvalCoordinator *eval_coordinator) {
   if (!members || !variable_proto) {
     return E_INVALIDARG;
@@ -578,6 +557,20 @@ HRESULT DbgClass::PopulateMembers(Variable *variable_proto,
   return S_OK;
 }
 
+std::uint32_t DbgClass::GetEstimatedCaptureCost() const {
+  if (GetIsNull() || class_type_ == ClassType::PRIMITIVETYPE ||
+      class_type_ == ClassType::ENUM) {
+    return 0;
+  }
+
+  if (!processed_) {
+    return kEstimatedMemberCount;
+  }
+
+  return static_cast<std::uint32_t>(
+      class_fields_.size() + class_properties_.size() * kPropertyCaptureCost);
+}
+
 HRESULT DbgClass::GetTypeSignature(TypeSignature *type_signature) {
   if (type_signature == nullptr) {
     return E_INVALIDARG;
@@ -24,6 +24,7 @@
 #include "dbg_class_property.h"
 #include "dbg_primitive.h"
 #include "dbg_reference_object.h"
+#include "type_layout_cache.h"
 
 namespace google_cloud_debugger {
 
@@ -50,9 +51,14 @@ class DbgClass : public DbgReferenceObject {
   // of the class) will be used to populate the members vector.
   HRESULT PopulateMembers(
       google::cloud::diagnostics::debug::Variable *variable_proto,
-      std::vector<VariableWrapper> *members,
+      VariableWrapperVector *members,
       IEvalCoordinator *eval_coordinator) override;
 
+  // Estimates the cost of populating the fields and properties of
+  // this class. Properties are weighted by kPropertyCaptureCost since
+  // each of them is a function evaluation.
+  std::uint32_t GetEstimatedCaptureCost() const override;
+
   // Returns the TypeSignature represented by this class.
   // This function will also populate the generic_types vector
   // of type_signature with the instantiated generic types
@@ -93,15 +99,30 @@ class DbgClass : public DbgReferenceObject {
                                             ICorDebugClass *debug_class,
                                             IMetaDataImport *metadata_import);
 
+  // Estimated number of members of a class whose members have not
+  // been processed yet.
+  static const std::uint32_t kEstimatedMemberCount = 8;
+
+  // Cost of capturing a property relative to a field.
+  static const std::uint32_t kPropertyCaptureCost = 10;
+
   // Various .NET class types that we need to process differently
   // rather than just printing out fields and properties.
   enum ClassType {
-    DEFAULT,        // Default class type.
-    PRIMITIVETYPE,  // Integral type and bool.
-    ENUM,           // Enum type.
-    LIST,           // System.Collections.Generic.List type.
-    SET,            // System.Collections.Generic.HashSet type.
-    DICTIONARY      // System.Collections.Generic.Dictionary type.
+    DEFAULT,                // Default class type.
+    PRIMITIVETYPE,          // Integral type and bool.
+    ENUM,                   // Enum type.
+    LIST,                   // System.Collections.Generic.List type.
+    SET,                    // System.Collections.Generic.HashSet type.
+    DICTIONARY,             // System.Collections.Generic.Dictionary type.
+    QUEUE,                  // System.Collections.Generic.Queue type.
+    STACK,                  // System.Collections.Generic.Stack type.
+    LINKED_LIST,            // System.Collections.Generic.LinkedList type.
+    SORTED_DICTIONARY,      // System.Collections.Generic.SortedDictionary type.
+    CONCURRENT_DICTIONARY,  // Collections.Concurrent.ConcurrentDictionary type.
+    IMMUTABLE_ARRAY,        // System.Collections.Immutable.ImmutableArray type.
+    IMMUTABLE_LIST,         // System.Collections.Immutable.ImmutableList type.
+    ARRAY_SEGMENT           // System.ArraySegment type.
   };
 
   // Clear cache of static field and properties.
@@ -133,6 +154,13 @@ class DbgClass : public DbgReferenceObject {
     debug_module_ = debug_module;
   }
 
+  // Sets the cached layout of this class. If the layout has members,
+  // fields and properties are created from it instead of from the
+  // metadata of the class.
+  void SetTypeLayout(std::shared_ptr<const TypeLayout> type_layout) {
+    type_layout_ = type_layout;
+  }
+
  private:
   // Processes the generic parameters of the class.
   HRESULT ProcessParameterizedType();
@@ -174,7 +202,7 @@ class DbgClass : public DbgReferenceObject {
   // status in variable.
   void PopulateClassMembers(
       google::cloud::diagnostics::debug::Variable *variable_proto,
-      std::vector<VariableWrapper> *members, IEvalCoordinator *eval_coordinator,
+      VariableWrapperVector *members, IEvalCoordinator *eval_coordinator,
       std::vector<std::shared_ptr<IDbgClassMember>> *class_members);
 
   // Extracts the static field member_name of class class_name in module
@@ -211,6 +239,9 @@ class DbgClass : public DbgReferenceObject {
   // The debug module the class is in.
   CComPtr<ICorDebugModule> debug_module_;
 
+  // Cached layout of the class. May be null.
+  std::shared_ptr<const TypeLayout> type_layout_;
+
   // The type of this object. Can either be ELEMENT_TYPE_CLASS
   // or ELEMENT_TYPE_VALUETYPE or ELEMENT_TYPE_OBJECT.
   CorElementType cor_type_;
@@ -24,10 +24,10 @@
 #include "i_cor_debug_helper.h"
 #include "i_dbg_object_factory.h"
 #include "i_eval_coordinator.h"
+#include "type_layout_cache.h"
 #include "type_signature.h"
 
 using google::cloud::diagnostics::debug::Variable;
-using std::string;
 using std::unique_ptr;
 
 namespace google_cloud_debugger {
@@ -56,50 +56,40 @@ void DbgClassField::Initialize(ICorDebugModule *debug_module,
     return;
   }
 
-  CComPtr<ICorDebugValue> field_value;
-  ULONG len_field_name;
+  FieldLayout field_layout;
+  TypeLayoutCache::ReadFieldLayout(metadata_import, field_def_, &field_layout);
+  Initialize(field_layout, debug_module, metadata_import, debug_obj_value,
+             debug_class);
+}
 
-  // First call to get length of array.
-  initialized_hr_ = metadata_import->GetFieldProps(
-      field_def_, &parent_token_, nullptr, 0, &len_field_name,
-      &member_attributes_, &signature_metadata_, &sig_metadata_length_,
-      &default_value_type_flags_, &default_value_, &default_value_len_);
-  if (FAILED(initialized_hr_)) {
-    WriteError("Failed to populate field metadata.");
+void DbgClassField::Initialize(const FieldLayout &field_layout,
+                               ICorDebugModule *debug_module,
+                               IMetaDataImport *metadata_import,
+                               ICorDebugObjectValue *debug_obj_value,
+                               ICorDebugClass *debug_class) {
+  if (metadata_import == nullptr) {
+    WriteError("MetaDataImport is null.");
+    initialized_hr_ = E_INVALIDARG;
     return;
   }
 
-  std::vector<WCHAR> wchar_field_name(len_field_name, 0);
-
-  // Second call to get the actual name.
-  initialized_hr_ = metadata_import->GetFieldProps(
-      field_def_, &parent_token_, wchar_field_name.data(), len_field_name,
-      &len_field_name, &member_attributes_, &signature_metadata_,
-      &sig_metadata_length_, &default_value_type_flags_, &default_value_,
-      &default_value_len_);
+  initialized_hr_ = field_layout.hr;
   if (FAILED(initialized_hr_)) {
     WriteError("Failed to populate field metadata.");
     return;
   }
 
-  member_name_ = ConvertWCharPtrToString(wchar_field_name);
-
-  // If field name is <MyProperty>k__BackingField, change it to
-  // MyProperty because it is the backing field of a property.
-  if (member_name_.size() > kBackingField.size() + 1) {
-    // Checks that field name is of the form <Property>k__BackingField.
-    if (member_name_[0] == '<') {
-      string::size_type position;
-      // Checks that field_name_ ends with k_BackingField.
-      position = member_name_.find(kBackingField,
-                                   member_name_.size() - kBackingField.size());
-      // Extracts out the field name.
-      if (position != string::npos) {
-        is_backing_field_ = true;
-        member_name_ = member_name_.substr(1, position - 1);
-      }
-    }
-  }
+  parent_token_ = field_layout.parent_token;
+  member_attributes_ = field_layout.attributes;
+  signature_metadata_ = field_layout.signature;
+  sig_metadata_length_ = field_layout.signature_length;
+  default_value_type_flags_ = field_layout.default_value_type_flags;
+  default_value_ = field_layout.default_value;
+  default_value_len_ = field_layout.default_value_length;
+  member_name_ = field_layout.name;
+  is_backing_field_ = field_layout.is_backing_field;
+
+  CComPtr<ICorDebugValue> field_value;
 
   // This will point to the value of the field if the field is const.
   if (default_value_ && IsFdLiteral(member_attributes_)) {
@@ -149,7 +139,7 @@ void DbgClassField::Initialize(ICorDebugModule *debug_module,
 
   unique_ptr<DbgObject> member_value;
   initialized_hr_ = obj_factory_->CreateDbgObject(
-      field_value, creation_depth_, &member_value, GetErrorStream());
+      field_value, creation_depth_, &member_value, ErrorStream(this));
 
   if (FAILED(initialized_hr_)) {
     WriteError("Failed to create DbgObject for field.");
@@ -224,11 +214,11 @@ HRESULT DbgClassField::ProcessConstEnumField(ICorDebugModule *debug_module,
   mdToken base_token;
   HRESULT hr = debug_helper_->GetTypeNameFromMdTypeDef(
       parent_token_, metadata_import, &class_name, &base_token,
-      GetErrorStream());
+      ErrorStream(this));
 
   std::string base_class_name;
   hr = debug_helper_->GetTypeNameFromMdToken(
-      base_token, metadata_import, &base_class_name, GetErrorStream());
+      base_token, metadata_import, &base_class_name, ErrorStream(this));
   if (FAILED(hr)) {
     return hr;
   }
@@ -308,7 +298,7 @@ HRESULT DbgClassField::ExtractStaticFieldValue(
   unique_ptr<DbgObject> member_value;
 
   hr = obj_factory_->CreateDbgObject(debug_value, creation_depth_,
-                                     &member_value, GetErrorStream());
+                                     &member_value, ErrorStream(this));
   if (FAILED(hr)) {
     if (member_value) {
       WriteError(member_value->GetErrorString());
@@ -23,6 +23,8 @@
 
 namespace google_cloud_debugger {
 
+struct FieldLayout;
+
 // Class that represents a field in a .NET class.
 class DbgClassField : public IDbgClassMember {
  public:
@@ -45,6 +47,14 @@ class DbgClassField : public IDbgClassMember {
                   ICorDebugObjectValue *debug_obj_value,
                   ICorDebugClass *debug_class);
 
+  // Same as above but the names, metadata signature and flags are
+  // taken from field_layout instead of being read from metadata_import.
+  void Initialize(const FieldLayout &field_layout,
+                  ICorDebugModule *debug_module,
+                  IMetaDataImport *metadata_import,
+                  ICorDebugObjectValue *debug_obj_value,
+                  ICorDebugClass *debug_class);
+
   // Evaluates and sets member_value_ to the value of the field
   // that is represented by this class.
   // Reference_value and generic_types are ignored.
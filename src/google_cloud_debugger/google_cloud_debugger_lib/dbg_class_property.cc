@@ -24,6 +24,7 @@
 #include "i_cor_debug_helper.h"
 #include "i_dbg_object_factory.h"
 #include "i_eval_coordinator.h"
+#include "type_layout_cache.h"
 
 using google::cloud::diagnostics::debug::Variable;
 using std::vector;
@@ -40,39 +41,32 @@ void DbgClassProperty::Initialize(mdProperty property_def,
     return;
   }
 
-  ULONG property_name_length;
-  ULONG other_methods_length;
-
-  property_def_ = property_def;
-  // First call to get length of array and length of other methods.
-  initialized_hr_ = metadata_import->GetPropertyProps(
-      property_def_, &parent_token_, nullptr, 0, &property_name_length,
-      &member_attributes_, &signature_metadata_, &sig_metadata_length_,
-      &default_value_type_flags_, &default_value_, &default_value_len_,
-      &property_setter_function, &property_getter_function, nullptr, 0,
-      &other_methods_length);
-
-  if (FAILED(initialized_hr_)) {
-    WriteError("Failed to get property metadata.");
-    return;
-  }
-
-  std::vector<WCHAR> wchar_property_name(property_name_length, 0);
-  other_methods_.resize(other_methods_length);
-
-  initialized_hr_ = metadata_import->GetPropertyProps(
-      property_def_, &parent_token_, wchar_property_name.data(),
-      wchar_property_name.size(), &property_name_length, &member_attributes_,
-      &signature_metadata_, &sig_metadata_length_, &default_value_type_flags_,
-      &default_value_, &default_value_len_, &property_setter_function,
-      &property_getter_function, other_methods_.data(), other_methods_.size(),
-      &other_methods_length);
+  PropertyLayout property_layout;
+  TypeLayoutCache::ReadPropertyLayout(metadata_import, property_def,
+                                      &property_layout);
+  Initialize(property_layout, debug_module, creation_depth);
+}
 
+void DbgClassProperty::Initialize(const PropertyLayout &property_layout,
+                                  ICorDebugModule *debug_module,
+                                  int creation_depth) {
+  property_def_ = property_layout.property_def;
+  initialized_hr_ = property_layout.hr;
   if (FAILED(initialized_hr_)) {
     WriteError("Failed to get property metadata.");
   }
 
-  member_name_ = ConvertWCharPtrToString(wchar_property_name);
+  parent_token_ = property_layout.parent_token;
+  member_attributes_ = property_layout.attributes;
+  signature_metadata_ = property_layout.signature;
+  sig_metadata_length_ = property_layout.signature_length;
+  default_value_type_flags_ = property_layout.default_value_type_flags;
+  default_value_ = property_layout.default_value;
+  default_value_len_ = property_layout.default_value_length;
+  property_getter_function = property_layout.getter_function;
+  property_setter_function = property_layout.setter_function;
+  other_methods_ = property_layout.other_methods;
+  member_name_ = property_layout.name;
   creation_depth_ = creation_depth;
   debug_module_ = debug_module;
 }
@@ -109,6 +103,26 @@ HRESULT DbgClassProperty::Evaluate(
     return E_FAIL;
   }
 
+  // Non-static getters that were already evaluated on the same object
+  // during this breakpoint hit (for example, through another variable
+  // or through an expression) do not need another function evaluation.
+  CORDB_ADDRESS module_base_address = 0;
+  bool use_property_cache =
+      !IsStatic() && object_ && object_->GetAddress() != 0;
+  if (use_property_cache) {
+    hr = debug_module_->GetBaseAddress(&module_base_address);
+    if (FAILED(hr)) {
+      use_property_cache = false;
+    } else {
+      member_value_ = eval_coordinator->GetCachedPropertyValue(
+          debug_value, object_->GetAddress(), object_->GetAddressEvalCount(),
+          module_base_address, property_getter_function);
+      if (member_value_) {
+        return S_OK;
+      }
+    }
+  }
+
   hr = debug_module_->GetFunctionFromToken(property_getter_function,
                                            &debug_function);
   if (FAILED(hr)) {
@@ -142,7 +156,7 @@ HRESULT DbgClassProperty::Evaluate(
   hr = obj_factory_->EvaluateAndCreateDbgObject(
     std::move(local_generic_types), std::move(arg_values),
     debug_function, debug_eval, eval_coordinator,
-    &member_value, GetErrorStream());
+    &member_value, ErrorStream(this));
 
   if (FAILED(hr)) {
     WriteError("Failed to evaluate the property.");
@@ -150,6 +164,15 @@ HRESULT DbgClassProperty::Evaluate(
   }
 
   member_value_ = std::move(member_value);
+  // CreateEval created the strong handle of the object, so the cache
+  // can follow the object if later evaluations move it.
+  CComPtr<ICorDebugValue> object_handle;
+  if (use_property_cache &&
+      SUCCEEDED(object_->GetICorDebugValue(&object_handle, debug_eval))) {
+    eval_coordinator->CachePropertyValue(object_handle, module_base_address,
+                                         property_getter_function,
+                                         member_value_);
+  }
   return S_OK;
 }
 
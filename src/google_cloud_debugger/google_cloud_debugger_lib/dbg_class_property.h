@@ -24,6 +24,8 @@
 
 namespace google_cloud_debugger {
 
+struct PropertyLayout;
+
 // This class represents a property in a .NET class.
 // The property is not evaluated by default unless EvaluateProperty
 // function is called.
@@ -43,6 +45,11 @@ class DbgClassProperty : public IDbgClassMember {
   void Initialize(mdProperty property_def, IMetaDataImport *metadata_import,
                   ICorDebugModule *debug_module, int creation_depth);
 
+  // Same as above but the name, metadata signature, attributes and
+  // tokens are taken from property_layout.
+  void Initialize(const PropertyLayout &property_layout,
+                  ICorDebugModule *debug_module, int creation_depth);
+
   // Evaluates the property and stores the value in member_value_.
   // reference_value is a reference to the class object that this property
   // belongs to. eval_coordinator is needed to perform the function
@@ -69,6 +76,12 @@ class DbgClassProperty : public IDbgClassMember {
   // Will fail if this is not set.
   HRESULT GetTypeSignature(TypeSignature *type_signature);
 
+  // Sets the object this property is evaluated on. object has to outlive
+  // this property. If this is set, Evaluate will reuse the getter result
+  // cached in the IEvalCoordinator for the same object instead of
+  // performing another function evaluation.
+  void SetObject(DbgObject *object) { object_ = object; }
+
   // Returns true if the property is static.
   // If the property is static, the signature metadata won't have the bit
   // corresponding to IMAGE_CEE_CS_CALLCONV_HASTHIS at the start.
@@ -98,6 +111,10 @@ class DbgClassProperty : public IDbgClassMember {
 
   // The ICorDebugModule this property is in.
   CComPtr<ICorDebugModule> debug_module_;
+
+  // The object this property is evaluated on, if known.
+  // nullptr if the property is static.
+  DbgObject *object_ = nullptr;
 };
 
 }  //  namespace google_cloud_debugger
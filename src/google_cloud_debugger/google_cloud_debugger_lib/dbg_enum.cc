@@ -18,19 +18,12 @@
 #include "i_eval_coordinator.h"
 
 using google::cloud::diagnostics::debug::Variable;
-using std::array;
-using std::char_traits;
-using std::min;
+using std::shared_ptr;
 using std::string;
 using std::vector;
 
 namespace google_cloud_debugger {
 
-const string DbgEnum::kEnumValue = "value__";
-std::unordered_map<std::string,
-                   std::vector<std::tuple<UVCP_CONSTANT, std::string>>>
-    DbgEnum::enum_values_dict;
-
 HRESULT DbgEnum::PopulateValue(Variable *variable) {
   if (!variable) {
     return E_INVALIDARG;
@@ -54,44 +47,12 @@ HRESULT DbgEnum::PopulateValue(Variable *variable) {
     return E_FAIL;
   }
 
-  if (enum_values_dict.find(class_name_) == enum_values_dict.end()) {
+  if (!enum_table_) {
     WriteError("Cannot find enum " + class_name_);
     return E_FAIL;
   }
 
-  // This mutable enum value may be zeroed out during the loop.
-  ULONG64 mutable_enum_value = enum_value_;
-  for (auto &&enum_value_tuple : enum_values_dict[class_name_]) {
-    UVCP_CONSTANT raw_default_value = std::get<0>(enum_value_tuple);
-    ULONG64 const_value =
-        ExtractEnumValue(enum_type_, (void *)raw_default_value);
-
-    // If the original_enum_value matches the const_value exactly,
-    // uses that instead of the "|" string.
-    if (enum_value_ == const_value) {
-      enum_string_ = std::get<1>(enum_value_tuple);
-      break;
-    }
-
-    // If mutable_enum_value is different from const_value, but const_value
-    // corresponds to bits in mutable_enum_value, then this const_value string
-    // is part of the mutable_enum_value string representation.
-    if (mutable_enum_value != const_value &&
-        (const_value == 0 ||
-         (const_value & mutable_enum_value) != const_value)) {
-      continue;
-    }
-
-    // Zero out the bits of const_value in enum_value;
-    mutable_enum_value = mutable_enum_value & (~const_value);
-
-    if (enum_string_.empty()) {
-      enum_string_.append(std::get<1>(enum_value_tuple));
-    } else {
-      enum_string_.append(" | " + std::get<1>(enum_value_tuple));
-    }
-  }
-
+  enum_string_ = enum_table_->GetValueName(enum_value_);
   variable->set_value(enum_string_);
   return S_OK;
 }
@@ -131,83 +92,66 @@ HRESULT DbgEnum::ProcessEnum(ICorDebugValue *debug_value,
 
   // Sets the underlying enum type.
   // This is from the non-static field __value.
-  for (auto &class_field : class_fields_) {
-    if (!class_field || class_field->IsStatic()) {
-      continue;
-    }
-
-    if (kEnumValue.compare(class_field->GetMemberName()) != 0) {
-      continue;
-    }
-
-    PCCOR_SIGNATURE field_signature = class_field->GetSignature();
-    enum_type_ = CorSigUncompressElementType(field_signature);
-    break;
-  }
-
+  enum_type_ = enum_table_->GetEnumType();
   if (enum_type_ == CorElementType::ELEMENT_TYPE_END) {
     initialize_hr_ = E_FAIL;
   }
 
-  enum_value_ = ExtractEnumValue(enum_type_, enum_value_array_.data());
+  enum_value_ =
+      EnumTable::ExtractEnumValue(enum_type_, enum_value_array_.data());
 
   return S_OK;
 }
 
 HRESULT DbgEnum::ProcessEnumFields(IMetaDataImport *metadata_import) {
-  HRESULT hr = ProcessFields(metadata_import, nullptr, nullptr);
+  if (!metadata_import) {
+    WriteError("MetaDataImport is null.");
+    return E_INVALIDARG;
+  }
+
+  // A module without an MVID cannot be told apart from another one
+  // so its enums are not cached.
+  string module_mvid;
+  bool use_cache = SUCCEEDED(
+      EnumTableCache::GetModuleMvid(metadata_import, &module_mvid));
+  if (use_cache) {
+    enum_table_ =
+        EnumTableCache::GetInstance()->GetTable(module_mvid, class_token_);
+    if (enum_table_) {
+      return S_OK;
+    }
+  }
+
+  vector<FieldLayout> read_fields;
+  const vector<FieldLayout> *fields = &read_fields;
+  HRESULT hr;
+  if (type_layout_) {
+    hr = type_layout_->GetFields(metadata_import, &fields);
+  } else {
+    hr = TypeLayoutCache::ReadFieldLayouts(metadata_import, class_token_,
+                                           &read_fields);
+  }
   if (FAILED(hr)) {
     WriteError("Failed to process enum fields.");
     return hr;
   }
 
-  AddEnumValuesToDict();
-  return S_OK;
-}
-
-void DbgEnum::AddEnumValuesToDict() {
-  if (enum_values_dict.find(class_name_) == enum_values_dict.end()) {
-    std::vector<std::tuple<UVCP_CONSTANT, std::string>> enum_values;
-    for (auto &class_field : class_fields_) {
-      if (!class_field || !class_field->IsStatic()) {
-        continue;
-      }
-
-      UVCP_CONSTANT raw_default_value = class_field->GetDefaultValue();
-      std::string value_name = class_field->GetMemberName();
-      enum_values.push_back(std::make_tuple<UVCP_CONSTANT, std::string>(
-          std::move(raw_default_value), std::move(value_name)));
-    }
-    enum_values_dict[class_name_] = std::move(enum_values);
+  shared_ptr<EnumTable> enum_table(new (std::nothrow) EnumTable(*fields));
+  if (!enum_table) {
+    WriteError("Ran out of memory to create enum table.");
+    return E_OUTOFMEMORY;
   }
-}
 
-ULONG64 DbgEnum::ExtractEnumValue(CorElementType enum_type, void *enum_value) {
-  switch (enum_type) {
-    case ELEMENT_TYPE_I:
-      return (ULONG64)(*((intptr_t *)enum_value));
-    case ELEMENT_TYPE_U:
-      return (ULONG64)(*((uintptr_t *)enum_value));
-    case ELEMENT_TYPE_CHAR:
-    case ELEMENT_TYPE_I1:
-      return (ULONG64)(*((int8_t *)enum_value));
-    case ELEMENT_TYPE_U1:
-      return (ULONG64)(*((uint8_t *)enum_value));
-    case ELEMENT_TYPE_I2:
-      return (ULONG64)(*((int16_t *)enum_value));
-    case ELEMENT_TYPE_U2:
-      return (ULONG64)(*((uint16_t *)enum_value));
-    case ELEMENT_TYPE_I4:
-      return (ULONG64)(*((int32_t *)enum_value));
-    case ELEMENT_TYPE_U4:
-      return (ULONG64)(*((uint32_t *)enum_value));
-    case ELEMENT_TYPE_I8:
-      return (ULONG64)(*((int64_t *)enum_value));
-    case ELEMENT_TYPE_U8:
-      return (ULONG64)(*((uint64_t *)enum_value));
-    default:
-      return 0;
+  // Only a complete table is cached since a type without value__ is
+  // not reported as an enum.
+  if (use_cache &&
+      enum_table->GetEnumType() != CorElementType::ELEMENT_TYPE_END) {
+    EnumTableCache::GetInstance()->AddTable(module_mvid, class_token_,
+                                            enum_table);
   }
+
+  enum_table_ = std::move(enum_table);
+  return S_OK;
 }
 
 }  // namespace google_cloud_debugger
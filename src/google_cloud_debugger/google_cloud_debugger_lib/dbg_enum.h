@@ -16,11 +16,10 @@
 #define DBG_ENUM_H_
 
 #include <memory>
-#include <tuple>
-#include <unordered_map>
 #include <vector>
 
 #include "dbg_class.h"
+#include "enum_table.h"
 
 namespace google_cloud_debugger {
 
@@ -67,7 +66,8 @@ class DbgEnum : public DbgClass {
   HRESULT ProcessEnum(ICorDebugValue *debug_value,
                       IMetaDataImport *metadata_import);
 
-  // Processes the fields of this enum.
+  // Gets the table of the names of the values of this enum, which is
+  // built from the fields of the enum the first time it is needed.
   HRESULT ProcessEnumFields(IMetaDataImport *metadata_import);
 
   // Sets the underlying integral value of the enum.
@@ -77,29 +77,12 @@ class DbgEnum : public DbgClass {
   void SetEnumType(const CorElementType &enum_type) { enum_type_ = enum_type; }
 
  private:
-  // Assuming the fields of this enum has been processed,
-  // add their values to the enum_values_dict.
-  void AddEnumValuesToDict();
-
-  // Key in the dictionary is the name of the enum.
-  // Values are the list of possible values of that enum.
-  // For example, enum Week { Monday, Tuesday } will have key
-  // as Week and values as (0, "Monday") and (1, "Tuesday").
-  static std::unordered_map<std::string,
-                            std::vector<std::tuple<UVCP_CONSTANT, std::string>>>
-      enum_values_dict;
-
-  // Given a void pointer and type of the enum, extract out the enum
-  // value.
-  ULONG64 ExtractEnumValue(CorElementType enum_type, void *enum_value);
+  // Names of the values of this enum, shared by the objects of the enum.
+  std::shared_ptr<const EnumTable> enum_table_;
 
   // Array of bytes to contain enum value if this class is an enum.
   std::vector<std::uint8_t> enum_value_array_;
 
-  // String that represents "__value" which is the field that determines
-  // the value of an enum.
-  static const std::string kEnumValue;
-
   // The integral type of the enum.
   // Assigned to ELEMENT_TYPE_END as a default value.
   CorElementType enum_type_ = CorElementType::ELEMENT_TYPE_END;
@@ -15,13 +15,16 @@
 #ifndef DBG_OBJECT_H_
 #define DBG_OBJECT_H_
 
+#include <cstdint>
 #include <string>
 #include <vector>
 
 #include "breakpoint.pb.h"
 #include "ccomptr.h"
+#include "collection_window.h"
 #include "cor.h"
 #include "cordebug.h"
+#include "snapshot_arena.h"
 #include "string_stream_wrapper.h"
 
 namespace google_cloud_debugger {
@@ -31,12 +34,19 @@ class VariableWrapper;
 class ICorDebugHelper;
 struct TypeSignature;
 
+// Variables of the members of an object. Like the objects, they are
+// allocated from the SnapshotArena of the hit.
+typedef std::vector<VariableWrapper, SnapshotAllocator<VariableWrapper>>
+    VariableWrapperVector;
+
 // This class represents a .NET object.
 // We try to store either a copy of the object itself (with value type)
 // or a copy of the reference (with reference type). This is because
 // if we issue a call to ICorDebugController->Continue, then the
 // ICorDebugValue and many other ICorDebug* interfaces will be lost.
-class DbgObject : public StringStreamWrapper {
+// DbgObjects created while a breakpoint hit is captured are allocated
+// from the SnapshotArena of the hit.
+class DbgObject : public StringStreamWrapper, public SnapshotAllocated {
  public:
   // Create a DbgObject with ICorDebugType debug_type.
   // The object will only be created to a depth of depth.
@@ -78,11 +88,23 @@ class DbgObject : public StringStreamWrapper {
   // object_factory is needed to create new DbgObjects for members.
   virtual HRESULT PopulateMembers(
       google::cloud::diagnostics::debug::Variable *variable_proto,
-      std::vector<VariableWrapper> *members,
+      VariableWrapperVector *members,
       IEvalCoordinator *eval_coordinator) {
     return S_FALSE;
   }
 
+  // Returns a rough estimate of the cost of populating the members of
+  // this object, in fields read. Objects without members cost 0.
+  // This lets cheap objects be captured before expensive ones when
+  // the size of a breakpoint is limited.
+  virtual std::uint32_t GetEstimatedCaptureCost() const { return 0; }
+
+  // Restricts the items populated by PopulateMembers to the items
+  // in window. Returns E_NOTIMPL if this object is not a collection.
+  virtual HRESULT SetCollectionWindow(const CollectionWindow &window) {
+    return E_NOTIMPL;
+  }
+
   // Returns an ICorDebugValue representing the object.
   virtual HRESULT GetICorDebugValue(ICorDebugValue **debug_value,
                                     ICorDebugEval *debug_eval) = 0;
@@ -114,8 +136,16 @@ class DbgObject : public StringStreamWrapper {
   // Returns the address of the object.
   CORDB_ADDRESS GetAddress() const { return address_; }
 
-  // Sets the address of the object.
-  void SetAddress(const CORDB_ADDRESS &address) { address_ = address; }
+  // Returns the number of function evaluations created before the
+  // address of the object was read (see EvalCoordinator::GetEvalCount).
+  std::uint64_t GetAddressEvalCount() const { return address_eval_count_; }
+
+  // Sets the address of the object, read after eval_count function
+  // evaluations were created.
+  void SetAddress(const CORDB_ADDRESS &address, std::uint64_t eval_count) {
+    address_ = address;
+    address_eval_count_ = eval_count;
+  }
 
  private:
   // The underlying type of the object.
@@ -127,6 +157,12 @@ class DbgObject : public StringStreamWrapper {
   // The address of the object.
   CORDB_ADDRESS address_ = 0;
 
+  // Number of function evaluations created before address_ was read.
+  // The garbage collector may move the object during a function
+  // evaluation, so address_ only identifies the object together with
+  // this count.
+  std::uint64_t address_eval_count_ = 0;
+
   // The depth of creation for this object.
   // Once this is 0, we don't create the fields and properties of the object.
   // Note that even though we use BFS in dbg_stack_frame to control how deep
@@ -17,6 +17,7 @@
 #include <assert.h>
 #include <cstdint>
 #include <iostream>
+#include <sstream>
 
 #include "cor_debug_helper.h"
 #include "dbg_array.h"
@@ -25,7 +26,9 @@
 #include "dbg_enum.h"
 #include "dbg_primitive.h"
 #include "dbg_string.h"
+#include "eval_coordinator.h"
 #include "i_eval_coordinator.h"
+#include "type_layout_cache.h"
 #include "type_signature.h"
 
 using google::cloud::diagnostics::debug::Variable;
@@ -150,7 +153,7 @@ HRESULT DbgObjectFactory::CreateDbgObjectHelper(
       *err_stream << "Failed to get address of the object.";
       return hr;
     }
-    temp_object->SetAddress(address);
+    temp_object->SetAddress(address, EvalCoordinator::GetEvalCount());
   }
 
   (*result_object) = std::move(temp_object);
@@ -260,20 +263,15 @@ HRESULT DbgObjectFactory::CreateDbgClassObject(
     return hr;
   }
 
-  string class_name;
-  hr = ProcessClassName(class_token, metadata_import, &class_name, err_stream);
+  std::shared_ptr<const TypeLayout> type_layout;
+  hr = GetTypeLayout(debug_type, debug_module, metadata_import, class_token,
+                     &type_layout, err_stream);
   if (FAILED(hr)) {
     return hr;
   }
 
-  std::vector<WCHAR> wchar_module_name;
-  hr = debug_helper_->GetModuleNameFromICorDebugModule(
-      debug_module, &wchar_module_name, err_stream);
-  if (FAILED(hr)) {
-    return hr;
-  }
-
-  string module_name = ConvertWCharPtrToString(wchar_module_name);
+  const string &class_name = type_layout->class_name;
+  const string &module_name = type_layout->module_name;
 
   if (is_null) {
     unique_ptr<DbgClass> null_obj(new (std::nothrow) DbgClass(
@@ -287,6 +285,7 @@ HRESULT DbgObjectFactory::CreateDbgClassObject(
     null_obj->SetClassName(class_name);
     null_obj->SetClassToken(class_token);
     null_obj->SetICorDebugModule(debug_module);
+    null_obj->SetTypeLayout(type_layout);
     *result_object = std::move(null_obj);
     return S_OK;
   }
@@ -297,11 +296,10 @@ HRESULT DbgObjectFactory::CreateDbgClassObject(
     // a primitive object.
     return hr;
   } else if (hr == E_NOTIMPL) {
-    string base_class_name;
-    hr = ProcessBaseClassName(debug_type, &base_class_name, err_stream);
-    if (FAILED(hr)) {
+    const string &base_class_name = type_layout->base_class_name;
+    if (FAILED(type_layout->base_class_hr)) {
       *err_stream << "Failed to get the base class.";
-      return hr;
+      return type_layout->base_class_hr;
     }
 
     unique_ptr<DbgClass> class_obj;
@@ -311,6 +309,7 @@ HRESULT DbgObjectFactory::CreateDbgClassObject(
           unique_ptr<DbgEnum>(new (std::nothrow) DbgEnum(
               debug_type, depth, class_name, class_token, debug_helper_,
               std::shared_ptr<DbgObjectFactory>(new DbgObjectFactory())));
+      enum_obj->SetTypeLayout(type_layout);
       // Only process class type for enum (since it is ValueType and we don't
       // store reference to the class object). Delay processing fields and
       // properties of non-ValueType class until we need them.
@@ -320,9 +319,7 @@ HRESULT DbgObjectFactory::CreateDbgClassObject(
         return hr;
       }
       class_obj = std::move(enum_obj);
-    } else if (kListClassName.compare(class_name) == 0 ||
-               kHashSetClassName.compare(class_name) == 0 ||
-               kDictionaryClassName.compare(class_name) == 0) {
+    } else if (DbgBuiltinCollection::IsBuiltinCollection(class_name)) {
       class_obj = unique_ptr<DbgBuiltinCollection>(
           new (std::nothrow) DbgBuiltinCollection(
               debug_type, depth, debug_helper_,
@@ -342,6 +339,7 @@ HRESULT DbgObjectFactory::CreateDbgClassObject(
     class_obj->SetClassName(class_name);
     class_obj->SetClassToken(class_token);
     class_obj->SetICorDebugModule(debug_module);
+    class_obj->SetTypeLayout(type_layout);
 
     // If this is a ValueType class, we have to process its members
     // because we can't store the reference to this class.
@@ -535,6 +533,61 @@ HRESULT DbgObjectFactory::CreateDbgObjectFromLiteralConst(
   }
 }
 
+HRESULT DbgObjectFactory::GetTypeLayout(
+    ICorDebugType *debug_type, ICorDebugModule *debug_module,
+    IMetaDataImport *metadata_import, mdTypeDef class_token,
+    std::shared_ptr<const TypeLayout> *type_layout, ostream *err_stream) {
+  // A module without a base address (only seen with mocked modules)
+  // cannot be told apart from another one so its layouts are not cached.
+  CORDB_ADDRESS module_base_address = 0;
+  HRESULT hr = debug_module->GetBaseAddress(&module_base_address);
+  bool use_cache = SUCCEEDED(hr) && module_base_address != 0;
+  if (use_cache) {
+    *type_layout = TypeLayoutCache::GetInstance()->GetLayout(
+        module_base_address, class_token);
+    if (*type_layout) {
+      return S_OK;
+    }
+  }
+
+  std::shared_ptr<TypeLayout> new_layout(new (std::nothrow) TypeLayout);
+  if (!new_layout) {
+    *err_stream << "Ran out of memory to create type layout.";
+    return E_OUTOFMEMORY;
+  }
+
+  hr = ProcessClassName(class_token, metadata_import, &new_layout->class_name,
+                        err_stream);
+  if (FAILED(hr)) {
+    return hr;
+  }
+
+  std::vector<WCHAR> wchar_module_name;
+  hr = debug_helper_->GetModuleNameFromICorDebugModule(
+      debug_module, &wchar_module_name, err_stream);
+  if (FAILED(hr)) {
+    return hr;
+  }
+  new_layout->module_name = ConvertWCharPtrToString(wchar_module_name);
+
+  // The base class only matters for classes that are not primitive types
+  // so a failure is only reported when such a class is created.
+  std::ostringstream base_class_err_stream;
+  new_layout->base_class_hr = ProcessBaseClassName(
+      debug_type, &new_layout->base_class_name, &base_class_err_stream);
+
+  // The fields and properties are only read when an object of the
+  // class is expanded.
+  new_layout->class_token = class_token;
+  if (use_cache && SUCCEEDED(new_layout->base_class_hr)) {
+    TypeLayoutCache::GetInstance()->AddLayout(module_base_address, class_token,
+                                              new_layout);
+  }
+
+  *type_layout = std::move(new_layout);
+  return S_OK;
+}
+
 HRESULT DbgObjectFactory::ProcessClassName(mdTypeDef class_token,
                                            IMetaDataImport *metadata_import,
                                            std::string *class_name,
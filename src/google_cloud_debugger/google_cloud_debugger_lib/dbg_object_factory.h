@@ -17,6 +17,7 @@
 
 #include "dbg_primitive.h"
 #include "i_dbg_object_factory.h"
+#include "type_layout_cache.h"
 
 namespace google_cloud_debugger {
 
@@ -82,6 +83,17 @@ class DbgObjectFactory : public IDbgObjectFactory {
                                 std::unique_ptr<DbgObject> *result_object,
                                 std::ostream *err_stream);
 
+  // Sets type_layout to the layout of the class class_token in
+  // debug_module, whose metadata is metadata_import. debug_type is
+  // used to resolve the base class. The layout is read from the
+  // metadata the first time and then taken from TypeLayoutCache.
+  HRESULT GetTypeLayout(ICorDebugType *debug_type,
+                        ICorDebugModule *debug_module,
+                        IMetaDataImport *metadata_import,
+                        mdTypeDef class_token,
+                        std::shared_ptr<const TypeLayout> *type_layout,
+                        std::ostream *err_stream);
+
   // Processes the class name and stores the result in class_name.
   HRESULT ProcessClassName(mdTypeDef class_token,
                            IMetaDataImport *metadata_import,
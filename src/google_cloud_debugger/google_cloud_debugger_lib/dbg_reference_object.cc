@@ -16,12 +16,71 @@
 
 #include "i_cor_debug_helper.h"
 #include "i_dbg_object_factory.h"
+#include "object_handle_pool.h"
 
 namespace google_cloud_debugger {
+
+DbgReferenceObject::~DbgReferenceObject() {
+  if (handle_pool_) {
+    handle_pool_->RemovePendingObject(this);
+  }
+}
+
+HRESULT DbgReferenceObject::CreateObjectHandle(ICorDebugValue *debug_value) {
+  ObjectHandlePool *handle_pool = ObjectHandlePool::GetCurrent();
+  if (!handle_pool || !debug_value) {
+    return debug_helper_->CreateStrongHandle(debug_value, &object_handle_,
+                                             ErrorStream(this));
+  }
+
+  deferred_value_ = debug_value;
+  handle_pool_ = handle_pool;
+  handle_pool_->AddPendingObject(this);
+  return S_OK;
+}
+
+HRESULT DbgReferenceObject::CreateDeferredHandle() {
+  handle_pool_ = nullptr;
+  if (object_handle_ || !deferred_value_) {
+    return S_OK;
+  }
+
+  HRESULT hr = debug_helper_->CreateStrongHandle(
+      deferred_value_, &object_handle_, ErrorStream(this));
+  if (FAILED(hr)) {
+    WriteError("Failed to create a deferred strong handle.");
+    return hr;
+  }
+
+  // deferred_value_ is kept since callers may still hold the pointer
+  // returned by GetObjectValue before the handle was created.
+  return S_OK;
+}
+
+ICorDebugValue *DbgReferenceObject::GetObjectValue() const {
+  if (object_handle_) {
+    return object_handle_;
+  }
+  return deferred_value_;
+}
+
+HRESULT DbgReferenceObject::DereferenceObject(ICorDebugValue **object_value) {
+  if (object_handle_) {
+    return object_handle_->Dereference(object_value);
+  }
+
+  if (!deferred_value_) {
+    return E_FAIL;
+  }
+
+  *object_value = deferred_value_;
+  deferred_value_->AddRef();
+  return S_OK;
+}
 HRESULT DbgReferenceObject::GetNonStaticField(
     const std::string &field_name,
     std::shared_ptr<DbgObject> *field_value) {
-  if (!object_handle_) {
+  if (!GetObjectValue()) {
     return E_INVALIDARG;
   }
 
@@ -30,8 +89,8 @@ HRESULT DbgReferenceObject::GetNonStaticField(
   // Dereferences the object to get ICorDebugObjectValue.
   BOOL is_null = FALSE;
   CComPtr<ICorDebugValue> debug_value;
-  hr = debug_helper_->Dereference(object_handle_, &debug_value,
-                   &is_null, GetErrorStream());
+  hr = debug_helper_->Dereference(GetObjectValue(), &debug_value,
+                   &is_null, ErrorStream(this));
   if (FAILED(hr)) {
     return hr;
   }
@@ -65,7 +124,7 @@ HRESULT DbgReferenceObject::GetNonStaticField(
 
   CComPtr<IMetaDataImport> metadata_import;
   hr = debug_helper_->GetMetadataImportFromICorDebugClass(debug_class,
-      &metadata_import, GetErrorStream());
+      &metadata_import, ErrorStream(this));
   if (FAILED(hr)) {
     return hr;
   }
@@ -76,7 +135,7 @@ HRESULT DbgReferenceObject::GetNonStaticField(
   ULONG field_sig_len = 0;
   hr = debug_helper_->GetFieldInfo(metadata_import, class_token,
       field_name, &field_def, &is_static, &field_sig,
-      &field_sig_len, GetErrorStream());
+      &field_sig_len, ErrorStream(this));
   if (FAILED(hr)) {
     return hr;
   }
@@ -95,7 +154,7 @@ HRESULT DbgReferenceObject::GetNonStaticField(
   std::unique_ptr<DbgObject> dbg_object;
   hr = object_factory_->CreateDbgObject(field_debug_value,
       GetCreationDepth() - 1,
-      &dbg_object, GetErrorStream());
+      &dbg_object, ErrorStream(this));
   if (FAILED(hr)) {
     return hr;
   }
@@ -107,16 +166,23 @@ HRESULT DbgReferenceObject::GetNonStaticField(
 HRESULT DbgReferenceObject::GetICorDebugValue(
     ICorDebugValue **debug_value,
     ICorDebugEval *debug_eval) {
-  if (object_handle_) {
-    *debug_value = object_handle_;
-    object_handle_->AddRef();
+  ICorDebugValue *object_value = GetObjectValue();
+  if (object_value) {
+    *debug_value = object_value;
+    object_value->AddRef();
     return S_OK;
   }
   return E_FAIL;
 }
 
 HRESULT DbgReferenceObject::GetDebugHandle(ICorDebugHandleValue **result) {
-  return GetICorDebugValue(reinterpret_cast<ICorDebugValue **>(result), nullptr);
+  // A deferred value is not a handle.
+  if (object_handle_) {
+    *result = object_handle_;
+    object_handle_->AddRef();
+    return S_OK;
+  }
+  return E_FAIL;
 }
 
 }
@@ -20,6 +20,7 @@
 namespace google_cloud_debugger {
 
 class IDbgObjectFactory;
+class ObjectHandlePool;
 
 // This class represents a .NET object of reference type.
 class DbgReferenceObject : public DbgObject {
@@ -32,23 +33,56 @@ class DbgReferenceObject : public DbgObject {
         object_factory_(obj_factory) {
   }
 
+  // Removes this object from the handle pool if it is still waiting
+  // for a handle.
+  ~DbgReferenceObject() override;
+
   // Searches the object for non-static field field_name and returns
   // the value in field_value.
   virtual HRESULT GetNonStaticField(const std::string &field_name,
                                     std::shared_ptr<DbgObject> *field_value);
 
-  // Returns object_handle_.
+  // Returns object_handle_, or the value of the object if its handle
+  // is deferred.
   virtual HRESULT GetICorDebugValue(ICorDebugValue **debug_value,
                                     ICorDebugEval *debug_eval) override;
 
   // Returns the underlying ICorDebugHandleValue for this object.
   HRESULT GetDebugHandle(ICorDebugHandleValue **result);
 
+  // Creates the strong handle that CreateObjectHandle deferred.
+  // Called by the ObjectHandlePool before the debuggee is continued.
+  HRESULT CreateDeferredHandle();
+
+  // Called by the ObjectHandlePool when it is closed before creating
+  // the handle of this object.
+  void DetachHandlePool() { handle_pool_ = nullptr; }
+
  protected:
+  // Keeps debug_value, the value of the object, until the debuggee is
+  // continued. If an ObjectHandlePool is current, the strong handle of
+  // the object is only created by the pool when needed. Otherwise, it
+  // is created right away.
+  HRESULT CreateObjectHandle(ICorDebugValue *debug_value);
+
+  // Returns object_handle_, or the value of the object if its handle
+  // is deferred. Both can be passed to ICorDebugHelper::Dereference.
+  ICorDebugValue *GetObjectValue() const;
+
+  // Returns the dereferenced value of the object in object_value.
+  HRESULT DereferenceObject(ICorDebugValue **object_value);
+
   // Handle for the object.
   // Only applicable for class, array and string.
   CComPtr<ICorDebugHandleValue> object_handle_;
 
+  // Value of the object if its handle was deferred. Only valid until
+  // the debuggee is continued.
+  CComPtr<ICorDebugValue> deferred_value_;
+
+  // The pool the handle of this object is deferred to, if any.
+  ObjectHandlePool *handle_pool_ = nullptr;
+
   std::shared_ptr<IDbgObjectFactory> object_factory_;
 };
 
@@ -15,9 +15,9 @@
 #include "dbg_stack_frame.h"
 
 #include <iostream>
-#include <queue>
 #include <vector>
 
+#include "capture_planner.h"
 #include "compiler_helpers.h"
 #include "constants.h"
 #include "dbg_breakpoint.h"
@@ -40,7 +40,6 @@ using google_cloud_debugger_portable_pdb::LocalVariableInfo;
 using std::cerr;
 using std::cout;
 using std::ostringstream;
-using std::queue;
 using std::shared_ptr;
 using std::string;
 using std::unique_ptr;
@@ -161,9 +160,7 @@ HRESULT DbgStackFrame::ProcessLocalVariables(
   }
 
   for (size_t i = 0; i < debug_values.size(); ++i) {
-    unique_ptr<DbgObject> variable_value;
     string variable_name;
-    unique_ptr<ostringstream> err_stream(new (std::nothrow) ostringstream);
     bool variable_hidden = false;
 
     // Default name if we can't get the name.
@@ -188,15 +185,8 @@ HRESULT DbgStackFrame::ProcessLocalVariables(
       continue;
     }
 
-    hr = obj_factory_->CreateDbgObject(debug_values[i], object_depth_,
-                                       &variable_value, &std::cerr);
-
-    if (FAILED(hr)) {
-      variable_value = nullptr;
-    }
-
-    variables_.push_back(
-        std::make_tuple(std::move(variable_name), std::move(variable_value)));
+    // The DbgObject is only created once the variable is needed.
+    variables_.push_back(FrameVariable(variable_name, debug_values[i]));
   }
 
   return S_OK;
@@ -234,7 +224,7 @@ HRESULT DbgStackFrame::ProcessLocalConstants(
     if (remaining_buffer.size() == 0
       || const_type == CorElementType::ELEMENT_TYPE_STRING) {
       variables_.push_back(
-          std::make_tuple(constant_info.name, std::move(const_obj)));
+          FrameVariable(constant_info.name, std::move(const_obj)));
       continue;
     }
 
@@ -307,7 +297,7 @@ HRESULT DbgStackFrame::ProcessLocalEnumConstant(
     return hr;
   }
 
-  variables_.push_back(std::make_tuple(constant_name, std::move(dbg_object)));
+  variables_.push_back(FrameVariable(constant_name, std::move(dbg_object)));
   return S_OK;
 }
 
@@ -387,7 +377,6 @@ HRESULT DbgStackFrame::ProcessMethodArguments(
   }
 
   for (size_t i = 0; i < method_arg_values.size(); ++i) {
-    unique_ptr<DbgObject> method_arg_value;
     string method_arg_name;
 
     if (i >= method_argument_names.size()) {
@@ -397,15 +386,8 @@ HRESULT DbgStackFrame::ProcessMethodArguments(
       method_arg_name = method_argument_names[i];
     }
 
-    hr = obj_factory_->CreateDbgObject(method_arg_values[i], object_depth_,
-                                       &method_arg_value, &std::cerr);
-
-    if (FAILED(hr)) {
-      method_arg_value = nullptr;
-    }
-
-    method_arguments_.push_back(std::make_tuple(std::move(method_arg_name),
-                                                std::move(method_arg_value)));
+    method_arguments_.push_back(
+        FrameVariable(method_arg_name, method_arg_values[i]));
   }
 
   return S_OK;
@@ -466,14 +448,14 @@ void DbgStackFrame::ProcessAsyncVariablesAndMethodArgs(
   for (auto &class_field : async_fields) {
     std::string field_name = class_field->GetMemberName();
     if (field_name[0] != '<') {
-      method_arguments_.push_back(std::make_tuple(
+      method_arguments_.push_back(FrameVariable(
           class_field->GetMemberName(), class_field->GetMemberValue()));
       continue;
     }
 
     if (field_name.compare(async_this) == 0) {
       method_arguments_.push_back(
-          std::make_tuple("this", class_field->GetMemberValue()));
+          FrameVariable("this", class_field->GetMemberValue()));
       is_static_method_ = false;
       continue;
     }
@@ -484,7 +466,7 @@ void DbgStackFrame::ProcessAsyncVariablesAndMethodArgs(
       std::string variable_name =
           field_name.substr(1, end_bracket_position - 1);
       variables_.push_back(
-          std::make_tuple(variable_name, class_field->GetMemberValue()));
+          FrameVariable(variable_name, class_field->GetMemberValue()));
     }
   }
 }
@@ -599,82 +581,27 @@ HRESULT DbgStackFrame::InitializeClassGenericTypeParameters(
 }
 
 HRESULT DbgStackFrame::PopulateTypeDict() {
-  if (type_dict_populated_) {
+  if (type_dict_) {
     return S_OK;
   }
 
+  if (!debug_module_) {
+    cerr << "Cannot get types because of null ICorDebugModule.";
+    return E_INVALIDARG;
+  }
+
   CComPtr<IMetaDataImport> metadata_import;
   HRESULT hr = GetMetaDataImport(&metadata_import);
   if (FAILED(hr)) {
     return hr;
   }
 
-  HCORENUM cor_enum = nullptr;
-
-  vector<mdTypeDef> type_defs(100, 0);
-  while (hr == S_OK) {
-    ULONG type_defs_returned = 0;
-    hr = metadata_import->EnumTypeDefs(&cor_enum, type_defs.data(),
-                                       type_defs.size(), &type_defs_returned);
-    if (FAILED(hr)) {
-      cerr << "Failed to get enumerate types with hr: " << std::hex << hr;
-      metadata_import->CloseEnum(cor_enum);
-      return hr;
-    }
-
-    // No type defs.
-    if (type_defs_returned == 0) {
-      break;
-    }
-    type_defs.resize(type_defs_returned);
-
-    for (auto const &type_def_token : type_defs) {
-      std::string type_name;
-      mdToken base_token;
-      hr = debug_helper_->GetTypeNameFromMdTypeDef(
-          type_def_token, metadata_import, &type_name, &base_token, &std::cerr);
-      if (FAILED(hr)) {
-        continue;
-      }
-      type_def_dict_[type_name] = type_def_token;
-    }
-  }
-
-  metadata_import->CloseEnum(cor_enum);
-  cor_enum = nullptr;
-
-  hr = S_OK;
-  vector<mdTypeRef> type_refs(100, 0);
-  while (hr == S_OK) {
-    ULONG type_refs_returned = 0;
-    hr = metadata_import->EnumTypeRefs(&cor_enum, type_refs.data(),
-                                       type_refs.size(), &type_refs_returned);
-    if (FAILED(hr)) {
-      cerr << "Failed to get enumerate types with hr: " << std::hex << hr;
-      return hr;
-    }
-
-    // No type defs.
-    if (type_refs_returned == 0) {
-      break;
-    }
-    type_refs.resize(type_refs_returned);
-
-    for (auto const &type_ref_token : type_refs) {
-      std::string type_name;
-      hr = debug_helper_->GetTypeNameFromMdTypeRef(
-          type_ref_token, metadata_import, &type_name, &std::cerr);
-      type_ref_dict_[type_name] = type_ref_token;
-    }
-  }
-
-  metadata_import->CloseEnum(cor_enum);
-  type_dict_populated_ = true;
-  return S_OK;
+  return type_cache_->GetTypeDict(debug_module_, metadata_import,
+                                  debug_helper_.get(), &type_dict_);
 }
 
 HRESULT DbgStackFrame::PopulateDebugAssemblies() {
-  if (debug_assemblies_populated_) {
+  if (debug_assemblies_) {
     return S_OK;
   }
 
@@ -683,23 +610,8 @@ HRESULT DbgStackFrame::PopulateDebugAssemblies() {
     return E_INVALIDARG;
   }
 
-  CComPtr<ICorDebugAssemblyEnum> assembly_enum;
-  HRESULT hr = app_domain_->EnumerateAssemblies(&assembly_enum);
-  if (FAILED(hr)) {
-    cerr << "Cannot get ICorDebugAssemblyEnum.";
-    return hr;
-  }
-
-  hr = debug_helper_->EnumerateICorDebugSpecifiedType<ICorDebugAssemblyEnum,
-                                                      ICorDebugAssembly>(
-      assembly_enum, &debug_assemblies_);
-  if (FAILED(hr)) {
-    cerr << "Failed to enumerate assemblies.";
-    return hr;
-  }
-
-  debug_assemblies_populated_ = true;
-  return S_OK;
+  return type_cache_->GetDebugAssemblies(app_domain_, debug_helper_.get(),
+                                         &debug_assemblies_);
 }
 
 HRESULT DbgStackFrame::GetClassTokenAndModule(
@@ -717,8 +629,8 @@ HRESULT DbgStackFrame::GetClassTokenAndModule(
   }
 
   // First, we search the dictionary of mdTypeDef.
-  auto type_def_info = type_def_dict_.find(class_name);
-  if (type_def_info != type_def_dict_.end()) {
+  auto type_def_info = type_dict_->type_defs.find(class_name);
+  if (type_def_info != type_dict_->type_defs.end()) {
     *debug_module = debug_module_;
     debug_module_->AddRef();
     *metadata_import = frame_metadata_import;
@@ -733,10 +645,10 @@ HRESULT DbgStackFrame::GetClassTokenAndModule(
   }
 
   // If we didn't find the class, we search the dictionary of mdTypeRef.
-  auto type_ref_info = type_ref_dict_.find(class_name);
-  if (type_ref_info != type_ref_dict_.end()) {
+  auto type_ref_info = type_dict_->type_refs.find(class_name);
+  if (type_ref_info != type_dict_->type_refs.end()) {
     hr = debug_helper_->GetMdTypeDefAndMetaDataFromTypeRef(
-        type_ref_info->second, debug_assemblies_, frame_metadata_import,
+        type_ref_info->second, *debug_assemblies_, frame_metadata_import,
         class_token, metadata_import, &cerr);
     if (FAILED(hr)) {
       return hr;
@@ -785,7 +697,7 @@ HRESULT DbgStackFrame::IsBaseType(const TypeSignature &source_type,
   }
 
   return TypeCompilerHelper::IsBaseClass(
-      source_token, source_metadata_import, debug_assemblies_,
+      source_token, source_metadata_import, *debug_assemblies_,
       target_type.type_name, debug_helper_.get(), err_stream);
 }
 
@@ -812,63 +724,59 @@ HRESULT DbgStackFrame::GetFieldAndAutoPropertyInfo(
 
 HRESULT DbgStackFrame::PopulateStackFrame(
     StackFrame *stack_frame, int stack_frame_size,
-    IEvalCoordinator *eval_coordinator) const {
+    IEvalCoordinator *eval_coordinator, int max_object_depth) const {
   if (!stack_frame || !eval_coordinator) {
     return E_INVALIDARG;
   }
 
+  CapturePlanner planner(eval_coordinator, max_object_depth);
+  AddVariablesToPlan(stack_frame, &planner);
+  // Stops capturing if stack frame reaches the maximum size.
+  return planner.Capture(stack_frame->ByteSize(), stack_frame_size);
+}
+
+void DbgStackFrame::AddVariablesToPlan(StackFrame *stack_frame,
+                                       CapturePlanner *planner) const {
   // We don't have to worry about deleting the pointer as Breakpoint
   // object has ownership of this.
   SourceLocation *location = stack_frame->mutable_location();
-  if (!location) {
-    cerr << "Mutable location returns null.";
-  }
-
   location->set_line(line_number_);
   location->set_path(file_name_);
 
-  queue<VariableWrapper> bfs_queue;
+  IDbgObjectFactory *obj_factory = obj_factory_.get();
+  int object_depth = object_depth_;
 
-  // Processes the local variables and put them into the BFS queue.
-  for (const auto &variable_tuple : variables_) {
+  // Adds the local variables to the plan. The DbgObjects of the
+  // variables are only created when the planner reaches them, so
+  // variables past the budget are never created.
+  for (const auto &variable : variables_) {
     Variable *variable_proto = stack_frame->add_locals();
-
-    variable_proto->set_name(std::get<0>(variable_tuple));
-    const shared_ptr<DbgObject> &variable_value = std::get<1>(variable_tuple);
-
-    if (!variable_value) {
-      continue;
-    }
-
-    bfs_queue.push(VariableWrapper(variable_proto, variable_value));
+    variable_proto->set_name(variable.GetName());
+    planner->AddVariable(VariableWrapper(
+        variable_proto, [&variable, obj_factory, object_depth]() {
+          return variable.GetValue(obj_factory, object_depth);
+        }));
   }
 
-  // Processes the method arguments and put them into the BFS queue.
-  for (const auto &variable_tuple : method_arguments_) {
+  // Adds the method arguments to the plan.
+  for (const auto &variable : method_arguments_) {
     Variable *variable_proto = stack_frame->add_arguments();
-
-    variable_proto->set_name(std::get<0>(variable_tuple));
-    const shared_ptr<DbgObject> &variable_value = std::get<1>(variable_tuple);
-
-    if (!variable_value) {
-      continue;
-    }
-
-    bfs_queue.push(VariableWrapper(variable_proto, variable_value));
+    variable_proto->set_name(variable.GetName());
+    planner->AddVariable(VariableWrapper(
+        variable_proto, [&variable, obj_factory, object_depth]() {
+          return variable.GetValue(obj_factory, object_depth);
+        }));
   }
+}
 
-  if (bfs_queue.size() != 0) {
-    return VariableWrapper::PerformBFS(&bfs_queue,
-                                       [stack_frame, stack_frame_size]() {
-                                         // Terminates the BFS if stack frame
-                                         // reaches the maximum size.
-                                         return stack_frame->ByteSize() >
-                                                stack_frame_size;
-                                       },
-                                       eval_coordinator);
+void DbgStackFrame::CreatePendingVariables() {
+  for (const auto &variable : variables_) {
+    variable.CreateValue(obj_factory_.get(), object_depth_);
   }
 
-  return S_OK;
+  for (const auto &variable : method_arguments_) {
+    variable.CreateValue(obj_factory_.get(), object_depth_);
+  }
 }
 
 HRESULT DbgStackFrame::GetLocalVariable(const std::string &variable_name,
@@ -882,14 +790,14 @@ HRESULT DbgStackFrame::GetLocalVariable(const std::string &variable_name,
   if (variable_name.compare(this_var) != 0) {
     auto local_var = std::find_if(
         variables_.begin(), variables_.end(),
-        [&variable_name](const VariableTuple &variable_tuple) {
-          return variable_name.compare(std::get<0>(variable_tuple)) == 0;
+        [&variable_name](const FrameVariable &variable) {
+          return variable_name.compare(variable.GetName()) == 0;
         });
 
     // If we found a match, we'll create a DbgObject and return it.
     hr = S_OK;
     if (local_var != variables_.end()) {
-      *dbg_object = std::get<1>(*local_var);
+      *dbg_object = local_var->GetValue(obj_factory_.get(), object_depth_);
       return S_OK;
     }
   }
@@ -898,12 +806,12 @@ HRESULT DbgStackFrame::GetLocalVariable(const std::string &variable_name,
   // variable_name.
   auto method_arg = std::find_if(
       method_arguments_.begin(), method_arguments_.end(),
-      [&variable_name](const VariableTuple &variable_tuple) {
-        return variable_name.compare(std::get<0>(variable_tuple)) == 0;
+      [&variable_name](const FrameVariable &variable) {
+        return variable_name.compare(variable.GetName()) == 0;
       });
 
   if (method_arg != method_arguments_.end()) {
-    *dbg_object = std::get<1>(*method_arg);
+    *dbg_object = method_arg->GetValue(obj_factory_.get(), object_depth_);
     return S_OK;
   }
 
@@ -1026,14 +934,14 @@ HRESULT DbgStackFrame::GetPropertyFromFrame(
 std::shared_ptr<DbgObject> DbgStackFrame::GetThisObject() {
   auto this_obj =
       std::find_if(method_arguments_.begin(), method_arguments_.end(),
-                   [](const VariableTuple &variable_tuple) {
-                     return std::get<0>(variable_tuple).compare("this") == 0;
+                   [](const FrameVariable &variable) {
+                     return variable.GetName().compare("this") == 0;
                    });
 
   if (this_obj == method_arguments_.end()) {
     return std::shared_ptr<DbgObject>();
   }
-  return std::get<1>(*this_obj);
+  return this_obj->GetValue(obj_factory_.get(), object_depth_);
 }
 
 HRESULT DbgStackFrame::GetFieldFromClass(
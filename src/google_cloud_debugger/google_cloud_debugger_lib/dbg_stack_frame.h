@@ -22,13 +22,14 @@
 #include <tuple>
 
 #include "document_index.h"
+#include "frame_variable.h"
 #include "i_dbg_stack_frame.h"
+#include "module_type_cache.h"
 #include "type_signature.h"
 
 namespace google_cloud_debugger {
 
-// TODO(quoct): Add error stream into the tuple.
-typedef std::tuple<std::string, std::shared_ptr<DbgObject>> VariableTuple;
+class CapturePlanner;
 class IDbgClassMember;
 
 // This class is represents a stack frame at a breakpoint.
@@ -37,9 +38,15 @@ class IDbgClassMember;
 // method name, class name, file name and line number.
 class DbgStackFrame : public IDbgStackFrame {
  public:
+  // type_cache is used to look up types by name across stack frames
+  // and breakpoint hits. If it is null, the frame creates its own.
   DbgStackFrame(std::shared_ptr<ICorDebugHelper> debug_helper,
-                std::shared_ptr<IDbgObjectFactory> obj_factory)
-      : debug_helper_(debug_helper), obj_factory_(obj_factory) {}
+                std::shared_ptr<IDbgObjectFactory> obj_factory,
+                std::shared_ptr<ModuleTypeCache> type_cache = nullptr)
+      : debug_helper_(debug_helper),
+        obj_factory_(obj_factory),
+        type_cache_(type_cache ? type_cache
+                               : std::make_shared<ModuleTypeCache>()) {}
 
   // Populate method_name_, file_name_, line_number_ and breakpoint_id_.
   // Also populate local variables and method arguments into variables_
@@ -56,10 +63,26 @@ class DbgStackFrame : public IDbgStackFrame {
   // method name, class name, file name and line number.
   // This method may perform function evaluation using eval_coordinator.
   // This method should not fill up the proto stack_frame with more kbs of
-  // information than stack_frame_size.
+  // information than stack_frame_size and does not inspect objects
+  // deeper than max_object_depth.
   HRESULT PopulateStackFrame(
       google::cloud::diagnostics::debug::StackFrame *stack_frame,
-      int stack_frame_size, IEvalCoordinator *eval_coordinator) const;
+      int stack_frame_size, IEvalCoordinator *eval_coordinator,
+      int max_object_depth = kDefaultObjectEvalDepth) const;
+
+  // Populates the location of the StackFrame object and the names of
+  // its local variables and method arguments. Their values are populated
+  // when planner captures them, which allows the variables of several
+  // frames to share a budget.
+  void AddVariablesToPlan(
+      google::cloud::diagnostics::debug::StackFrame *stack_frame,
+      CapturePlanner *planner) const;
+
+  // Creates the DbgObjects of the local variables and method arguments
+  // that have not been needed yet. This has to be called before the
+  // debuggee resumes (for function evaluation) if they may still be
+  // needed afterwards.
+  void CreatePendingVariables();
 
   // Gets a local variable or method arguments with name
   // variable_name.
@@ -195,12 +218,22 @@ class DbgStackFrame : public IDbgStackFrame {
   // Gets the virtual address of the function this stack frame is in.
   ULONG32 GetFuncVirtualAddr() const { return func_virtual_addr_; }
 
+  // Sets the fingerprint of the location of this stack frame.
+  void SetFingerprint(std::uint64_t fingerprint) { fingerprint_ = fingerprint; }
+
+  // Gets the fingerprint of the location of this stack frame.
+  std::uint64_t GetFingerprint() const { return fingerprint_; }
+
   // Returns if this is just an empty frame with no information.
   bool IsEmpty() { return empty_; }
 
   // Sets whether this is an empty frame.
   void SetEmpty(bool empty) { empty_ = empty; }
 
+  // Sets how deep the objects of this frame are inspected. This has
+  // to be called before the frame is initialized.
+  void SetObjectDepth(int object_depth) { object_depth_ = object_depth; }
+
   // Returns true if this is a parsed IL frame.
   bool IsProcessedIlFrame() { return is_processed_il_frame_; }
 
@@ -305,11 +338,11 @@ class DbgStackFrame : public IDbgStackFrame {
   void ProcessAsyncVariablesAndMethodArgs(
       const std::vector<std::shared_ptr<IDbgClassMember>> &async_fields);
 
-  // Populates the type_def_dict_ and type_ref_dict_ with all
-  // the types loaded in this frame.
+  // Populates type_dict_ with all the types of the module
+  // this frame is in.
   HRESULT PopulateTypeDict();
 
-  // Populate debug_assemblies_ with all loaded assemblies
+  // Populates debug_assemblies_ with all loaded assemblies
   // in app_domain_.
   HRESULT PopulateDebugAssemblies();
 
@@ -330,11 +363,11 @@ class DbgStackFrame : public IDbgStackFrame {
                                       ULONG *signature_len,
                                       std::ostream *err_stream);
 
-  // Tuple that contains variable's name, variable's value and the error stream.
-  std::vector<VariableTuple> variables_;
+  // Local variables and constants of the frame.
+  std::vector<FrameVariable> variables_;
 
-  // Tuple that contains method argument's name, value and the error stream.
-  std::vector<VariableTuple> method_arguments_;
+  // Method arguments of the frame.
+  std::vector<FrameVariable> method_arguments_;
 
   // Determines how deep to inspect the object.
   int object_depth_ = kDefaultObjectEvalDepth;
@@ -354,6 +387,9 @@ class DbgStackFrame : public IDbgStackFrame {
   // Virtual address of the function this stack frame is in.
   ULONG32 func_virtual_addr_ = 0;
 
+  // Fingerprint of the module, method and IL offset of this stack frame.
+  std::uint64_t fingerprint_ = 0;
+
   // The line number where the variables are in.
   std::uint32_t line_number_ = 0;
 
@@ -379,27 +415,15 @@ class DbgStackFrame : public IDbgStackFrame {
   // The module this stack frame is in.
   CComPtr<ICorDebugModule> debug_module_;
 
-  // Dictionary whose key is class name and whose value
-  // is the metadata token mdTypeDef of that class.
-  std::map<std::string, mdTypeDef> type_def_dict_;
-
-  // Dictionary whose key is class name and whose value
-  // is the metadata token mdTypeRef of that class.
-  // The difference between mdTypeDef and mdTypeRef
-  // is that mdTypeDef type is found in the current module
-  // whereas mdTypeRef is found in other modules.
-  // Hence, mdTypeRef may needs to be resolved to mdTypeDef
-  // when needed.
-  std::map<std::string, mdTypeRef> type_ref_dict_;
-
-  // True if type_def_dict_ and type_ref_dict_ have been populated.
-  bool type_dict_populated_ = false;
+  // Cache of the types of the loaded modules and of the loaded
+  // assemblies, shared with other stack frames.
+  std::shared_ptr<ModuleTypeCache> type_cache_;
 
-  // Cache of loaded debug assemblies.
-  std::vector<CComPtr<ICorDebugAssembly>> debug_assemblies_;
+  // Types of the module this frame is in. Null until populated.
+  std::shared_ptr<const ModuleTypeDict> type_dict_;
 
-  // True if debug_assemblies_ has been populated.
-  bool debug_assemblies_populated_ = false;
+  // Loaded assemblies of app_domain_. Null until populated.
+  std::shared_ptr<const DebugAssemblies> debug_assemblies_;
 };
 
 }  //  namespace google_cloud_debugger
@@ -17,9 +17,11 @@
 #include <iostream>
 
 #include "class_names.h"
+#include "dbg_breakpoint.h"
 #include "i_cor_debug_helper.h"
 #include "i_eval_coordinator.h"
 
+using google::cloud::diagnostics::debug::Status;
 using google::cloud::diagnostics::debug::Variable;
 using std::string;
 
@@ -32,8 +34,7 @@ void DbgString::Initialize(ICorDebugValue *debug_value, BOOL is_null) {
     return;
   }
 
-  initialize_hr_ = debug_helper_->CreateStrongHandle(
-      debug_value, &object_handle_, GetErrorStream());
+  initialize_hr_ = CreateObjectHandle(debug_value);
   if (FAILED(initialize_hr_)) {
     WriteError("Failed to create a handle for the string.");
   }
@@ -53,12 +54,19 @@ HRESULT DbgString::PopulateValue(Variable *variable) {
     return S_OK;
   }
 
-  HRESULT hr = ExtractStringFromReference();
+  HRESULT hr =
+      ExtractStringFromReference(DbgBreakpoint::GetMaximumStringLength());
   if (FAILED(hr)) {
     return hr;
   }
 
   variable->set_value(string_obj_);
+  if (truncated_) {
+    Status *status = variable->mutable_status();
+    status->set_iserror(false);
+    status->set_message("String truncated. Original length: " +
+                        std::to_string(original_length_) + ".");
+  }
   return S_OK;
 }
 
@@ -81,7 +89,7 @@ HRESULT DbgString::GetString(DbgObject *object, string *returned_string) {
     return E_INVALIDARG;
   }
 
-  HRESULT hr = dbg_string->ExtractStringFromReference();
+  HRESULT hr = dbg_string->ExtractStringFromReference(UINT32_MAX);
   if (FAILED(hr)) {
     return hr;
   }
@@ -90,12 +98,17 @@ HRESULT DbgString::GetString(DbgObject *object, string *returned_string) {
   return S_OK;
 }
 
-HRESULT DbgString::ExtractStringFromReference() {
+HRESULT DbgString::ExtractStringFromReference(std::uint32_t max_length) {
+  // A prefix read with the same limit, or a string that was read whole
+  // and fits in the limit, does not have to be read again.
   if (string_obj_set_) {
-    return S_OK;
+    if (truncated_ ? max_length == read_max_length_
+                   : original_length_ <= max_length) {
+      return S_OK;
+    }
   }
 
-  if (!object_handle_) {
+  if (!GetObjectValue()) {
     return E_INVALIDARG;
   }
 
@@ -103,7 +116,7 @@ HRESULT DbgString::ExtractStringFromReference() {
   CComPtr<ICorDebugValue> debug_value;
   CComPtr<ICorDebugStringValue> debug_string;
 
-  hr = object_handle_->Dereference(&debug_value);
+  hr = DereferenceObject(&debug_value);
 
   if (FAILED(hr)) {
     WriteError("Failed to dereference string reference.");
@@ -118,13 +131,18 @@ HRESULT DbgString::ExtractStringFromReference() {
     return hr;
   }
 
+  ULONG32 original_length = 0;
   hr = debug_helper_->ExtractStringFromICorDebugStringValue(
-      debug_string, &string_obj_, GetErrorStream());
+      debug_string, max_length, &string_obj_, &original_length,
+      ErrorStream(this));
   if (FAILED(hr)) {
     return hr;
   }
 
   string_obj_set_ = true;
+  original_length_ = original_length;
+  read_max_length_ = max_length;
+  truncated_ = original_length > max_length;
   return S_OK;
 }
 
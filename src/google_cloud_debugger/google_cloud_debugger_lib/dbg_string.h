@@ -42,27 +42,49 @@ class DbgString : public DbgReferenceObject {
   void Initialize(ICorDebugValue *debug_value, BOOL is_null) override;
 
   // Dereferences string_handle_ to get the underlying object
-  // and sets the value of variable to that object.
+  // and sets the value of variable to that object. Only the first
+  // DbgBreakpoint::GetMaximumStringLength() characters are captured.
+  // If the string is longer, the status of variable records that it is
+  // truncated and the length of the whole string. This is a status rather
+  // than a field of Variable since the agent forwards variables to the
+  // Cloud Debugger API, which only shows such notes through the status.
   HRESULT PopulateValue(
       google::cloud::diagnostics::debug::Variable *variable) override;
 
   // Sets type of variable to System.String.
   HRESULT GetTypeString(std::string *type_string) override;
 
-  // Extracts string from DbgObject.
+  // Extracts the whole string from DbgObject. This is used when
+  // evaluating expressions, so the string is never truncated.
   // Fails if DbgObject is not a DbgString.
   static HRESULT GetString(DbgObject *object, std::string *returned_string);
 
+  // Returns true if the string read last is truncated.
+  bool IsTruncated() const { return truncated_; }
+
+  // Returns the length of the whole string.
+  std::uint32_t GetOriginalLength() const { return original_length_; }
+
  private:
-  // Dereferences the string handle and extracts out the string
-  // into string_obj_. Will not do anything if string_obj_set_ is true.
-  HRESULT ExtractStringFromReference();
+  // Dereferences the string handle and extracts out at most max_length
+  // characters of the string into string_obj_. Will not do anything if
+  // string_obj_ already holds that prefix.
+  HRESULT ExtractStringFromReference(std::uint32_t max_length);
 
-  // The underlying string object.
+  // The underlying string object, which may only be a prefix of it.
   std::string string_obj_;
 
   // True if string_obj_ is set.
   bool string_obj_set_ = false;
+
+  // True if string_obj_ is only a prefix of the string.
+  bool truncated_ = false;
+
+  // The maximum length string_obj_ was read with.
+  std::uint32_t read_max_length_ = 0;
+
+  // Length of the whole string.
+  std::uint32_t original_length_ = 0;
 };
 
 }  //  namespace google_cloud_debugger
@@ -44,6 +44,11 @@ using std::vector;
 
 Debugger::~Debugger() {
   HRESULT hr;
+  // The profiler stops and continues the process so it is stopped first.
+  if (debugger_callback_) {
+    debugger_callback_->StopSamplingProfiler();
+  }
+
   // Stop and detach the debugger.
   if (cordebug_process_) {
     hr = cordebug_process_->Stop(-1);
@@ -217,6 +222,14 @@ void Debugger::CallbackFunction(IUnknown *unknown, void *parameter,
   }
 
   debugger->debugger_callback_->SetDebugProcess(debugger->cordebug_process_);
+
+  if (debugger->profiler_interval_ > std::chrono::milliseconds::zero()) {
+    hr = debugger->debugger_callback_->StartSamplingProfiler(
+        debugger->profiler_interval_, debugger->profiler_file_path_);
+    if (FAILED(hr)) {
+      cerr << "Failed to start the sampling profiler: " << hex << hr << endl;
+    }
+  }
 }
 
 void Debugger::DeactivateBreakpoints() {
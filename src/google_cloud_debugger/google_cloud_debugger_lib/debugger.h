@@ -15,6 +15,7 @@
 #ifndef DEBUGGER_H_
 #define DEBUGGER_H_
 
+#include <chrono>
 #include <string>
 
 #include "ccomptr.h"
@@ -66,6 +67,15 @@ class Debugger final {
     debugger_callback_->SetMethodEvaluation(eval);
   }
 
+  // Makes the debugger sample the stacks of the process every interval
+  // once it is attached and write them to file_path. Has to be called
+  // before StartDebugging.
+  void EnableSamplingProfiler(std::chrono::milliseconds interval,
+                              const std::string &file_path) {
+    profiler_interval_ = interval;
+    profiler_file_path_ = file_path;
+  }
+
  private:
   // The name of the pipe the debugger will use to communicate with the agent.
   std::string pipe_name_;
@@ -103,6 +113,14 @@ class Debugger final {
 
   // True if we should kill the process upon termination.
   bool kill_proc_;
+
+  // Time between two samples of the sampling profiler. The profiler
+  // is not started if this is 0.
+  std::chrono::milliseconds profiler_interval_ =
+      std::chrono::milliseconds::zero();
+
+  // File the sampling profiler writes the sampled stacks to.
+  std::string profiler_file_path_;
 };
 
 }  // namespace google_cloud_debugger
@@ -25,11 +25,10 @@
 #include "constants.h"
 #include "dbg_stack_frame.h"
 #include "cor_debug_helper.h"
-#include "portable_pdb_file.h"
 #include "eval_coordinator.h"
+#include "metrics.h"
+#include "type_layout_cache.h"
 
-using google_cloud_debugger_portable_pdb::IPortablePdbFile;
-using google_cloud_debugger_portable_pdb::PortablePdbFile;
 using std::cerr;
 using std::cout;
 using std::string;
@@ -44,8 +43,10 @@ HRESULT DebuggerCallback::Initialize() {
 
   // TODO(quoct): We are compiling with C++11 on Linux so we don't have
   // make_unique. We should look into upgrading to C++14.
-  eval_coordinator_ =
-      std::unique_ptr<EvalCoordinator>(new (std::nothrow) EvalCoordinator);
+  method_cache_ = std::make_shared<StackFrameMethodCache>();
+  type_cache_ = std::make_shared<ModuleTypeCache>();
+  eval_coordinator_ = std::unique_ptr<EvalCoordinator>(
+      new (std::nothrow) EvalCoordinator(method_cache_, type_cache_));
   breakpoint_collection_ = std::unique_ptr<IBreakpointCollection>(
       new (std::nothrow) BreakpointCollection);
   if (!eval_coordinator_) {
@@ -60,11 +61,37 @@ HRESULT DebuggerCallback::Initialize() {
   }
 
   debug_helper_ = std::shared_ptr<ICorDebugHelper>(new CorDebugHelper());
+  module_registry_ = std::unique_ptr<ModuleRegistry>(
+      new (std::nothrow) ModuleRegistry(debug_helper_));
+  if (!module_registry_) {
+    cerr << "Failed to create ModuleRegistry.";
+    return E_OUTOFMEMORY;
+  }
 
   initialized_success_ = true;
   return S_OK;
 }
 
+HRESULT DebuggerCallback::StartSamplingProfiler(
+    std::chrono::milliseconds interval, const string &file_path) {
+  if (!debug_process_) {
+    cerr << "Cannot sample the stacks before the process is set.";
+    return E_FAIL;
+  }
+
+  sampling_profiler_ = std::unique_ptr<SamplingProfiler>(
+      new (std::nothrow) SamplingProfiler(
+          debug_process_, debug_helper_, method_cache_,
+          eval_coordinator_.get(), module_registry_.get(), interval,
+          file_path));
+  if (!sampling_profiler_) {
+    cerr << "Failed to create SamplingProfiler.";
+    return E_OUTOFMEMORY;
+  }
+
+  return S_OK;
+}
+
 HRESULT STDMETHODCALLTYPE DebuggerCallback::QueryInterface(REFIID riid,
                                                            void **object) {
   if (riid == __uuidof(ICorDebugManagedCallback)) {
@@ -117,6 +144,8 @@ HRESULT STDMETHODCALLTYPE DebuggerCallback::ExitProcess(ICorDebugProcess *proces
 HRESULT STDMETHODCALLTYPE DebuggerCallback::Breakpoint(
     ICorDebugAppDomain *appdomain, ICorDebugThread *debug_thread,
     ICorDebugBreakpoint *debug_breakpoint) {
+  ScopedPhaseTimer timer(MetricPhase::kBreakpointCallback);
+
   // If a function evaluation is going on, we don't hit breakpoint.
   // Otherwise, this can lead to infinite loop situation. For example,
   // if a user sets a breakpoint in a getter method of property X and we
@@ -146,9 +175,17 @@ HRESULT STDMETHODCALLTYPE DebuggerCallback::Breakpoint(
     return hr;
   }
 
+  std::shared_ptr<const PdbFileIndex> pdb_index;
+  {
+    // Only waits if modules loaded just before the hit are still being
+    // registered.
+    ScopedPhaseTimer pdb_lookup_timer(MetricPhase::kPdbLookup);
+    pdb_index = GetPdbFileIndex();
+  }
+
   hr = breakpoint_collection_->EvaluateAndPrintBreakpoint(
-      function_token, il_offset, eval_coordinator_.get(),
-      debug_thread, portable_pdbs_);
+      function_token, il_offset, eval_coordinator_.get(), debug_thread,
+      std::move(pdb_index));
   if (FAILED(hr)) {
     cerr << "Failed to get stack frame's information.";
     appdomain->Continue(FALSE);
@@ -184,22 +221,41 @@ HRESULT STDMETHODCALLTYPE DebuggerCallback::EvalException(
 
 HRESULT DebuggerCallback::LoadModule(ICorDebugAppDomain *appdomain,
                                      ICorDebugModule *debug_module) {
-  std::unique_ptr<IPortablePdbFile> portable_pdb(new (std::nothrow)
-                                                     PortablePdbFile());
-  if (!portable_pdb) {
-    cerr << "Cannot create PortablePdbFile object.";
-    appdomain->Continue(FALSE);
-    return E_OUTOFMEMORY;
-  }
+  // Parsing the PDB file is deferred to the registry's background thread
+  // so the debuggee is not held up while loading assemblies at startup.
+  module_registry_->AddModule(debug_module);
+  return appdomain->Continue(FALSE);
+}
 
-  HRESULT hr = portable_pdb->Initialize(debug_module, debug_helper_.get());
-  if (FAILED(hr)) {
-    cerr << "Failed set debug module for PortablePdbFile.";
-    return appdomain->Continue(FALSE);
+HRESULT DebuggerCallback::UnloadModule(ICorDebugAppDomain *appdomain,
+                                       ICorDebugModule *debug_module) {
+  // Another module may later be loaded at the same base address so
+  // anything cached for this one has to go.
+  CORDB_ADDRESS module_base_address = 0;
+  HRESULT hr = debug_module->GetBaseAddress(&module_base_address);
+  if (SUCCEEDED(hr)) {
+    module_registry_->RemoveModule(module_base_address);
+    method_cache_->RemoveModule(module_base_address);
+    type_cache_->RemoveModule(module_base_address);
+    TypeLayoutCache::GetInstance()->RemoveModule(module_base_address);
+  } else {
+    cerr << "Failed to get base address of the unloaded module.";
   }
 
-  portable_pdbs_.push_back(std::move(portable_pdb));
+  type_cache_->ClearDebugAssemblies();
+  return appdomain->Continue(FALSE);
+}
+
+HRESULT DebuggerCallback::LoadAssembly(ICorDebugAppDomain *appdomain,
+                                       ICorDebugAssembly *assembly) {
+  // Type references may now resolve to the new assembly.
+  type_cache_->ClearDebugAssemblies();
+  return appdomain->Continue(FALSE);
+}
 
+HRESULT DebuggerCallback::UnloadAssembly(ICorDebugAppDomain *appdomain,
+                                         ICorDebugAssembly *assembly) {
+  type_cache_->ClearDebugAssemblies();
   return appdomain->Continue(FALSE);
 }
 
@@ -17,13 +17,19 @@
 
 #include <atomic>
 #include <iostream>
+#include <chrono>
 #include <memory>
+#include <string>
 
 #include "i_breakpoint_collection.h"
 #include "cor.h"
 #include "cordebug.h"
 #include "corsym.h"
 #include "i_eval_coordinator.h"
+#include "module_registry.h"
+#include "module_type_cache.h"
+#include "sampling_profiler.h"
+#include "stack_frame_method_cache.h"
 
 namespace google_cloud_debugger {
 
@@ -67,6 +73,18 @@ class DebuggerCallback final : public ICorDebugManagedCallback,
   HRESULT STDMETHODCALLTYPE LoadModule(ICorDebugAppDomain *appdomain,
                                        ICorDebugModule *debug_module) override;
 
+  // This method is called when a module is unloaded.
+  HRESULT STDMETHODCALLTYPE UnloadModule(
+      ICorDebugAppDomain *appdomain, ICorDebugModule *debug_module) override;
+
+  // This method is called when an assembly is loaded.
+  HRESULT STDMETHODCALLTYPE LoadAssembly(
+      ICorDebugAppDomain *appdomain, ICorDebugAssembly *assembly) override;
+
+  // This method is called when an assembly is unloaded.
+  HRESULT STDMETHODCALLTYPE UnloadAssembly(
+      ICorDebugAppDomain *appdomain, ICorDebugAssembly *assembly) override;
+
   // This method is called when the process the debugger is watching exits.
   HRESULT STDMETHODCALLTYPE ExitProcess(ICorDebugProcess *process) override;
 
@@ -96,8 +114,6 @@ class DebuggerCallback final : public ICorDebugManagedCallback,
                         ICorDebugThread *debug_thread);
   DEBUGGERCALLBACK_STUB(ExitThread, ICorDebugAppDomain,
                         ICorDebugThread *debug_thread);
-  DEBUGGERCALLBACK_STUB(UnloadModule, ICorDebugAppDomain,
-                        ICorDebugModule *debug_module);
   DEBUGGERCALLBACK_STUB(LoadClass, ICorDebugAppDomain,
                         ICorDebugClass *debug_class);
   DEBUGGERCALLBACK_STUB(UnloadClass, ICorDebugAppDomain,
@@ -114,10 +130,6 @@ class DebuggerCallback final : public ICorDebugManagedCallback,
                         ICorDebugAppDomain *appdomain);
   DEBUGGERCALLBACK_STUB(ExitAppDomain, ICorDebugProcess,
                         ICorDebugAppDomain *appdomain);
-  DEBUGGERCALLBACK_STUB(LoadAssembly, ICorDebugAppDomain,
-                        ICorDebugAssembly *assembly);
-  DEBUGGERCALLBACK_STUB(UnloadAssembly, ICorDebugAppDomain,
-                        ICorDebugAssembly *assembly);
   DEBUGGERCALLBACK_STUB(ControlCTrap, ICorDebugProcess);
   DEBUGGERCALLBACK_STUB(NameChange, ICorDebugAppDomain,
                         ICorDebugThread *debug_thread);
@@ -168,11 +180,10 @@ class DebuggerCallback final : public ICorDebugManagedCallback,
     debug_process_ = debug_process;
   };
 
-  // Returns all the PDB files that are parsed.
-  const std::vector<
-      std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>>
-      &GetPdbFiles() const {
-    return portable_pdbs_;
+  // Returns the parsed PDB files of all the modules loaded so far,
+  // indexed by module base address.
+  std::shared_ptr<const PdbFileIndex> GetPdbFileIndex() const {
+    return module_registry_->GetPdbFileIndex();
   }
 
   // Reads, parses and activates/deactivates incoming breakpoints.
@@ -198,6 +209,14 @@ class DebuggerCallback final : public ICorDebugManagedCallback,
   // Gets the name of the pipe the debugger will use to communicate with
   // the agent.
   std::string GetPipeName() { return pipe_name_; }
+
+  // Starts sampling the stacks of the debugged process every interval
+  // and writing them to file_path. Has to be called after SetDebugProcess.
+  HRESULT StartSamplingProfiler(std::chrono::milliseconds interval,
+                                const std::string &file_path);
+
+  // Stops sampling the stacks of the debugged process.
+  void StopSamplingProfiler() { sampling_profiler_.reset(); }
   
  private:
   // Given an ICorDebugBreakpoint, gets the function token, IL offset
@@ -215,10 +234,15 @@ class DebuggerCallback final : public ICorDebugManagedCallback,
   // This field is used for reference counting (AddRef and Release).
   std::atomic<ULONG> ref_count_;
 
-  // Vector containing all the portable PDB files that are parsed.
-  std::vector<
-      std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>>
-      portable_pdbs_;
+  // Registry of the loaded modules and their portable PDB files.
+  std::unique_ptr<ModuleRegistry> module_registry_;
+
+  // Names of the methods on the stack, cached across breakpoint hits.
+  std::shared_ptr<StackFrameMethodCache> method_cache_;
+
+  // Types of the loaded modules and loaded assemblies, cached across
+  // breakpoint hits.
+  std::shared_ptr<ModuleTypeCache> type_cache_;
 
   // The ICorDebugProcess of the debugged process.
   CComPtr<ICorDebugProcess> debug_process_;
@@ -230,6 +254,10 @@ class DebuggerCallback final : public ICorDebugManagedCallback,
   // Helper methods for ICorDebug objects.
   std::shared_ptr<ICorDebugHelper> debug_helper_;
 
+  // Samples the stacks of the debugged process. This uses the fields
+  // above, so it is declared after them to be destroyed first.
+  std::unique_ptr<SamplingProfiler> sampling_profiler_;
+
   bool initialized_success_ = false;
 
   // The name of the pipe the debugger will use to communicate with the agent.
@@ -0,0 +1,167 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "enum_table.h"
+
+#include <cstring>
+
+using std::lock_guard;
+using std::make_pair;
+using std::mutex;
+using std::shared_ptr;
+using std::string;
+using std::vector;
+
+namespace google_cloud_debugger {
+
+// Name of the non-static field that holds the value of an enum.
+static const char kEnumValueFieldName[] = "value__";
+
+EnumTable::EnumTable(const vector<FieldLayout> &fields) {
+  for (const FieldLayout &field : fields) {
+    if (FAILED(field.hr) || IsFdStatic(field.attributes) ||
+        field.name.compare(kEnumValueFieldName) != 0 || !field.signature) {
+      continue;
+    }
+
+    PCCOR_SIGNATURE field_signature = field.signature;
+    enum_type_ = CorSigUncompressElementType(field_signature);
+    break;
+  }
+
+  if (enum_type_ == CorElementType::ELEMENT_TYPE_END) {
+    return;
+  }
+
+  for (const FieldLayout &field : fields) {
+    if (FAILED(field.hr) || !IsFdStatic(field.attributes) ||
+        !field.default_value) {
+      continue;
+    }
+
+    ULONG64 value = ExtractEnumValue(enum_type_, field.default_value);
+    // If several constants have the same value, the first one names it.
+    names_by_value_.insert(make_pair(value, field.name));
+    if (value != 0) {
+      flags_.push_back(make_pair(value, field.name));
+    }
+  }
+}
+
+string EnumTable::GetValueName(ULONG64 value) const {
+  auto it = names_by_value_.find(value);
+  if (it != names_by_value_.end()) {
+    return it->second;
+  }
+
+  // Zeroes out the bits of each constant that is part of value.
+  string value_name;
+  ULONG64 remaining_value = value;
+  for (const auto &flag : flags_) {
+    if ((flag.first & remaining_value) != flag.first) {
+      continue;
+    }
+
+    remaining_value &= ~flag.first;
+    if (!value_name.empty()) {
+      value_name.append(" | ");
+    }
+    value_name.append(flag.second);
+  }
+
+  return value_name;
+}
+
+ULONG64 EnumTable::ExtractEnumValue(CorElementType enum_type,
+                                    const void *enum_value) {
+  switch (enum_type) {
+    case ELEMENT_TYPE_I:
+      return (ULONG64)(*((const intptr_t *)enum_value));
+    case ELEMENT_TYPE_U:
+      return (ULONG64)(*((const uintptr_t *)enum_value));
+    case ELEMENT_TYPE_CHAR:
+    case ELEMENT_TYPE_I1:
+      return (ULONG64)(*((const int8_t *)enum_value));
+    case ELEMENT_TYPE_U1:
+      return (ULONG64)(*((const uint8_t *)enum_value));
+    case ELEMENT_TYPE_I2:
+      return (ULONG64)(*((const int16_t *)enum_value));
+    case ELEMENT_TYPE_U2:
+      return (ULONG64)(*((const uint16_t *)enum_value));
+    case ELEMENT_TYPE_I4:
+      return (ULONG64)(*((const int32_t *)enum_value));
+    case ELEMENT_TYPE_U4:
+      return (ULONG64)(*((const uint32_t *)enum_value));
+    case ELEMENT_TYPE_I8:
+      return (ULONG64)(*((const int64_t *)enum_value));
+    case ELEMENT_TYPE_U8:
+      return (ULONG64)(*((const uint64_t *)enum_value));
+    default:
+      return 0;
+  }
+}
+
+EnumTableCache *EnumTableCache::GetInstance() {
+  static EnumTableCache enum_table_cache;
+  return &enum_table_cache;
+}
+
+shared_ptr<const EnumTable> EnumTableCache::GetTable(const string &module_mvid,
+                                                     mdTypeDef enum_token) {
+  lock_guard<mutex> lk(mutex_);
+  auto it = tables_.find(make_pair(module_mvid, enum_token));
+  if (it == tables_.end()) {
+    return nullptr;
+  }
+
+  return it->second;
+}
+
+void EnumTableCache::AddTable(const string &module_mvid, mdTypeDef enum_token,
+                              shared_ptr<const EnumTable> table) {
+  lock_guard<mutex> lk(mutex_);
+  if (tables_.size() >= kMaximumCachedTables) {
+    return;
+  }
+
+  tables_[make_pair(module_mvid, enum_token)] = std::move(table);
+}
+
+HRESULT EnumTableCache::GetModuleMvid(IMetaDataImport *metadata_import,
+                                      string *module_mvid) {
+  if (!metadata_import || !module_mvid) {
+    return E_INVALIDARG;
+  }
+
+  GUID mvid;
+  memset(&mvid, 0, sizeof(mvid));
+  ULONG module_name_length = 0;
+  HRESULT hr = metadata_import->GetScopeProps(nullptr, 0, &module_name_length,
+                                              &mvid);
+  if (FAILED(hr)) {
+    return hr;
+  }
+
+  GUID empty_mvid;
+  memset(&empty_mvid, 0, sizeof(empty_mvid));
+  if (memcmp(&mvid, &empty_mvid, sizeof(mvid)) == 0) {
+    return E_FAIL;
+  }
+
+  module_mvid->assign(reinterpret_cast<const char *>(&mvid), sizeof(mvid));
+  return S_OK;
+}
+
+}  //  namespace google_cloud_debugger
@@ -0,0 +1,112 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef ENUM_TABLE_H_
+#define ENUM_TABLE_H_
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "cor.h"
+#include "cordebug.h"
+#include "type_layout_cache.h"
+
+namespace google_cloud_debugger {
+
+// Names of the values of an enum. The table only depends on the
+// metadata of the enum so it is built once and shared by every object
+// of the enum. It is immutable once built.
+class EnumTable {
+ public:
+  // Builds the table from the fields of the enum. The underlying type
+  // of the enum is the type of its non-static field value__ and its
+  // values are the constants of its static fields.
+  explicit EnumTable(const std::vector<FieldLayout> &fields);
+
+  // Returns the underlying integral type of the enum or
+  // ELEMENT_TYPE_END if the enum does not have a value__ field.
+  CorElementType GetEnumType() const { return enum_type_; }
+
+  // Returns the name of the constant equal to value. If there is none,
+  // returns the names of the constants whose bits make up value,
+  // separated by " | " (for example, "Read | Write").
+  std::string GetValueName(ULONG64 value) const;
+
+  // Given a void pointer and type of the enum, extracts out the enum
+  // value.
+  static ULONG64 ExtractEnumValue(CorElementType enum_type,
+                                  const void *enum_value);
+
+ private:
+  // The integral type of the enum.
+  CorElementType enum_type_ = CorElementType::ELEMENT_TYPE_END;
+
+  // Name of the first constant of each value of the enum.
+  std::unordered_map<ULONG64, std::string> names_by_value_;
+
+  // Non-zero constants of the enum in metadata order. A value that is
+  // not a constant is decomposed into these.
+  std::vector<std::pair<ULONG64, std::string>> flags_;
+};
+
+// Process-wide cache of EnumTable keyed by the MVID of the module and
+// the token of the enum. The MVID is used instead of the base address
+// of the module because enums of constants are only resolved to the
+// metadata of their module. Tables do not point into the metadata so
+// they stay valid after the module is unloaded.
+// This class is thread-safe.
+class EnumTableCache {
+ public:
+  // Maximum number of tables cached. Once the cache is full, new
+  // tables are not cached.
+  static const std::size_t kMaximumCachedTables = 10000;
+
+  // Returns the enum table cache of the debugger.
+  static EnumTableCache *GetInstance();
+
+  // Returns the table of the enum with token enum_token in the module
+  // with MVID module_mvid. Returns nullptr if it is not cached.
+  std::shared_ptr<const EnumTable> GetTable(const std::string &module_mvid,
+                                            mdTypeDef enum_token);
+
+  // Caches table as the table of the enum with token enum_token in the
+  // module with MVID module_mvid.
+  void AddTable(const std::string &module_mvid, mdTypeDef enum_token,
+                std::shared_ptr<const EnumTable> table);
+
+  // Gets the MVID of the module of metadata_import as a string of bytes.
+  // Fails if the module does not have an MVID (only seen with mocked
+  // metadata).
+  static HRESULT GetModuleMvid(IMetaDataImport *metadata_import,
+                               std::string *module_mvid);
+
+ private:
+  // Cached tables by module MVID and enum token.
+  std::map<std::pair<std::string, mdTypeDef>,
+           std::shared_ptr<const EnumTable>>
+      tables_;
+
+  // Guards tables_.
+  std::mutex mutex_;
+};
+
+}  //  namespace google_cloud_debugger
+
+#endif  //  ENUM_TABLE_H_
@@ -0,0 +1,69 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "eval_completion_channel.h"
+
+using std::lock_guard;
+using std::mutex;
+using std::unique_lock;
+using std::chrono::steady_clock;
+
+namespace google_cloud_debugger {
+
+void EvalCompletionChannel::Reset() {
+  lock_guard<mutex> lk(mutex_);
+  debugger_callback_can_continue_ = false;
+  eval_complete_ = false;
+}
+
+void EvalCompletionChannel::SignalDebuggerCallback() {
+  {
+    lock_guard<mutex> lk(mutex_);
+    debugger_callback_can_continue_ = true;
+  }
+  debugger_callback_cv_.notify_one();
+}
+
+void EvalCompletionChannel::WaitForCaptureThread() {
+  unique_lock<mutex> lk(mutex_);
+  debugger_callback_cv_.wait(lk,
+                             [&] { return debugger_callback_can_continue_; });
+  debugger_callback_can_continue_ = false;
+}
+
+void EvalCompletionChannel::SignalEvalComplete() {
+  {
+    lock_guard<mutex> lk(mutex_);
+    eval_complete_ = true;
+  }
+  capture_thread_cv_.notify_one();
+}
+
+bool EvalCompletionChannel::WaitForEvalComplete(
+    const steady_clock::time_point &deadline) {
+  unique_lock<mutex> lk(mutex_);
+  if (!capture_thread_cv_.wait_until(lk, deadline,
+                                     [&] { return eval_complete_; })) {
+    // The capture thread gives up on the eval, so a late EvalComplete
+    // must not find a token and continue the debuggee while the
+    // capture is still reading values.
+    debugger_callback_can_continue_ = false;
+    return false;
+  }
+
+  eval_complete_ = false;
+  return true;
+}
+
+}  //  namespace google_cloud_debugger
@@ -0,0 +1,81 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef EVAL_COMPLETION_CHANNEL_H_
+#define EVAL_COMPLETION_CHANNEL_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+
+namespace google_cloud_debugger {
+
+// Single-producer/single-consumer channel used by EvalCoordinator to hand
+// control back and forth between the DebuggerCallback thread and the
+// thread that captures the breakpoint.
+//
+// The channel has two one-slot mailboxes, one per direction:
+//  1. The capture thread posts to the callback thread when the debuggee
+//     can be continued (either to run a func-eval or because the capture
+//     is finished).
+//  2. The callback thread posts to the capture thread when a func-eval
+//     completes (EvalComplete or EvalException callback).
+//
+// Each wait consumes the token posted by the other side, so a func-eval
+// costs exactly one wake-up in each direction. Waiters are notified
+// after the lock is released so the woken thread does not immediately
+// block on the mutex.
+class EvalCompletionChannel {
+ public:
+  // Clears any stale tokens in both directions.
+  void Reset();
+
+  // Called by the capture thread to let the DebuggerCallback thread
+  // return control to the debuggee.
+  void SignalDebuggerCallback();
+
+  // Called by the DebuggerCallback thread. Blocks until the capture thread
+  // calls SignalDebuggerCallback.
+  void WaitForCaptureThread();
+
+  // Called by the DebuggerCallback thread when a func-eval finishes.
+  void SignalEvalComplete();
+
+  // Called by the capture thread. Blocks until the DebuggerCallback thread
+  // calls SignalEvalComplete or until deadline is reached.
+  // Returns false if the deadline is reached first, in which case the
+  // token posted by SignalDebuggerCallback is cleared if it was not
+  // consumed yet.
+  bool WaitForEvalComplete(
+      const std::chrono::steady_clock::time_point &deadline);
+
+ private:
+  std::mutex mutex_;
+
+  // The DebuggerCallback thread waits on this.
+  std::condition_variable debugger_callback_cv_;
+
+  // The capture thread waits on this.
+  std::condition_variable capture_thread_cv_;
+
+  // Token posted by the capture thread for the DebuggerCallback thread.
+  bool debugger_callback_can_continue_ = false;
+
+  // Token posted by the DebuggerCallback thread for the capture thread.
+  bool eval_complete_ = false;
+};
+
+}  //  namespace google_cloud_debugger
+
+#endif  // EVAL_COMPLETION_CHANNEL_H_
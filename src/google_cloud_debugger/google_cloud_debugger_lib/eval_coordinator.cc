@@ -19,6 +19,7 @@
 #include <iostream>
 #include <memory>
 #include <thread>
+#include <vector>
 
 #include "breakpoint.pb.h"
 #include "breakpoint_collection.h"
@@ -26,6 +27,10 @@
 #include "dbg_breakpoint.h"
 #include "dbg_class.h"
 #include "dbg_object_factory.h"
+#include "metrics.h"
+#include "object_handle_pool.h"
+#include "pdb_file_index.h"
+#include "snapshot_arena.h"
 #include "stack_frame_collection.h"
 
 using google::cloud::diagnostics::debug::Breakpoint;
@@ -34,20 +39,45 @@ using std::lock_guard;
 using std::mutex;
 using std::unique_lock;
 using std::unique_ptr;
-using std::chrono::high_resolution_clock;
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
 using std::chrono::minutes;
+using std::chrono::steady_clock;
 
 namespace google_cloud_debugger {
 
 minutes EvalCoordinator::one_minute = minutes(1);
+std::atomic<std::uint64_t> EvalCoordinator::eval_count_(0);
 
 HRESULT EvalCoordinator::CreateEval(ICorDebugEval **eval) {
-  lock_guard<mutex> lk(mutex_);
+  std::vector<std::function<void()>> before_eval_callbacks;
+  {
+    lock_guard<mutex> lk(mutex_);
+    before_eval_callbacks.swap(before_eval_callbacks_);
+  }
+
+  // The callbacks may create DbgObjects, so they are called without
+  // holding the lock.
+  for (auto &callback : before_eval_callbacks) {
+    callback();
+  }
 
+  // The values of the objects without a handle, including any created
+  // by the callbacks above, are lost once the debuggee runs the eval.
+  ObjectHandlePool *handle_pool = ObjectHandlePool::GetCurrent();
+  if (handle_pool) {
+    handle_pool->CreatePendingHandles();
+  }
+
+  lock_guard<mutex> lk(mutex_);
   if (active_debug_thread_ == nullptr) {
     std::cerr << "Active debug thread is missing";
     return E_FAIL;
   }
+
+  // Addresses read from now on may belong to other objects than the
+  // addresses read before, since the eval can move objects.
+  ++eval_count_;
   return active_debug_thread_->CreateEval(eval);
 }
 
@@ -74,96 +104,94 @@ HRESULT EvalCoordinator::CreateStackWalk(
 HRESULT EvalCoordinator::WaitForEval(BOOL *exception_thrown,
                                      ICorDebugEval *eval,
                                      ICorDebugValue **eval_result) {
-  // Let the debugger continue so we can get back the eval result.
-  unique_lock<mutex> lk(mutex_);
+  ScopedPhaseTimer timer(MetricPhase::kFuncEval);
 
-  waiting_for_eval_ = TRUE;
-  debuggercallback_can_continue_ = TRUE;
-  eval_exception_occurred_ = FALSE;
-  HRESULT hr = CORDBG_E_FUNC_EVAL_NOT_COMPLETE;
-  auto start = high_resolution_clock::now();
+  {
+    lock_guard<mutex> lk(mutex_);
+    waiting_for_eval_ = TRUE;
+    eval_exception_occurred_ = FALSE;
+  }
+
+  // The eval may already be finished (or may have failed) so check
+  // before handing control to the debugger.
+  HRESULT hr = eval->GetResult(eval_result);
+  auto deadline = steady_clock::now() + one_minute;
 
-  // Wait until evaluation is done.
+  // Wait until evaluation is done. The debugger callback thread only
+  // posts to the channel from EvalComplete or EvalException, so we only
+  // have to query the result again once we are woken up.
   while (hr == CORDBG_E_FUNC_EVAL_NOT_COMPLETE ||
          hr == CORDBG_E_PROCESS_NOT_SYNCHRONIZED) {
-    auto current = high_resolution_clock::now();
-    if (current - start > one_minute) {
+    // Let the debugger continue so we can get back the eval result.
+    eval_channel_.SignalDebuggerCallback();
+    if (!eval_channel_.WaitForEvalComplete(deadline)) {
       hr = CORDBG_E_FUNC_EVAL_NOT_COMPLETE;
       cerr << "Timed out while trying to evaluate function.";
       break;
     }
 
     hr = eval->GetResult(eval_result);
-
-    if (hr == CORDBG_E_FUNC_EVAL_NOT_COMPLETE ||
-        hr == CORDBG_E_PROCESS_NOT_SYNCHRONIZED) {
-      // Wake up the debugger thread to do the evaluation.
-      debugger_callback_cv_.notify_one();
-      variable_threads_cv_.wait_for(lk, one_minute);
-    } else {
-      break;
-    }
   }
 
-  // We got our lock back!
   // Tells the debugger to chill out until our next eval call or we reach the
   // end.
-  debuggercallback_can_continue_ = FALSE;
+  lock_guard<mutex> lk(mutex_);
   waiting_for_eval_ = FALSE;
-
   *exception_thrown = eval_exception_occurred_;
   return hr;
 }
 
 void EvalCoordinator::SignalFinishedEval(ICorDebugThread *debug_thread) {
-  unique_lock<mutex> lk(mutex_);
+  {
+    lock_guard<mutex> lk(mutex_);
+    active_debug_thread_ = debug_thread;
+  }
 
-  debuggercallback_can_continue_ = FALSE;
-  active_debug_thread_ = debug_thread;
-  // Wake up all variable threads and so one of them can
-  // use the evaluation result.
-  variable_threads_cv_.notify_all();
+  // Wake up the capture thread so it can use the evaluation result.
+  eval_channel_.SignalEvalComplete();
 
-  // finished_printing_variables_ is set to true if the StackFrame
-  // decides to call SignalFinishedPrintingVariable to signal that it has
-  // finished printing the variables.
-  // debuggercallback_can_continue_ is set to true if the StackFrame
-  // makes another evaluation by calling WaitForEval.
-  debugger_callback_cv_.wait(lk,
-                             [&] { return debuggercallback_can_continue_; });
+  // The capture thread posts back to the channel either when it makes
+  // another evaluation by calling WaitForEval or when it calls
+  // SignalFinishedPrintingVariable to signal that it has finished
+  // printing the variables.
+  eval_channel_.WaitForCaptureThread();
 }
 
 HRESULT EvalCoordinator::ProcessBreakpoints(
     ICorDebugThread *debug_thread, IBreakpointCollection *breakpoint_collection,
     std::vector<std::shared_ptr<DbgBreakpoint>> breakpoints,
-    const std::vector<
-        std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>>
-        &pdb_files) {
+    std::shared_ptr<const PdbFileIndex> pdb_index) {
   if (!debug_thread) {
     cerr << "Debug stack walk is null.";
     return E_INVALIDARG;
   }
 
-  active_debug_thread_ = debug_thread;
+  // Drops tokens left over from an eval that timed out.
+  eval_channel_.Reset();
 
-  unique_lock<mutex> lk(mutex_);
+  {
+    unique_lock<mutex> lk(mutex_);
+    // The sample continues the debuggee when it is done, so the capture
+    // only starts afterwards.
+    sample_ended_cv_.wait(lk, [&] { return !sampling_; });
+    capturing_ = TRUE;
+    active_debug_thread_ = debug_thread;
+    ready_to_print_variables_ = TRUE;
+    property_values_.clear();
+    before_eval_callbacks_.clear();
+  }
 
   std::future<HRESULT> print_breakpoint_task = std::async(
       std::launch::async, &EvalCoordinator::ProcessBreakpointsTask, this,
-      breakpoint_collection, std::move(breakpoints), pdb_files);
+      breakpoint_collection, std::move(breakpoints), pdb_index);
   print_breakpoint_tasks_.push_back(std::move(print_breakpoint_task));
 
-  ready_to_print_variables_ = TRUE;
-  debuggercallback_can_continue_ = FALSE;
-
   // Notify the StackFrame threads we are ready.
   variable_threads_cv_.notify_all();
 
-  // The StackFrame in active_debug_thread_ will have to set
-  // debuggerCallBackCanContinue to TRUE by either calling WaitForEval
-  // or SignalFinishPrintingVariable.
-  debugger_callback_cv_.wait(lk,
-                             [&] { return debuggercallback_can_continue_; });
+  // The StackFrame in active_debug_thread_ will have to post to the
+  // channel by either calling WaitForEval or SignalFinishPrintingVariable.
+  eval_channel_.WaitForCaptureThread();
 
   return S_OK;
 }
@@ -186,9 +214,11 @@ void EvalCoordinator::SignalFinishedPrintingVariable() {
   {
     lock_guard<mutex> lk(mutex_);
     DbgClass::ClearStaticCache();
-    debuggercallback_can_continue_ = TRUE;
+    property_values_.clear();
+    before_eval_callbacks_.clear();
+    capturing_ = FALSE;
   }
-  debugger_callback_cv_.notify_one();
+  eval_channel_.SignalDebuggerCallback();
 }
 
 HRESULT EvalCoordinator::GetActiveDebugThread(ICorDebugThread **debug_thread) {
@@ -226,6 +256,118 @@ HRESULT EvalCoordinator::GetActiveDebugFrame(
   return E_FAIL;
 }
 
+std::shared_ptr<DbgObject> EvalCoordinator::GetCachedPropertyValue(
+    ICorDebugValue *object_value, CORDB_ADDRESS object_address,
+    std::uint64_t address_eval_count, CORDB_ADDRESS module_base_address,
+    mdMethodDef getter_token) {
+  std::uint64_t eval_count = eval_count_;
+  if (address_eval_count != eval_count) {
+    // The object may have moved since object_address was read.
+    if (FAILED(GetHandleAddress(object_value, &object_address))) {
+      return nullptr;
+    }
+  }
+
+  lock_guard<mutex> lk(mutex_);
+  UpdatePropertyValueAddresses(eval_count);
+  auto property_value = property_values_.find(
+      std::make_tuple(object_address, module_base_address, getter_token));
+  if (property_value == property_values_.end()) {
+    return nullptr;
+  }
+
+  return property_value->second.value;
+}
+
+void EvalCoordinator::CachePropertyValue(ICorDebugValue *object_handle,
+                                         CORDB_ADDRESS module_base_address,
+                                         mdMethodDef getter_token,
+                                         std::shared_ptr<DbgObject> value) {
+  CachedPropertyValue cached_value;
+  CORDB_ADDRESS object_address;
+  if (!object_handle ||
+      FAILED(object_handle->QueryInterface(
+          __uuidof(ICorDebugHandleValue),
+          reinterpret_cast<void **>(&cached_value.object_handle))) ||
+      FAILED(cached_value.object_handle->GetValue(&object_address))) {
+    return;
+  }
+  cached_value.value = std::move(value);
+
+  lock_guard<mutex> lk(mutex_);
+  UpdatePropertyValueAddresses(eval_count_);
+  property_values_[std::make_tuple(object_address, module_base_address,
+                                   getter_token)] = std::move(cached_value);
+}
+
+void EvalCoordinator::UpdatePropertyValueAddresses(std::uint64_t eval_count) {
+  if (property_values_eval_count_ == eval_count) {
+    return;
+  }
+
+  // Re-keys every cached value by the current address of its object.
+  // Values whose handle cannot be read any more are dropped.
+  std::map<std::tuple<CORDB_ADDRESS, CORDB_ADDRESS, mdMethodDef>,
+           CachedPropertyValue>
+      property_values;
+  for (auto &property_value : property_values_) {
+    CORDB_ADDRESS object_address;
+    if (FAILED(property_value.second.object_handle->GetValue(
+            &object_address))) {
+      continue;
+    }
+
+    property_values[std::make_tuple(object_address,
+                                    std::get<1>(property_value.first),
+                                    std::get<2>(property_value.first))] =
+        std::move(property_value.second);
+  }
+
+  property_values_ = std::move(property_values);
+  property_values_eval_count_ = eval_count;
+}
+
+HRESULT EvalCoordinator::GetHandleAddress(ICorDebugValue *object_value,
+                                          CORDB_ADDRESS *address) {
+  if (!object_value) {
+    return E_INVALIDARG;
+  }
+
+  CComPtr<ICorDebugHandleValue> object_handle;
+  HRESULT hr = object_value->QueryInterface(
+      __uuidof(ICorDebugHandleValue),
+      reinterpret_cast<void **>(&object_handle));
+  if (FAILED(hr)) {
+    return hr;
+  }
+
+  // The value of a reference is the address of the object it points to.
+  return object_handle->GetValue(address);
+}
+
+void EvalCoordinator::AddBeforeEvalCallback(std::function<void()> callback) {
+  lock_guard<mutex> lk(mutex_);
+  before_eval_callbacks_.push_back(std::move(callback));
+}
+
+BOOL EvalCoordinator::TryBeginSample() {
+  lock_guard<mutex> lk(mutex_);
+  if (capturing_ || waiting_for_eval_) {
+    return FALSE;
+  }
+
+  sampling_ = TRUE;
+  return TRUE;
+}
+
+void EvalCoordinator::EndSample() {
+  {
+    lock_guard<mutex> lk(mutex_);
+    sampling_ = FALSE;
+  }
+  sample_ended_cv_.notify_all();
+}
+
 BOOL EvalCoordinator::WaitingForEval() {
   lock_guard<mutex> lk(mutex_);
   return waiting_for_eval_;
@@ -234,37 +376,61 @@ BOOL EvalCoordinator::WaitingForEval() {
 HRESULT EvalCoordinator::ProcessBreakpointsTask(
     IBreakpointCollection *breakpoint_collection,
     std::vector<std::shared_ptr<DbgBreakpoint>> breakpoints,
-    const std::vector<
-        std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>>
-        &pdb_files) {
-  // Vector of PDB files that are parsed successfully.
-  std::vector<
-      std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>>
-      parsed_pdb_files;
-  for (auto &&pdb_file : pdb_files) {
-    if (!pdb_file) {
-      continue;
-    }
+    std::shared_ptr<const PdbFileIndex> pdb_index) {
+  if (!pdb_index) {
+    cerr << "PDB file index is null.";
+    return E_INVALIDARG;
+  }
 
-    if (pdb_file->ParsePdbFile()) {
-      parsed_pdb_files.push_back(pdb_file);
+  // The stack is walked once for all the breakpoints so it is walked
+  // with the largest limits of their capture profiles.
+  CaptureProfile walk_profile;
+  if (!breakpoints.empty()) {
+    walk_profile = breakpoints[0]->GetCaptureProfile();
+    for (auto &&breakpoint : breakpoints) {
+      walk_profile = walk_profile.Union(breakpoint->GetCaptureProfile());
     }
   }
 
+  // The DbgObjects of the hit are allocated from this arena. Their
+  // memory is freed in bulk when the hit is done.
+  ScopedSnapshotArena snapshot_arena;
+
+  // The reference objects of the hit only create their strong handles
+  // if a function evaluation continues the debuggee. The handles are
+  // disposed together when the hit is done.
+  ObjectHandlePool handle_pool;
+  ScopedObjectHandlePool scoped_handle_pool(&handle_pool);
+
   // Creates and initializes stack frame collection based on the
   // ICorDebugStackWalk object.
   unique_ptr<IStackFrameCollection> stack_frames(
       new (std::nothrow) StackFrameCollection(
           std::shared_ptr<ICorDebugHelper>(new CorDebugHelper()),
-          std::shared_ptr<IDbgObjectFactory>(new DbgObjectFactory())));
+          std::shared_ptr<IDbgObjectFactory>(new DbgObjectFactory()),
+          method_cache_, type_cache_, walk_profile));
   if (!stack_frames) {
     cerr << "Failed to create DbgStack.";
     return E_OUTOFMEMORY;
   }
 
+  // Phase 1: while the debuggee is stopped, evaluates the breakpoints and
+  // copies the values we need into the breakpoint protos. The protos
+  // do not reference any ICorDebug objects so they can outlive the pause.
+  // The protos are built here rather than after Continue because the
+  // DbgObjects read the fields, items and properties of their members
+  // from ICorDebug while they are populated, so the graph of DbgObjects
+  // is not detached from the debuggee until it is turned into protos.
+  auto capture_start = steady_clock::now();
+  std::vector<Breakpoint> proto_breakpoints;
+  proto_breakpoints.reserve(breakpoints.size());
   HRESULT hr = S_OK;
   for (auto &&breakpoint : breakpoints) {
-    hr = stack_frames->ProcessBreakpoint(parsed_pdb_files, breakpoint.get(),
+    // Reports the hit counts of the deduplication windows that ended
+    // since the last hit of the breakpoint.
+    breakpoint->TakeHitCountUpdates(false, &proto_breakpoints);
+
+    hr = stack_frames->ProcessBreakpoint(*pdb_index, breakpoint.get(),
                                          this);
     if (FAILED(hr)) {
       std::cerr << "Failed to process breakpoint \"" << breakpoint->GetId()
@@ -272,12 +438,7 @@ HRESULT EvalCoordinator::ProcessBreakpointsTask(
       Breakpoint error_breakpoint;
       error_breakpoint.set_id(breakpoint->GetId());
       SetErrorStatusMessage(&error_breakpoint, breakpoint->GetErrorString());
-
-      hr = breakpoint_collection->WriteBreakpoint(error_breakpoint);
-      if (FAILED(hr)) {
-        cerr << "Failed to write error breakpoint: " << std::hex << hr;
-        break;
-      }
+      proto_breakpoints.push_back(std::move(error_breakpoint));
       continue;
     }
 
@@ -291,11 +452,43 @@ HRESULT EvalCoordinator::ProcessBreakpointsTask(
     Breakpoint proto_breakpoint;
     hr = breakpoint->PopulateBreakpoint(&proto_breakpoint, stack_frames.get(),
                                         this);
+    if (hr == S_FALSE && proto_breakpoint.hit_count() > 1) {
+      // The call stack was already captured in the deduplication window.
+      // The hit is only counted and reported when the window ends.
+      continue;
+    }
+
     if (FAILED(hr)) {
       // We should still write the breakpoint to report the error to the user.
       cerr << "Failed to print out variables: " << std::hex << hr;
     }
+    proto_breakpoints.push_back(std::move(proto_breakpoint));
+  }
 
+  stack_frames.reset();
+  SnapshotArena *arena = snapshot_arena.GetArena();
+  if (arena) {
+    Metrics::GetInstance()->RecordCount(MetricCounter::kArenaAllocations,
+                                        arena->GetAllocationCount());
+    Metrics::GetInstance()->RecordCount(MetricCounter::kArenaChunks,
+                                        arena->GetChunkCount());
+  }
+  Metrics::GetInstance()->RecordCount(MetricCounter::kStrongHandles,
+                                      handle_pool.GetHandleCount());
+  Metrics::GetInstance()->RecordCount(MetricCounter::kReferenceObjects,
+                                      handle_pool.GetObjectCount());
+  handle_pool.ReleaseHandles();
+  Metrics::GetInstance()->Record(
+      MetricPhase::kCapture,
+      duration_cast<microseconds>(steady_clock::now() - capture_start).count(),
+      std::string());
+  SignalFinishedPrintingVariable();
+
+  // Phase 2: the debuggee is running again, serializes the protos and
+  // writes them to the pipe.
+  ScopedPhaseTimer publish_timer(MetricPhase::kPublish);
+  hr = S_OK;
+  for (auto &&proto_breakpoint : proto_breakpoints) {
     hr = breakpoint_collection->WriteBreakpoint(proto_breakpoint);
     if (FAILED(hr)) {
       cerr << "Failed to write breakpoint: " << std::hex << hr;
@@ -303,8 +496,6 @@ HRESULT EvalCoordinator::ProcessBreakpointsTask(
     }
   }
 
-  stack_frames.reset();
-  SignalFinishedPrintingVariable();
   return hr;
 }
 
@@ -15,10 +15,17 @@
 #ifndef EVAL_COORDINATOR_H_
 #define EVAL_COORDINATOR_H_
 
+#include <atomic>
 #include <chrono>
+#include <cstdint>
 #include <future>
+#include <map>
+#include <tuple>
 
+#include "eval_completion_channel.h"
 #include "i_eval_coordinator.h"
+#include "module_type_cache.h"
+#include "stack_frame_method_cache.h"
 
 namespace google_cloud_debugger {
 
@@ -48,6 +55,14 @@ class IStackFrameCollection;
 // cannot perform evaluation.
 class EvalCoordinator : public IEvalCoordinator {
  public:
+  EvalCoordinator() = default;
+
+  // method_cache and type_cache are shared with the caller so that it
+  // can invalidate them when modules and assemblies are unloaded.
+  EvalCoordinator(std::shared_ptr<StackFrameMethodCache> method_cache,
+                  std::shared_ptr<ModuleTypeCache> type_cache)
+      : method_cache_(method_cache), type_cache_(type_cache) {}
+
   // This method is used to create an ICorDebugEval object
   // from the active thread.
   HRESULT CreateEval(ICorDebugEval **eval) override;
@@ -76,9 +91,7 @@ class EvalCoordinator : public IEvalCoordinator {
       ICorDebugThread *debug_thread,
       IBreakpointCollection *breakpoint_collection,
       std::vector<std::shared_ptr<DbgBreakpoint>> breakpoints,
-      const std::vector<
-          std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>>
-          &pdb_files) override;
+      std::shared_ptr<const PdbFileIndex> pdb_index) override;
 
   // StackFrame calls this to signal that it already processed all the
   // variables and it is just waiting to perform evaluation (if necessary) and
@@ -114,6 +127,37 @@ class EvalCoordinator : public IEvalCoordinator {
   // Returns whether method call should be performed when evaluating condition.
   BOOL MethodEvaluation() override { return condition_evaluation_; }
 
+  // Returns the cached result of the property getter getter_token
+  // evaluated on the same object during this breakpoint hit.
+  std::shared_ptr<DbgObject> GetCachedPropertyValue(
+      ICorDebugValue *object_value, CORDB_ADDRESS object_address,
+      std::uint64_t address_eval_count, CORDB_ADDRESS module_base_address,
+      mdMethodDef getter_token) override;
+
+  // Caches the result of the property getter getter_token evaluated on
+  // the object object_handle points to until the debuggee is continued.
+  void CachePropertyValue(ICorDebugValue *object_handle,
+                          CORDB_ADDRESS module_base_address,
+                          mdMethodDef getter_token,
+                          std::shared_ptr<DbgObject> value) override;
+
+  // Registers callback to be called before the next function evaluation
+  // of this breakpoint hit.
+  void AddBeforeEvalCallback(std::function<void()> callback) override;
+
+  // Returns FALSE if a breakpoint hit is being captured. Otherwise, holds
+  // off the capture of breakpoint hits until EndSample is called.
+  BOOL TryBeginSample() override;
+
+  // Lets the breakpoint hits waiting for the stack sample be captured.
+  void EndSample() override;
+
+  // Returns the number of function evaluations created so far. The
+  // debuggee runs during a function evaluation and the garbage collector
+  // may move objects, so an object address only identifies an object
+  // together with the eval count it was read at.
+  static std::uint64_t GetEvalCount() { return eval_count_; }
+
  private:
   // Helper function to process a vector of multiple breakpoints at the same location
   // using the stack frame collection. The stack frame collection
@@ -122,9 +166,17 @@ class EvalCoordinator : public IEvalCoordinator {
   HRESULT ProcessBreakpointsTask(
       IBreakpointCollection *breakpoint_collection,
       std::vector<std::shared_ptr<DbgBreakpoint>> breakpoints,
-      const std::vector<
-          std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>>
-          &pdb_files);
+      std::shared_ptr<const PdbFileIndex> pdb_index);
+
+  // Re-reads the addresses of the objects in property_values_ through
+  // their handles if function evaluations were created since they were
+  // read. Has to be called with mutex_ held.
+  void UpdatePropertyValueAddresses(std::uint64_t eval_count);
+
+  // Reads the current address of the object that object_value, a strong
+  // handle, points to.
+  static HRESULT GetHandleAddress(ICorDebugValue *object_value,
+                                  CORDB_ADDRESS *address);
 
   // If sets to true, object evaluation will be performed when evaluating property.
   BOOL property_evaluation_ = FALSE;
@@ -136,23 +188,77 @@ class EvalCoordinator : public IEvalCoordinator {
   // The tasks that help us enumerate and print out variables.
   std::vector<std::future<HRESULT>> print_breakpoint_tasks_;
 
+  // Names of the methods on the stack, shared by the stack frame
+  // collections of all the breakpoint hits.
+  std::shared_ptr<StackFrameMethodCache> method_cache_ =
+      std::make_shared<StackFrameMethodCache>();
+
+  // Types of the loaded modules used by expressions, shared by the
+  // stack frame collections of all the breakpoint hits.
+  std::shared_ptr<ModuleTypeCache> type_cache_ =
+      std::make_shared<ModuleTypeCache>();
+
   // The ICorDebugThread that the active StackFrame is on.
   CComPtr<ICorDebugThread> active_debug_thread_;
 
-  // variable_thread_ and the thread that DebuggerCallback object is on
-  // will use this condition_variable_ and mutex_ to communicate.
+  // The capture thread and the thread that DebuggerCallback object is on
+  // hand control to each other through this channel.
+  EvalCompletionChannel eval_channel_;
+
+  // The capture thread waits on this until ProcessBreakpoints is called.
   std::condition_variable variable_threads_cv_;
 
-  std::condition_variable debugger_callback_cv_;
+  // ProcessBreakpoints waits on this for a stack sample to end.
+  std::condition_variable sample_ended_cv_;
 
+  // Guards the flags below and active_debug_thread_.
   std::mutex mutex_;
 
+  // A property getter result cached for the rest of a breakpoint hit.
+  struct CachedPropertyValue {
+    // Strong handle to the object the getter was evaluated on. The handle
+    // follows the object when the garbage collector moves it.
+    CComPtr<ICorDebugHandleValue> object_handle;
+
+    // Result of the getter.
+    std::shared_ptr<DbgObject> value;
+  };
+
+  // Results of property getters evaluated during the current breakpoint
+  // hit, keyed by the address of the object, the base address of the
+  // module the getter is in and the getter token. Property reads,
+  // expression evaluation and condition evaluation all share this so a
+  // getter is only func-evaluated once per object, whichever variable
+  // the object is reached through. Cleared whenever the debuggee is
+  // continued since the property values may change afterwards.
+  std::map<std::tuple<CORDB_ADDRESS, CORDB_ADDRESS, mdMethodDef>,
+           CachedPropertyValue>
+      property_values_;
+
+  // Eval count the object addresses in property_values_ were read at.
+  std::uint64_t property_values_eval_count_ = 0;
+
+  // Callbacks to call before the next function evaluation. Cleared
+  // whenever the debuggee is continued.
+  std::vector<std::function<void()>> before_eval_callbacks_;
+
   BOOL ready_to_print_variables_ = FALSE;
-  BOOL debuggercallback_can_continue_ = FALSE;
   BOOL eval_exception_occurred_ = FALSE;
   BOOL waiting_for_eval_ = FALSE;
 
+  // True from ProcessBreakpoints until the capture thread calls
+  // SignalFinishedPrintingVariable. Function evaluations only happen
+  // in between.
+  BOOL capturing_ = FALSE;
+
+  // True while a stack sample stops the debuggee.
+  BOOL sampling_ = FALSE;
+
   static std::chrono::minutes one_minute;
+
+  // Number of function evaluations created so far by all the breakpoint
+  // hits.
+  static std::atomic<std::uint64_t> eval_count_;
 };
 
 }  //  namespace google_cloud_debugger
@@ -0,0 +1,47 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "frame_variable.h"
+
+#include <iostream>
+
+#include "dbg_object.h"
+#include "i_dbg_object_factory.h"
+
+namespace google_cloud_debugger {
+
+std::shared_ptr<DbgObject> FrameVariable::GetValue(
+    IDbgObjectFactory *obj_factory, int object_depth) const {
+  CreateValue(obj_factory, object_depth);
+  return value_;
+}
+
+void FrameVariable::CreateValue(IDbgObjectFactory *obj_factory,
+                                int object_depth) const {
+  if (!debug_value_ || !obj_factory) {
+    return;
+  }
+
+  std::unique_ptr<DbgObject> value;
+  HRESULT hr = obj_factory->CreateDbgObject(debug_value_, object_depth,
+                                            &value, &std::cerr);
+  if (SUCCEEDED(hr)) {
+    value_ = std::move(value);
+  }
+
+  // Only tries once, the value will not be any different next time.
+  debug_value_.Release();
+}
+
+}  //  namespace google_cloud_debugger
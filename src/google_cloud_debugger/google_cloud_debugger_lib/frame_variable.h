@@ -0,0 +1,86 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef FRAME_VARIABLE_H_
+#define FRAME_VARIABLE_H_
+
+#include <memory>
+#include <string>
+
+#include "ccomptr.h"
+#include "cor.h"
+#include "cordebug.h"
+
+namespace google_cloud_debugger {
+
+class DbgObject;
+class IDbgObjectFactory;
+
+// A local variable, constant or method argument of a stack frame.
+// Creating the DbgObject of a value dereferences, unboxes and resolves
+// the type of the value, so it is only done the first time the value
+// is needed. Until then, only the name and the ICorDebugValue are kept.
+//
+// The ICorDebugValue is neutered once the debuggee resumes, so the
+// DbgObject has to be created (see CreateValue) before any function
+// evaluation if it may still be needed afterwards.
+class FrameVariable {
+ public:
+  // Creates a variable whose DbgObject is created from debug_value
+  // the first time it is needed.
+  FrameVariable(const std::string &name, ICorDebugValue *debug_value)
+      : name_(name) {
+    debug_value_ = debug_value;
+  }
+
+  // Creates a variable whose DbgObject is already created.
+  FrameVariable(const std::string &name, std::shared_ptr<DbgObject> value)
+      : name_(name), value_(value) {}
+
+  // Copies are used instead of moves since moving a CComPtr does not
+  // clear the source.
+  FrameVariable(const FrameVariable &other) = default;
+  FrameVariable &operator=(const FrameVariable &other) = default;
+
+  // Returns the name of the variable.
+  const std::string &GetName() const { return name_; }
+
+  // Returns the DbgObject of this variable. If it is not created yet,
+  // creates it with obj_factory using object_depth as the evaluation
+  // depth. Returns nullptr if the DbgObject cannot be created.
+  std::shared_ptr<DbgObject> GetValue(IDbgObjectFactory *obj_factory,
+                                      int object_depth) const;
+
+  // Creates the DbgObject of this variable if it is not created yet.
+  void CreateValue(IDbgObjectFactory *obj_factory, int object_depth) const;
+
+  // Returns true if the DbgObject of this variable has not been
+  // created yet.
+  bool IsPending() const { return debug_value_ != nullptr; }
+
+ private:
+  // Name of the variable.
+  std::string name_;
+
+  // The value of the variable. Released once value_ is created.
+  mutable CComPtr<ICorDebugValue> debug_value_;
+
+  // The DbgObject of the variable. Null until it is created or if it
+  // cannot be created.
+  mutable std::shared_ptr<DbgObject> value_;
+};
+
+}  //  namespace google_cloud_debugger
+
+#endif  //  FRAME_VARIABLE_H_
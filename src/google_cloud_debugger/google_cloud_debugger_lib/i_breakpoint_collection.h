@@ -32,6 +32,7 @@ namespace google_cloud_debugger {
 class DbgBreakpoint;
 class DebuggerCallback;
 class IEvalCoordinator;
+class PdbFileIndex;
 
 // Interface for managing a collection of breakpoints.
 class IBreakpointCollection {
@@ -78,9 +79,7 @@ class IBreakpointCollection {
   virtual HRESULT EvaluateAndPrintBreakpoint(
       mdMethodDef function_token, ULONG32 il_offset,
       IEvalCoordinator *eval_coordinator, ICorDebugThread *debug_thread,
-      const std::vector<
-          std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>>
-          &pdb_files) = 0;
+      std::shared_ptr<const PdbFileIndex> pdb_index) = 0;
 };
 
 }  // namespace google_cloud_debugger
@@ -96,9 +96,13 @@ class ICorDebugHelper {
                                      ICorDebugHandleValue **handle,
                                      std::ostream *err_stream) = 0;
 
-  // Extracts out a string from ICorDebugStringValue.
+  // Extracts out at most max_length characters from the start of
+  // ICorDebugStringValue. Only that prefix is read from the debuggee.
+  // original_length is set to the length of the whole string, which is
+  // larger than max_length if the string is truncated.
   virtual HRESULT ExtractStringFromICorDebugStringValue(
-      ICorDebugStringValue *debug_string, std::string *returned_string,
+      ICorDebugStringValue *debug_string, ULONG32 max_length,
+      std::string *returned_string, ULONG32 *original_length,
       std::ostream *err_stream) = 0;
 
   // Given a metadata token for the parameter param_token,
@@ -21,6 +21,7 @@
 
 #include "constants.h"
 #include "i_cor_debug_helper.h"
+#include "snapshot_arena.h"
 #include "string_stream_wrapper.h"
 
 namespace google_cloud_debugger {
@@ -30,7 +31,7 @@ class DbgObject;
 class IDbgObjectFactory;
 
 // This class represents a member (property or field) in a .NET class.
-class IDbgClassMember : public StringStreamWrapper {
+class IDbgClassMember : public StringStreamWrapper, public SnapshotAllocated {
  public:
   IDbgClassMember(std::shared_ptr<ICorDebugHelper> debug_helper,
                   std::shared_ptr<IDbgObjectFactory> obj_factory)
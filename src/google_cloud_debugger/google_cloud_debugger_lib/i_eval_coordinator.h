@@ -16,6 +16,7 @@
 #define I_EVAL_COORDINATOR_H_
 
 #include <condition_variable>
+#include <functional>
 #include <memory>
 #include <mutex>
 #include <thread>
@@ -29,7 +30,9 @@ namespace google_cloud_debugger {
 
 class IBreakpointCollection;
 class DbgBreakpoint;
+class DbgObject;
 class IDbgObjectFactory;
+class PdbFileIndex;
 
 // An EvalCoordinator object is used by DebuggerCallback object to evaluate
 // and print out variables. It does so by creating a StackFrame on a new
@@ -85,9 +88,7 @@ class IEvalCoordinator {
   virtual HRESULT ProcessBreakpoints(
       ICorDebugThread *debug_thread, IBreakpointCollection *breakpoint_collection,
       std::vector<std::shared_ptr<DbgBreakpoint>> breakpoints,
-      const std::vector<
-          std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>>
-          &pdb_files) = 0;
+      std::shared_ptr<const PdbFileIndex> pdb_index) = 0;
 
   // StackFrame calls this to signal that it already processed all the
   // variables and it is just waiting to perform evaluation (if necessary) and
@@ -118,6 +119,44 @@ class IEvalCoordinator {
 
   // Returns whether method call should be performed when evaluating condition.
   virtual BOOL MethodEvaluation() = 0;
+
+  // Returns the result of the property getter getter_token (from the module
+  // at module_base_address) if it has already been evaluated on the same
+  // object during the current breakpoint hit. Returns nullptr otherwise.
+  // object_address is the address of the object, read after
+  // address_eval_count function evaluations were created. Objects may move
+  // during a function evaluation, so if another evaluation was created
+  // since, the current address is read through object_value, which then
+  // has to be a strong handle to the object.
+  virtual std::shared_ptr<DbgObject> GetCachedPropertyValue(
+      ICorDebugValue *object_value, CORDB_ADDRESS object_address,
+      std::uint64_t address_eval_count, CORDB_ADDRESS module_base_address,
+      mdMethodDef getter_token) = 0;
+
+  // Caches the result of evaluating the property getter getter_token on the
+  // object that object_handle, a strong handle, points to for the rest of
+  // the current breakpoint hit. The cache follows the object through the
+  // handle when it is moved by later function evaluations.
+  virtual void CachePropertyValue(ICorDebugValue *object_handle,
+                                  CORDB_ADDRESS module_base_address,
+                                  mdMethodDef getter_token,
+                                  std::shared_ptr<DbgObject> value) = 0;
+
+  // Registers callback to be called once, right before the next function
+  // evaluation is created. Function evaluation resumes the debuggee,
+  // which neuters the ICorDebugValues obtained while it was stopped,
+  // so anything still holding such values has to convert them first.
+  virtual void AddBeforeEvalCallback(std::function<void()> callback) = 0;
+
+  // Returns FALSE if a breakpoint hit is being captured, including while
+  // a function evaluation is in flight. Otherwise, marks a stack sample
+  // as in progress: breakpoint hits wait for EndSample before they are
+  // captured, so the sample can stop and continue the debuggee without
+  // interleaving with the capture.
+  virtual BOOL TryBeginSample() = 0;
+
+  // Ends the stack sample started by a successful TryBeginSample.
+  virtual void EndSample() = 0;
 };
 
 }  //  namespace google_cloud_debugger
@@ -15,10 +15,12 @@
 #ifndef I_STACK_FRAME_COLLECTION_H_
 #define I_STACK_FRAME_COLLECTION_H_
 
+#include <cstdint>
 #include <unordered_map>
 #include <vector>
 
 #include "breakpoint.pb.h"
+#include "capture_profile.h"
 #include "cor.h"
 #include "cordebug.h"
 #include "i_portable_pdb_file.h"
@@ -28,6 +30,7 @@ namespace google_cloud_debugger {
 class IEvalCoordinator;
 class DbgBreakpoint;
 class DbgObject;
+class PdbFileIndex;
 
 class IStackFrameCollection {
  public:
@@ -40,17 +43,22 @@ class IStackFrameCollection {
   // Afterwards, stack information will be collected at the
   // breakpoint's location.
   virtual HRESULT ProcessBreakpoint(
-      const std::vector<
-          std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>>
-          &pdb_files,
+      const PdbFileIndex &pdb_index,
       DbgBreakpoint *breakpoint, IEvalCoordinator *eval_coordinator) = 0;
 
-  // Populates the stack frames of a breakpoint using stack_frames.
+  // Populates the stack frames of a breakpoint using stack_frames
+  // within the limits of capture_profile.
   // eval_coordinator will be used to perform eval coordination during function
   // evaluation if needed.
   virtual HRESULT PopulateStackFrames(
       google::cloud::diagnostics::debug::Breakpoint *breakpoint,
+      const CaptureProfile &capture_profile,
       IEvalCoordinator *eval_coordinator) = 0;
+
+  // Returns a fingerprint of the module, method token and IL offset
+  // of the walked stack frames. Hits from the same call path have
+  // the same fingerprint.
+  virtual std::uint64_t GetStackFingerprint() const = 0;
 };
 
 }  //  namespace google_cloud_debugger
@@ -0,0 +1,305 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "metrics.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+
+using std::cerr;
+using std::lock_guard;
+using std::memory_order_relaxed;
+using std::mutex;
+using std::ostream;
+using std::string;
+using std::uint64_t;
+using std::unique_lock;
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
+using std::chrono::seconds;
+using std::chrono::steady_clock;
+
+namespace google_cloud_debugger {
+
+const char *GetMetricPhaseName(MetricPhase phase) {
+  switch (phase) {
+    case MetricPhase::kBreakpointCallback:
+      return "breakpoint_callback";
+    case MetricPhase::kBreakpointDispatch:
+      return "breakpoint_dispatch";
+    case MetricPhase::kPdbLookup:
+      return "pdb_lookup";
+    case MetricPhase::kModuleLoad:
+      return "module_load";
+    case MetricPhase::kModuleRegistration:
+      return "module_registration";
+    case MetricPhase::kConditionCompile:
+      return "condition_compile";
+    case MetricPhase::kConditionEvaluate:
+      return "condition_evaluate";
+    case MetricPhase::kExpressionEvaluate:
+      return "expression_evaluate";
+    case MetricPhase::kStackWalk:
+      return "stack_walk";
+    case MetricPhase::kVariableCapture:
+      return "variable_capture";
+    case MetricPhase::kFuncEval:
+      return "func_eval";
+    case MetricPhase::kProtoByteSize:
+      return "proto_byte_size";
+    case MetricPhase::kSerialize:
+      return "serialize";
+    case MetricPhase::kPipeWrite:
+      return "pipe_write";
+    case MetricPhase::kCapture:
+      return "capture";
+    case MetricPhase::kPublish:
+      return "publish";
+    case MetricPhase::kProfilerSample:
+      return "profiler_sample";
+    default:
+      return "unknown";
+  }
+}
+
+const char *GetMetricCounterName(MetricCounter counter) {
+  switch (counter) {
+    case MetricCounter::kStrongHandles:
+      return "strong_handles";
+    case MetricCounter::kReferenceObjects:
+      return "reference_objects";
+    case MetricCounter::kArenaAllocations:
+      return "arena_allocations";
+    case MetricCounter::kArenaChunks:
+      return "arena_chunks";
+    default:
+      return "unknown";
+  }
+}
+
+LatencyHistogram::LatencyHistogram() : count_(0), total_(0), max_(0) {
+  for (auto &bucket : buckets_) {
+    bucket.store(0, memory_order_relaxed);
+  }
+}
+
+void LatencyHistogram::Record(std::int64_t micros) {
+  uint64_t value = micros > 0 ? static_cast<uint64_t>(micros) : 0;
+
+  int bucket = 0;
+  while (bucket < kBucketCount - 1 && (uint64_t(1) << bucket) <= value) {
+    ++bucket;
+  }
+
+  buckets_[bucket].fetch_add(1, memory_order_relaxed);
+  count_.fetch_add(1, memory_order_relaxed);
+  total_.fetch_add(value, memory_order_relaxed);
+
+  uint64_t current_max = max_.load(memory_order_relaxed);
+  while (value > current_max &&
+         !max_.compare_exchange_weak(current_max, value,
+                                     memory_order_relaxed)) {
+  }
+}
+
+uint64_t LatencyHistogram::GetCount() const {
+  return count_.load(memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::GetTotal() const {
+  return total_.load(memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::GetMax() const {
+  return max_.load(memory_order_relaxed);
+}
+
+uint64_t LatencyHistogram::GetPercentile(double percentile) const {
+  uint64_t count = GetCount();
+  if (count == 0) {
+    return 0;
+  }
+
+  uint64_t rank = static_cast<uint64_t>(count * percentile / 100.0);
+  rank = std::max<uint64_t>(1, std::min(rank, count));
+
+  uint64_t seen = 0;
+  for (int i = 0; i < kBucketCount - 1; ++i) {
+    seen += buckets_[i].load(memory_order_relaxed);
+    if (seen >= rank) {
+      return std::min(uint64_t(1) << i, GetMax());
+    }
+  }
+
+  return GetMax();
+}
+
+Metrics *Metrics::GetInstance() {
+  static Metrics metrics;
+  return &metrics;
+}
+
+void Metrics::Record(MetricPhase phase, std::int64_t micros,
+                     const string &breakpoint_id) {
+  std::size_t index = static_cast<std::size_t>(phase);
+  global_histograms_[index].Record(micros);
+
+  if (breakpoint_id.empty()) {
+    return;
+  }
+
+  lock_guard<mutex> lk(mutex_);
+  auto it = breakpoint_histograms_.find(breakpoint_id);
+  if (it == breakpoint_histograms_.end()) {
+    if (breakpoint_histograms_.size() >= kMaximumTrackedBreakpoints) {
+      return;
+    }
+
+    std::unique_ptr<PhaseHistograms> histograms(new (std::nothrow)
+                                                    PhaseHistograms);
+    if (!histograms) {
+      return;
+    }
+
+    it = breakpoint_histograms_
+             .insert(std::make_pair(breakpoint_id, std::move(histograms)))
+             .first;
+  }
+
+  (*it->second)[index].Record(micros);
+}
+
+void Metrics::RecordCount(MetricCounter counter, uint64_t value) {
+  counter_histograms_[static_cast<std::size_t>(counter)].Record(
+      static_cast<std::int64_t>(value));
+}
+
+void Metrics::RemoveBreakpoint(const string &breakpoint_id) {
+  lock_guard<mutex> lk(mutex_);
+  breakpoint_histograms_.erase(breakpoint_id);
+}
+
+const LatencyHistogram &Metrics::GetHistogram(MetricPhase phase) const {
+  return global_histograms_[static_cast<std::size_t>(phase)];
+}
+
+const LatencyHistogram &Metrics::GetCountHistogram(
+    MetricCounter counter) const {
+  return counter_histograms_[static_cast<std::size_t>(counter)];
+}
+
+void Metrics::WriteReport(ostream *out) {
+  *out << "phase count total_us max_us p50_us p90_us p99_us" << std::endl;
+  *out << "[global]" << std::endl;
+  WriteHistograms(global_histograms_, out);
+
+  *out << "[per_hit]" << std::endl;
+  for (std::size_t i = 0; i < counter_histograms_.size(); ++i) {
+    const LatencyHistogram &histogram = counter_histograms_[i];
+    if (histogram.GetCount() == 0) {
+      continue;
+    }
+
+    WriteHistogram(GetMetricCounterName(static_cast<MetricCounter>(i)),
+                   histogram, out);
+  }
+
+  lock_guard<mutex> lk(mutex_);
+  for (auto &&breakpoint_histograms : breakpoint_histograms_) {
+    *out << "[breakpoint " << breakpoint_histograms.first << "]" << std::endl;
+    WriteHistograms(*breakpoint_histograms.second, out);
+  }
+}
+
+void Metrics::WriteHistograms(const PhaseHistograms &histograms,
+                              ostream *out) {
+  for (std::size_t i = 0; i < histograms.size(); ++i) {
+    const LatencyHistogram &histogram = histograms[i];
+    if (histogram.GetCount() == 0) {
+      continue;
+    }
+
+    WriteHistogram(GetMetricPhaseName(static_cast<MetricPhase>(i)),
+                   histogram, out);
+  }
+}
+
+void Metrics::WriteHistogram(const char *name,
+                             const LatencyHistogram &histogram,
+                             ostream *out) {
+  *out << name << " " << histogram.GetCount() << " " << histogram.GetTotal()
+       << " " << histogram.GetMax() << " " << histogram.GetPercentile(50)
+       << " " << histogram.GetPercentile(90) << " "
+       << histogram.GetPercentile(99) << std::endl;
+}
+
+ScopedPhaseTimer::ScopedPhaseTimer(MetricPhase phase)
+    : phase_(phase), breakpoint_id_(nullptr), start_(steady_clock::now()) {}
+
+ScopedPhaseTimer::ScopedPhaseTimer(MetricPhase phase,
+                                   const string &breakpoint_id)
+    : phase_(phase),
+      breakpoint_id_(&breakpoint_id),
+      start_(steady_clock::now()) {}
+
+ScopedPhaseTimer::~ScopedPhaseTimer() {
+  static const string kNoBreakpoint;
+  std::int64_t micros =
+      duration_cast<microseconds>(steady_clock::now() - start_).count();
+  Metrics::GetInstance()->Record(
+      phase_, micros, breakpoint_id_ ? *breakpoint_id_ : kNoBreakpoint);
+}
+
+const seconds MetricsFileExporter::kExportInterval = seconds(60);
+
+MetricsFileExporter::MetricsFileExporter(const string &file_path)
+    : file_path_(file_path) {
+  export_thread_ = std::thread(&MetricsFileExporter::ExportLoop, this);
+}
+
+MetricsFileExporter::~MetricsFileExporter() {
+  {
+    lock_guard<mutex> lk(mutex_);
+    stopping_ = true;
+  }
+  stop_cv_.notify_one();
+
+  if (export_thread_.joinable()) {
+    export_thread_.join();
+  }
+
+  WriteFile();
+}
+
+void MetricsFileExporter::WriteFile() {
+  std::ofstream file(file_path_, std::ios::out | std::ios::trunc);
+  if (!file) {
+    cerr << "Failed to open metrics file " << file_path_ << std::endl;
+    return;
+  }
+
+  Metrics::GetInstance()->WriteReport(&file);
+}
+
+void MetricsFileExporter::ExportLoop() {
+  unique_lock<mutex> lk(mutex_);
+  while (!stop_cv_.wait_for(lk, kExportInterval, [&] { return stopping_; })) {
+    lk.unlock();
+    WriteFile();
+    lk.lock();
+  }
+}
+
+}  //  namespace google_cloud_debugger
@@ -0,0 +1,252 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef METRICS_H_
+#define METRICS_H_
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+
+namespace google_cloud_debugger {
+
+// Phases of a breakpoint hit that are timed.
+enum class MetricPhase {
+  // The whole Breakpoint callback. The debuggee is stopped for this
+  // long, except while func-evals run.
+  kBreakpointCallback,
+  // Matching the hit location against the active breakpoints.
+  kBreakpointDispatch,
+  // Parsing and looking up the PDB files of the modules.
+  kPdbLookup,
+  // Reading a loaded module in the LoadModule callback. The debuggee
+  // is stopped for this long.
+  kModuleLoad,
+  // Parsing the PDB files of a batch of loaded modules on the
+  // background thread of ModuleRegistry.
+  kModuleRegistration,
+  // Compiling the condition of a breakpoint.
+  kConditionCompile,
+  // Evaluating the compiled condition of a breakpoint.
+  kConditionEvaluate,
+  // Compiling and evaluating the expressions of a breakpoint.
+  kExpressionEvaluate,
+  // Walking the stack and populating the frames.
+  kStackWalk,
+  // Breadth-first capture of the variables into the breakpoint proto.
+  kVariableCapture,
+  // A single func-eval (property getter or method call).
+  kFuncEval,
+  // Computing the size of the breakpoint proto.
+  kProtoByteSize,
+  // Serializing the breakpoint proto.
+  kSerialize,
+  // Writing the serialized breakpoint to the pipe.
+  kPipeWrite,
+  // Everything done while the debuggee is stopped for a hit.
+  kCapture,
+  // Serializing and writing the breakpoints of a hit once the debuggee
+  // is continued.
+  kPublish,
+  // A sample of the sampling profiler. The debuggee is stopped for this
+  // long.
+  kProfilerSample,
+  // Number of phases, not a phase.
+  kPhaseCount
+};
+
+// Returns the name of phase used in reports.
+const char *GetMetricPhaseName(MetricPhase phase);
+
+// Quantities that are counted for each breakpoint hit.
+enum class MetricCounter {
+  // Strong handles created for the reference objects of a hit.
+  kStrongHandles,
+  // Reference objects of a hit that could have needed a strong handle.
+  kReferenceObjects,
+  // Allocations made from the SnapshotArena of a hit.
+  kArenaAllocations,
+  // Chunks allocated by the SnapshotArena of a hit, which are the only
+  // heap allocations made for the allocations above.
+  kArenaChunks,
+  // Number of counters, not a counter.
+  kCounterCount
+};
+
+// Returns the name of counter used in reports.
+const char *GetMetricCounterName(MetricCounter counter);
+
+// Histogram of latencies in microseconds with power-of-two buckets.
+// Recording is lock-free so it can be done on any thread.
+class LatencyHistogram {
+ public:
+  // Bucket i counts latencies below 2^i microseconds (the last bucket
+  // counts everything else).
+  static const int kBucketCount = 32;
+
+  LatencyHistogram();
+
+  // Records a latency of micros microseconds.
+  void Record(std::int64_t micros);
+
+  // Returns the number of latencies recorded.
+  std::uint64_t GetCount() const;
+
+  // Returns the sum of all the latencies recorded.
+  std::uint64_t GetTotal() const;
+
+  // Returns the largest latency recorded.
+  std::uint64_t GetMax() const;
+
+  // Returns an upper bound of the given percentile (between 0 and 100)
+  // of the latencies recorded. Returns 0 if nothing is recorded.
+  std::uint64_t GetPercentile(double percentile) const;
+
+ private:
+  std::array<std::atomic<std::uint64_t>, kBucketCount> buckets_;
+  std::atomic<std::uint64_t> count_;
+  std::atomic<std::uint64_t> total_;
+  std::atomic<std::uint64_t> max_;
+};
+
+// Global and per-breakpoint latency histograms of every MetricPhase,
+// and global histograms of the per-hit values of every MetricCounter.
+//
+// Recording a global latency or a counter only touches atomics.
+// Recording a per-breakpoint latency also takes a lock to find the
+// histograms of the breakpoint.
+class Metrics {
+ public:
+  // Maximum number of breakpoints that have their own histograms.
+  // Latencies of other breakpoints are only recorded globally.
+  static const std::size_t kMaximumTrackedBreakpoints = 100;
+
+  // Returns the metrics of the debugger.
+  static Metrics *GetInstance();
+
+  // Records a latency of micros microseconds for phase.
+  // If breakpoint_id is not empty, the latency is also recorded
+  // for that breakpoint.
+  void Record(MetricPhase phase, std::int64_t micros,
+              const std::string &breakpoint_id);
+
+  // Records the value of counter for one breakpoint hit.
+  void RecordCount(MetricCounter counter, std::uint64_t value);
+
+  // Drops the histograms of the breakpoint with ID breakpoint_id.
+  // Called when the breakpoint is removed so its slot can be used
+  // by another breakpoint.
+  void RemoveBreakpoint(const std::string &breakpoint_id);
+
+  // Returns the global histogram of phase.
+  const LatencyHistogram &GetHistogram(MetricPhase phase) const;
+
+  // Returns the histogram of the per-hit values of counter. The values
+  // use the buckets of the latencies.
+  const LatencyHistogram &GetCountHistogram(MetricCounter counter) const;
+
+  // Writes a text report of the histograms to out.
+  void WriteReport(std::ostream *out);
+
+ private:
+  typedef std::array<LatencyHistogram,
+                     static_cast<std::size_t>(MetricPhase::kPhaseCount)>
+      PhaseHistograms;
+
+  // Writes the histograms that are not empty to out.
+  static void WriteHistograms(const PhaseHistograms &histograms,
+                              std::ostream *out);
+
+  // Writes a line with name and the statistics of histogram to out.
+  static void WriteHistogram(const char *name,
+                             const LatencyHistogram &histogram,
+                             std::ostream *out);
+
+  // Histograms of all the breakpoints.
+  PhaseHistograms global_histograms_;
+
+  // Histograms of the per-hit values of the counters.
+  std::array<LatencyHistogram,
+             static_cast<std::size_t>(MetricCounter::kCounterCount)>
+      counter_histograms_;
+
+  // Histograms of each breakpoint by breakpoint ID.
+  std::map<std::string, std::unique_ptr<PhaseHistograms>>
+      breakpoint_histograms_;
+
+  // Guards breakpoint_histograms_.
+  std::mutex mutex_;
+};
+
+// Times the scope it is declared in and records it in Metrics.
+class ScopedPhaseTimer {
+ public:
+  ScopedPhaseTimer(MetricPhase phase);
+
+  // Also records the latency for the breakpoint with ID breakpoint_id.
+  // breakpoint_id has to outlive this object.
+  ScopedPhaseTimer(MetricPhase phase, const std::string &breakpoint_id);
+
+  ~ScopedPhaseTimer();
+
+ private:
+  MetricPhase phase_;
+
+  const std::string *breakpoint_id_;
+
+  std::chrono::steady_clock::time_point start_;
+};
+
+// Periodically writes the report of Metrics to a file.
+class MetricsFileExporter {
+ public:
+  // How often the report is written.
+  static const std::chrono::seconds kExportInterval;
+
+  // Starts writing the report to file_path every kExportInterval.
+  MetricsFileExporter(const std::string &file_path);
+
+  // Writes the report one last time and stops.
+  ~MetricsFileExporter();
+
+ private:
+  // Overwrites the file with the current report.
+  void WriteFile();
+
+  // Loop of the export thread.
+  void ExportLoop();
+
+  std::string file_path_;
+
+  // Set to true to stop the export thread.
+  bool stopping_ = false;
+
+  std::mutex mutex_;
+
+  std::condition_variable stop_cv_;
+
+  std::thread export_thread_;
+};
+
+}  //  namespace google_cloud_debugger
+
+#endif  //  METRICS_H_
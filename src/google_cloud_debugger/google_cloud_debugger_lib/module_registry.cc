@@ -0,0 +1,209 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "module_registry.h"
+
+#include <iostream>
+
+#include "i_cor_debug_helper.h"
+#include "metrics.h"
+#include "portable_pdb_file.h"
+
+using google_cloud_debugger_portable_pdb::IPortablePdbFile;
+using google_cloud_debugger_portable_pdb::PortablePdbFile;
+using std::cerr;
+using std::lock_guard;
+using std::mutex;
+using std::shared_ptr;
+using std::string;
+using std::unique_lock;
+using std::vector;
+
+namespace google_cloud_debugger {
+
+ModuleRegistry::ModuleRegistry(shared_ptr<ICorDebugHelper> debug_helper)
+    : debug_helper_(debug_helper), pdb_index_(new PdbFileIndex()) {
+  worker_thread_ = std::thread(&ModuleRegistry::ProcessQueuedModules, this);
+}
+
+ModuleRegistry::~ModuleRegistry() {
+  {
+    lock_guard<mutex> lk(mutex_);
+    shutting_down_ = true;
+  }
+  modules_queued_cv_.notify_one();
+  modules_processed_cv_.notify_all();
+
+  if (worker_thread_.joinable()) {
+    worker_thread_.join();
+  }
+}
+
+void ModuleRegistry::AddModule(ICorDebugModule *debug_module) {
+  if (!debug_module) {
+    return;
+  }
+
+  // The debuggee is stopped until this returns.
+  ScopedPhaseTimer timer(MetricPhase::kModuleLoad);
+  ModuleEntry entry;
+  HRESULT hr = CreateModuleEntry(debug_module, &entry);
+  if (FAILED(hr)) {
+    cerr << "Failed to register module with HRESULT: " << std::hex << hr
+         << std::dec << std::endl;
+    return;
+  }
+
+  {
+    lock_guard<mutex> lk(mutex_);
+    queued_modules_.push_back(std::move(entry));
+  }
+  modules_queued_cv_.notify_one();
+}
+
+shared_ptr<const PdbFileIndex> ModuleRegistry::GetPdbFileIndex() {
+  unique_lock<mutex> lk(mutex_);
+  WaitForQueuedModules(&lk);
+  return pdb_index_;
+}
+
+shared_ptr<IPortablePdbFile> ModuleRegistry::GetPdbFileByModuleName(
+    const string &module_name) {
+  unique_lock<mutex> lk(mutex_);
+  WaitForQueuedModules(&lk);
+  auto it = modules_by_name_.find(module_name);
+  if (it == modules_by_name_.end()) {
+    return nullptr;
+  }
+  return it->second.pdb_file;
+}
+
+void ModuleRegistry::RemoveModule(CORDB_ADDRESS base_address) {
+  unique_lock<mutex> lk(mutex_);
+  // The module may still be queued, so it is only removed once it is
+  // processed.
+  WaitForQueuedModules(&lk);
+
+  // Modules are rarely unloaded so the names are simply scanned.
+  auto module = modules_by_name_.begin();
+  while (module != modules_by_name_.end()) {
+    if (module->second.base_address == base_address) {
+      module = modules_by_name_.erase(module);
+    } else {
+      ++module;
+    }
+  }
+
+  if (!pdb_index_->GetPdbFile(base_address)) {
+    return;
+  }
+
+  // Copying the index only copies pointers to its segments. Only the
+  // segment of the module is copied when it is removed.
+  shared_ptr<PdbFileIndex> pdb_index(new (std::nothrow)
+                                         PdbFileIndex(*pdb_index_));
+  if (!pdb_index) {
+    cerr << "Failed to remove module from the PDB file index.";
+    return;
+  }
+
+  pdb_index->RemovePdbFile(base_address);
+  pdb_index_ = std::move(pdb_index);
+}
+
+void ModuleRegistry::WaitForQueuedModules(unique_lock<mutex> *lock) {
+  modules_processed_cv_.wait(*lock, [&] {
+    return shutting_down_ ||
+           (queued_modules_.empty() && modules_in_progress_ == 0);
+  });
+}
+
+void ModuleRegistry::ProcessQueuedModules() {
+  while (true) {
+    vector<ModuleEntry> batch;
+    {
+      unique_lock<mutex> lk(mutex_);
+      modules_queued_cv_.wait(
+          lk, [&] { return shutting_down_ || !queued_modules_.empty(); });
+      if (shutting_down_) {
+        return;
+      }
+
+      // Takes every module queued so far. At startup, the runtime loads
+      // modules in bursts so a single batch usually covers many of them.
+      batch.swap(queued_modules_);
+      modules_in_progress_ = batch.size();
+    }
+
+    ScopedPhaseTimer timer(MetricPhase::kModuleRegistration);
+    // Parsing only reads the PDB file on disk and the metadata that was
+    // retrieved in AddModule, so the debuggee can be running.
+    // Modules without a PDB file (most framework assemblies) are only
+    // tried once here instead of on every breakpoint hit.
+    for (auto &entry : batch) {
+      entry.parsed = entry.pdb_file->ParsePdbFile();
+    }
+
+    {
+      lock_guard<mutex> lk(mutex_);
+      // Readers may still hold the current index so a new one is built.
+      // It shares the segments of the current index.
+      shared_ptr<PdbFileIndex> pdb_index(new (std::nothrow)
+                                             PdbFileIndex(*pdb_index_));
+      if (!pdb_index) {
+        cerr << "Failed to add modules to the PDB file index.";
+      }
+
+      for (auto &entry : batch) {
+        if (pdb_index && entry.parsed) {
+          pdb_index->AddPdbFile(entry.base_address, entry.pdb_file);
+        }
+        modules_by_name_[entry.pdb_file->GetModuleName()] = std::move(entry);
+      }
+
+      if (pdb_index) {
+        pdb_index_ = std::move(pdb_index);
+      }
+      modules_in_progress_ = 0;
+    }
+    modules_processed_cv_.notify_all();
+  }
+}
+
+HRESULT ModuleRegistry::CreateModuleEntry(ICorDebugModule *debug_module,
+                                          ModuleEntry *module_entry) {
+  shared_ptr<IPortablePdbFile> portable_pdb(new (std::nothrow)
+                                                PortablePdbFile());
+  if (!portable_pdb) {
+    cerr << "Cannot create PortablePdbFile object.";
+    return E_OUTOFMEMORY;
+  }
+
+  HRESULT hr = portable_pdb->Initialize(debug_module, debug_helper_.get());
+  if (FAILED(hr)) {
+    cerr << "Failed set debug module for PortablePdbFile.";
+    return hr;
+  }
+
+  hr = debug_module->GetBaseAddress(&module_entry->base_address);
+  if (FAILED(hr)) {
+    cerr << "Failed to get base address of the module.";
+    return hr;
+  }
+
+  module_entry->pdb_file = std::move(portable_pdb);
+  return S_OK;
+}
+
+}  //  namespace google_cloud_debugger
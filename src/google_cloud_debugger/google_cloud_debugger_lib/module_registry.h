@@ -0,0 +1,143 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MODULE_REGISTRY_H_
+#define MODULE_REGISTRY_H_
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "ccomptr.h"
+#include "cor.h"
+#include "cordebug.h"
+#include "i_portable_pdb_file.h"
+#include "pdb_file_index.h"
+
+namespace google_cloud_debugger {
+
+class ICorDebugHelper;
+
+// Registry of the modules loaded by the debuggee and their PDB files.
+//
+// At startup, the runtime fires a LoadModule callback for every assembly
+// the application loads. Parsing the PDB file of a module reads and
+// parses a file from disk, so instead of doing this before continuing
+// the debuggee, DebuggerCallback only queues the module here. The
+// ICorDebug calls needed for a module (its metadata import, name and
+// base address) are still made in AddModule, on the callback thread:
+// ICorDebug objects should only be used while the debuggee is stopped.
+// A background thread then parses the PDB files of the queued modules
+// in batches, which only reads the file and the metadata already
+// retrieved, and publishes the parsed PDB files in a PdbFileIndex.
+//
+// Readers always see every module that was added before the read:
+// the lookup functions wait for queued modules to be processed.
+// This class is thread-safe.
+class ModuleRegistry {
+ public:
+  // debug_helper is used to initialize the PortablePdbFile of each module.
+  ModuleRegistry(std::shared_ptr<ICorDebugHelper> debug_helper);
+
+  // Stops the background thread. Modules that are still queued
+  // are dropped.
+  ~ModuleRegistry();
+
+  // Reads what is needed from debug_module and queues its PDB file to be
+  // parsed on the background thread. Must be called while the debuggee
+  // is stopped.
+  void AddModule(ICorDebugModule *debug_module);
+
+  // Returns the index of the parsed PDB files of all the modules
+  // added so far. The index is never modified once returned.
+  std::shared_ptr<const PdbFileIndex> GetPdbFileIndex();
+
+  // Returns the PDB file of the module with name module_name, whether
+  // or not it could be parsed. Returns nullptr if there is no such module.
+  std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>
+  GetPdbFileByModuleName(const std::string &module_name);
+
+  // Removes the module loaded at base_address. Must be called when
+  // the module is unloaded since another module may be loaded at the
+  // same address. Indexes returned before keep the module.
+  void RemoveModule(CORDB_ADDRESS base_address);
+
+ private:
+  // A module that is added.
+  struct ModuleEntry {
+    // Base address of the module.
+    CORDB_ADDRESS base_address;
+
+    // PDB file of the module.
+    std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>
+        pdb_file;
+
+    // True if pdb_file is parsed successfully.
+    bool parsed = false;
+  };
+
+  // Loop of the background thread. Takes all the queued modules at once
+  // and parses their PDB files outside of the lock.
+  void ProcessQueuedModules();
+
+  // Creates a ModuleEntry for debug_module and initializes its PDB file
+  // without parsing it.
+  HRESULT CreateModuleEntry(ICorDebugModule *debug_module,
+                            ModuleEntry *module_entry);
+
+  // Blocks until all the queued modules are processed. lock must hold
+  // mutex_.
+  void WaitForQueuedModules(std::unique_lock<std::mutex> *lock);
+
+  // Helper methods for ICorDebug objects.
+  std::shared_ptr<ICorDebugHelper> debug_helper_;
+
+  // Modules that are added but whose PDB files are not parsed yet.
+  std::vector<ModuleEntry> queued_modules_;
+
+  // Number of modules taken from queued_modules_ by the background
+  // thread that are still being processed.
+  size_t modules_in_progress_ = 0;
+
+  // Parsed PDB files of the processed modules. Replaced by a new index
+  // whenever a batch of modules is processed. The new index shares
+  // most of its storage with the previous one.
+  std::shared_ptr<const PdbFileIndex> pdb_index_;
+
+  // All the processed modules by module name.
+  std::unordered_map<std::string, ModuleEntry> modules_by_name_;
+
+  // The background thread waits on this for modules to be queued.
+  std::condition_variable modules_queued_cv_;
+
+  // Readers wait on this for queued modules to be processed.
+  std::condition_variable modules_processed_cv_;
+
+  // Guards all the fields above.
+  std::mutex mutex_;
+
+  // True if the background thread should exit.
+  bool shutting_down_ = false;
+
+  // Thread that processes the queued modules.
+  std::thread worker_thread_;
+};
+
+}  //  namespace google_cloud_debugger
+
+#endif  // MODULE_REGISTRY_H_
@@ -0,0 +1,203 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "module_type_cache.h"
+
+#include <iostream>
+
+#include "i_cor_debug_helper.h"
+
+using std::cerr;
+using std::lock_guard;
+using std::mutex;
+using std::shared_ptr;
+using std::vector;
+
+namespace google_cloud_debugger {
+
+HRESULT ModuleTypeCache::GetTypeDict(
+    ICorDebugModule *debug_module, IMetaDataImport *metadata_import,
+    ICorDebugHelper *debug_helper, shared_ptr<const ModuleTypeDict> *type_dict) {
+  if (!debug_module || !metadata_import || !debug_helper || !type_dict) {
+    return E_INVALIDARG;
+  }
+
+  CORDB_ADDRESS module_base_address = 0;
+  HRESULT hr = debug_module->GetBaseAddress(&module_base_address);
+  if (FAILED(hr)) {
+    cerr << "Failed to get base address of the module.";
+    return hr;
+  }
+
+  {
+    lock_guard<mutex> lk(mutex_);
+    auto it = type_dicts_.find(module_base_address);
+    if (it != type_dicts_.end()) {
+      *type_dict = it->second;
+      return S_OK;
+    }
+  }
+
+  // The enumeration calls into the debuggee so it is done without
+  // holding the lock.
+  shared_ptr<ModuleTypeDict> new_type_dict(new (std::nothrow) ModuleTypeDict);
+  if (!new_type_dict) {
+    return E_OUTOFMEMORY;
+  }
+
+  hr = PopulateTypeDict(metadata_import, debug_helper, new_type_dict.get());
+  if (FAILED(hr)) {
+    return hr;
+  }
+
+  lock_guard<mutex> lk(mutex_);
+  // If another thread populated the module first, uses its dictionary.
+  *type_dict =
+      type_dicts_.insert(std::make_pair(module_base_address, new_type_dict))
+          .first->second;
+  return S_OK;
+}
+
+HRESULT ModuleTypeCache::GetDebugAssemblies(
+    ICorDebugAppDomain *app_domain, ICorDebugHelper *debug_helper,
+    shared_ptr<const DebugAssemblies> *debug_assemblies) {
+  if (!app_domain || !debug_helper || !debug_assemblies) {
+    return E_INVALIDARG;
+  }
+
+  ULONG32 app_domain_id = 0;
+  HRESULT hr = app_domain->GetID(&app_domain_id);
+  if (FAILED(hr)) {
+    cerr << "Failed to get ID of the app domain.";
+    return hr;
+  }
+
+  {
+    lock_guard<mutex> lk(mutex_);
+    auto it = debug_assemblies_.find(app_domain_id);
+    if (it != debug_assemblies_.end()) {
+      *debug_assemblies = it->second;
+      return S_OK;
+    }
+  }
+
+  CComPtr<ICorDebugAssemblyEnum> assembly_enum;
+  hr = app_domain->EnumerateAssemblies(&assembly_enum);
+  if (FAILED(hr)) {
+    cerr << "Cannot get ICorDebugAssemblyEnum.";
+    return hr;
+  }
+
+  shared_ptr<DebugAssemblies> new_debug_assemblies(new (std::nothrow)
+                                                       DebugAssemblies);
+  if (!new_debug_assemblies) {
+    return E_OUTOFMEMORY;
+  }
+
+  hr = debug_helper->EnumerateICorDebugSpecifiedType<ICorDebugAssemblyEnum,
+                                                     ICorDebugAssembly>(
+      assembly_enum, new_debug_assemblies.get());
+  if (FAILED(hr)) {
+    cerr << "Failed to enumerate assemblies.";
+    return hr;
+  }
+
+  lock_guard<mutex> lk(mutex_);
+  *debug_assemblies =
+      debug_assemblies_
+          .insert(std::make_pair(app_domain_id, new_debug_assemblies))
+          .first->second;
+  return S_OK;
+}
+
+void ModuleTypeCache::RemoveModule(CORDB_ADDRESS module_base_address) {
+  lock_guard<mutex> lk(mutex_);
+  type_dicts_.erase(module_base_address);
+}
+
+void ModuleTypeCache::ClearDebugAssemblies() {
+  lock_guard<mutex> lk(mutex_);
+  debug_assemblies_.clear();
+}
+
+HRESULT ModuleTypeCache::PopulateTypeDict(IMetaDataImport *metadata_import,
+                                          ICorDebugHelper *debug_helper,
+                                          ModuleTypeDict *type_dict) {
+  HCORENUM cor_enum = nullptr;
+
+  HRESULT hr = S_OK;
+  vector<mdTypeDef> type_defs(100, 0);
+  while (hr == S_OK) {
+    ULONG type_defs_returned = 0;
+    hr = metadata_import->EnumTypeDefs(&cor_enum, type_defs.data(),
+                                       type_defs.size(), &type_defs_returned);
+    if (FAILED(hr)) {
+      cerr << "Failed to get enumerate types with hr: " << std::hex << hr;
+      metadata_import->CloseEnum(cor_enum);
+      return hr;
+    }
+
+    // No type defs.
+    if (type_defs_returned == 0) {
+      break;
+    }
+
+    for (ULONG i = 0; i < type_defs_returned; ++i) {
+      std::string type_name;
+      mdToken base_token;
+      HRESULT name_hr = debug_helper->GetTypeNameFromMdTypeDef(
+          type_defs[i], metadata_import, &type_name, &base_token, &std::cerr);
+      if (FAILED(name_hr)) {
+        continue;
+      }
+      type_dict->type_defs[type_name] = type_defs[i];
+    }
+  }
+
+  metadata_import->CloseEnum(cor_enum);
+  cor_enum = nullptr;
+
+  hr = S_OK;
+  vector<mdTypeRef> type_refs(100, 0);
+  while (hr == S_OK) {
+    ULONG type_refs_returned = 0;
+    hr = metadata_import->EnumTypeRefs(&cor_enum, type_refs.data(),
+                                       type_refs.size(), &type_refs_returned);
+    if (FAILED(hr)) {
+      cerr << "Failed to get enumerate types with hr: " << std::hex << hr;
+      metadata_import->CloseEnum(cor_enum);
+      return hr;
+    }
+
+    // No type refs.
+    if (type_refs_returned == 0) {
+      break;
+    }
+
+    for (ULONG i = 0; i < type_refs_returned; ++i) {
+      std::string type_name;
+      HRESULT name_hr = debug_helper->GetTypeNameFromMdTypeRef(
+          type_refs[i], metadata_import, &type_name, &std::cerr);
+      if (FAILED(name_hr)) {
+        continue;
+      }
+      type_dict->type_refs[type_name] = type_refs[i];
+    }
+  }
+
+  metadata_import->CloseEnum(cor_enum);
+  return S_OK;
+}
+
+}  //  namespace google_cloud_debugger
@@ -0,0 +1,105 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef MODULE_TYPE_CACHE_H_
+#define MODULE_TYPE_CACHE_H_
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "ccomptr.h"
+#include "cor.h"
+#include "cordebug.h"
+
+namespace google_cloud_debugger {
+
+class ICorDebugHelper;
+
+// The types defined and referenced by a module.
+struct ModuleTypeDict {
+  // Dictionary whose key is class name and whose value
+  // is the metadata token mdTypeDef of that class.
+  std::map<std::string, mdTypeDef> type_defs;
+
+  // Dictionary whose key is class name and whose value
+  // is the metadata token mdTypeRef of that class.
+  // The difference between mdTypeDef and mdTypeRef
+  // is that mdTypeDef type is found in the current module
+  // whereas mdTypeRef is found in other modules.
+  // Hence, mdTypeRef may needs to be resolved to mdTypeDef
+  // when needed.
+  std::map<std::string, mdTypeRef> type_refs;
+};
+
+// Loaded assemblies of an app domain.
+typedef std::vector<CComPtr<ICorDebugAssembly>> DebugAssemblies;
+
+// Cache of the type dictionaries of the loaded modules, keyed by module
+// base address, and of the loaded assemblies of each app domain.
+// Both are only computed the first time a stack frame asks for them
+// (when an expression refers to a type by name) and are then shared
+// by all the stack frames of all the breakpoint hits.
+// This class is thread-safe.
+class ModuleTypeCache {
+ public:
+  // Sets type_dict to the types of debug_module, whose metadata is
+  // metadata_import. The types are enumerated on the first call
+  // for a module.
+  HRESULT GetTypeDict(ICorDebugModule *debug_module,
+                      IMetaDataImport *metadata_import,
+                      ICorDebugHelper *debug_helper,
+                      std::shared_ptr<const ModuleTypeDict> *type_dict);
+
+  // Sets debug_assemblies to the assemblies loaded in app_domain.
+  // The assemblies are enumerated on the first call for an app domain
+  // after the cache is created or cleared.
+  HRESULT GetDebugAssemblies(
+      ICorDebugAppDomain *app_domain, ICorDebugHelper *debug_helper,
+      std::shared_ptr<const DebugAssemblies> *debug_assemblies);
+
+  // Removes the types of the module loaded at module_base_address.
+  // This has to be called when the module is unloaded since another
+  // module may be loaded at the same address.
+  void RemoveModule(CORDB_ADDRESS module_base_address);
+
+  // Removes the assemblies of all the app domains. This has to be
+  // called whenever an assembly is loaded or unloaded.
+  void ClearDebugAssemblies();
+
+ private:
+  // Enumerates the type definitions and type references in the metadata
+  // metadata_import into type_dict.
+  static HRESULT PopulateTypeDict(IMetaDataImport *metadata_import,
+                                  ICorDebugHelper *debug_helper,
+                                  ModuleTypeDict *type_dict);
+
+  // Type dictionaries by module base address.
+  std::unordered_map<CORDB_ADDRESS, std::shared_ptr<const ModuleTypeDict>>
+      type_dicts_;
+
+  // Loaded assemblies by app domain ID.
+  std::unordered_map<ULONG32, std::shared_ptr<const DebugAssemblies>>
+      debug_assemblies_;
+
+  // Guards type_dicts_ and debug_assemblies_.
+  std::mutex mutex_;
+};
+
+}  //  namespace google_cloud_debugger
+
+#endif  //  MODULE_TYPE_CACHE_H_
@@ -0,0 +1,79 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "object_handle_pool.h"
+
+#include "dbg_reference_object.h"
+
+namespace google_cloud_debugger {
+
+// The pool that is current on each thread.
+static thread_local ObjectHandlePool *current_pool = nullptr;
+
+ObjectHandlePool::~ObjectHandlePool() {
+  for (DbgReferenceObject *object : pending_objects_) {
+    object->DetachHandlePool();
+  }
+  ReleaseHandles();
+}
+
+ObjectHandlePool *ObjectHandlePool::GetCurrent() { return current_pool; }
+
+void ObjectHandlePool::AddPendingObject(DbgReferenceObject *object) {
+  pending_objects_.insert(object);
+  ++object_count_;
+}
+
+void ObjectHandlePool::RemovePendingObject(DbgReferenceObject *object) {
+  pending_objects_.erase(object);
+}
+
+void ObjectHandlePool::CreatePendingHandles() {
+  std::unordered_set<DbgReferenceObject *> pending_objects;
+  pending_objects.swap(pending_objects_);
+
+  for (DbgReferenceObject *object : pending_objects) {
+    // Errors are written to the error stream of the object and reported
+    // when the object is used.
+    if (FAILED(object->CreateDeferredHandle())) {
+      continue;
+    }
+
+    CComPtr<ICorDebugHandleValue> handle;
+    if (SUCCEEDED(object->GetDebugHandle(&handle))) {
+      handles_.push_back(handle);
+      ++handle_count_;
+    }
+  }
+}
+
+void ObjectHandlePool::ReleaseHandles() {
+  // Disposing the handles releases them in the debuggee right away
+  // instead of when the last reference to them goes away.
+  for (auto &handle : handles_) {
+    handle->Dispose();
+  }
+  handles_.clear();
+}
+
+ScopedObjectHandlePool::ScopedObjectHandlePool(ObjectHandlePool *pool)
+    : previous_pool_(current_pool) {
+  current_pool = pool;
+}
+
+ScopedObjectHandlePool::~ScopedObjectHandlePool() {
+  current_pool = previous_pool_;
+}
+
+}  //  namespace google_cloud_debugger
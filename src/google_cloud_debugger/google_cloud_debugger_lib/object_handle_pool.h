@@ -0,0 +1,111 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef OBJECT_HANDLE_POOL_H_
+#define OBJECT_HANDLE_POOL_H_
+
+#include <cstdint>
+#include <unordered_set>
+#include <vector>
+
+#include "ccomptr.h"
+#include "cor.h"
+#include "cordebug.h"
+
+namespace google_cloud_debugger {
+
+class DbgReferenceObject;
+
+// Strong handles of the reference objects created while a breakpoint hit
+// is captured.
+//
+// The ICorDebugValue of an object is only valid until the debuggee is
+// continued, so reference objects used to create a strong handle as soon
+// as they were created. Each handle is a call into the debuggee and is
+// a GC root until it is released, and most objects of a hit never need
+// one since the debuggee is only continued for function evaluations.
+// While a pool is current, reference objects keep their ICorDebugValue
+// and are added to the pool instead. The handles are only created, all
+// at once, right before the debuggee is continued for a function
+// evaluation, and they are disposed together when the pool is closed.
+//
+// This class is NOT thread-safe. The pool and the objects added to it
+// are only used by the thread capturing the hit.
+class ObjectHandlePool {
+ public:
+  ObjectHandlePool() = default;
+
+  // Detaches the objects still waiting for a handle and disposes the
+  // handles created by the pool.
+  ~ObjectHandlePool();
+
+  // Returns the pool that is current on this thread, or nullptr.
+  static ObjectHandlePool *GetCurrent();
+
+  // Adds object to the objects waiting for a handle.
+  void AddPendingObject(DbgReferenceObject *object);
+
+  // Removes object from the objects waiting for a handle. This has to
+  // be called when a pending object is deleted.
+  void RemovePendingObject(DbgReferenceObject *object);
+
+  // Creates the handles of all the objects waiting for one. This has to
+  // be called before the debuggee is continued.
+  void CreatePendingHandles();
+
+  // Disposes the handles created by the pool.
+  void ReleaseHandles();
+
+  // Returns the number of reference objects added to the pool.
+  std::uint64_t GetObjectCount() const { return object_count_; }
+
+  // Returns the number of handles created by the pool.
+  std::uint64_t GetHandleCount() const { return handle_count_; }
+
+ private:
+  ObjectHandlePool(const ObjectHandlePool &) = delete;
+  ObjectHandlePool &operator=(const ObjectHandlePool &) = delete;
+
+  // Objects waiting for a handle.
+  std::unordered_set<DbgReferenceObject *> pending_objects_;
+
+  // Handles created by the pool and not disposed yet.
+  std::vector<CComPtr<ICorDebugHandleValue>> handles_;
+
+  // Number of reference objects added to the pool.
+  std::uint64_t object_count_ = 0;
+
+  // Number of handles created by the pool.
+  std::uint64_t handle_count_ = 0;
+};
+
+// Makes pool current on this thread for the lifetime of this object.
+// Reference objects created on this thread in the meantime defer their
+// handles to it.
+class ScopedObjectHandlePool {
+ public:
+  explicit ScopedObjectHandlePool(ObjectHandlePool *pool);
+  ~ScopedObjectHandlePool();
+
+ private:
+  ScopedObjectHandlePool(const ScopedObjectHandlePool &) = delete;
+  ScopedObjectHandlePool &operator=(const ScopedObjectHandlePool &) = delete;
+
+  // The pool that was current before this scope.
+  ObjectHandlePool *previous_pool_;
+};
+
+}  //  namespace google_cloud_debugger
+
+#endif  //  OBJECT_HANDLE_POOL_H_
@@ -0,0 +1,143 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "pdb_file_index.h"
+
+#include <algorithm>
+#include <iostream>
+
+using google_cloud_debugger_portable_pdb::IPortablePdbFile;
+using std::shared_ptr;
+using std::vector;
+
+namespace google_cloud_debugger {
+
+void PdbFileIndex::AddPdbFile(CORDB_ADDRESS base_address,
+                              shared_ptr<IPortablePdbFile> pdb_file) {
+  if (!pdb_file) {
+    return;
+  }
+
+  RemovePdbFile(base_address);
+  Segment *segment = GetLastMutableSegment();
+  if (!segment) {
+    std::cerr << "Failed to add PDB file to the index.";
+    return;
+  }
+
+  segment->pdb_files.push_back(pdb_file);
+  segment->pdb_files_by_base_address[base_address] = std::move(pdb_file);
+}
+
+bool PdbFileIndex::RemovePdbFile(CORDB_ADDRESS base_address) {
+  for (std::size_t i = 0; i < segments_.size(); ++i) {
+    if (segments_[i]->pdb_files_by_base_address.find(base_address) ==
+        segments_[i]->pdb_files_by_base_address.end()) {
+      continue;
+    }
+
+    Segment *segment = GetMutableSegment(i);
+    if (!segment) {
+      std::cerr << "Failed to remove PDB file from the index.";
+      return false;
+    }
+
+    auto it = segment->pdb_files_by_base_address.find(base_address);
+    segment->pdb_files.erase(std::find(segment->pdb_files.begin(),
+                                       segment->pdb_files.end(), it->second));
+    segment->pdb_files_by_base_address.erase(it);
+    if (segment->pdb_files.empty()) {
+      segments_.erase(segments_.begin() + i);
+    }
+    return true;
+  }
+
+  return false;
+}
+
+shared_ptr<IPortablePdbFile> PdbFileIndex::GetPdbFile(
+    CORDB_ADDRESS base_address) const {
+  for (auto &&segment : segments_) {
+    auto it = segment->pdb_files_by_base_address.find(base_address);
+    if (it != segment->pdb_files_by_base_address.end()) {
+      return it->second;
+    }
+  }
+
+  return nullptr;
+}
+
+vector<shared_ptr<IPortablePdbFile>> PdbFileIndex::GetPdbFiles() const {
+  vector<shared_ptr<IPortablePdbFile>> pdb_files;
+  for (auto &&segment : segments_) {
+    pdb_files.insert(pdb_files.end(), segment->pdb_files.begin(),
+                     segment->pdb_files.end());
+  }
+  return pdb_files;
+}
+
+PdbFileIndex::Segment *PdbFileIndex::GetMutableSegment(std::size_t index) {
+  // The index is only modified by its owner, so a segment that is not
+  // shared cannot become shared while it is modified.
+  if (segments_[index].use_count() > 1) {
+    shared_ptr<Segment> segment(new (std::nothrow) Segment(*segments_[index]));
+    if (!segment) {
+      return nullptr;
+    }
+    segments_[index] = std::move(segment);
+  }
+
+  return segments_[index].get();
+}
+
+PdbFileIndex::Segment *PdbFileIndex::GetLastMutableSegment() {
+  // The last segment keeps growing until the index is copied.
+  if (!segments_.empty() && segments_.back().use_count() == 1) {
+    return segments_.back().get();
+  }
+
+  MergeLastSegments();
+  shared_ptr<Segment> segment(new (std::nothrow) Segment());
+  if (!segment) {
+    return nullptr;
+  }
+
+  segments_.push_back(std::move(segment));
+  return segments_.back().get();
+}
+
+void PdbFileIndex::MergeLastSegments() {
+  while (segments_.size() >= 2) {
+    const Segment &last = *segments_[segments_.size() - 1];
+    const Segment &previous = *segments_[segments_.size() - 2];
+    if (last.pdb_files.size() * 2 <= previous.pdb_files.size()) {
+      return;
+    }
+
+    shared_ptr<Segment> merged(new (std::nothrow) Segment(previous));
+    if (!merged) {
+      return;
+    }
+
+    merged->pdb_files.insert(merged->pdb_files.end(), last.pdb_files.begin(),
+                             last.pdb_files.end());
+    merged->pdb_files_by_base_address.insert(
+        last.pdb_files_by_base_address.begin(),
+        last.pdb_files_by_base_address.end());
+    segments_.pop_back();
+    segments_.back() = std::move(merged);
+  }
+}
+
+}  //  namespace google_cloud_debugger
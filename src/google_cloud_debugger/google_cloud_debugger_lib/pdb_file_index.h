@@ -0,0 +1,102 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef PDB_FILE_INDEX_H_
+#define PDB_FILE_INDEX_H_
+
+#include <cstddef>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "cor.h"
+#include "cordebug.h"
+#include "i_portable_pdb_file.h"
+
+namespace google_cloud_debugger {
+
+// Parsed PDB files of the loaded modules, indexed by the base address
+// of the module.
+//
+// ModuleRegistry publishes a new PdbFileIndex whenever modules are
+// registered and never modifies a published one, so a breakpoint hit
+// can use the same index for its whole capture without locking.
+//
+// To keep publishing cheap with hundreds of modules, the PDB files are
+// stored in immutable segments shared between the copies of an index.
+// Copying an index only copies the pointers to its segments, and a
+// segment is only copied when a shared one is modified. The segments
+// are merged so that each is at most half the size of the one before
+// it, which keeps their number logarithmic in the number of PDB files.
+class PdbFileIndex {
+ public:
+  // Adds pdb_file, the parsed PDB file of the module loaded
+  // at base_address. Replaces the PDB file already added for
+  // base_address, if any.
+  void AddPdbFile(
+      CORDB_ADDRESS base_address,
+      std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>
+          pdb_file);
+
+  // Removes the PDB file of the module loaded at base_address.
+  // Returns false if there is none.
+  bool RemovePdbFile(CORDB_ADDRESS base_address);
+
+  // Returns the PDB file of the module loaded at base_address.
+  // Returns nullptr if the module does not have a parsed PDB file.
+  std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>
+  GetPdbFile(CORDB_ADDRESS base_address) const;
+
+  // Returns all the parsed PDB files in the order they are added.
+  std::vector<
+      std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>>
+  GetPdbFiles() const;
+
+  // Returns the number of segments the PDB files are stored in.
+  std::size_t GetSegmentCount() const { return segments_.size(); }
+
+ private:
+  // PDB files added together.
+  struct Segment {
+    // The PDB files of the segment in the order they are added.
+    std::vector<
+        std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>>
+        pdb_files;
+
+    // The PDB files of the segment by module base address.
+    std::unordered_map<
+        CORDB_ADDRESS,
+        std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>>
+        pdb_files_by_base_address;
+  };
+
+  // Returns the segment at index, copying it first if it is shared with
+  // another index.
+  Segment *GetMutableSegment(std::size_t index);
+
+  // Returns a segment at the end of segments_ that new PDB files can
+  // be added to. Returns nullptr if it cannot be created.
+  Segment *GetLastMutableSegment();
+
+  // Merges the last segments until each one is at most half the size
+  // of the one before it.
+  void MergeLastSegments();
+
+  // The segments of this index, from the oldest to the newest.
+  std::vector<std::shared_ptr<Segment>> segments_;
+};
+
+}  //  namespace google_cloud_debugger
+
+#endif  //  PDB_FILE_INDEX_H_
@@ -0,0 +1,207 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "sampling_profiler.h"
+
+#include <fstream>
+#include <iostream>
+
+#include "metrics.h"
+#include "stack_frame_collection.h"
+
+using std::cerr;
+using std::lock_guard;
+using std::mutex;
+using std::shared_ptr;
+using std::string;
+using std::unique_lock;
+using std::vector;
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+using std::chrono::seconds;
+using std::chrono::steady_clock;
+
+namespace google_cloud_debugger {
+
+const char FoldedStacks::kOtherStacks[] = "[other]";
+
+void FoldedStacks::AddSample(const vector<string> &frame_names) {
+  if (frame_names.empty()) {
+    return;
+  }
+
+  // Folded stacks start with the outermost frame.
+  string folded_stack;
+  for (auto it = frame_names.rbegin(); it != frame_names.rend(); ++it) {
+    if (!folded_stack.empty()) {
+      folded_stack += ';';
+    }
+    folded_stack += *it;
+  }
+
+  lock_guard<mutex> lk(mutex_);
+  ++sample_count_;
+  auto stack = stacks_.find(folded_stack);
+  if (stack != stacks_.end()) {
+    ++stack->second;
+  } else if (stacks_.size() < kMaximumStacks) {
+    stacks_[folded_stack] = 1;
+  } else {
+    ++stacks_[kOtherStacks];
+  }
+}
+
+std::uint64_t FoldedStacks::GetSampleCount() const {
+  lock_guard<mutex> lk(mutex_);
+  return sample_count_;
+}
+
+void FoldedStacks::Write(std::ostream *out) const {
+  lock_guard<mutex> lk(mutex_);
+  for (auto &&stack : stacks_) {
+    *out << stack.first << " " << stack.second << "\n";
+  }
+}
+
+const seconds SamplingProfiler::kExportInterval = seconds(60);
+
+SamplingProfiler::SamplingProfiler(
+    ICorDebugProcess *debug_process, shared_ptr<ICorDebugHelper> debug_helper,
+    shared_ptr<StackFrameMethodCache> method_cache,
+    IEvalCoordinator *eval_coordinator, ModuleRegistry *module_registry,
+    milliseconds interval, const string &file_path)
+    : debug_helper_(debug_helper),
+      method_cache_(method_cache),
+      eval_coordinator_(eval_coordinator),
+      module_registry_(module_registry),
+      interval_(interval),
+      pause_budget_(duration_cast<microseconds>(interval) / 10),
+      file_path_(file_path) {
+  // CComPtr cannot be constructed from a raw pointer, only assigned.
+  debug_process_ = debug_process;
+  sample_thread_ = std::thread(&SamplingProfiler::SampleLoop, this);
+}
+
+SamplingProfiler::~SamplingProfiler() {
+  {
+    lock_guard<mutex> lk(mutex_);
+    stopping_ = true;
+  }
+  stop_cv_.notify_one();
+
+  if (sample_thread_.joinable()) {
+    sample_thread_.join();
+  }
+
+  WriteFile();
+}
+
+HRESULT SamplingProfiler::TakeSample() {
+  // Getting the index may wait for queued modules to be parsed, so this
+  // is done before stopping the debuggee.
+  shared_ptr<const PdbFileIndex> pdb_index =
+      module_registry_->GetPdbFileIndex();
+  StackFrameCollection stack_frames(debug_helper_, nullptr, method_cache_);
+  vector<vector<string>> stacks;
+
+  if (!eval_coordinator_->TryBeginSample()) {
+    return S_FALSE;
+  }
+
+  {
+    ScopedPhaseTimer timer(MetricPhase::kProfilerSample);
+    steady_clock::time_point pause_start = steady_clock::now();
+
+    // Stop and Continue are counted by the debugger, so this also works
+    // while the debuggee is stopped in a callback that waits for
+    // the sample to end.
+    HRESULT hr = debug_process_->Stop(-1);
+    if (FAILED(hr)) {
+      eval_coordinator_->EndSample();
+      cerr << "Failed to stop the process for a sample: " << std::hex << hr
+           << std::dec << std::endl;
+      return hr;
+    }
+
+    vector<CComPtr<ICorDebugThread>> debug_threads;
+    CComPtr<ICorDebugThreadEnum> thread_enum;
+    hr = debug_process_->EnumerateThreads(&thread_enum);
+    if (SUCCEEDED(hr)) {
+      hr = ICorDebugHelper::EnumerateICorDebugSpecifiedType<
+          ICorDebugThreadEnum, ICorDebugThread>(thread_enum, &debug_threads);
+    }
+
+    if (FAILED(hr)) {
+      cerr << "Failed to enumerate threads: " << std::hex << hr << std::dec
+           << std::endl;
+    }
+
+    for (std::size_t i = 0; i < debug_threads.size(); ++i) {
+      // The remaining threads are skipped rather than keeping
+      // the debuggee stopped for too long.
+      if (i >= kMaximumThreadsPerSample ||
+          steady_clock::now() - pause_start >= pause_budget_) {
+        break;
+      }
+
+      vector<string> frame_names;
+      hr = stack_frames.WalkFrameNames(debug_threads[i], *pdb_index,
+                                       kMaximumFramesPerThread, &frame_names);
+      if (SUCCEEDED(hr)) {
+        stacks.push_back(std::move(frame_names));
+      }
+    }
+
+    hr = debug_process_->Continue(FALSE);
+    eval_coordinator_->EndSample();
+    if (FAILED(hr)) {
+      cerr << "Failed to continue the process after a sample: " << std::hex
+           << hr << std::dec << std::endl;
+      return hr;
+    }
+  }
+
+  for (auto &&stack : stacks) {
+    folded_stacks_.AddSample(stack);
+  }
+  return S_OK;
+}
+
+void SamplingProfiler::WriteFile() {
+  std::ofstream file(file_path_, std::ios::out | std::ios::trunc);
+  if (!file) {
+    cerr << "Failed to open profile file " << file_path_ << std::endl;
+    return;
+  }
+
+  folded_stacks_.Write(&file);
+}
+
+void SamplingProfiler::SampleLoop() {
+  steady_clock::time_point last_export = steady_clock::now();
+  unique_lock<mutex> lk(mutex_);
+  while (!stop_cv_.wait_for(lk, interval_, [&] { return stopping_; })) {
+    lk.unlock();
+    TakeSample();
+    if (steady_clock::now() - last_export >= kExportInterval) {
+      WriteFile();
+      last_export = steady_clock::now();
+    }
+    lk.lock();
+  }
+}
+
+}  //  namespace google_cloud_debugger
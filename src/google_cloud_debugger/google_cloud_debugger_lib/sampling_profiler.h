@@ -0,0 +1,161 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef SAMPLING_PROFILER_H_
+#define SAMPLING_PROFILER_H_
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "ccomptr.h"
+#include "cor.h"
+#include "cordebug.h"
+#include "i_cor_debug_helper.h"
+#include "i_eval_coordinator.h"
+#include "module_registry.h"
+#include "stack_frame_method_cache.h"
+
+namespace google_cloud_debugger {
+
+// Call stacks aggregated in the folded format read by flame graph tools:
+// one line per distinct stack with its frames, from the outermost one,
+// separated by semicolons, followed by a space and the number of samples.
+// This class is thread-safe.
+class FoldedStacks {
+ public:
+  // Maximum number of distinct stacks kept. Samples of new stacks are
+  // counted under kOtherStacks once the limit is reached.
+  static const std::size_t kMaximumStacks = 10000;
+
+  // Stack that the samples of the stacks over the limit are counted under.
+  static const char kOtherStacks[];
+
+  // Adds a sample of the stack frame_names, innermost frame first.
+  // Empty stacks are ignored.
+  void AddSample(const std::vector<std::string> &frame_names);
+
+  // Returns the number of samples added.
+  std::uint64_t GetSampleCount() const;
+
+  // Writes the folded stacks to out.
+  void Write(std::ostream *out) const;
+
+ private:
+  // Number of samples by folded stack.
+  std::map<std::string, std::uint64_t> stacks_;
+
+  // Number of samples added.
+  std::uint64_t sample_count_ = 0;
+
+  // Guards stacks_ and sample_count_.
+  mutable std::mutex mutex_;
+};
+
+// Periodically stops the debuggee, walks the stacks of its managed threads
+// and resumes it. The stacks are aggregated in a FoldedStacks that is
+// periodically written to a file.
+//
+// Only the names of the methods on the stacks are resolved, through the
+// method cache shared with the breakpoint stack walks, so the debuggee is
+// only stopped for the stack walks themselves. The pause of a sample is
+// bounded by the number of threads and frames walked and by a time budget
+// after which the remaining threads are skipped.
+class SamplingProfiler {
+ public:
+  // Maximum number of threads walked in a sample.
+  static const std::uint32_t kMaximumThreadsPerSample = 256;
+
+  // Maximum number of frames walked on a thread.
+  static const std::uint32_t kMaximumFramesPerThread = 64;
+
+  // How often the folded stacks are written to the file.
+  static const std::chrono::seconds kExportInterval;
+
+  // Starts taking a sample of debug_process every interval and writing
+  // the folded stacks to file_path. Threads are not walked anymore once
+  // a sample has stopped the debuggee for a tenth of interval.
+  // Samples are skipped while eval_coordinator captures a breakpoint hit.
+  // eval_coordinator and module_registry have to outlive this object.
+  SamplingProfiler(ICorDebugProcess *debug_process,
+                   std::shared_ptr<ICorDebugHelper> debug_helper,
+                   std::shared_ptr<StackFrameMethodCache> method_cache,
+                   IEvalCoordinator *eval_coordinator,
+                   ModuleRegistry *module_registry,
+                   std::chrono::milliseconds interval,
+                   const std::string &file_path);
+
+  // Stops sampling and writes the folded stacks one last time.
+  ~SamplingProfiler();
+
+  // Stops the debuggee, walks the stacks of its threads and resumes it.
+  // Returns S_FALSE without sampling if a breakpoint hit is being
+  // captured: the capture continues the debuggee for function
+  // evaluations and reads the stack of the hit thread, so the sample
+  // would race with it.
+  HRESULT TakeSample();
+
+ private:
+  // Overwrites the file with the current folded stacks.
+  void WriteFile();
+
+  // Loop of the sampling thread.
+  void SampleLoop();
+
+  // The process being sampled.
+  CComPtr<ICorDebugProcess> debug_process_;
+
+  // Helper methods for ICorDebug objects.
+  std::shared_ptr<ICorDebugHelper> debug_helper_;
+
+  // Names of the methods on the stack, shared with the breakpoint
+  // stack walks.
+  std::shared_ptr<StackFrameMethodCache> method_cache_;
+
+  // Coordinates the samples with the capture of breakpoint hits.
+  IEvalCoordinator *eval_coordinator_;
+
+  // Registry of the loaded modules, used to cache the methods with
+  // their PDB files.
+  ModuleRegistry *module_registry_;
+
+  // Time between two samples.
+  std::chrono::milliseconds interval_;
+
+  // Longest time a sample keeps the debuggee stopped for.
+  std::chrono::microseconds pause_budget_;
+
+  std::string file_path_;
+
+  // Stacks sampled so far.
+  FoldedStacks folded_stacks_;
+
+  // Set to true to stop the sampling thread.
+  bool stopping_ = false;
+  std::mutex mutex_;
+  std::condition_variable stop_cv_;
+  std::thread sample_thread_;
+};
+
+}  //  namespace google_cloud_debugger
+
+#endif  //  SAMPLING_PROFILER_H_
@@ -0,0 +1,117 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "snapshot_arena.h"
+
+namespace google_cloud_debugger {
+
+// Header in front of every allocation. It is padded so the memory
+// after it is aligned for any type.
+union AllocationHeader {
+  SnapshotArena *arena;
+  std::max_align_t alignment;
+};
+
+static const std::size_t kHeaderSize = sizeof(AllocationHeader);
+
+// Rounds size up to a multiple of the header size.
+static std::size_t AlignSize(std::size_t size) {
+  return (size + kHeaderSize - 1) / kHeaderSize * kHeaderSize;
+}
+
+static thread_local SnapshotArena *current_arena = nullptr;
+
+SnapshotArena::~SnapshotArena() {
+  for (char *chunk : chunks_) {
+    delete[] chunk;
+  }
+}
+
+void *SnapshotArena::Allocate(std::size_t size) {
+  std::size_t total_size = kHeaderSize + AlignSize(size);
+  SnapshotArena *arena = current_arena;
+
+  AllocationHeader *header = nullptr;
+  if (arena && total_size <= kMaximumArenaAllocation) {
+    header =
+        static_cast<AllocationHeader *>(arena->AllocateFromChunk(total_size));
+  }
+
+  if (header) {
+    header->arena = arena;
+  } else {
+    header = static_cast<AllocationHeader *>(
+        ::operator new(total_size, std::nothrow));
+    if (!header) {
+      return nullptr;
+    }
+    header->arena = nullptr;
+  }
+
+  return header + 1;
+}
+
+void SnapshotArena::Deallocate(void *memory) {
+  if (!memory) {
+    return;
+  }
+
+  AllocationHeader *header = static_cast<AllocationHeader *>(memory) - 1;
+  if (header->arena) {
+    header->arena->Release();
+  } else {
+    ::operator delete(header);
+  }
+}
+
+SnapshotArena *SnapshotArena::GetCurrent() { return current_arena; }
+
+void *SnapshotArena::AllocateFromChunk(std::size_t size) {
+  if (chunk_used_ + size > kChunkSize) {
+    char *chunk = new (std::nothrow) char[kChunkSize];
+    if (!chunk) {
+      return nullptr;
+    }
+    chunks_.push_back(chunk);
+    chunk_used_ = 0;
+  }
+
+  void *memory = chunks_.back() + chunk_used_;
+  chunk_used_ += size;
+  ++allocation_count_;
+  references_.fetch_add(1);
+  return memory;
+}
+
+void SnapshotArena::Release() {
+  if (references_.fetch_sub(1) == 1) {
+    delete this;
+  }
+}
+
+ScopedSnapshotArena::ScopedSnapshotArena()
+    : arena_(new (std::nothrow) SnapshotArena()),
+      previous_arena_(current_arena) {
+  current_arena = arena_;
+}
+
+ScopedSnapshotArena::~ScopedSnapshotArena() {
+  current_arena = previous_arena_;
+  if (arena_) {
+    arena_->Release();
+  }
+}
+
+}  //  namespace google_cloud_debugger
@@ -0,0 +1,180 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef SNAPSHOT_ARENA_H_
+#define SNAPSHOT_ARENA_H_
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+namespace google_cloud_debugger {
+
+// Memory for the objects created while a breakpoint hit is captured.
+// A hit creates thousands of small DbgObjects and class members that
+// all die together when the hit is done, so they are carved out of
+// large chunks instead of being allocated one at a time.
+//
+// Every allocation has a small header that records the arena it came
+// from, so objects that outlive the capture (for example values cached
+// by a breakpoint) are still safe to delete: the chunks are only freed
+// once the arena is closed and every object in it is deleted.
+//
+// Allocate is only called by the thread the arena is current on.
+// Deallocate can be called from any thread.
+class SnapshotArena {
+ public:
+  // Size of the chunks allocated by the arena.
+  static const std::size_t kChunkSize = 64 * 1024;
+
+  // Allocations larger than this are not put in the arena.
+  static const std::size_t kMaximumArenaAllocation = kChunkSize / 4;
+
+  // Allocates size bytes from the arena that is current on this thread,
+  // or from the heap if there is none. Returns nullptr on failure.
+  static void *Allocate(std::size_t size);
+
+  // Deallocates memory returned by Allocate.
+  static void Deallocate(void *memory);
+
+  // Returns the arena that is current on this thread, or nullptr.
+  static SnapshotArena *GetCurrent();
+
+  // Returns the number of allocations made from this arena.
+  std::uint64_t GetAllocationCount() const { return allocation_count_; }
+
+  // Returns the number of chunks allocated by this arena, which is the
+  // number of calls made to the heap for the allocations above.
+  std::size_t GetChunkCount() const { return chunks_.size(); }
+
+ private:
+  friend class ScopedSnapshotArena;
+
+  SnapshotArena() = default;
+  ~SnapshotArena();
+
+  SnapshotArena(const SnapshotArena &) = delete;
+  SnapshotArena &operator=(const SnapshotArena &) = delete;
+
+  // Allocates size bytes from the chunks of this arena.
+  void *AllocateFromChunk(std::size_t size);
+
+  // Drops a reference to this arena and deletes it if it was the last.
+  void Release();
+
+  // The chunks of this arena.
+  std::vector<char *> chunks_;
+
+  // Bytes used in the last chunk.
+  std::size_t chunk_used_ = kChunkSize;
+
+  // Number of allocations made from this arena.
+  std::uint64_t allocation_count_ = 0;
+
+  // One reference for the scope that owns the arena and one for each
+  // object that is not deleted yet.
+  std::atomic<std::uint64_t> references_{1};
+};
+
+// Makes a new SnapshotArena current on this thread for the lifetime of
+// this object. DbgObjects and class members created on this thread in
+// the meantime are allocated from it.
+class ScopedSnapshotArena {
+ public:
+  ScopedSnapshotArena();
+  ~ScopedSnapshotArena();
+
+  // Returns the arena, which may be nullptr if it failed to be created.
+  SnapshotArena *GetArena() const { return arena_; }
+
+ private:
+  ScopedSnapshotArena(const ScopedSnapshotArena &) = delete;
+  ScopedSnapshotArena &operator=(const ScopedSnapshotArena &) = delete;
+
+  // The arena of this scope.
+  SnapshotArena *arena_;
+
+  // The arena that was current before this scope.
+  SnapshotArena *previous_arena_;
+};
+
+// Base class for classes whose objects are allocated from the current
+// SnapshotArena.
+class SnapshotAllocated {
+ public:
+  static void *operator new(std::size_t size) {
+    void *memory = SnapshotArena::Allocate(size);
+    if (!memory) {
+      throw std::bad_alloc();
+    }
+    return memory;
+  }
+
+  static void *operator new(std::size_t size, const std::nothrow_t &) {
+    return SnapshotArena::Allocate(size);
+  }
+
+  static void operator delete(void *memory) {
+    SnapshotArena::Deallocate(memory);
+  }
+
+  static void operator delete(void *memory, const std::nothrow_t &) {
+    SnapshotArena::Deallocate(memory);
+  }
+};
+
+// Allocator of standard containers that allocates from the current
+// SnapshotArena, so the temporary containers of a capture are freed in
+// bulk with its DbgObjects. Like the objects, the memory can be freed
+// from any thread and after the arena is closed.
+template <typename T>
+class SnapshotAllocator {
+ public:
+  typedef T value_type;
+
+  SnapshotAllocator() = default;
+
+  template <typename U>
+  SnapshotAllocator(const SnapshotAllocator<U> &) {}
+
+  T *allocate(std::size_t count) {
+    void *memory = SnapshotArena::Allocate(count * sizeof(T));
+    if (!memory) {
+      throw std::bad_alloc();
+    }
+    return static_cast<T *>(memory);
+  }
+
+  void deallocate(T *memory, std::size_t) {
+    SnapshotArena::Deallocate(memory);
+  }
+};
+
+// Every SnapshotAllocator can free the memory of the others.
+template <typename T, typename U>
+bool operator==(const SnapshotAllocator<T> &, const SnapshotAllocator<U> &) {
+  return true;
+}
+
+template <typename T, typename U>
+bool operator!=(const SnapshotAllocator<T> &, const SnapshotAllocator<U> &) {
+  return false;
+}
+
+}  //  namespace google_cloud_debugger
+
+#endif  //  SNAPSHOT_ARENA_H_
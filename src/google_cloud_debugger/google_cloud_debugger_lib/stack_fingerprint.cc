@@ -0,0 +1,120 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "stack_fingerprint.h"
+
+using std::lock_guard;
+using std::mutex;
+using std::chrono::milliseconds;
+using std::chrono::steady_clock;
+
+namespace google_cloud_debugger {
+
+// FNV-1a prime for 64-bit hashes.
+static const std::uint64_t kFnvPrime = 1099511628211ULL;
+
+const std::uint64_t StackFingerprint::kEmptyStack;
+
+std::uint64_t StackFingerprint::HashFrame(CORDB_ADDRESS module_base_address,
+                                          mdMethodDef method_token,
+                                          std::uint32_t il_offset) {
+  std::uint64_t hash = Combine(kEmptyStack, module_base_address);
+  hash = Combine(hash, method_token);
+  return Combine(hash, il_offset);
+}
+
+std::uint64_t StackFingerprint::Combine(std::uint64_t stack_fingerprint,
+                                        std::uint64_t frame_fingerprint) {
+  // FNV-1a over the bytes of frame_fingerprint.
+  for (int i = 0; i < 8; ++i) {
+    stack_fingerprint ^= (frame_fingerprint >> (i * 8)) & 0xff;
+    stack_fingerprint *= kFnvPrime;
+  }
+  return stack_fingerprint;
+}
+
+const std::size_t StackHitCounter::kMaximumFingerprints;
+
+std::uint32_t StackHitCounter::RecordHit(std::uint64_t fingerprint,
+                                         milliseconds window,
+                                         steady_clock::time_point now) {
+  if (window.count() <= 0) {
+    return 1;
+  }
+
+  lock_guard<mutex> lk(mutex_);
+  auto it = windows_.find(fingerprint);
+  if (it != windows_.end()) {
+    if (now - it->second.window_start < window) {
+      return ++it->second.hit_count;
+    }
+
+    // The window expired so this hit is captured and starts a new one.
+    KeepEndedWindow(fingerprint, it->second);
+    it->second.window_start = now;
+    it->second.hit_count = 1;
+    return 1;
+  }
+
+  if (windows_.size() >= kMaximumFingerprints) {
+    RemoveExpiredEntries(window, now);
+    if (windows_.size() >= kMaximumFingerprints) {
+      return 1;
+    }
+  }
+
+  windows_[fingerprint] = WindowEntry{now, 1};
+  return 1;
+}
+
+void StackHitCounter::RemoveExpiredEntries(milliseconds window,
+                                           steady_clock::time_point now) {
+  auto it = windows_.begin();
+  while (it != windows_.end()) {
+    if (now - it->second.window_start >= window) {
+      KeepEndedWindow(it->first, it->second);
+      it = windows_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+void StackHitCounter::TakeEndedWindows(
+    milliseconds window, steady_clock::time_point now, bool flush_all,
+    std::vector<std::pair<std::uint64_t, std::uint32_t>> *ended_windows) {
+  lock_guard<mutex> lk(mutex_);
+  if (flush_all) {
+    for (auto &&kvp : windows_) {
+      KeepEndedWindow(kvp.first, kvp.second);
+    }
+    windows_.clear();
+  } else {
+    RemoveExpiredEntries(window, now);
+  }
+
+  ended_windows->insert(ended_windows->end(), ended_windows_.begin(),
+                        ended_windows_.end());
+  ended_windows_.clear();
+}
+
+void StackHitCounter::KeepEndedWindow(std::uint64_t fingerprint,
+                                      const WindowEntry &entry) {
+  // A window with a single hit was fully reported by its captured hit.
+  if (entry.hit_count > 1) {
+    ended_windows_.push_back(std::make_pair(fingerprint, entry.hit_count));
+  }
+}
+
+}  //  namespace google_cloud_debugger
@@ -0,0 +1,106 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef STACK_FINGERPRINT_H_
+#define STACK_FINGERPRINT_H_
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "cor.h"
+#include "cordebug.h"
+
+namespace google_cloud_debugger {
+
+// Helpers to compute a cheap fingerprint of a call stack from the
+// module, method token and IL offset of each frame.
+class StackFingerprint {
+ public:
+  // Fingerprint of an empty stack.
+  static const std::uint64_t kEmptyStack = 14695981039346656037ULL;
+
+  // Returns the fingerprint of a frame stopped at il_offset in the method
+  // with token method_token of the module loaded at module_base_address.
+  static std::uint64_t HashFrame(CORDB_ADDRESS module_base_address,
+                                 mdMethodDef method_token,
+                                 std::uint32_t il_offset);
+
+  // Returns stack_fingerprint extended with the frame fingerprint
+  // frame_fingerprint. The order of the frames matters.
+  static std::uint64_t Combine(std::uint64_t stack_fingerprint,
+                               std::uint64_t frame_fingerprint);
+};
+
+// Counts the hits of a breakpoint per stack fingerprint within a time
+// window, so that only the first hit from a call path is captured.
+// The counts of the windows that ended with more than one hit are kept
+// until they are taken by TakeEndedWindows.
+// This class is thread-safe.
+class StackHitCounter {
+ public:
+  // Maximum number of fingerprints tracked. Once this is reached and no
+  // window has expired, hits from new call paths are always captured.
+  static const std::size_t kMaximumFingerprints = 1000;
+
+  // Records a hit with stack fingerprint fingerprint at time now.
+  // Returns the number of hits with this fingerprint in the window
+  // started by the first of them, including this one. A window of 0
+  // disables the counting and always returns 1.
+  std::uint32_t RecordHit(std::uint64_t fingerprint,
+                          std::chrono::milliseconds window,
+                          std::chrono::steady_clock::time_point now);
+
+  // Appends the stack fingerprint and hit count of every window that
+  // ended before now with more than one hit to ended_windows and stops
+  // tracking them. If flush_all is true, the windows that did not
+  // end yet are taken too.
+  void TakeEndedWindows(
+      std::chrono::milliseconds window,
+      std::chrono::steady_clock::time_point now, bool flush_all,
+      std::vector<std::pair<std::uint64_t, std::uint32_t>> *ended_windows);
+
+ private:
+  struct WindowEntry {
+    // Time of the captured hit that started the window.
+    std::chrono::steady_clock::time_point window_start;
+
+    // Number of hits in the window, including the captured one.
+    std::uint32_t hit_count;
+  };
+
+  // Removes the entries whose window ended before now.
+  void RemoveExpiredEntries(std::chrono::milliseconds window,
+                            std::chrono::steady_clock::time_point now);
+
+  // Keeps the count of a window with more than one hit that ended
+  // so that it can be reported by TakeEndedWindows.
+  void KeepEndedWindow(std::uint64_t fingerprint, const WindowEntry &entry);
+
+  // Windows by stack fingerprint.
+  std::unordered_map<std::uint64_t, WindowEntry> windows_;
+
+  // Fingerprints and hit counts of the ended windows not taken yet.
+  std::vector<std::pair<std::uint64_t, std::uint32_t>> ended_windows_;
+
+  // Guards windows_ and ended_windows_.
+  std::mutex mutex_;
+};
+
+}  //  namespace google_cloud_debugger
+
+#endif  //  STACK_FINGERPRINT_H_
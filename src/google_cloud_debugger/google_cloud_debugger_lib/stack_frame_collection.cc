@@ -18,11 +18,15 @@
 #include <iostream>
 #include <string>
 
+#include "capture_planner.h"
 #include "dbg_breakpoint.h"
 #include "expression_util.h"
 #include "i_cor_debug_helper.h"
 #include "i_dbg_object_factory.h"
 #include "i_eval_coordinator.h"
+#include "metrics.h"
+#include "pdb_file_index.h"
+#include "stack_fingerprint.h"
 
 using google::cloud::diagnostics::debug::Breakpoint;
 using google::cloud::diagnostics::debug::SourceLocation;
@@ -40,14 +44,27 @@ using std::vector;
 namespace google_cloud_debugger {
 StackFrameCollection::StackFrameCollection(
     std::shared_ptr<ICorDebugHelper> debug_helper,
-    std::shared_ptr<IDbgObjectFactory> obj_factory)
-    : debug_helper_(debug_helper), obj_factory_(obj_factory) {}
+    std::shared_ptr<IDbgObjectFactory> obj_factory,
+    std::shared_ptr<StackFrameMethodCache> method_cache,
+    std::shared_ptr<ModuleTypeCache> type_cache,
+    const CaptureProfile &walk_profile)
+    : debug_helper_(debug_helper),
+      obj_factory_(obj_factory),
+      method_cache_(method_cache),
+      type_cache_(type_cache),
+      walk_profile_(walk_profile) {
+  if (!method_cache_) {
+    method_cache_ = std::make_shared<StackFrameMethodCache>();
+  }
+
+  if (!type_cache_) {
+    type_cache_ = std::make_shared<ModuleTypeCache>();
+  }
+}
 
 HRESULT StackFrameCollection::ProcessBreakpoint(
-    const vector<
-        std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>>
-        &pdb_files,
-    DbgBreakpoint *breakpoint, IEvalCoordinator *eval_coordinator) {
+    const PdbFileIndex &pdb_index, DbgBreakpoint *breakpoint,
+    IEvalCoordinator *eval_coordinator) {
   if (!breakpoint) {
     std::cerr << "DbgBreakpoint is null.";
     return E_INVALIDARG;
@@ -64,7 +81,7 @@ HRESULT StackFrameCollection::ProcessBreakpoint(
   // TODO(quoct): Add expressions handling.
   const std::string &breakpoint_condition = breakpoint->GetCondition();
   if (!breakpoint_condition.empty()) {
-    hr = EvaluateBreakpointCondition(breakpoint, eval_coordinator, pdb_files);
+    hr = EvaluateBreakpointCondition(breakpoint, eval_coordinator, pdb_index);
     if (FAILED(hr)) {
       breakpoint->WriteError("Failed to evaluate breakpoint condition " +
                              breakpoint_condition);
@@ -76,19 +93,23 @@ HRESULT StackFrameCollection::ProcessBreakpoint(
     }
   }
 
-  if (!breakpoint->GetExpressions().empty()) {
-    hr = ProcessExpressions(breakpoint, eval_coordinator, pdb_files);
+  // Stack-only breakpoints do not read any variables, so their
+  // expressions are not evaluated.
+  if (!breakpoint->GetExpressions().empty() &&
+      !breakpoint->GetCaptureProfile().stack_only) {
+    hr = ProcessExpressions(breakpoint, eval_coordinator, pdb_index);
     if (FAILED(hr)) {
       breakpoint->WriteError("Failed to evaluate breakpoint expressions.");
       return hr;
     }
   }
 
-  return WalkStackAndProcessStackFrame(eval_coordinator, pdb_files);
+  return WalkStackAndProcessStackFrame(eval_coordinator, pdb_index);
 }
 
 HRESULT StackFrameCollection::PopulateStackFrames(
-    Breakpoint *breakpoint, IEvalCoordinator *eval_coordinator) {
+    Breakpoint *breakpoint, const CaptureProfile &capture_profile,
+    IEvalCoordinator *eval_coordinator) {
   if (!breakpoint) {
     std::cerr << "Null breakpoint.";
     return E_INVALIDARG;
@@ -99,20 +120,27 @@ HRESULT StackFrameCollection::PopulateStackFrames(
     return E_INVALIDARG;
   }
 
-  HRESULT hr = S_OK;
-
-  // Gives the first frame half available kb in the breakpoint.
-  int frame_max_size =
-      (DbgBreakpoint::kMaximumBreakpointSize - breakpoint->ByteSize()) / 2;
+  // The stack may have been walked for another breakpoint with
+  // a deeper capture profile, so the limits of this breakpoint
+  // are applied here.
+  int max_breakpoint_size =
+      static_cast<int>(capture_profile.max_breakpoint_size);
+  int max_frames_with_variables =
+      capture_profile.stack_only
+          ? 0
+          : static_cast<int>(capture_profile.max_stack_frames_with_variables);
   int processed_il_frames_so_far = 0;
+  std::uint32_t frames_so_far = 0;
 
+  // The variables of all the frames share the size left in the breakpoint
+  // and are captured once all the frames are added.
+  CapturePlanner planner(eval_coordinator,
+                         static_cast<int>(capture_profile.max_object_depth));
   for (auto &&dbg_stack_frame : stack_frames_) {
-    // If this is the last processed IL frame, just gives it the rest
-    // of the size available.
-    if (processed_il_frames_so_far == number_of_processed_il_frames_ - 1) {
-      frame_max_size =
-          DbgBreakpoint::kMaximumBreakpointSize - breakpoint->ByteSize();
+    if (frames_so_far >= capture_profile.max_stack_frames) {
+      break;
     }
+    ++frames_so_far;
 
     StackFrame *frame = breakpoint->add_stack_frames();
     // If dbg_stack_frame is an empty stack frame, just says it's undebuggable.
@@ -133,71 +161,95 @@ HRESULT StackFrameCollection::PopulateStackFrames(
     frame_location->set_line(dbg_stack_frame->GetLineNumber());
     frame_location->set_path(dbg_stack_frame->GetFile());
 
-    hr = dbg_stack_frame->PopulateStackFrame(frame, frame_max_size,
-                                             eval_coordinator);
-    if (FAILED(hr)) {
-      return hr;
+    // Frames past the limit of the breakpoint are reported without
+    // their variables.
+    if (processed_il_frames_so_far < max_frames_with_variables) {
+      dbg_stack_frame->AddVariablesToPlan(frame, &planner);
     }
 
     if (dbg_stack_frame->IsProcessedIlFrame()) {
       ++processed_il_frames_so_far;
     }
-
-    if (breakpoint->ByteSize() > DbgBreakpoint::kMaximumBreakpointSize) {
-      break;
-    }
-
-    // Updates frame_max_size to half of whatever is left.
-    frame_max_size =
-        (DbgBreakpoint::kMaximumBreakpointSize - breakpoint->ByteSize()) / 2;
   }
 
-  return S_OK;
+  // ByteSize walks the whole proto, so it is only called once and timed
+  // separately. The planner then adds the size of each variable it
+  // captures.
+  int breakpoint_size;
+  {
+    ScopedPhaseTimer timer(MetricPhase::kProtoByteSize, breakpoint->id());
+    breakpoint_size = breakpoint->ByteSize();
+  }
+  return planner.Capture(breakpoint_size, max_breakpoint_size);
 }
 
-HRESULT StackFrameCollection::PopulateAsyncStackFrameInfo(
-    DbgStackFrame *async_frame, ICorDebugStackWalk *stack_walk,
-    const std::vector<
-        std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>>
-        &parsed_pdb_files) {
-  HRESULT hr;
-  // To get to the stack frame with the actual method information,
-  // we have to step through the stack twice.
-  for (int i = 0; i < 2; ++i) {
-    hr = stack_walk->Next();
-    if (FAILED(hr)) {
-      cerr << "Failed to get stack frame's information.";
-      return hr;
-    }
+HRESULT StackFrameCollection::WalkFrameNames(
+    ICorDebugThread *debug_thread, const PdbFileIndex &pdb_index,
+    std::uint32_t max_frames, vector<string> *frame_names) {
+  if (!debug_thread || !frame_names) {
+    return E_INVALIDARG;
   }
 
-  CComPtr<ICorDebugFrame> real_method_frame;
-  hr = stack_walk->GetFrame(&real_method_frame);
-  if (hr == S_FALSE) {
-    cerr << "Failed to get the stack after async method.";
-    return E_FAIL;
+  CComPtr<ICorDebugThread3> debug_thread3;
+  HRESULT hr = debug_thread->QueryInterface(
+      __uuidof(ICorDebugThread3), reinterpret_cast<void **>(&debug_thread3));
+  if (FAILED(hr)) {
+    cerr << "Failed to cast ICorDebugThread to ICorDebugThread3.";
+    return hr;
   }
 
-  std::shared_ptr<DbgStackFrame> real_method_stack_frame(
-      new DbgStackFrame(debug_helper_, obj_factory_));
-  hr = PopulateDbgStackFrameHelper(parsed_pdb_files, real_method_frame,
-                                   real_method_stack_frame.get(), false);
+  CComPtr<ICorDebugStackWalk> debug_stack_walk;
+  hr = debug_thread3->CreateStackWalk(&debug_stack_walk);
   if (FAILED(hr)) {
-    cerr << "Failed to get stack frame's information.";
+    cerr << "Failed to create stack walk.";
     return hr;
   }
 
-  async_frame->SetClass(real_method_stack_frame->GetClass());
-  async_frame->SetModuleName(real_method_stack_frame->GetModule());
-  async_frame->SetMethod(real_method_stack_frame->GetMethod());
-  async_frame->SetClassToken(real_method_stack_frame->GetClassToken());
+  std::uint32_t frames_so_far = 0;
+  while (frames_so_far < max_frames) {
+    CComPtr<ICorDebugFrame> frame;
+    hr = debug_stack_walk->GetFrame(&frame);
+    // No more stacks.
+    if (hr == S_FALSE) {
+      return S_OK;
+    }
+
+    if (FAILED(hr)) {
+      cerr << "Failed to get active frame.";
+      return hr;
+    }
+
+    std::shared_ptr<DbgStackFrame> stack_frame = CreateStackFrame();
+    hr = PopulateDbgStackFrameHelper(pdb_index, frame, stack_frame.get(),
+                                     false);
+    if (FAILED(hr)) {
+      return hr;
+    }
+
+    if (stack_frame->IsEmpty()) {
+      frame_names->push_back("[native]");
+    } else {
+      frame_names->push_back(stack_frame->GetShortModuleName() + "!" +
+                             stack_frame->GetClass() + "." +
+                             stack_frame->GetMethod());
+    }
+    ++frames_so_far;
+
+    hr = debug_stack_walk->Next();
+    if (FAILED(hr)) {
+      cerr << "Failed to get stack frame's information.";
+      return hr;
+    }
+  }
+
   return S_OK;
 }
 
 HRESULT StackFrameCollection::PopulateLocalVarsAndMethodArgs(
     mdMethodDef target_function_token, DbgStackFrame *dbg_stack_frame,
     ICorDebugILFrame *il_frame, IMetaDataImport *metadata_import,
-    google_cloud_debugger_portable_pdb::IPortablePdbFile *pdb_file) {
+    google_cloud_debugger_portable_pdb::IPortablePdbFile *pdb_file,
+    bool populate_variables) {
   if (!dbg_stack_frame || !il_frame || !pdb_file) {
     return E_INVALIDARG;
   }
@@ -271,6 +323,10 @@ HRESULT StackFrameCollection::PopulateLocalVarsAndMethodArgs(
             method.sequence_points[matching_sequence_point_position];
 
         dbg_stack_frame->SetLineNumber(sequence_point.start_line);
+        if (!populate_variables) {
+          return S_OK;
+        }
+
         vector<LocalVariableInfo> local_variables;
         vector<LocalConstantInfo> local_constants;
         for (auto &&local_scope : method.local_scope) {
@@ -300,10 +356,37 @@ HRESULT StackFrameCollection::PopulateLocalVarsAndMethodArgs(
   return S_OK;
 }
 
+// Retrieves the name of the class with token class_token.
+static HRESULT GetTypeDefName(IMetaDataImport *metadata_import,
+                              mdTypeDef class_token, string *class_name) {
+  mdToken extends_token;
+  DWORD class_flags;
+  ULONG class_name_length;
+  HRESULT hr = metadata_import->GetTypeDefProps(
+      class_token, nullptr, 0, &class_name_length, &class_flags,
+      &extends_token);
+  if (FAILED(hr)) {
+    cerr << "Failed to get length of name of class type for stack frame.";
+    return hr;
+  }
+
+  std::vector<WCHAR> wchar_class_name(class_name_length, 0);
+  hr = metadata_import->GetTypeDefProps(
+      class_token, wchar_class_name.data(), wchar_class_name.size(),
+      &class_name_length, &class_flags, &extends_token);
+  if (FAILED(hr)) {
+    cerr << "Failed to get name of class type for stack frame.";
+    return hr;
+  }
+
+  *class_name = ConvertWCharPtrToString(wchar_class_name);
+  return S_OK;
+}
+
 HRESULT StackFrameCollection::PopulateModuleClassAndFunctionName(
-    DbgStackFrame *dbg_stack_frame, mdMethodDef function_token,
+    StackFrameMethod *frame_method, mdMethodDef function_token,
     IMetaDataImport *metadata_import) {
-  if (!dbg_stack_frame || !metadata_import) {
+  if (!frame_method || !metadata_import) {
     return E_INVALIDARG;
   }
 
@@ -340,50 +423,122 @@ HRESULT StackFrameCollection::PopulateModuleClassAndFunctionName(
     return hr;
   }
 
-  // Retrieves the class name.
-  // TODO(quoct): Cache the class name in MethodInfo method.
-  mdToken extends_token;
-  DWORD class_flags;
-  ULONG class_name_length;
-  hr = metadata_import->GetTypeDefProps(
-      type_def, nullptr, 0, &class_name_length, &class_flags, &extends_token);
+  hr = GetTypeDefName(metadata_import, type_def, &frame_method->class_name);
+  if (FAILED(hr)) {
+    return hr;
+  }
+
+  frame_method->method_name = ConvertWCharPtrToString(method_name);
+  frame_method->class_token = type_def;
+  frame_method->virtual_address = target_method_virtual_addr;
+
+  return S_OK;
+}
+
+HRESULT StackFrameCollection::PopulateKickoffMethod(
+    StackFrameMethod *frame_method, IMetaDataImport *metadata_import) {
+  static const string kStateMachineMethod = "MoveNext";
+  static const string kStateMachineSuffix = ">d__";
+
+  if (frame_method->method_name != kStateMachineMethod) {
+    return S_FALSE;
+  }
+
+  const string &class_name = frame_method->class_name;
+  size_t suffix_position = class_name.rfind(kStateMachineSuffix);
+  if (class_name.empty() || class_name[0] != '<' ||
+      suffix_position == string::npos || suffix_position < 2) {
+    return S_FALSE;
+  }
+
+  mdTypeDef kickoff_class_token = 0;
+  HRESULT hr = metadata_import->GetNestedClassProps(frame_method->class_token,
+                                                    &kickoff_class_token);
+  if (FAILED(hr)) {
+    return S_FALSE;
+  }
+
+  // Makes sure the kickoff method is in the enclosing class.
+  string kickoff_method_name = class_name.substr(1, suffix_position - 1);
+  vector<WCHAR> wchar_kickoff_method_name =
+      ConvertStringToWCharPtr(kickoff_method_name);
+  HCORENUM cor_enum = nullptr;
+  mdMethodDef kickoff_method_token = 0;
+  ULONG method_count = 0;
+  hr = metadata_import->EnumMethodsWithName(
+      &cor_enum, kickoff_class_token, wchar_kickoff_method_name.data(),
+      &kickoff_method_token, 1, &method_count);
+  metadata_import->CloseEnum(cor_enum);
+  if (FAILED(hr) || method_count == 0) {
+    return S_FALSE;
+  }
+
+  hr = GetTypeDefName(metadata_import, kickoff_class_token,
+                      &frame_method->kickoff_class_name);
   if (FAILED(hr)) {
-    cerr << "Failed to get length of name of class type for stack frame.";
     return hr;
   }
 
-  std::vector<WCHAR> class_name(class_name_length, 0);
-  hr = metadata_import->GetTypeDefProps(type_def, class_name.data(),
-                                        class_name.size(), &class_name_length,
-                                        &class_flags, &extends_token);
+  frame_method->is_state_machine = true;
+  frame_method->kickoff_method_name = std::move(kickoff_method_name);
+  frame_method->kickoff_class_token = kickoff_class_token;
+  return S_OK;
+}
+
+HRESULT StackFrameCollection::ResolveFrameMethod(
+    ICorDebugModule *frame_module, CORDB_ADDRESS module_base_address,
+    mdMethodDef function_token, IMetaDataImport **metadata_import,
+    std::shared_ptr<const StackFrameMethod> *frame_method) {
+  std::shared_ptr<StackFrameMethod> method(new (std::nothrow)
+                                               StackFrameMethod);
+  if (!method) {
+    return E_OUTOFMEMORY;
+  }
+
+  vector<WCHAR> module_name;
+  HRESULT hr = debug_helper_->GetModuleNameFromICorDebugModule(
+      frame_module, &module_name, &cerr);
   if (FAILED(hr)) {
-    cerr << "Failed to get name of class type for stack frame.";
     return hr;
   }
+  method->module_name = ConvertWCharPtrToString(module_name);
 
-  // Even if we cannot get variables, we should still report
-  // method and class name of this frame.
-  dbg_stack_frame->SetMethod(method_name);
-  dbg_stack_frame->SetClass(class_name);
-  dbg_stack_frame->SetClassToken(type_def);
-  dbg_stack_frame->SetFuncVirtualAddr(target_method_virtual_addr);
+  hr = debug_helper_->GetMetadataImportFromICorDebugModule(
+      frame_module, metadata_import, &cerr);
+  if (FAILED(hr)) {
+    return hr;
+  }
+
+  hr = PopulateModuleClassAndFunctionName(method.get(), function_token,
+                                          *metadata_import);
+  if (FAILED(hr)) {
+    return hr;
+  }
 
+  // The frame is still reported as the state machine if its kickoff
+  // method cannot be found.
+  hr = PopulateKickoffMethod(method.get(), *metadata_import);
+  if (FAILED(hr)) {
+    cerr << "Failed to get the kickoff method of a state machine.";
+  }
+
+  method_cache_->AddMethod(module_base_address, function_token, method);
+  *frame_method = std::move(method);
   return S_OK;
 }
 
 HRESULT StackFrameCollection::WalkStackAndProcessStackFrame(
     IEvalCoordinator *eval_coordinator,
-    const std::vector<
-        std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>>
-        &parsed_pdb_files) {
+    const PdbFileIndex &pdb_index) {
   if (stack_walked_) {
     return S_OK;
   }
 
+  ScopedPhaseTimer timer(MetricPhase::kStackWalk);
   CComPtr<ICorDebugStackWalk> debug_stack_walk;
   CComPtr<ICorDebugFrame> frame;
-  int il_frame_parsed_so_far = 0;
-  int frame_parsed_so_far = 0;
+  std::uint32_t il_frame_parsed_so_far = 0;
+  std::uint32_t frame_parsed_so_far = 0;
   HRESULT hr = eval_coordinator->CreateStackWalk(&debug_stack_walk);
   if (FAILED(hr)) {
     cerr << "Failed to create stack walk.";
@@ -393,21 +548,20 @@ HRESULT StackFrameCollection::WalkStackAndProcessStackFrame(
   // Skips the first stack if it is already processed.
   if (first_stack_) {
     stack_frames_.push_back(first_stack_);
+    stack_fingerprint_ = StackFingerprint::Combine(
+        stack_fingerprint_, first_stack_->GetFingerprint());
     ++frame_parsed_so_far;
     if (first_stack_->IsProcessedIlFrame()) {
       ++il_frame_parsed_so_far;
     }
 
-    int stack_to_skip = first_stack_->IsAsyncMethod() ? 3 : 1;
-    for (int i = 0; i < stack_to_skip; ++i) {
-      hr = debug_stack_walk->Next();
-    }
+    hr = debug_stack_walk->Next();
   }
 
   // Walks through the stack and populates stack_frames_ vector.
   while (SUCCEEDED(hr)) {
     // Don't parse too many stack frames.
-    if (frame_parsed_so_far >= kMaximumStackFrames) {
+    if (frame_parsed_so_far >= walk_profile_.max_stack_frames) {
       stack_walked_ = true;
       return S_OK;
     }
@@ -425,35 +579,29 @@ HRESULT StackFrameCollection::WalkStackAndProcessStackFrame(
     }
 
     // Do not process too many IL frames to minimize breakpoint size.
+    // If all the breakpoints are stack-only, no frame is processed but
+    // their locations are still resolved.
     bool process_il_frame =
-        il_frame_parsed_so_far < kMaximumStackFramesWithVariables;
+        !walk_profile_.stack_only &&
+        il_frame_parsed_so_far < walk_profile_.max_stack_frames_with_variables;
 
-    std::shared_ptr<DbgStackFrame> stack_frame(
-        new DbgStackFrame(debug_helper_, obj_factory_));
-    hr = PopulateDbgStackFrameHelper(parsed_pdb_files, frame, stack_frame.get(),
-                                     process_il_frame);
+    std::shared_ptr<DbgStackFrame> stack_frame = CreateStackFrame();
+    hr = PopulateDbgStackFrameHelper(pdb_index, frame, stack_frame.get(),
+                                     process_il_frame,
+                                     walk_profile_.stack_only);
     if (FAILED(hr)) {
       cerr << "Failed to process stack frame.";
       return hr;
     }
+    CreatePendingVariablesBeforeEval(eval_coordinator, stack_frame);
 
     ++frame_parsed_so_far;
     if (stack_frame->IsProcessedIlFrame()) {
       ++il_frame_parsed_so_far;
     }
 
-    // If this is an async frame, the method name would be something like
-    // <RealMethodName>d__18.MoveNext. PopulateAsyncStackFrameInfo
-    // will populate stack_frame with the correct method name and class token.
-    if (stack_frame->IsAsyncMethod()) {
-      hr = PopulateAsyncStackFrameInfo(stack_frame.get(), debug_stack_walk,
-                                       parsed_pdb_files);
-      if (FAILED(hr)) {
-        cerr << "Failed to get async stack frame's information.";
-        return hr;
-      }
-    }
-
+    stack_fingerprint_ = StackFingerprint::Combine(
+        stack_fingerprint_, stack_frame->GetFingerprint());
     stack_frames_.push_back(std::move(stack_frame));
     hr = debug_stack_walk->Next();
   }
@@ -468,10 +616,8 @@ HRESULT StackFrameCollection::WalkStackAndProcessStackFrame(
 
 HRESULT StackFrameCollection::EvaluateBreakpointCondition(
     DbgBreakpoint *breakpoint, IEvalCoordinator *eval_coordinator,
-    const std::vector<
-        std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>>
-        &parsed_pdb_files) {
-  HRESULT hr = ProcessFirstStack(eval_coordinator, parsed_pdb_files);
+    const PdbFileIndex &pdb_index) {
+  HRESULT hr = ProcessFirstStack(eval_coordinator, pdb_index);
   if (FAILED(hr)) {
     std::cerr << "Failed to process the first stack.";
     return hr;
@@ -489,10 +635,8 @@ HRESULT StackFrameCollection::EvaluateBreakpointCondition(
 
 HRESULT StackFrameCollection::ProcessExpressions(
     DbgBreakpoint *breakpoint, IEvalCoordinator *eval_coordinator,
-    const std::vector<
-        std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>>
-        &parsed_pdb_files) {
-  HRESULT hr = ProcessFirstStack(eval_coordinator, parsed_pdb_files);
+    const PdbFileIndex &pdb_index) {
+  HRESULT hr = ProcessFirstStack(eval_coordinator, pdb_index);
   if (FAILED(hr)) {
     std::cerr << "Failed to process the first stack.";
     return hr;
@@ -510,9 +654,7 @@ HRESULT StackFrameCollection::ProcessExpressions(
 
 HRESULT StackFrameCollection::ProcessFirstStack(
     IEvalCoordinator *eval_coordinator,
-    const std::vector<
-        std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>>
-        &parsed_pdb_files) {
+    const PdbFileIndex &pdb_index) {
   if (first_stack_) {
     return S_OK;
   }
@@ -531,46 +673,47 @@ HRESULT StackFrameCollection::ProcessFirstStack(
     return hr;
   }
 
-  first_stack_ = std::shared_ptr<DbgStackFrame>(
-      new DbgStackFrame(debug_helper_, obj_factory_));
-  hr = PopulateDbgStackFrameHelper(parsed_pdb_files, debug_frame,
+  first_stack_ = CreateStackFrame();
+  hr = PopulateDbgStackFrameHelper(pdb_index, debug_frame,
                                    first_stack_.get(), true);
   if (FAILED(hr)) {
     std::cerr << "Failed to process stack frame.";
     first_stack_.reset();
     return hr;
   }
+  CreatePendingVariablesBeforeEval(eval_coordinator, first_stack_);
 
-  // If this is an async frame, the method name would be something like
-  // <RealMethodName>d__18.MoveNext. PopulateAsyncStackFrameInfo
-  // will populate stack_frame with the correct method name and class token.
-  if (first_stack_->IsAsyncMethod()) {
-    CComPtr<ICorDebugStackWalk> debug_stack_walk;
-    HRESULT hr = eval_coordinator->CreateStackWalk(&debug_stack_walk);
-    if (FAILED(hr)) {
-      cerr << "Failed to create stack walk.";
-      first_stack_.reset();
-      return hr;
-    }
+  return S_OK;
+}
 
-    hr = PopulateAsyncStackFrameInfo(first_stack_.get(), debug_stack_walk,
-                                     parsed_pdb_files);
-    if (FAILED(hr)) {
-      cerr << "Failed to get async stack frame's information.";
-      first_stack_.reset();
-      return hr;
-    }
+std::shared_ptr<DbgStackFrame> StackFrameCollection::CreateStackFrame() {
+  std::shared_ptr<DbgStackFrame> stack_frame(
+      new DbgStackFrame(debug_helper_, obj_factory_, type_cache_));
+  stack_frame->SetObjectDepth(walk_profile_.max_object_depth);
+  return stack_frame;
+}
+
+void StackFrameCollection::CreatePendingVariablesBeforeEval(
+    IEvalCoordinator *eval_coordinator,
+    std::shared_ptr<DbgStackFrame> stack_frame) {
+  if (!eval_coordinator || !stack_frame->IsProcessedIlFrame()) {
+    return;
   }
 
-  return S_OK;
+  // The collection may be gone by the time the evaluation runs.
+  std::weak_ptr<DbgStackFrame> weak_stack_frame = stack_frame;
+  eval_coordinator->AddBeforeEvalCallback([weak_stack_frame]() {
+    std::shared_ptr<DbgStackFrame> stack_frame = weak_stack_frame.lock();
+    if (stack_frame) {
+      stack_frame->CreatePendingVariables();
+    }
+  });
 }
 
 HRESULT StackFrameCollection::PopulateDbgStackFrameHelper(
-    const std::vector<
-        std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>>
-        &parsed_pdb_files,
+    const PdbFileIndex &pdb_index,
     ICorDebugFrame *debug_frame, DbgStackFrame *stack_frame,
-    bool process_il_frame) {
+    bool process_il_frame, bool resolve_location) {
   // Gets ICorDebugFunction that corresponds to the function at this frame.
   // We delay the logic to query the IL frame until we have to get the
   // variables and method arguments.
@@ -605,71 +748,108 @@ HRESULT StackFrameCollection::PopulateDbgStackFrameHelper(
     return hr;
   }
 
-  vector<WCHAR> module_name;
-  hr = debug_helper_->GetModuleNameFromICorDebugModule(frame_module,
-                                                       &module_name, &cerr);
+  CORDB_ADDRESS module_base_address = 0;
+  hr = frame_module->GetBaseAddress(&module_base_address);
   if (FAILED(hr)) {
+    cerr << "Failed to get base address of ICorDebugModule.";
     return hr;
   }
 
-  stack_frame->SetModuleName(module_name);
-  string target_module_name = stack_frame->GetModule();
+  // The IL offset tells apart the calls made from different places in
+  // the same method. Non-IL frames only use the module and the method.
+  CComPtr<ICorDebugILFrame> il_frame;
+  HRESULT il_frame_hr = debug_frame->QueryInterface(
+      __uuidof(ICorDebugILFrame), reinterpret_cast<void **>(&il_frame));
+  ULONG32 ip_offset = 0;
+  if (SUCCEEDED(il_frame_hr) && il_frame) {
+    CorDebugMappingResult mapping_result;
+    if (FAILED(il_frame->GetIP(&ip_offset, &mapping_result))) {
+      ip_offset = 0;
+    }
+  }
+  stack_frame->SetFingerprint(StackFingerprint::HashFrame(
+      module_base_address, target_function_token, ip_offset));
 
+  // The metadata import is only retrieved here if the method is not
+  // cached yet.
   CComPtr<IMetaDataImport> metadata_import;
-  hr = debug_helper_->GetMetadataImportFromICorDebugModule(
-      frame_module, &metadata_import, &cerr);
-  if (FAILED(hr)) {
-    return hr;
+  std::shared_ptr<const StackFrameMethod> frame_method =
+      method_cache_->GetMethod(module_base_address, target_function_token);
+  if (!frame_method) {
+    hr = ResolveFrameMethod(frame_module, module_base_address,
+                            target_function_token, &metadata_import,
+                            &frame_method);
+    if (FAILED(hr)) {
+      return hr;
+    }
   }
 
   // Populates the module, class and function name of this stack frame
   // so we can report this even if we don't have local variables or
-  // method arguments.
-  hr = PopulateModuleClassAndFunctionName(stack_frame, target_function_token,
-                                          metadata_import);
-  if (FAILED(hr)) {
-    return hr;
-  }
-
-  if (!process_il_frame) {
+  // method arguments. Frames of a state machine
+  // (<RealMethodName>d__18.MoveNext) are reported as the async or iterator
+  // method it was generated for.
+  stack_frame->SetModuleName(frame_method->module_name);
+  if (frame_method->is_state_machine) {
+    stack_frame->SetMethod(frame_method->kickoff_method_name);
+    stack_frame->SetClass(frame_method->kickoff_class_name);
+  } else {
+    stack_frame->SetMethod(frame_method->method_name);
+    stack_frame->SetClass(frame_method->class_name);
+  }
+  stack_frame->SetClassToken(frame_method->class_token);
+  stack_frame->SetFuncVirtualAddr(frame_method->virtual_address);
+
+  if (!process_il_frame && !resolve_location) {
     return S_OK;
   }
 
-  CComPtr<ICorDebugILFrame> il_frame;
-  hr = debug_frame->QueryInterface(__uuidof(ICorDebugILFrame),
-                                   reinterpret_cast<void **>(&il_frame));
   // If this is a non-IL frame, we cannot get local variables
   // and method arguments so simply skip that step.
-  if (hr == E_NOINTERFACE) {
+  if (il_frame_hr == E_NOINTERFACE) {
     return S_OK;
   }
 
-  if (FAILED(hr)) {
+  if (FAILED(il_frame_hr)) {
     cerr << "Failed to get ILFrame";
-    return hr;
+    return il_frame_hr;
   }
 
-  for (auto &&pdb_file : parsed_pdb_files) {
-    // TODO(quoct): Possible performance improvement by caching the pdb_file
-    // based on token.
-    string pdb_module_name = pdb_file->GetModuleName();
-    if (pdb_module_name.compare(target_module_name) != 0) {
-      continue;
-    }
+  std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>
+      pdb_file = pdb_index.GetPdbFile(module_base_address);
+  if (!pdb_file) {
+    return S_FALSE;
+  }
 
-    // Tries to populate local variables and method arguments of this frame.
-    hr = PopulateLocalVarsAndMethodArgs(target_function_token, stack_frame,
-                                        il_frame, metadata_import,
-                                        pdb_file.get());
-    if (FAILED(hr)) {
-      cerr << "Failed to populate stack frame information.";
-      return hr;
+  if (!metadata_import) {
+    hr = pdb_file->GetMetaDataImport(&metadata_import);
+    if (FAILED(hr) || !metadata_import) {
+      metadata_import.Release();
+      hr = debug_helper_->GetMetadataImportFromICorDebugModule(
+          frame_module, &metadata_import, &cerr);
+      if (FAILED(hr)) {
+        return hr;
+      }
     }
+  }
 
-    return S_OK;
+  // Tries to populate local variables and method arguments of this frame.
+  hr = PopulateLocalVarsAndMethodArgs(target_function_token, stack_frame,
+                                      il_frame, metadata_import,
+                                      pdb_file.get(),
+                                      process_il_frame);
+  if (FAILED(hr)) {
+    cerr << "Failed to populate stack frame information.";
+    return hr;
   }
 
-  return S_FALSE;
+  // The state machine captures this of the kickoff method, so members
+  // are looked up in the class of the kickoff method.
+  if (stack_frame->IsAsyncMethod() && frame_method->is_state_machine) {
+    stack_frame->SetClassToken(frame_method->kickoff_class_token);
+  }
+
+  return S_OK;
 }
 
 }  //  namespace google_cloud_debugger
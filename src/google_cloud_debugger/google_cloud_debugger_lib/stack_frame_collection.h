@@ -15,17 +15,32 @@
 #ifndef STACK_FRAME_COLLECTION_H_
 #define STACK_FRAME_COLLECTION_H_
 
+#include <string>
 #include <vector>
 
+#include "capture_profile.h"
 #include "dbg_stack_frame.h"
 #include "i_stack_frame_collection.h"
+#include "module_type_cache.h"
+#include "stack_fingerprint.h"
+#include "stack_frame_method_cache.h"
 
 namespace google_cloud_debugger {
 
 class StackFrameCollection : public IStackFrameCollection {
  public:
-  StackFrameCollection(std::shared_ptr<ICorDebugHelper> debug_helper,
-                       std::shared_ptr<IDbgObjectFactory> obj_factory);
+  // method_cache is used to cache the names of the methods on the stack
+  // and type_cache the types used by expressions across breakpoint hits.
+  // If either is null, the collection creates its own.
+  // The stack is walked once for all the breakpoints processed by this
+  // collection, so walk_profile has to cover the capture profiles of
+  // all of them.
+  StackFrameCollection(
+      std::shared_ptr<ICorDebugHelper> debug_helper,
+      std::shared_ptr<IDbgObjectFactory> obj_factory,
+      std::shared_ptr<StackFrameMethodCache> method_cache = nullptr,
+      std::shared_ptr<ModuleTypeCache> type_cache = nullptr,
+      const CaptureProfile &walk_profile = CaptureProfile::GetDefault());
 
   // This function first checks whether breakpoint has a condition.
   // If the condition evaluated to false, do nothing.
@@ -34,9 +49,7 @@ class StackFrameCollection : public IStackFrameCollection {
   // Afterwards, WalkStackAndProcessStackFrame will be called to
   // populate stack_frames_ vector.
   HRESULT ProcessBreakpoint(
-      const std::vector<
-          std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>>
-          &pdb_files,
+      const PdbFileIndex &pdb_index,
       DbgBreakpoint *breakpoint, IEvalCoordinator *eval_coordinator) override;
 
   // Populates the stack frames of a breakpoint using stack_frames.
@@ -44,8 +57,23 @@ class StackFrameCollection : public IStackFrameCollection {
   // evaluation if needed.
   HRESULT PopulateStackFrames(
       google::cloud::diagnostics::debug::Breakpoint *breakpoint,
+      const CaptureProfile &capture_profile,
       IEvalCoordinator *eval_coordinator) override;
 
+  // Returns the fingerprint of the walked stack frames.
+  std::uint64_t GetStackFingerprint() const override {
+    return stack_fingerprint_;
+  }
+
+  // Walks the stack of debug_thread and appends the names of at most
+  // max_frames of its frames, from the innermost one, to frame_names.
+  // Only the names of the methods are resolved (through the method cache)
+  // and the frames are not stored in this collection.
+  HRESULT WalkFrameNames(ICorDebugThread *debug_thread,
+                         const PdbFileIndex &pdb_index,
+                         std::uint32_t max_frames,
+                         std::vector<std::string> *frame_names);
+
  private:
   // Class that contains helper method for ICorDebug objects.
   std::shared_ptr<ICorDebugHelper> debug_helper_;
@@ -53,81 +81,100 @@ class StackFrameCollection : public IStackFrameCollection {
   // Factory for creating DbgObject.
   std::shared_ptr<IDbgObjectFactory> obj_factory_;
 
-  // Populates the stack frame information for an async frame.
-  // We need to do this because the async frame does not have information
-  // like method name, class name and class token as it is a
-  // compile generated method. So we have to walk the frame twice
-  // and get to a frame that has this information.
-  HRESULT PopulateAsyncStackFrameInfo(
-      DbgStackFrame *async_frame, ICorDebugStackWalk *stack_walk,
-      const std::vector<
-          std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>>
-          &parsed_pdb_files);
+  // Cache of the methods of the stack frames.
+  std::shared_ptr<StackFrameMethodCache> method_cache_;
+
+  // Cache of the types of the loaded modules, shared by the stack frames.
+  std::shared_ptr<ModuleTypeCache> type_cache_;
+
+  // Limits of the stack walk.
+  CaptureProfile walk_profile_;
+
+  // Creates a stack frame whose objects are inspected as deep as
+  // walk_profile_ allows.
+  std::shared_ptr<DbgStackFrame> CreateStackFrame();
+
+  // If frame_method is the MoveNext method of a compiler generated state
+  // machine (<KickoffMethod>d__N), populates the names and class token of
+  // the kickoff method in frame_method. The state machine is nested in
+  // the class of the kickoff method, so this only needs the metadata and
+  // not the frames below on the stack. Returns S_FALSE if frame_method
+  // is not a state machine.
+  HRESULT PopulateKickoffMethod(StackFrameMethod *frame_method,
+                                IMetaDataImport *metadata_import);
 
   // Given a PDB file, this function tries to find the metadata of the function
   // with token target_function_token in the PDB file. If found, this function
   // will populate dbg_stack_frame using the metadata found and the
-  // ICorDebugILFrame il_frame object.
+  // ICorDebugILFrame il_frame object. If populate_variables is false,
+  // only the file and line number of dbg_stack_frame are populated.
   HRESULT PopulateLocalVarsAndMethodArgs(
       mdMethodDef target_function_token, DbgStackFrame *dbg_stack_frame,
       ICorDebugILFrame *il_frame, IMetaDataImport *metadata_import,
-      google_cloud_debugger_portable_pdb::IPortablePdbFile *pdb_files);
+      google_cloud_debugger_portable_pdb::IPortablePdbFile *pdb_files,
+      bool populate_variables = true);
 
-  // Populates the module, class and function name of a stack frame
-  // using function_token (represents function the frame is in)
-  // and IMetaDataImport (from the module the frame is in).
-  HRESULT PopulateModuleClassAndFunctionName(DbgStackFrame *dbg_stack_frame,
+  // Populates the class and function name, class token and virtual address
+  // of frame_method using function_token (represents function the frame
+  // is in) and IMetaDataImport (from the module the frame is in).
+  HRESULT PopulateModuleClassAndFunctionName(StackFrameMethod *frame_method,
                                              mdMethodDef function_token,
                                              IMetaDataImport *metadata_import);
 
+  // Resolves the module name, class and function name of the function
+  // with token function_token in frame_module and caches the result in
+  // method_cache_. metadata_import is set to the IMetaDataImport of
+  // frame_module.
+  HRESULT ResolveFrameMethod(
+      ICorDebugModule *frame_module, CORDB_ADDRESS module_base_address,
+      mdMethodDef function_token, IMetaDataImport **metadata_import,
+      std::shared_ptr<const StackFrameMethod> *frame_method);
+
   // Helper function to walk the stack, process each frame and store them
   // into stack_frames_. If the stack is already walked, this function will
   // do nothing.
   // IEvalCoordinator eval_coordinator is used to create the stack walk.
-  // Parsed_pdb_files vector is needed for mapping each stack frame to a file
-  // location.
+  // pdb_index is needed for mapping each stack frame to a file location.
   HRESULT WalkStackAndProcessStackFrame(
       IEvalCoordinator *eval_coordinator,
-      const std::vector<
-          std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>>
-          &parsed_pdb_files);
+      const PdbFileIndex &pdb_index);
 
   // Helper function to evaluate the condition stored in DbgBreakpoint
   // breakpoint. IEvalCoordinator is needed to get the active debug thread and
-  // frame. Parsed_pdb_files vector is needed to retrieve local variables names.
+  // frame. pdb_index is needed to retrieve local variables names.
   HRESULT EvaluateBreakpointCondition(
       DbgBreakpoint *breakpoint, IEvalCoordinator *eval_coordinator,
-      const std::vector<
-          std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>>
-          &parsed_pdb_files);
+      const PdbFileIndex &pdb_index);
 
   // Given a breakpoint, evaluates the expressions in the breakpoint using
   // the first stack of this stack frame collection.
   HRESULT ProcessExpressions(
       DbgBreakpoint *breakpoint, IEvalCoordinator *eval_coordinator,
-      const std::vector<
-          std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>>
-          &parsed_pdb_files);
+      const PdbFileIndex &pdb_index);
 
   // Processes information in the first stack of this stack frame collection
   // and caches the result in first_stack_.
   HRESULT ProcessFirstStack(
       IEvalCoordinator *eval_coordinator,
-      const std::vector<
-          std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>>
-          &parsed_pdb_files);
+      const PdbFileIndex &pdb_index);
 
   // Helper function to process information in ICorDebugFrame debug_frame
   // and initialize DbgStackFrame stack_frame with that information.
   // If process_il_frame is set to true, this function will try to convert
   // debug_frame to an ICorDebugILFrame and retrieve local variables and
-  // method arguments from the frame.
+  // method arguments from the frame. Otherwise, if resolve_location is
+  // set to true, only the file and line number of the frame are retrieved.
   HRESULT PopulateDbgStackFrameHelper(
-      const std::vector<
-          std::shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>>
-          &parsed_pdb_files,
+      const PdbFileIndex &pdb_index,
       ICorDebugFrame *debug_frame, DbgStackFrame *stack_frame,
-      bool process_il_frame);
+      bool process_il_frame, bool resolve_location = false);
+
+  // Makes eval_coordinator create the pending variables of stack_frame
+  // before it runs a function evaluation. Resuming the debuggee for
+  // the evaluation neuters the ICorDebugValue of these variables.
+  void CreatePendingVariablesBeforeEval(
+      IEvalCoordinator *eval_coordinator,
+      std::shared_ptr<DbgStackFrame> stack_frame);
 
   // Vectors of stack frames that this collection owns.
   std::vector<std::shared_ptr<DbgStackFrame>> stack_frames_;
@@ -138,15 +185,12 @@ class StackFrameCollection : public IStackFrameCollection {
   // Number of processed IL frames in stack_frames_.
   int number_of_processed_il_frames_ = 0;
 
+  // Fingerprint of the frames in stack_frames_.
+  std::uint64_t stack_fingerprint_ = StackFingerprint::kEmptyStack;
+
   // True if the stack has been walked and processed.
   // This means stack_frames_ vector should have been populated.
   bool stack_walked_ = false;
-
-  // Maximum number of stack frames to be parsed.
-  static const std::uint32_t kMaximumStackFrames = 20;
-
-  // Maximum number of stack frames with populated variables to be parsed.
-  static const std::uint32_t kMaximumStackFramesWithVariables = 4;
 };
 
 }  //  namespace google_cloud_debugger
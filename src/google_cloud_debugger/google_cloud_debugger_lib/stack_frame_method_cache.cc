@@ -0,0 +1,59 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "stack_frame_method_cache.h"
+
+using std::lock_guard;
+using std::make_pair;
+using std::mutex;
+using std::shared_ptr;
+
+namespace google_cloud_debugger {
+
+shared_ptr<const StackFrameMethod> StackFrameMethodCache::GetMethod(
+    CORDB_ADDRESS module_base_address, mdMethodDef method_token) {
+  lock_guard<mutex> lk(mutex_);
+  auto it = methods_.find(make_pair(module_base_address, method_token));
+  if (it == methods_.end()) {
+    return nullptr;
+  }
+
+  return it->second;
+}
+
+void StackFrameMethodCache::AddMethod(
+    CORDB_ADDRESS module_base_address, mdMethodDef method_token,
+    shared_ptr<const StackFrameMethod> method) {
+  lock_guard<mutex> lk(mutex_);
+  if (methods_.size() >= kMaximumCachedMethods) {
+    return;
+  }
+
+  methods_[make_pair(module_base_address, method_token)] = std::move(method);
+}
+
+void StackFrameMethodCache::RemoveModule(CORDB_ADDRESS module_base_address) {
+  lock_guard<mutex> lk(mutex_);
+  // Keys are ordered by module base address first so the methods of
+  // a module are next to each other.
+  auto first = methods_.lower_bound(make_pair(module_base_address,
+                                              static_cast<mdMethodDef>(0)));
+  auto last = first;
+  while (last != methods_.end() && last->first.first == module_base_address) {
+    ++last;
+  }
+  methods_.erase(first, last);
+}
+
+}  //  namespace google_cloud_debugger
@@ -0,0 +1,103 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef STACK_FRAME_METHOD_CACHE_H_
+#define STACK_FRAME_METHOD_CACHE_H_
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+
+#include "cor.h"
+#include "cordebug.h"
+
+namespace google_cloud_debugger {
+
+// Information about the method a stack frame is in. This only depends
+// on the module and the method token, not on the frame itself.
+// The PDB file of the module is not part of it: it is looked up in the
+// PdbFileIndex of every walk, since the module may only be registered
+// after the method is cached.
+struct StackFrameMethod {
+  // Name of the module the method is in.
+  std::string module_name;
+
+  // Name of the class the method is in.
+  std::string class_name;
+
+  // Name of the method.
+  std::string method_name;
+
+  // Token of the class the method is in.
+  mdTypeDef class_token = 0;
+
+  // Relative virtual address of the method.
+  ULONG32 virtual_address = 0;
+
+  // True if the method is the MoveNext method of the state machine
+  // generated by the compiler for an async or iterator method, which is
+  // called the kickoff method.
+  bool is_state_machine = false;
+
+  // Name of the class the kickoff method is in.
+  std::string kickoff_class_name;
+
+  // Name of the kickoff method.
+  std::string kickoff_method_name;
+
+  // Token of the class the kickoff method is in.
+  mdTypeDef kickoff_class_token = 0;
+};
+
+// Cache of StackFrameMethod keyed by the base address of the module
+// and the method token. The same methods show up in most stack walks,
+// so this saves the metadata calls needed to resolve the names of
+// a frame across frames and breakpoint hits.
+// This class is thread-safe.
+class StackFrameMethodCache {
+ public:
+  // Maximum number of methods cached. Once the cache is full, new methods
+  // are not cached.
+  static const std::size_t kMaximumCachedMethods = 10000;
+
+  // Returns the method with token method_token in the module loaded
+  // at module_base_address. Returns nullptr if it is not cached.
+  std::shared_ptr<const StackFrameMethod> GetMethod(
+      CORDB_ADDRESS module_base_address, mdMethodDef method_token);
+
+  // Caches method as the method with token method_token in the module
+  // loaded at module_base_address.
+  void AddMethod(CORDB_ADDRESS module_base_address, mdMethodDef method_token,
+                 std::shared_ptr<const StackFrameMethod> method);
+
+  // Removes all the methods of the module loaded at module_base_address.
+  // This has to be called when the module is unloaded since another
+  // module may be loaded at the same address.
+  void RemoveModule(CORDB_ADDRESS module_base_address);
+
+ private:
+  // Cached methods by module base address and method token.
+  std::map<std::pair<CORDB_ADDRESS, mdMethodDef>,
+           std::shared_ptr<const StackFrameMethod>>
+      methods_;
+
+  // Guards methods_.
+  std::mutex mutex_;
+};
+
+}  //  namespace google_cloud_debugger
+
+#endif  //  STACK_FRAME_METHOD_CACHE_H_
@@ -28,6 +28,8 @@ namespace google_cloud_debugger {
 // This class is meant to be inherited and used for outputting error and
 // output stream to the underlying ostringstream. It has methods to set the
 // underlying streams as well as collecting the output and error stream.
+// The error stream is only allocated when the first error is written,
+// since most objects never have one.
 // This class is NOT thread-safe.
 class StringStreamWrapper {
  public:
@@ -40,26 +42,74 @@ class StringStreamWrapper {
 
   // Writes the string error to the error_stream_.
   void WriteError(const std::string &error) {
-    *error_stream_ << error << std::endl;
+    std::ostringstream *error_stream = GetErrorStream();
+    if (error_stream) {
+      *error_stream << error << std::endl;
+    }
   }
 
-  // Gets the underlying error stream.
-  std::ostringstream *GetErrorStream() { return error_stream_.get(); }
+  // Gets the underlying error stream, allocating it if needed.
+  // Prefer passing an ErrorStream to functions that only write to
+  // the stream when they fail.
+  std::ostringstream *GetErrorStream() {
+    if (!error_stream_) {
+      error_stream_.reset(new (std::nothrow) std::ostringstream());
+    }
+    return error_stream_.get();
+  }
 
   // Gets string collected in the error stream.
-  std::string GetErrorString() { return error_stream_->str(); }
+  std::string GetErrorString() {
+    return error_stream_ ? error_stream_->str() : std::string();
+  }
+
+  // Returns true if an error stream was allocated.
+  bool HasErrorStream() const { return error_stream_ != nullptr; }
 
   // Resets the error stream.
   void ResetErrorStream() {
-    error_stream_->str("");
-    error_stream_->clear();
+    if (error_stream_) {
+      error_stream_->str("");
+      error_stream_->clear();
+    }
+  }
+
+ private:
+  // The underlying error stream. Null until an error is written.
+  std::unique_ptr<std::ostringstream> error_stream_;
+};
+
+// Stream to pass to a function that only writes to it on failure.
+// It lives on the stack of the caller, so nothing is allocated if
+// nothing is written. Whatever is written is appended to the error
+// stream of owner when this goes out of scope, which is at the end of
+// the full expression for a temporary:
+//   hr = debug_helper_->Dereference(handle, &value, &is_null,
+//                                   ErrorStream(this));
+class ErrorStream {
+ public:
+  explicit ErrorStream(StringStreamWrapper *owner) : owner_(owner) {}
+
+  ~ErrorStream() {
+    if (stream_.tellp() > 0) {
+      std::ostringstream *error_stream = owner_->GetErrorStream();
+      if (error_stream) {
+        *error_stream << stream_.str();
+      }
+    }
   }
 
+  operator std::ostream *() { return &stream_; }
+
  private:
-  // The underlying error stream.
-  std::unique_ptr<std::ostringstream> error_stream_ =
-      std::unique_ptr<std::ostringstream>(new (std::nothrow)
-                                              std::ostringstream());
+  ErrorStream(const ErrorStream &) = delete;
+  ErrorStream &operator=(const ErrorStream &) = delete;
+
+  // Stack stream the errors are written to.
+  std::ostringstream stream_;
+
+  // The object the errors belong to.
+  StringStreamWrapper *owner_;
 };
 
 // Sets the Status field of variable using error string err_string.
@@ -0,0 +1,249 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "type_layout_cache.h"
+
+#include <array>
+
+#include "constants.h"
+#include "string_stream_wrapper.h"
+
+using std::array;
+using std::lock_guard;
+using std::make_pair;
+using std::mutex;
+using std::shared_ptr;
+using std::string;
+using std::vector;
+
+namespace google_cloud_debugger {
+
+HRESULT TypeLayout::GetFields(IMetaDataImport *metadata_import,
+                              const vector<FieldLayout> **fields) const {
+  std::call_once(fields_read_, [this, metadata_import]() {
+    fields_hr_ = TypeLayoutCache::ReadFieldLayouts(metadata_import,
+                                                   class_token, &fields_);
+  });
+  *fields = &fields_;
+  return fields_hr_;
+}
+
+HRESULT TypeLayout::GetProperties(
+    IMetaDataImport *metadata_import,
+    const vector<PropertyLayout> **properties) const {
+  std::call_once(properties_read_, [this, metadata_import]() {
+    properties_hr_ = TypeLayoutCache::ReadPropertyLayouts(
+        metadata_import, class_token, &properties_);
+  });
+  *properties = &properties_;
+  return properties_hr_;
+}
+
+TypeLayoutCache *TypeLayoutCache::GetInstance() {
+  static TypeLayoutCache type_layout_cache;
+  return &type_layout_cache;
+}
+
+shared_ptr<const TypeLayout> TypeLayoutCache::GetLayout(
+    CORDB_ADDRESS module_base_address, mdTypeDef class_token) {
+  lock_guard<mutex> lk(mutex_);
+  auto it = layouts_.find(make_pair(module_base_address, class_token));
+  if (it == layouts_.end()) {
+    return nullptr;
+  }
+
+  return it->second;
+}
+
+void TypeLayoutCache::AddLayout(CORDB_ADDRESS module_base_address,
+                                mdTypeDef class_token,
+                                shared_ptr<const TypeLayout> layout) {
+  lock_guard<mutex> lk(mutex_);
+  if (layouts_.size() >= kMaximumCachedLayouts) {
+    return;
+  }
+
+  layouts_[make_pair(module_base_address, class_token)] = std::move(layout);
+}
+
+void TypeLayoutCache::RemoveModule(CORDB_ADDRESS module_base_address) {
+  lock_guard<mutex> lk(mutex_);
+  // Keys are ordered by module base address first so the classes of
+  // a module are next to each other.
+  auto first = layouts_.lower_bound(
+      make_pair(module_base_address, static_cast<mdTypeDef>(0)));
+  auto last = first;
+  while (last != layouts_.end() && last->first.first == module_base_address) {
+    ++last;
+  }
+  layouts_.erase(first, last);
+}
+
+HRESULT TypeLayoutCache::ReadFieldLayout(IMetaDataImport *metadata_import,
+                                         mdFieldDef field_def,
+                                         FieldLayout *field) {
+  if (!metadata_import || !field) {
+    return E_INVALIDARG;
+  }
+
+  field->field_def = field_def;
+  ULONG len_field_name;
+
+  // First call to get length of array.
+  field->hr = metadata_import->GetFieldProps(
+      field_def, &field->parent_token, nullptr, 0, &len_field_name,
+      &field->attributes, &field->signature, &field->signature_length,
+      &field->default_value_type_flags, &field->default_value,
+      &field->default_value_length);
+  if (FAILED(field->hr)) {
+    return field->hr;
+  }
+
+  vector<WCHAR> wchar_field_name(len_field_name, 0);
+
+  // Second call to get the actual name.
+  field->hr = metadata_import->GetFieldProps(
+      field_def, &field->parent_token, wchar_field_name.data(), len_field_name,
+      &len_field_name, &field->attributes, &field->signature,
+      &field->signature_length, &field->default_value_type_flags,
+      &field->default_value, &field->default_value_length);
+  if (FAILED(field->hr)) {
+    return field->hr;
+  }
+
+  field->name = ConvertWCharPtrToString(wchar_field_name);
+
+  // If field name is <MyProperty>k__BackingField, change it to
+  // MyProperty because it is the backing field of a property.
+  if (field->name.size() > kBackingField.size() + 1 && field->name[0] == '<') {
+    string::size_type position = field->name.find(
+        kBackingField, field->name.size() - kBackingField.size());
+    if (position != string::npos) {
+      field->is_backing_field = true;
+      field->name = field->name.substr(1, position - 1);
+    }
+  }
+
+  return S_OK;
+}
+
+HRESULT TypeLayoutCache::ReadPropertyLayout(IMetaDataImport *metadata_import,
+                                            mdProperty property_def,
+                                            PropertyLayout *property) {
+  if (!metadata_import || !property) {
+    return E_INVALIDARG;
+  }
+
+  property->property_def = property_def;
+  ULONG property_name_length;
+  ULONG other_methods_length;
+
+  // First call to get length of array and length of other methods.
+  property->hr = metadata_import->GetPropertyProps(
+      property_def, &property->parent_token, nullptr, 0, &property_name_length,
+      &property->attributes, &property->signature, &property->signature_length,
+      &property->default_value_type_flags, &property->default_value,
+      &property->default_value_length, &property->setter_function,
+      &property->getter_function, nullptr, 0, &other_methods_length);
+  if (FAILED(property->hr)) {
+    return property->hr;
+  }
+
+  vector<WCHAR> wchar_property_name(property_name_length, 0);
+  property->other_methods.resize(other_methods_length);
+
+  property->hr = metadata_import->GetPropertyProps(
+      property_def, &property->parent_token, wchar_property_name.data(),
+      wchar_property_name.size(), &property_name_length, &property->attributes,
+      &property->signature, &property->signature_length,
+      &property->default_value_type_flags, &property->default_value,
+      &property->default_value_length, &property->setter_function,
+      &property->getter_function, property->other_methods.data(),
+      property->other_methods.size(), &other_methods_length);
+
+  property->name = ConvertWCharPtrToString(wchar_property_name);
+  return property->hr;
+}
+
+HRESULT TypeLayoutCache::ReadFieldLayouts(IMetaDataImport *metadata_import,
+                                          mdTypeDef class_token,
+                                          vector<FieldLayout> *fields) {
+  if (!metadata_import || !fields) {
+    return E_INVALIDARG;
+  }
+
+  HCORENUM cor_enum = nullptr;
+  HRESULT hr = S_OK;
+  while (true) {
+    array<mdFieldDef, 100> field_defs;
+    ULONG field_defs_returned = 0;
+
+    hr = metadata_import->EnumFields(&cor_enum, class_token, field_defs.data(),
+                                     field_defs.size(), &field_defs_returned);
+    if (FAILED(hr) || field_defs_returned == 0) {
+      break;
+    }
+
+    fields->reserve(fields->size() + field_defs_returned);
+    for (int i = 0; i < field_defs_returned; ++i) {
+      FieldLayout field;
+      ReadFieldLayout(metadata_import, field_defs[i], &field);
+      fields->push_back(std::move(field));
+    }
+  }
+
+  if (cor_enum) {
+    metadata_import->CloseEnum(cor_enum);
+  }
+
+  return FAILED(hr) ? hr : S_OK;
+}
+
+HRESULT TypeLayoutCache::ReadPropertyLayouts(
+    IMetaDataImport *metadata_import, mdTypeDef class_token,
+    vector<PropertyLayout> *properties) {
+  if (!metadata_import || !properties) {
+    return E_INVALIDARG;
+  }
+
+  HCORENUM cor_enum = nullptr;
+  HRESULT hr = S_OK;
+  while (true) {
+    array<mdProperty, 100> property_defs;
+    ULONG property_defs_returned = 0;
+
+    hr = metadata_import->EnumProperties(
+        &cor_enum, class_token, property_defs.data(), property_defs.size(),
+        &property_defs_returned);
+    if (FAILED(hr) || property_defs_returned == 0) {
+      break;
+    }
+
+    properties->reserve(properties->size() + property_defs_returned);
+    for (int i = 0; i < property_defs_returned; ++i) {
+      PropertyLayout property;
+      ReadPropertyLayout(metadata_import, property_defs[i], &property);
+      properties->push_back(std::move(property));
+    }
+  }
+
+  if (cor_enum) {
+    metadata_import->CloseEnum(cor_enum);
+  }
+
+  return FAILED(hr) ? hr : S_OK;
+}
+
+}  //  namespace google_cloud_debugger
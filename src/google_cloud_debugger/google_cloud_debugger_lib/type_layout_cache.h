@@ -0,0 +1,216 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef TYPE_LAYOUT_CACHE_H_
+#define TYPE_LAYOUT_CACHE_H_
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "cor.h"
+#include "cordebug.h"
+
+namespace google_cloud_debugger {
+
+// Metadata of a field of a class. Signature and default value point
+// into the metadata of the module so they stay valid until the module
+// is unloaded.
+struct FieldLayout {
+  // Token of the field.
+  mdFieldDef field_def = 0;
+
+  // HRESULT of reading the metadata of the field.
+  HRESULT hr = S_OK;
+
+  // Name of the field. For the backing field <MyProperty>k__BackingField
+  // of a property, this is the name of the property, MyProperty.
+  std::string name;
+
+  // True if this is the backing field of a property.
+  bool is_backing_field = false;
+
+  // Token of the type that implements the field.
+  mdTypeDef parent_token = 0;
+
+  // Attribute flags of the field.
+  DWORD attributes = 0;
+
+  // Metadata signature of the field.
+  PCCOR_SIGNATURE signature = nullptr;
+  ULONG signature_length = 0;
+
+  // Type, value and length of the default value of the field.
+  DWORD default_value_type_flags = 0;
+  UVCP_CONSTANT default_value = nullptr;
+  ULONG default_value_length = 0;
+};
+
+// Metadata of a property of a class. Like FieldLayout, the signature
+// points into the metadata of the module.
+struct PropertyLayout {
+  // Token of the property.
+  mdProperty property_def = 0;
+
+  // HRESULT of reading the metadata of the property.
+  HRESULT hr = S_OK;
+
+  // Name of the property.
+  std::string name;
+
+  // Token of the type that implements the property.
+  mdTypeDef parent_token = 0;
+
+  // Attribute flags of the property.
+  DWORD attributes = 0;
+
+  // Metadata signature of the property.
+  PCCOR_SIGNATURE signature = nullptr;
+  ULONG signature_length = 0;
+
+  // Type, value and length of the default value of the property.
+  DWORD default_value_type_flags = 0;
+  UVCP_CONSTANT default_value = nullptr;
+  ULONG default_value_length = 0;
+
+  // Tokens of the getter, the setter and the other methods
+  // of the property.
+  mdMethodDef getter_function = 0;
+  mdMethodDef setter_function = 0;
+  std::vector<mdMethodDef> other_methods;
+};
+
+// Everything about a class that only depends on its metadata: its
+// names and the metadata of its fields and properties. This does not
+// depend on the generic instantiation of the class (List<int> and
+// List<string> share the layout of List<T>); the generic types and the
+// values of the members are still read from each object. Member
+// signatures are not parsed here since the values of the members are
+// typed by ICorDebug. Only expressions parse them, against the generic
+// types of the object.
+//
+// The names are needed to tell primitive types, enums and other classes
+// apart, so they are read when the layout is created. The fields and
+// properties are only read the first time an object of the class is
+// expanded, so primitive types, nulls and objects past the budget of
+// a breakpoint never read them.
+struct TypeLayout {
+  // Name of the module the class is in.
+  std::string module_name;
+
+  // Name of the class.
+  std::string class_name;
+
+  // Token of the class.
+  mdTypeDef class_token = 0;
+
+  // Name of the base class and the HRESULT of resolving it.
+  std::string base_class_name;
+  HRESULT base_class_hr = S_OK;
+
+  // Sets fields to the fields of the class in metadata order. They are
+  // read from metadata_import, the metadata of the module of the class,
+  // the first time this is called. Returns the HRESULT of reading them.
+  // The metadata of a loaded module does not change, so a failure is
+  // kept like a success. This is thread-safe.
+  HRESULT GetFields(IMetaDataImport *metadata_import,
+                    const std::vector<FieldLayout> **fields) const;
+
+  // Same as GetFields for the properties of the class.
+  HRESULT GetProperties(IMetaDataImport *metadata_import,
+                        const std::vector<PropertyLayout> **properties) const;
+
+ private:
+  // Set once the fields are read, and the HRESULT of reading them.
+  mutable std::once_flag fields_read_;
+  mutable HRESULT fields_hr_ = S_OK;
+  mutable std::vector<FieldLayout> fields_;
+
+  // Set once the properties are read, and the HRESULT of reading them.
+  mutable std::once_flag properties_read_;
+  mutable HRESULT properties_hr_ = S_OK;
+  mutable std::vector<PropertyLayout> properties_;
+};
+
+// Process-wide cache of TypeLayout keyed by module base address and
+// class token, so that the metadata of a class is read once instead
+// of once per object. Objects of the same class are common, for
+// example in collections and in every breakpoint hit on the same line.
+// This class is thread-safe.
+class TypeLayoutCache {
+ public:
+  // Maximum number of layouts cached. Once the cache is full, new
+  // layouts are not cached.
+  static const std::size_t kMaximumCachedLayouts = 10000;
+
+  // Returns the type layout cache of the debugger.
+  static TypeLayoutCache *GetInstance();
+
+  // Returns the layout of the class with token class_token in the module
+  // loaded at module_base_address. Returns nullptr if it is not cached.
+  std::shared_ptr<const TypeLayout> GetLayout(CORDB_ADDRESS module_base_address,
+                                              mdTypeDef class_token);
+
+  // Caches layout as the layout of the class with token class_token
+  // in the module loaded at module_base_address.
+  void AddLayout(CORDB_ADDRESS module_base_address, mdTypeDef class_token,
+                 std::shared_ptr<const TypeLayout> layout);
+
+  // Removes the layouts of the classes of the module loaded at
+  // module_base_address. This has to be called when the module is
+  // unloaded since the layouts point into its metadata.
+  void RemoveModule(CORDB_ADDRESS module_base_address);
+
+  // Reads the metadata of the field field_def into field.
+  // The HRESULT is also stored in field->hr.
+  static HRESULT ReadFieldLayout(IMetaDataImport *metadata_import,
+                                 mdFieldDef field_def, FieldLayout *field);
+
+  // Reads the metadata of the property property_def into property.
+  // The HRESULT is also stored in property->hr.
+  static HRESULT ReadPropertyLayout(IMetaDataImport *metadata_import,
+                                    mdProperty property_def,
+                                    PropertyLayout *property);
+
+  // Enumerates the fields of the class class_token into fields.
+  // Fields whose metadata cannot be read are still added with
+  // their HRESULT.
+  static HRESULT ReadFieldLayouts(IMetaDataImport *metadata_import,
+                                  mdTypeDef class_token,
+                                  std::vector<FieldLayout> *fields);
+
+  // Enumerates the properties of the class class_token into properties.
+  // Properties whose metadata cannot be read are still added with
+  // their HRESULT.
+  static HRESULT ReadPropertyLayouts(IMetaDataImport *metadata_import,
+                                     mdTypeDef class_token,
+                                     std::vector<PropertyLayout> *properties);
+
+ private:
+  // Cached layouts by module base address and class token.
+  std::map<std::pair<CORDB_ADDRESS, mdTypeDef>,
+           std::shared_ptr<const TypeLayout>>
+      layouts_;
+
+  // Guards layouts_.
+  std::mutex mutex_;
+};
+
+}  //  namespace google_cloud_debugger
+
+#endif  //  TYPE_LAYOUT_CACHE_H_
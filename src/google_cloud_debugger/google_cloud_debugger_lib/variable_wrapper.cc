@@ -22,7 +22,6 @@
 
 using google::cloud::diagnostics::debug::Variable;
 using std::function;
-using std::queue;
 using std::shared_ptr;
 using std::string;
 using std::unique_ptr;
@@ -30,80 +29,106 @@ using std::vector;
 
 namespace google_cloud_debugger {
 
-HRESULT VariableWrapper::PerformBFS(queue<VariableWrapper>* bfs_queue,
+HRESULT VariableWrapper::PerformBFS(VariableWrapperQueue* bfs_queue,
                                     const function<bool()> &terminate_condition,
-                                    IEvalCoordinator *eval_coordinator) {
+                                    IEvalCoordinator *eval_coordinator,
+                                    int max_object_depth) {
   if (!bfs_queue) {
     return E_INVALIDARG;
   }
 
-  HRESULT hr;
-  // Until the queue is empty, we:
-  //  1. Pop out an item X.
-  //  2. If X is null, continue with the loop.
-  //  3. If the BFS level of X is kDefaultObjectEvalDepth,
-  // sets an error status on X saying that we cannot evaluate
-  // its children and continue with the loop.
-  //  4. Otherwise, try to get members (children) of X.
-  //  5. If there are members, push them into the queue. We
-  // also set the BFS level of the members to be the BFS
-  // level of the node X + 1. If not, call PopulateValue on X.
+  // Until the queue is empty, we pop out an item X and capture it.
+  // If X has members, they are pushed into the queue.
+  CapturedObjectTable captured_objects;
   while (!bfs_queue->empty()) {
     if (terminate_condition()) {
       return S_OK;
     }
 
     VariableWrapper current_variable = bfs_queue->front();
-    // Populates the type of the variable into the variable proto.
-    hr = current_variable.PopulateType();
-
-    if (FAILED(hr)) {
-      SetErrorStatusMessage(current_variable.variable_proto_,
-                            current_variable.variable_value_->GetErrorString());
-      bfs_queue->pop();
-      continue;
-    }
+    bfs_queue->pop();
 
-    if (current_variable.bfs_level_ >= kDefaultObjectEvalDepth) {
-      // We have reached a level that is more than the evaluation depth.
-      SetErrorStatusMessage(current_variable.variable_proto_,
-                            "Object evaluation limit reached");
-      bfs_queue->pop();
-      continue;
+    VariableWrapperVector variable_members;
+    current_variable.Capture(&variable_members, eval_coordinator,
+                             max_object_depth, &captured_objects);
+    for (auto &member_value : variable_members) {
+      bfs_queue->push(member_value);
     }
+  }
 
-    // If variable is null, moves on.
-    if (current_variable.variable_value_->GetIsNull()) {
-      bfs_queue->pop();
-      continue;
-    }
+  return S_OK;
+}
 
-    // Tries to see whether we can get any members (children) from
-    // this variable.
-    vector<VariableWrapper> variable_members;
-    hr = current_variable.PopulateMembers(&variable_members, eval_coordinator);
+void VariableWrapper::Capture(VariableWrapperVector *members,
+                              IEvalCoordinator *eval_coordinator,
+                              int max_object_depth,
+                              CapturedObjectTable *captured_objects) {
+  //  1. If the underlying object is null, returns.
+  //  2. If the BFS level is max_object_depth, sets an error status
+  // saying that we cannot evaluate its children and returns.
+  //  3. If the object is already expanded in another variable, only
+  // references it and returns.
+  //  4. Otherwise, tries to get members (children).
+  //  5. If there are members, appends them to members with a BFS level
+  // one deeper. If not, calls PopulateValue.
+  if (!LoadValue()) {
+    return;
+  }
 
-    // If hr is S_FALSE then there are no members so we simply
-    // call PopulateValue.
-    if (hr == S_FALSE) {
-      hr = current_variable.PopulateValue();
-    }
-    // Otherwise, process and put the members in the queue.
-    else if (SUCCEEDED(hr)) {
-      for (auto &member_value : variable_members) {
-        member_value.bfs_level_ = current_variable.bfs_level_ + 1;
-        bfs_queue->push(member_value);
-      }
-    }
+  // Populates the type of the variable into the variable proto.
+  HRESULT hr = PopulateType();
+  if (FAILED(hr)) {
+    SetErrorStatusMessage(variable_proto_, variable_value_->GetErrorString());
+    return;
+  }
+
+  if (bfs_level_ >= max_object_depth) {
+    // We have reached a level that is more than the evaluation depth.
+    SetErrorStatusMessage(variable_proto_, "Object evaluation limit reached");
+    return;
+  }
 
-    if (FAILED(hr)) {
-      SetErrorStatusMessage(current_variable.variable_proto_,
-                            current_variable.variable_value_->GetErrorString());
+  // If variable is null, moves on.
+  if (variable_value_->GetIsNull()) {
+    return;
+  }
+
+  // The members of an object reached through several variables are
+  // only captured once.
+  if (captured_objects &&
+      captured_objects->ReferenceOrAdd(*variable_value_, variable_proto_)) {
+    return;
+  }
+
+  // Tries to see whether we can get any members (children) from
+  // this variable.
+  VariableWrapperVector variable_members;
+  hr = PopulateMembers(&variable_members, eval_coordinator);
+
+  // If hr is S_FALSE then there are no members so we simply
+  // call PopulateValue.
+  if (hr == S_FALSE) {
+    hr = PopulateValue();
+  }
+  // Otherwise, process and put the members in the vector.
+  else if (SUCCEEDED(hr)) {
+    for (auto &member_value : variable_members) {
+      member_value.bfs_level_ = bfs_level_ + 1;
+      members->push_back(member_value);
     }
-    bfs_queue->pop();
   }
 
-  return S_OK;
+  if (FAILED(hr)) {
+    SetErrorStatusMessage(variable_proto_, variable_value_->GetErrorString());
+  }
+}
+
+shared_ptr<DbgObject> VariableWrapper::LoadValue() {
+  if (value_loader_) {
+    variable_value_ = value_loader_();
+    value_loader_ = nullptr;
+  }
+  return variable_value_;
 }
 
 // Populates variable proto variable_proto_ with
@@ -126,7 +151,7 @@ HRESULT VariableWrapper::PopulateType() {
 
 // Calls PopulateMembers of variable_value_ object.
 // Pass in variable_proto_ as the parent proto.
-HRESULT VariableWrapper::PopulateMembers(std::vector<VariableWrapper> *members,
+HRESULT VariableWrapper::PopulateMembers(VariableWrapperVector *members,
   IEvalCoordinator *eval_coordinator) {
   if (!variable_proto_ || !variable_value_
     || !members || !eval_coordinator) {
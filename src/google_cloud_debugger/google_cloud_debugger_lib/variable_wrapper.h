@@ -15,13 +15,16 @@
 #ifndef VARIABLE_WRAPPER_H_
 #define VARIABLE_WRAPPER_H_
 
+#include <deque>
 #include <functional>
 #include <memory>
 #include <queue>
 #include <sstream>
 #include <string>
+#include <vector>
 
 #include "breakpoint.pb.h"
+#include "captured_object_table.h"
 #include "constants.h"
 #include "cor.h"
 #include "cordebug.h"
@@ -31,10 +34,17 @@ namespace google_cloud_debugger {
 
 class IEvalCoordinator;
 
+// Queue of the breadth-first capture of variables, allocated from the
+// SnapshotArena of the hit.
+typedef std::queue<
+    VariableWrapper,
+    std::deque<VariableWrapper, SnapshotAllocator<VariableWrapper>>>
+    VariableWrapperQueue;
+
 // This wrapper class contains pointers to a variable proto and
 // its underlying object. It also contains the BFS level,
 // which is used by PopulateStackFrame to stop the BFS when
-// it reaches kDefaultObjectEvalDepth.
+// it reaches max_object_depth.
 class VariableWrapper {
 public:
   // Constructor that takes in variable proto, the underlying object
@@ -45,23 +55,49 @@ public:
     variable_value_(variable_value),
     bfs_level_(bfs_level) {}
 
+  // Constructor for a top-level variable whose underlying object is only
+  // created by value_loader when the BFS reaches it. value_loader
+  // returns nullptr if the object cannot be created.
+  VariableWrapper(google::cloud::diagnostics::debug::Variable *variable_proto,
+    std::function<std::shared_ptr<DbgObject>()> value_loader)
+    : variable_proto_(variable_proto),
+    value_loader_(value_loader),
+    bfs_level_(1) {}
+
   // This method is used to process all VariableWrapper in the
   // queue by populating their variable_proto_ with the underlying
   // object variable_value_.
   // Until the queue is empty, this method:
   //  1. Checks if terminate_condition is true. If so, returns.
   //  2. Pops out an item X.
-  //  3. If X is null, continues with the loop.
-  //  4. If the BFS level of X is kDefaultObjectEvalDepth,
+  //  3. If X is null (or its underlying object cannot be created),
+  // continues with the loop.
+  //  4. If the BFS level of X is max_object_depth,
   // sets an error status on X saying that we cannot evaluate
   // its children and continues with the loop.
-  //  5. Otherwise, tries to get members (children) of X.
-  //  6. If there are members, pushes them into the queue. We
+  //  5. If the object of X was already expanded in another variable,
+  // marks X as a reference to it and continues with the loop.
+  //  6. Otherwise, tries to get members (children) of X.
+  //  7. If there are members, pushes them into the queue. We
   // also set the BFS level of the members to be the BFS
   // level of the node X + 1. If not, call PopulateValue on X.
-  static HRESULT PerformBFS(std::queue<VariableWrapper> *bfs_queue,
+  static HRESULT PerformBFS(VariableWrapperQueue *bfs_queue,
                             const std::function<bool()> &terminate_condition,
-                            IEvalCoordinator *eval_coordinator);
+                            IEvalCoordinator *eval_coordinator,
+                            int max_object_depth = kDefaultObjectEvalDepth);
+
+  // Processes this variable as a step of the BFS: populates its type and
+  // then either its value or, if it has members, appends its members one
+  // BFS level deeper to members. Errors are set as the status of
+  // variable_proto_. If captured_objects is not null, an object that is
+  // already expanded in another variable is only referenced.
+  void Capture(VariableWrapperVector *members,
+               IEvalCoordinator *eval_coordinator, int max_object_depth,
+               CapturedObjectTable *captured_objects = nullptr);
+
+  // Creates the underlying object if this variable has a value loader
+  // and returns it.
+  std::shared_ptr<DbgObject> LoadValue();
 
   // Populates variable proto variable_proto_ with
   // variable_value_ object.
@@ -73,7 +109,7 @@ public:
 
   // Calls PopulateMembers of variable_value_ object.
   // Pass in variable_proto_ as the parent proto.
-  HRESULT PopulateMembers(std::vector<VariableWrapper> *members,
+  HRESULT PopulateMembers(VariableWrapperVector *members,
                           IEvalCoordinator *eval_coordinator);
 
   // Returns the variable proto of this wrapper.
@@ -91,6 +127,11 @@ public:
     bfs_level_ = level;
   }
 
+  // Returns the BFS level.
+  std::int32_t GetBFSLevel() const {
+    return bfs_level_;
+  }
+
 private:
   // The proto for this variable.
   google::cloud::diagnostics::debug::Variable *variable_proto_;
@@ -98,6 +139,9 @@ private:
   // The underlying object that will be used to populate variable proto.
   std::shared_ptr<DbgObject> variable_value_;
 
+  // If set, creates variable_value_ when the BFS reaches this variable.
+  std::function<std::shared_ptr<DbgObject>()> value_loader_;
+
   // The BFS level that this variable is at.
   std::int32_t bfs_level_;
 };
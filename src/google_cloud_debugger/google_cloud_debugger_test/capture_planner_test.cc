@@ -0,0 +1,267 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "breakpoint.pb.h"
+#include "capture_planner.h"
+#include "dbg_object.h"
+#include "i_cor_debug_helper.h"
+#include "i_eval_coordinator_mock.h"
+#include "variable_wrapper.h"
+
+using google::cloud::diagnostics::debug::Variable;
+using google_cloud_debugger::CapturePlanner;
+using google_cloud_debugger::DbgObject;
+using google_cloud_debugger::ICorDebugHelper;
+using google_cloud_debugger::IEvalCoordinator;
+using google_cloud_debugger::VariableWrapper;
+using google_cloud_debugger::VariableWrapperVector;
+using std::shared_ptr;
+using std::string;
+using std::vector;
+
+namespace google_cloud_debugger_test {
+
+// DbgObject with a fixed estimated cost. An object without members
+// populates its name as its value. Every object records its name
+// in capture_order when it is captured.
+class FakePlannedObject : public DbgObject {
+ public:
+  FakePlannedObject(const string &name, std::uint32_t cost,
+                    vector<string> *capture_order)
+      : DbgObject(nullptr, 0, shared_ptr<ICorDebugHelper>()),
+        name_(name),
+        cost_(cost),
+        capture_order_(capture_order) {}
+
+  virtual void Initialize(ICorDebugValue *debug_value, BOOL is_null) override {}
+
+  virtual HRESULT GetTypeString(std::string *type_string) override {
+    capture_order_->push_back(name_);
+    *type_string = name_;
+    return S_OK;
+  }
+
+  virtual HRESULT GetICorDebugValue(ICorDebugValue **debug_value,
+                                    ICorDebugEval *debug_eval) override {
+    return E_NOTIMPL;
+  }
+
+  virtual HRESULT PopulateValue(Variable *variable) override {
+    variable->set_value(name_);
+    return S_OK;
+  }
+
+  virtual HRESULT PopulateMembers(Variable *variable_proto,
+                                  VariableWrapperVector *members,
+                                  IEvalCoordinator *eval_coordinator) override {
+    if (members_.empty()) {
+      return S_FALSE;
+    }
+
+    for (auto &member : members_) {
+      Variable *member_proto = variable_proto->add_members();
+      member_proto->set_name(member->name_);
+      members->push_back(VariableWrapper(member_proto, member));
+    }
+    return S_OK;
+  }
+
+  virtual std::uint32_t GetEstimatedCaptureCost() const override {
+    return cost_;
+  }
+
+  // Adds a member to the object and returns it.
+  shared_ptr<FakePlannedObject> AddMember(const string &name,
+                                          std::uint32_t cost) {
+    shared_ptr<FakePlannedObject> member(
+        new FakePlannedObject(name, cost, capture_order_));
+    members_.push_back(member);
+    return member;
+  }
+
+ private:
+  string name_;
+  std::uint32_t cost_;
+  vector<string> *capture_order_;
+  vector<shared_ptr<FakePlannedObject>> members_;
+};
+
+class CapturePlannerTest : public ::testing::Test {
+ protected:
+  // Creates a top-level object backed by a proto in frame_.
+  shared_ptr<FakePlannedObject> AddVariable(const string &name,
+                                            std::uint32_t cost) {
+    shared_ptr<FakePlannedObject> object(
+        new FakePlannedObject(name, cost, &capture_order_));
+    Variable *variable_proto = frame_.add_members();
+    variable_proto->set_name(name);
+    planner_.AddVariable(VariableWrapper(variable_proto, object));
+    return object;
+  }
+
+  // Creates a top-level variable backed by a proto in frame_ whose
+  // object is only created when the planner loads it.
+  shared_ptr<FakePlannedObject> AddLazyVariable(const string &name,
+                                                std::uint32_t cost) {
+    shared_ptr<FakePlannedObject> object(
+        new FakePlannedObject(name, cost, &capture_order_));
+    Variable *variable_proto = frame_.add_members();
+    variable_proto->set_name(name);
+    planner_.AddVariable(
+        VariableWrapper(variable_proto, [this, name, object]() {
+          load_order_.push_back(name);
+          return std::static_pointer_cast<DbgObject>(object);
+        }));
+    return object;
+  }
+
+  // Captures the variables until anything is added to frame_.
+  HRESULT CaptureUntilFrameGrows() {
+    return planner_.Capture(frame_.ByteSize(), frame_.ByteSize());
+  }
+
+  // Captures all the variables.
+  HRESULT CaptureAll() {
+    return planner_.Capture(0, std::numeric_limits<int>::max());
+  }
+
+  IEvalCoordinatorMock eval_coordinator_mock_;
+  CapturePlanner planner_{&eval_coordinator_mock_};
+
+  // Holds the top-level variable protos.
+  Variable frame_;
+
+  vector<string> capture_order_;
+
+  // Names of the lazy variables in the order they are loaded.
+  vector<string> load_order_;
+};
+
+// Tests that variables without members are captured before objects
+// that were added ahead of them.
+TEST_F(CapturePlannerTest, CheapVariablesFirst) {
+  shared_ptr<FakePlannedObject> large_object = AddVariable("large", 100);
+  large_object->AddMember("field", 0);
+  AddVariable("number", 0);
+
+  // Capturing the number uses up the budget before the large object
+  // is expanded.
+  EXPECT_EQ(CaptureUntilFrameGrows(), S_OK);
+
+  EXPECT_EQ(capture_order_, vector<string>({"number"}));
+  EXPECT_EQ(frame_.members(0).type(), "");
+  EXPECT_EQ(frame_.members(0).members_size(), 0);
+  EXPECT_EQ(frame_.members(1).value(), "number");
+}
+
+// Tests that objects of the same level are expanded from the cheapest
+// to the most expensive.
+TEST_F(CapturePlannerTest, CheapestObjectFirst) {
+  AddVariable("expensive", 50)->AddMember("expensive_field", 0);
+  AddVariable("cheap", 5)->AddMember("cheap_field", 0);
+
+  EXPECT_EQ(CaptureUntilFrameGrows(), S_OK);
+
+  EXPECT_EQ(capture_order_, vector<string>({"cheap"}));
+  EXPECT_EQ(frame_.members(0).members_size(), 0);
+  ASSERT_EQ(frame_.members(1).members_size(), 1);
+  EXPECT_EQ(frame_.members(1).members(0).name(), "cheap_field");
+}
+
+// Tests that all the objects of a level are expanded before
+// the objects of the next level, even if they are more expensive.
+// Within the next level, the cheaper sibling_field goes first.
+TEST_F(CapturePlannerTest, ShallowestLevelFirst) {
+  shared_ptr<FakePlannedObject> parent = AddVariable("parent", 1);
+  parent->AddMember("child", 1)->AddMember("grandchild", 0);
+  AddVariable("sibling", 10)->AddMember("sibling_field", 0);
+
+  EXPECT_EQ(CaptureAll(), S_OK);
+
+  EXPECT_EQ(capture_order_,
+            vector<string>({"parent", "sibling", "sibling_field", "child",
+                            "grandchild"}));
+  ASSERT_EQ(frame_.members(0).members_size(), 1);
+  ASSERT_EQ(frame_.members(0).members(0).members_size(), 1);
+  EXPECT_EQ(frame_.members(0).members(0).members(0).value(), "grandchild");
+  ASSERT_EQ(frame_.members(1).members_size(), 1);
+  EXPECT_EQ(frame_.members(1).members(0).value(), "sibling_field");
+}
+
+// Tests that top-level variables are only loaded when the planner
+// reaches them within the budget.
+TEST_F(CapturePlannerTest, LoadsVariablesWithinBudget) {
+  AddLazyVariable("object", 10)->AddMember("field", 0);
+  AddLazyVariable("number", 0);
+  AddLazyVariable("other_number", 0);
+
+  // The object is loaded but only queued, then capturing the first
+  // number uses up the budget.
+  EXPECT_EQ(CaptureUntilFrameGrows(), S_OK);
+
+  EXPECT_EQ(load_order_, vector<string>({"object", "number"}));
+  EXPECT_EQ(capture_order_, vector<string>({"number"}));
+  EXPECT_EQ(frame_.members(2).value(), "");
+}
+
+// Tests that the size of the captured variables is tracked so that
+// the capture stops once it exceeds the budget.
+TEST_F(CapturePlannerTest, TracksCapturedSize) {
+  AddVariable("first", 0);
+  AddVariable("second", 0);
+  AddVariable("third", 0);
+
+  // The budget fits exactly the type and value of the first variable,
+  // so the capture stops after the second one.
+  Variable first;
+  first.set_name("first");
+  int name_size = first.ByteSize();
+  first.set_type("first");
+  first.set_value("first");
+  int budget = frame_.ByteSize() + first.ByteSize() - name_size;
+  EXPECT_EQ(planner_.Capture(frame_.ByteSize(), budget), S_OK);
+
+  EXPECT_EQ(capture_order_, vector<string>({"first", "second"}));
+  EXPECT_EQ(frame_.members(1).value(), "second");
+  EXPECT_EQ(frame_.members(2).value(), "");
+}
+
+// Tests that objects are not expanded beyond the maximum object depth.
+TEST_F(CapturePlannerTest, MaxObjectDepth) {
+  CapturePlanner planner(&eval_coordinator_mock_, 2);
+  shared_ptr<FakePlannedObject> parent(
+      new FakePlannedObject("parent", 1, &capture_order_));
+  parent->AddMember("child", 1)->AddMember("grandchild", 0);
+  Variable *variable_proto = frame_.add_members();
+  planner.AddVariable(VariableWrapper(variable_proto, parent));
+
+  EXPECT_EQ(planner.Capture(0, std::numeric_limits<int>::max()), S_OK);
+
+  EXPECT_EQ(capture_order_, vector<string>({"parent", "child"}));
+  ASSERT_EQ(variable_proto->members_size(), 1);
+  EXPECT_TRUE(variable_proto->members(0).status().iserror());
+  EXPECT_EQ(variable_proto->members(0).members_size(), 0);
+}
+
+}  // namespace google_cloud_debugger_test
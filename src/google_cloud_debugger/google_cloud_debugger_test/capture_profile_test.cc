@@ -0,0 +1,123 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+
+#include "breakpoint.pb.h"
+#include "capture_profile.h"
+
+using google::cloud::diagnostics::debug::Breakpoint;
+using google_cloud_debugger::CaptureProfile;
+
+namespace google_cloud_debugger_test {
+
+// Tests that a breakpoint without limits gets the default profile.
+TEST(CaptureProfileTest, FromBreakpointDefault) {
+  Breakpoint breakpoint;
+  CaptureProfile profile = CaptureProfile::FromBreakpoint(breakpoint);
+  const CaptureProfile &default_profile = CaptureProfile::GetDefault();
+
+  EXPECT_EQ(profile.max_stack_frames, default_profile.max_stack_frames);
+  EXPECT_EQ(profile.max_stack_frames_with_variables,
+            default_profile.max_stack_frames_with_variables);
+  EXPECT_EQ(profile.max_object_depth, default_profile.max_object_depth);
+  EXPECT_EQ(profile.max_collection_size, default_profile.max_collection_size);
+  EXPECT_EQ(profile.max_expression_collection_size,
+            default_profile.max_expression_collection_size);
+  EXPECT_EQ(profile.max_breakpoint_size, default_profile.max_breakpoint_size);
+  EXPECT_FALSE(profile.stack_only);
+}
+
+// Tests that the limits set in a breakpoint override the default.
+TEST(CaptureProfileTest, FromBreakpointOverride) {
+  Breakpoint breakpoint;
+  breakpoint.set_max_stack_frames(5);
+  breakpoint.set_max_stack_frames_with_variables(1);
+  breakpoint.set_max_object_depth(2);
+  breakpoint.set_max_collection_size(3);
+  breakpoint.set_max_expression_collection_size(50);
+  breakpoint.set_max_breakpoint_size(1024);
+  breakpoint.set_stack_only(true);
+
+  CaptureProfile profile = CaptureProfile::FromBreakpoint(breakpoint);
+  EXPECT_EQ(profile.max_stack_frames, 5);
+  EXPECT_EQ(profile.max_stack_frames_with_variables, 1);
+  EXPECT_EQ(profile.max_object_depth, 2);
+  EXPECT_EQ(profile.max_collection_size, 3);
+  EXPECT_EQ(profile.max_expression_collection_size, 50);
+  EXPECT_EQ(profile.max_breakpoint_size, 1024);
+  EXPECT_TRUE(profile.stack_only);
+
+  // Negative limits are ignored.
+  breakpoint.set_max_stack_frames(-1);
+  profile = CaptureProfile::FromBreakpoint(breakpoint);
+  EXPECT_EQ(profile.max_stack_frames,
+            CaptureProfile::GetDefault().max_stack_frames);
+}
+
+// Tests that Union takes the larger of each limit.
+TEST(CaptureProfileTest, Union) {
+  CaptureProfile first;
+  first.max_stack_frames = 5;
+  first.max_stack_frames_with_variables = 10;
+  first.max_object_depth = 1;
+  first.max_collection_size = 100;
+  first.max_expression_collection_size = 20;
+  first.max_string_length = 1000;
+  first.max_breakpoint_size = 1024;
+
+  CaptureProfile second;
+  second.max_stack_frames = 50;
+  second.max_stack_frames_with_variables = 1;
+  second.max_object_depth = 6;
+  second.max_collection_size = 2;
+  second.max_expression_collection_size = 200;
+  second.max_string_length = 10;
+  second.max_breakpoint_size = 4096;
+
+  CaptureProfile result = first.Union(second);
+  EXPECT_EQ(result.max_stack_frames, 50);
+  EXPECT_EQ(result.max_stack_frames_with_variables, 10);
+  EXPECT_EQ(result.max_object_depth, 6);
+  EXPECT_EQ(result.max_collection_size, 100);
+  EXPECT_EQ(result.max_expression_collection_size, 200);
+  EXPECT_EQ(result.max_string_length, 1000);
+  EXPECT_EQ(result.max_breakpoint_size, 4096);
+}
+
+// Tests that the union of profiles is only stack-only if all of them are.
+TEST(CaptureProfileTest, UnionStackOnly) {
+  CaptureProfile stack_only;
+  stack_only.stack_only = true;
+  CaptureProfile full;
+
+  EXPECT_TRUE(stack_only.Union(stack_only).stack_only);
+  EXPECT_FALSE(stack_only.Union(full).stack_only);
+  EXPECT_FALSE(full.Union(stack_only).stack_only);
+}
+
+// Tests that breakpoints without limits pick up a new default profile.
+TEST(CaptureProfileTest, SetDefault) {
+  CaptureProfile original = CaptureProfile::GetDefault();
+  CaptureProfile new_default;
+  new_default.max_stack_frames = 7;
+  CaptureProfile::SetDefault(new_default);
+
+  Breakpoint breakpoint;
+  EXPECT_EQ(CaptureProfile::FromBreakpoint(breakpoint).max_stack_frames, 7);
+
+  CaptureProfile::SetDefault(original);
+}
+
+}  // namespace google_cloud_debugger_test
@@ -0,0 +1,117 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <cstdint>
+
+#include "captured_object_table.h"
+#include "dbg_primitive.h"
+
+using google::cloud::diagnostics::debug::Variable;
+using google_cloud_debugger::CapturedObjectTable;
+using google_cloud_debugger::DbgPrimitive;
+
+namespace google_cloud_debugger_test {
+
+// Only the type and the address of the objects matter to the table so
+// a primitive stands in for them.
+static void SetHeapObject(DbgPrimitive<int32_t> *object,
+                          CorElementType element_type,
+                          CORDB_ADDRESS address,
+                          std::uint64_t address_eval_count = 0) {
+  object->SetCorElementType(element_type);
+  object->SetAddress(address, address_eval_count);
+}
+
+// Tests that only non-null heap objects are tracked.
+TEST(CapturedObjectTableTest, IsTracked) {
+  DbgPrimitive<int32_t> object(1);
+  SetHeapObject(&object, CorElementType::ELEMENT_TYPE_CLASS, 0x1000);
+  EXPECT_TRUE(CapturedObjectTable::IsTracked(object));
+
+  SetHeapObject(&object, CorElementType::ELEMENT_TYPE_SZARRAY, 0x1000);
+  EXPECT_TRUE(CapturedObjectTable::IsTracked(object));
+
+  SetHeapObject(&object, CorElementType::ELEMENT_TYPE_VALUETYPE, 0x1000);
+  EXPECT_FALSE(CapturedObjectTable::IsTracked(object));
+
+  SetHeapObject(&object, CorElementType::ELEMENT_TYPE_CLASS, 0);
+  EXPECT_FALSE(CapturedObjectTable::IsTracked(object));
+}
+
+// Tests that the second variable of an object references the first one
+// and that both get the same object ID.
+TEST(CapturedObjectTableTest, ReferenceOrAdd) {
+  DbgPrimitive<int32_t> object(1);
+  SetHeapObject(&object, CorElementType::ELEMENT_TYPE_CLASS, 0x1000);
+  DbgPrimitive<int32_t> other_object(2);
+  SetHeapObject(&other_object, CorElementType::ELEMENT_TYPE_CLASS, 0x2000);
+
+  CapturedObjectTable table;
+  Variable first;
+  Variable second;
+  Variable third;
+  Variable other;
+
+  EXPECT_FALSE(table.ReferenceOrAdd(object, &first));
+  EXPECT_FALSE(table.ReferenceOrAdd(other_object, &other));
+  EXPECT_EQ(first.object_id(), 0);
+  EXPECT_EQ(table.GetReferenceCount(), 0);
+
+  EXPECT_TRUE(table.ReferenceOrAdd(object, &second));
+  EXPECT_TRUE(table.ReferenceOrAdd(object, &third));
+  EXPECT_NE(first.object_id(), 0);
+  EXPECT_FALSE(first.is_reference());
+  EXPECT_EQ(second.object_id(), first.object_id());
+  EXPECT_TRUE(second.is_reference());
+  EXPECT_EQ(third.object_id(), first.object_id());
+  EXPECT_TRUE(third.is_reference());
+  EXPECT_EQ(table.GetReferenceCount(), 2);
+
+  // Objects that are only reached once do not get an ID.
+  EXPECT_EQ(other.object_id(), 0);
+}
+
+// Tests that objects at the same address read before and after a
+// function evaluation are not taken for the same object.
+TEST(CapturedObjectTableTest, AddressReadAfterEval) {
+  DbgPrimitive<int32_t> object(1);
+  SetHeapObject(&object, CorElementType::ELEMENT_TYPE_CLASS, 0x1000, 1);
+  DbgPrimitive<int32_t> moved_object(2);
+  SetHeapObject(&moved_object, CorElementType::ELEMENT_TYPE_CLASS, 0x1000, 2);
+
+  CapturedObjectTable table;
+  Variable first;
+  Variable second;
+  EXPECT_FALSE(table.ReferenceOrAdd(object, &first));
+  EXPECT_FALSE(table.ReferenceOrAdd(moved_object, &second));
+  EXPECT_FALSE(second.is_reference());
+  EXPECT_EQ(table.GetReferenceCount(), 0);
+}
+
+// Tests that value types are never referenced.
+TEST(CapturedObjectTableTest, ValueTypeNotReferenced) {
+  DbgPrimitive<int32_t> object(1);
+  SetHeapObject(&object, CorElementType::ELEMENT_TYPE_VALUETYPE, 0x1000);
+
+  CapturedObjectTable table;
+  Variable first;
+  Variable second;
+  EXPECT_FALSE(table.ReferenceOrAdd(object, &first));
+  EXPECT_FALSE(table.ReferenceOrAdd(object, &second));
+  EXPECT_EQ(second.object_id(), 0);
+  EXPECT_FALSE(second.is_reference());
+}
+
+}  // namespace google_cloud_debugger_test
@@ -0,0 +1,75 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+#include <string>
+
+#include "collection_window.h"
+
+using google_cloud_debugger::CollectionWindow;
+using std::string;
+
+namespace google_cloud_debugger_test {
+
+// Tests that a slice is split into its collection and window.
+TEST(CollectionWindowTest, ParseSlice) {
+  string collection;
+  CollectionWindow window;
+  EXPECT_TRUE(
+      CollectionWindow::ParseSlice("items[1000..1020]", &collection, &window));
+  EXPECT_EQ(collection, "items");
+  EXPECT_EQ(window.first_item, 1000);
+  EXPECT_EQ(window.max_items, 20);
+
+  EXPECT_TRUE(CollectionWindow::ParseSlice(" this.map[key].items[ 5 .. 6 ] ",
+                                           &collection, &window));
+  EXPECT_EQ(collection, "this.map[key].items");
+  EXPECT_EQ(window.first_item, 5);
+  EXPECT_EQ(window.max_items, 1);
+}
+
+// Tests slices without a first or last index.
+TEST(CollectionWindowTest, ParseOpenSlice) {
+  string collection;
+  CollectionWindow window;
+  EXPECT_TRUE(
+      CollectionWindow::ParseSlice("items[..20]", &collection, &window));
+  EXPECT_EQ(window.first_item, 0);
+  EXPECT_EQ(window.max_items, 20);
+
+  EXPECT_TRUE(
+      CollectionWindow::ParseSlice("items[100..]", &collection, &window));
+  EXPECT_EQ(window.first_item, 100);
+  EXPECT_EQ(window.max_items, UINT32_MAX - 100);
+}
+
+// Tests that expressions that are not slices are not parsed.
+TEST(CollectionWindowTest, ParseNotSlice) {
+  string collection;
+  CollectionWindow window;
+  EXPECT_FALSE(CollectionWindow::ParseSlice("items", &collection, &window));
+  EXPECT_FALSE(CollectionWindow::ParseSlice("items[3]", &collection, &window));
+  EXPECT_FALSE(CollectionWindow::ParseSlice("[1..2]", &collection, &window));
+  EXPECT_FALSE(
+      CollectionWindow::ParseSlice("items[i..2]", &collection, &window));
+  EXPECT_FALSE(
+      CollectionWindow::ParseSlice("items[5..2]", &collection, &window));
+  EXPECT_FALSE(CollectionWindow::ParseSlice("items[0..99999999999]",
+                                            &collection, &window));
+  EXPECT_FALSE(
+      CollectionWindow::ParseSlice("items[1..2]]", &collection, &window));
+}
+
+}  // namespace google_cloud_debugger_test
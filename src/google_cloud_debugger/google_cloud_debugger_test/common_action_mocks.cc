@@ -21,6 +21,7 @@ using ::testing::Return;
 using ::testing::SetArgPointee;
 using ::testing::_;
 using google_cloud_debugger::VariableWrapper;
+using google_cloud_debugger::VariableWrapperVector;
 using std::vector;
 
 namespace google_cloud_debugger_test {
@@ -45,7 +46,7 @@ void SetUpMockGenericValue(
       .WillRepeatedly(DoAll(SetArg0ToInt32Value(value), Return(S_OK)));
 }
 
-void PopulateTypeAndValue(vector<VariableWrapper> &variable_wrappers) {
+void PopulateTypeAndValue(VariableWrapperVector &variable_wrappers) {
   for (auto &wrapper : variable_wrappers) {
     EXPECT_EQ(wrapper.PopulateType(), S_OK);
     EXPECT_EQ(wrapper.PopulateValue(), S_OK);
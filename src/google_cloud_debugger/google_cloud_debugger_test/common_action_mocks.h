@@ -71,7 +71,7 @@ void SetUpMockGenericValue(ICorDebugGenericValueMock *generic_value,
 // Loops through the items in variable_wrappers and populates
 // their protos with the respective types and values.
 void PopulateTypeAndValue(
-    std::vector<google_cloud_debugger::VariableWrapper> &variable_wrappers);
+    google_cloud_debugger::VariableWrapperVector &variable_wrappers);
 
 }  // namespace google_cloud_debugger_test
 
@@ -27,12 +27,14 @@
 
 using google::cloud::diagnostics::debug::Variable;
 using google_cloud_debugger::CComPtr;
+using google_cloud_debugger::CollectionWindow;
 using google_cloud_debugger::CorDebugHelper;
 using google_cloud_debugger::DbgArray;
 using google_cloud_debugger::DbgObjectFactory;
 using google_cloud_debugger::ICorDebugHelper;
 using google_cloud_debugger::IDbgObjectFactory;
 using google_cloud_debugger::VariableWrapper;
+using google_cloud_debugger::VariableWrapperVector;
 using std::string;
 using std::vector;
 using ::testing::_;
@@ -304,7 +306,7 @@ TEST_F(DbgArrayTest, TestPopulateMembers) {
   // If array is null, then variables should have 0 members.
   {
     Variable variable;
-    vector<VariableWrapper> variable_wrappers;
+    VariableWrapperVector variable_wrappers;
     DbgArray dbgarray(&array_type_, 1, debug_helper_, dbg_object_factory_);
 
     // Initialize to a null array.
@@ -318,7 +320,7 @@ TEST_F(DbgArrayTest, TestPopulateMembers) {
   }
 
   Variable variable;
-  vector<VariableWrapper> variable_wrappers;
+  VariableWrapperVector variable_wrappers;
   DbgArray dbgarray(&array_type_, 1, debug_helper_, dbg_object_factory_);
 
   dbgarray.Initialize(&array_value_, FALSE);
@@ -361,6 +363,109 @@ TEST_F(DbgArrayTest, TestPopulateMembers) {
   EXPECT_EQ(variable.members(1).value(), std::to_string(value1));
 }
 
+// Tests that PopulateMembers reads the items of an array of primitives
+// with one memory read instead of getting each item.
+TEST_F(DbgArrayTest, TestPopulateMembersPrimitiveItems) {
+  SetUpArray();
+
+  Variable variable;
+  VariableWrapperVector variable_wrappers;
+  DbgArray dbgarray(&array_type_, 1, debug_helper_, dbg_object_factory_);
+  dbgarray.Initialize(&array_value_, FALSE);
+
+  ICorDebugThreadMock active_thread;
+  ICorDebugProcessMock debug_process;
+  EXPECT_CALL(eval_coordinator_, GetActiveDebugThread(_))
+      .WillRepeatedly(DoAll(SetArgPointee<0>(&active_thread), Return(S_OK)));
+  EXPECT_CALL(active_thread, GetProcess(_))
+      .WillRepeatedly(DoAll(SetArgPointee<0>(&debug_process), Return(S_OK)));
+
+  // Only the first item is retrieved to get the address of the items.
+  ICorDebugGenericValueMock item0;
+  CORDB_ADDRESS items_address = 0x1000;
+  EXPECT_CALL(item0, GetAddress(_))
+      .WillRepeatedly(DoAll(SetArgPointee<0>(items_address), Return(S_OK)));
+  EXPECT_CALL(array_value_, GetElementAtPosition(0, _))
+      .Times(1)
+      .WillRepeatedly(DoAll(SetArgPointee<1>(&item0), Return(S_OK)));
+  EXPECT_CALL(array_value_, GetElementAtPosition(1, _)).Times(0);
+
+  int32_t values[2] = {20, 40};
+  BYTE *value_bytes = reinterpret_cast<BYTE *>(values);
+  EXPECT_CALL(debug_process,
+              ReadMemory(items_address, sizeof(values), _, _))
+      .Times(1)
+      .WillRepeatedly(DoAll(
+          SetArrayArgument<2>(value_bytes, value_bytes + sizeof(values)),
+          SetArgPointee<3>(sizeof(values)), Return(S_OK)));
+
+  HRESULT hr = dbgarray.PopulateMembers(&variable, &variable_wrappers,
+                                        &eval_coordinator_);
+  EXPECT_TRUE(SUCCEEDED(hr)) << "Failed with hr: " << hr;
+  ASSERT_EQ(variable_wrappers.size(), 2);
+
+  PopulateTypeAndValue(variable_wrappers);
+
+  EXPECT_EQ(variable.members(0).name(), "[0]");
+  EXPECT_EQ(variable.members(1).name(), "[1]");
+  EXPECT_EQ(variable.members(0).type(), "System.Int32");
+  EXPECT_EQ(variable.members(1).type(), "System.Int32");
+  EXPECT_EQ(variable.members(0).value(), "20");
+  EXPECT_EQ(variable.members(1).value(), "40");
+}
+
+// Tests that PopulateMembers only reads the items in the collection
+// window of the array.
+TEST_F(DbgArrayTest, TestPopulateMembersWindow) {
+  SetUpArray();
+
+  Variable variable;
+  VariableWrapperVector variable_wrappers;
+  DbgArray dbgarray(&array_type_, 1, debug_helper_, dbg_object_factory_);
+  dbgarray.Initialize(&array_value_, FALSE);
+
+  CollectionWindow window;
+  window.first_item = 1;
+  window.max_items = 5;
+  EXPECT_EQ(dbgarray.SetCollectionWindow(window), S_OK);
+  EXPECT_EQ(dbgarray.GetEstimatedCaptureCost(), 1);
+
+  ICorDebugThreadMock active_thread;
+  ICorDebugProcessMock debug_process;
+  EXPECT_CALL(eval_coordinator_, GetActiveDebugThread(_))
+      .WillRepeatedly(DoAll(SetArgPointee<0>(&active_thread), Return(S_OK)));
+  EXPECT_CALL(active_thread, GetProcess(_))
+      .WillRepeatedly(DoAll(SetArgPointee<0>(&debug_process), Return(S_OK)));
+
+  // The items before the window are not retrieved.
+  ICorDebugGenericValueMock item1;
+  CORDB_ADDRESS items_address = 0x1004;
+  EXPECT_CALL(item1, GetAddress(_))
+      .WillRepeatedly(DoAll(SetArgPointee<0>(items_address), Return(S_OK)));
+  EXPECT_CALL(array_value_, GetElementAtPosition(0, _)).Times(0);
+  EXPECT_CALL(array_value_, GetElementAtPosition(1, _))
+      .Times(1)
+      .WillRepeatedly(DoAll(SetArgPointee<1>(&item1), Return(S_OK)));
+
+  int32_t value = 40;
+  BYTE *value_bytes = reinterpret_cast<BYTE *>(&value);
+  EXPECT_CALL(debug_process, ReadMemory(items_address, sizeof(value), _, _))
+      .Times(1)
+      .WillRepeatedly(DoAll(
+          SetArrayArgument<2>(value_bytes, value_bytes + sizeof(value)),
+          SetArgPointee<3>(sizeof(value)), Return(S_OK)));
+
+  HRESULT hr = dbgarray.PopulateMembers(&variable, &variable_wrappers,
+                                        &eval_coordinator_);
+  EXPECT_TRUE(SUCCEEDED(hr)) << "Failed with hr: " << hr;
+  ASSERT_EQ(variable_wrappers.size(), 1);
+
+  PopulateTypeAndValue(variable_wrappers);
+
+  EXPECT_EQ(variable.members(0).name(), "[1]");
+  EXPECT_EQ(variable.members(0).value(), "40");
+}
+
 // Tests error case for PopulateMembers function of DbgArray.
 TEST_F(DbgArrayTest, TestPopulateMembersError) {
   SetUpArray();
@@ -376,7 +481,7 @@ TEST_F(DbgArrayTest, TestPopulateMembersError) {
     // function fails.
     EXPECT_EQ(dbgarray.GetInitializeHr(), E_INVALIDARG);
     Variable variable;
-    vector<VariableWrapper> variable_wrappers;
+    VariableWrapperVector variable_wrappers;
     EXPECT_EQ(dbgarray.GetInitializeHr(),
               dbgarray.PopulateMembers(&variable, &variable_wrappers,
                                        &eval_coordinator_));
@@ -386,7 +491,7 @@ TEST_F(DbgArrayTest, TestPopulateMembersError) {
   dbgarray.Initialize(&array_value_, FALSE);
 
   // Should throws error for null variable.
-  vector<VariableWrapper> variable_wrappers;
+  VariableWrapperVector variable_wrappers;
   EXPECT_EQ(
       dbgarray.PopulateMembers(nullptr, &variable_wrappers, &eval_coordinator_),
       E_INVALIDARG);
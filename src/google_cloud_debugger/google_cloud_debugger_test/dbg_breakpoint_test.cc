@@ -29,6 +29,7 @@
 #include "i_stack_frame_collection_mock.h"
 
 using google::cloud::diagnostics::debug::Breakpoint;
+using google_cloud_debugger::CaptureProfile;
 using google_cloud_debugger::CComPtr;
 using google_cloud_debugger::DbgBreakpoint;
 using google_cloud_debugger_portable_pdb::IDocumentIndex;
@@ -297,7 +298,7 @@ TEST_F(DbgBreakpointTest, PopulateBreakpoint) {
 
   EXPECT_CALL(
       stackframe_collection_mock,
-      PopulateStackFrames(&proto_breakpoint, &eval_coordinator_mock_))
+      PopulateStackFrames(&proto_breakpoint, _, &eval_coordinator_mock_))
       .Times(1)
       .WillRepeatedly(Return(S_OK));
 
@@ -311,6 +312,57 @@ TEST_F(DbgBreakpointTest, PopulateBreakpoint) {
   EXPECT_EQ(proto_breakpoint.id(), id_);
 }
 
+// Tests that PopulateBreakpoint only counts the hits from a call stack
+// that was captured within the deduplication window.
+TEST_F(DbgBreakpointTest, PopulateBreakpointStackDedup) {
+  SetUpBreakpoint();
+  CaptureProfile capture_profile;
+  capture_profile.stack_dedup_window_ms = 60000;
+  breakpoint_.SetCaptureProfile(capture_profile);
+
+  IStackFrameCollectionMock stackframe_collection_mock;
+  EXPECT_CALL(stackframe_collection_mock, GetStackFingerprint())
+      .WillRepeatedly(Return(1234));
+  EXPECT_CALL(stackframe_collection_mock, PopulateStackFrames(_, _, _))
+      .Times(1)
+      .WillRepeatedly(Return(S_OK));
+
+  Breakpoint first_hit;
+  HRESULT hr = breakpoint_.PopulateBreakpoint(
+      &first_hit, &stackframe_collection_mock, &eval_coordinator_mock_);
+  EXPECT_TRUE(SUCCEEDED(hr)) << "Failed with hr: " << hr;
+  EXPECT_EQ(first_hit.hit_count(), 1);
+  EXPECT_EQ(first_hit.stack_fingerprint(), 1234);
+
+  // The next hits from the same call stack are only counted.
+  for (std::uint32_t i = 2; i <= 3; ++i) {
+    Breakpoint deduplicated_hit;
+    hr = breakpoint_.PopulateBreakpoint(
+        &deduplicated_hit, &stackframe_collection_mock, &eval_coordinator_mock_);
+    EXPECT_EQ(hr, S_FALSE);
+    EXPECT_EQ(deduplicated_hit.hit_count(), i);
+    EXPECT_EQ(deduplicated_hit.stack_frames_size(), 0);
+  }
+
+  // The window has not ended yet.
+  std::vector<Breakpoint> updates;
+  breakpoint_.TakeHitCountUpdates(false, &updates);
+  EXPECT_TRUE(updates.empty());
+
+  // Removing the breakpoint reports the count of the window.
+  breakpoint_.TakeHitCountUpdates(true, &updates);
+  ASSERT_EQ(updates.size(), 1);
+  EXPECT_EQ(updates[0].id(), id_);
+  EXPECT_EQ(updates[0].location().line(), line_);
+  EXPECT_EQ(updates[0].hit_count(), 3);
+  EXPECT_EQ(updates[0].stack_fingerprint(), 1234);
+
+  // The count is only reported once.
+  updates.clear();
+  breakpoint_.TakeHitCountUpdates(true, &updates);
+  EXPECT_TRUE(updates.empty());
+}
+
 // Tests the error cases of PopulateBreakpoint function of DbgBreakpoint.
 TEST_F(DbgBreakpointTest, PopulateBreakpointError) {
   SetUpBreakpoint();
@@ -332,7 +384,7 @@ TEST_F(DbgBreakpointTest, PopulateBreakpointError) {
   // Makes PopulateStackFrames returns error.
   EXPECT_CALL(
       stackframe_collection_mock,
-      PopulateStackFrames(&proto_breakpoint, &eval_coordinator_mock_))
+      PopulateStackFrames(&proto_breakpoint, _, &eval_coordinator_mock_))
       .Times(1)
       .WillRepeatedly(Return(CORDBG_E_BAD_REFERENCE_VALUE));
 
@@ -373,7 +425,7 @@ TEST_F(DbgBreakpointTest, PopulateBreakpointExpression) {
 
   EXPECT_CALL(
       stackframe_collection_mock,
-      PopulateStackFrames(&proto_breakpoint, &eval_coordinator_mock_))
+      PopulateStackFrames(&proto_breakpoint, _, &eval_coordinator_mock_))
       .Times(1)
       .WillRepeatedly(Return(S_OK));
 
@@ -0,0 +1,672 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "ccomptr.h"
+#include "class_names.h"
+#include "common_action_mocks.h"
+#include "dbg_array.h"
+#include "dbg_builtin_collection.h"
+#include "dbg_primitive.h"
+#include "i_cor_debug_helper_mock.h"
+#include "i_cor_debug_mocks.h"
+#include "i_dbg_object_factory_mock.h"
+#include "i_eval_coordinator_mock.h"
+#include "i_metadata_import_mock.h"
+#include "object_handle_pool.h"
+#include "variable_wrapper.h"
+
+using google::cloud::diagnostics::debug::Variable;
+using google_cloud_debugger::CComPtr;
+using google_cloud_debugger::CollectionWindow;
+using google_cloud_debugger::ConvertWCharPtrToString;
+using google_cloud_debugger::DbgArray;
+using google_cloud_debugger::DbgBuiltinCollection;
+using google_cloud_debugger::DbgObject;
+using google_cloud_debugger::DbgPrimitive;
+using google_cloud_debugger::ObjectHandlePool;
+using google_cloud_debugger::ScopedObjectHandlePool;
+using google_cloud_debugger::VariableWrapper;
+using google_cloud_debugger::VariableWrapperVector;
+using google_cloud_debugger::kArraySegmentClassName;
+using google_cloud_debugger::kConcurrentDictionaryClassName;
+using google_cloud_debugger::kImmutableArrayClassName;
+using google_cloud_debugger::kImmutableListClassName;
+using google_cloud_debugger::kLinkedListClassName;
+using google_cloud_debugger::kQueueClassName;
+using google_cloud_debugger::kSortedDictionaryClassName;
+using google_cloud_debugger::kStackClassName;
+using std::map;
+using std::pair;
+using std::string;
+using std::unique_ptr;
+using std::vector;
+using ::testing::_;
+using ::testing::DoAll;
+using ::testing::HasSubstr;
+using ::testing::Invoke;
+using ::testing::Return;
+using ::testing::SetArgPointee;
+
+namespace google_cloud_debugger_test {
+
+// DbgBuiltinCollection that reads the collection object_value. The value
+// is set directly so the class does not have to be initialized.
+class TestBuiltinCollection : public DbgBuiltinCollection {
+ public:
+  TestBuiltinCollection(
+      const string &class_name, ICorDebugValue *object_value,
+      std::shared_ptr<google_cloud_debugger::ICorDebugHelper> debug_helper,
+      std::shared_ptr<google_cloud_debugger::IDbgObjectFactory> obj_factory)
+      : DbgBuiltinCollection(nullptr, 3, debug_helper, obj_factory) {
+    SetClassName(class_name);
+    deferred_value_ = object_value;
+  }
+};
+
+// Test Fixture for DbgBuiltinCollection.
+// The objects of a collection all have the class debug_class_, whose
+// fields are given tokens by name as they are set. Items of the
+// collections are ints.
+class DbgBuiltinCollectionTest : public ::testing::Test {
+ protected:
+  DbgBuiltinCollectionTest() : scoped_handle_pool_(&handle_pool_) {}
+
+  virtual void SetUp() {
+    // Dereferencing a value returns the value itself, except for
+    // null_reference_.
+    ON_CALL(*debug_helper_, Dereference(_, _, _, _))
+        .WillByDefault(Invoke([](ICorDebugValue *debug_value,
+                                 ICorDebugValue **dereferenced_value,
+                                 BOOL *is_null, std::ostream *err_stream) {
+          *dereferenced_value = debug_value;
+          *is_null = FALSE;
+          return S_OK;
+        }));
+
+    ON_CALL(*debug_helper_,
+            Dereference(static_cast<ICorDebugValue *>(&null_reference_), _, _,
+                        _))
+        .WillByDefault(
+            DoAll(SetArgPointee<1>(static_cast<ICorDebugValue *>(nullptr)),
+                  SetArgPointee<2>(TRUE), Return(S_OK)));
+
+    ON_CALL(*debug_helper_, GetMetadataImportFromICorDebugClass(_, _, _))
+        .WillByDefault(
+            DoAll(SetArgPointee<1>(&metadata_import_), Return(S_OK)));
+
+    ON_CALL(metadata_import_, FindField(_, _, _, _, _))
+        .WillByDefault(Invoke(this, &DbgBuiltinCollectionTest::FindField));
+
+    ON_CALL(debug_class_, GetToken(_))
+        .WillByDefault(DoAll(SetArgPointee<0>(class_token_), Return(S_OK)));
+
+    ON_CALL(debug_type_, GetClass(_))
+        .WillByDefault(DoAll(SetArgPointee<0>(&debug_class_), Return(S_OK)));
+
+    // The class has no base class.
+    ON_CALL(debug_type_, GetBase(_))
+        .WillByDefault(
+            DoAll(SetArgPointee<0>(static_cast<ICorDebugType *>(nullptr)),
+                  Return(S_OK)));
+
+    // Sets up the type of the arrays of ints.
+    ON_CALL(array_type_, GetFirstTypeParameter(_))
+        .WillByDefault(DoAll(SetArgPointee<0>(&item_type_), Return(S_OK)));
+
+    ON_CALL(array_type_, GetRank(_))
+        .WillByDefault(DoAll(SetArgPointee<0>(1), Return(S_OK)));
+
+    ON_CALL(*object_factory_, CreateDbgObjectMockHelper(_, _, _, _))
+        .WillByDefault(
+            Invoke(this, &DbgBuiltinCollectionTest::CreateDbgObject));
+
+    // The arrays do not need an empty object for the type of their items.
+    ON_CALL(*object_factory_, CreateDbgObject(_, _, _))
+        .WillByDefault(Return(S_OK));
+  }
+
+  // Returns the token of the field field_name of debug_class_.
+  mdFieldDef GetFieldDef(const string &field_name) {
+    auto field_def = field_defs_.find(field_name);
+    if (field_def != field_defs_.end()) {
+      return field_def->second;
+    }
+
+    mdFieldDef new_field_def =
+        first_field_def_ + static_cast<mdFieldDef>(field_defs_.size());
+    field_defs_[field_name] = new_field_def;
+    return new_field_def;
+  }
+
+  // Finds the fields of debug_class_ that were set.
+  HRESULT FindField(mdTypeDef class_token, LPCWSTR field_name,
+                    PCCOR_SIGNATURE signature, ULONG signature_len,
+                    mdFieldDef *field_def) {
+    auto found_field = field_defs_.find(ConvertWCharPtrToString(field_name));
+    if (class_token != class_token_ || found_field == field_defs_.end()) {
+      return E_FAIL;
+    }
+
+    *field_def = found_field->second;
+    return S_OK;
+  }
+
+  // Creates a DbgArray for the arrays and a DbgPrimitive for the ints.
+  HRESULT CreateDbgObject(ICorDebugValue *debug_value, int depth,
+                          DbgObject **result_object,
+                          std::ostream *err_stream) {
+    CComPtr<ICorDebugArrayValue> array_value;
+    if (SUCCEEDED(debug_value->QueryInterface(
+            __uuidof(ICorDebugArrayValue),
+            reinterpret_cast<void **>(&array_value)))) {
+      DbgArray *dbg_array =
+          new DbgArray(&array_type_, depth, debug_helper_, object_factory_);
+      dbg_array->Initialize(debug_value, FALSE);
+      *result_object = dbg_array;
+      return S_OK;
+    }
+
+    DbgPrimitive<int32_t> *dbg_int = new DbgPrimitive<int32_t>(
+        static_cast<ICorDebugType *>(nullptr));
+    dbg_int->Initialize(debug_value, FALSE);
+    *result_object = dbg_int;
+    return S_OK;
+  }
+
+  // Returns a new int with value value.
+  ICorDebugGenericValueMock *CreateInt32(int32_t value) {
+    int32_values_.emplace_back(new ICorDebugGenericValueMock());
+    SetUpMockGenericValue(int32_values_.back().get(), value);
+    return int32_values_.back().get();
+  }
+
+  // Returns a new object of class debug_class_.
+  ICorDebugObjectValue2Mock *CreateObject() {
+    objects_.emplace_back(new ICorDebugObjectValue2Mock());
+    ICorDebugObjectValue2Mock *object = objects_.back().get();
+
+    ON_CALL(*object, QueryInterface(_, _))
+        .WillByDefault(Return(E_NOINTERFACE));
+
+    ON_CALL(*object, QueryInterface(__uuidof(ICorDebugObjectValue), _))
+        .WillByDefault(
+            DoAll(SetArgPointee<1>(static_cast<ICorDebugObjectValue *>(object)),
+                  Return(S_OK)));
+
+    ON_CALL(*object, QueryInterface(__uuidof(ICorDebugValue2), _))
+        .WillByDefault(
+            DoAll(SetArgPointee<1>(static_cast<ICorDebugValue2 *>(object)),
+                  Return(S_OK)));
+
+    ON_CALL(*object, GetClass(_))
+        .WillByDefault(DoAll(SetArgPointee<0>(&debug_class_), Return(S_OK)));
+
+    ON_CALL(*object, GetExactType(_))
+        .WillByDefault(DoAll(SetArgPointee<0>(&debug_type_), Return(S_OK)));
+    return object;
+  }
+
+  // Returns a new array with items.
+  ICorDebugArrayValueMock *CreateArray(const vector<ICorDebugValue *> &items) {
+    arrays_.emplace_back(new ICorDebugArrayValueMock());
+    ICorDebugArrayValueMock *array = arrays_.back().get();
+
+    ON_CALL(*array, QueryInterface(_, _)).WillByDefault(Return(E_NOINTERFACE));
+
+    ON_CALL(*array, QueryInterface(__uuidof(ICorDebugArrayValue), _))
+        .WillByDefault(DoAll(SetArgPointee<1>(array), Return(S_OK)));
+
+    ON_CALL(*array, GetCount(_))
+        .WillByDefault(DoAll(
+            SetArgPointee<0>(static_cast<ULONG32>(items.size())),
+            Return(S_OK)));
+
+    for (ULONG32 index = 0; index < items.size(); ++index) {
+      ON_CALL(*array, GetElementAtPosition(index, _))
+          .WillByDefault(
+              DoAll(SetArgPointee<1>(items[index]), Return(S_OK)));
+    }
+    return array;
+  }
+
+  // Returns a new array of ints with values.
+  ICorDebugArrayValueMock *CreateInt32Array(const vector<int32_t> &values) {
+    vector<ICorDebugValue *> items;
+    for (int32_t value : values) {
+      items.push_back(CreateInt32(value));
+    }
+    return CreateArray(items);
+  }
+
+  // Sets the field field_name of object to field_value.
+  void SetField(ICorDebugObjectValue2Mock *object, const string &field_name,
+                ICorDebugValue *field_value) {
+    ON_CALL(*object, GetFieldValue(&debug_class_, GetFieldDef(field_name), _))
+        .WillByDefault(DoAll(SetArgPointee<2>(field_value), Return(S_OK)));
+  }
+
+  // Sets the int field field_name of object to value.
+  void SetInt32Field(ICorDebugObjectValue2Mock *object,
+                     const string &field_name, int32_t value) {
+    SetField(object, field_name, CreateInt32(value));
+  }
+
+  // Returns a new node of a LinkedList with item value. The next field
+  // of the node is set by the caller.
+  ICorDebugObjectValue2Mock *CreateLinkedListNode(int32_t value) {
+    ICorDebugObjectValue2Mock *node = CreateObject();
+    SetInt32Field(node, "item", value);
+    return node;
+  }
+
+  // Returns a new LinkedList with count items whose values are
+  // 1 to item_count. nodes is set to the nodes of the list.
+  ICorDebugObjectValue2Mock *CreateLinkedList(
+      int32_t item_count, vector<ICorDebugObjectValue2Mock *> *nodes) {
+    for (int32_t index = 0; index < item_count; ++index) {
+      nodes->push_back(CreateLinkedListNode(index + 1));
+    }
+
+    // The list is circular.
+    for (int32_t index = 0; index < item_count; ++index) {
+      SetField((*nodes)[index], "next", (*nodes)[(index + 1) % item_count]);
+    }
+
+    ICorDebugObjectValue2Mock *linked_list = CreateObject();
+    SetInt32Field(linked_list, "count", item_count);
+    SetField(linked_list, "head", (*nodes)[0]);
+    return linked_list;
+  }
+
+  // Returns a new node of an ImmutableList with item value, left and
+  // right subtrees and count items in its tree.
+  ICorDebugObjectValue2Mock *CreateImmutableListNode(
+      int32_t value, int32_t count, ICorDebugValue *left,
+      ICorDebugValue *right) {
+    ICorDebugObjectValue2Mock *node = CreateObject();
+    SetInt32Field(node, "_key", value);
+    SetInt32Field(node, "_count", count);
+    SetField(node, "_left", left);
+    SetField(node, "_right", right);
+    return node;
+  }
+
+  // Returns an ImmutableList with items 1, 2 and 3. The tree of the list
+  // has 2 at its root. leaf is set to the node of item 1.
+  ICorDebugObjectValue2Mock *CreateImmutableList(
+      ICorDebugObjectValue2Mock **leaf) {
+    // The leaves of the tree point to an empty node.
+    ICorDebugObjectValue2Mock *empty_node = CreateObject();
+    SetField(empty_node, "_left", &null_reference_);
+
+    *leaf = CreateImmutableListNode(1, 1, empty_node, empty_node);
+    ICorDebugObjectValue2Mock *root = CreateImmutableListNode(
+        2, 3, *leaf, CreateImmutableListNode(3, 1, empty_node, empty_node));
+
+    ICorDebugObjectValue2Mock *immutable_list = CreateObject();
+    SetField(immutable_list, "_root", root);
+    return immutable_list;
+  }
+
+  // Returns a new collection of class class_name for object.
+  unique_ptr<DbgBuiltinCollection> CreateCollection(
+      const string &class_name, ICorDebugObjectValue2Mock *object) {
+    return unique_ptr<DbgBuiltinCollection>(new TestBuiltinCollection(
+        class_name, object, debug_helper_, object_factory_));
+  }
+
+  // Populates the members of collection into variable_ and populates
+  // the types and values of the items.
+  HRESULT PopulateCollection(DbgBuiltinCollection *collection) {
+    HRESULT hr = collection->PopulateMembers(&variable_, &members_,
+                                             &eval_coordinator_);
+    if (SUCCEEDED(hr)) {
+      PopulateTypeAndValue(members_);
+    }
+    return hr;
+  }
+
+  // Checks that variable_ has the count of the collection and items.
+  void CheckItems(int32_t count, const vector<string> &items) {
+    ASSERT_EQ(variable_.members_size(), static_cast<int>(items.size()) + 1);
+    EXPECT_EQ(variable_.members(0).name(), "Count");
+    EXPECT_EQ(variable_.members(0).value(), std::to_string(count));
+    for (size_t index = 0; index < items.size(); ++index) {
+      const Variable &item = variable_.members(index + 1);
+      EXPECT_EQ(item.name(), "[" + std::to_string(index) + "]");
+      EXPECT_EQ(item.value(), items[index]);
+    }
+  }
+
+  // Checks that variable_ has the count of the dictionary and items,
+  // the keys and values of the dictionary.
+  void CheckKeyValueItems(int32_t count,
+                          const vector<pair<string, string>> &items) {
+    ASSERT_EQ(variable_.members_size(), static_cast<int>(items.size()) + 1);
+    EXPECT_EQ(variable_.members(0).name(), "Count");
+    EXPECT_EQ(variable_.members(0).value(), std::to_string(count));
+    for (size_t index = 0; index < items.size(); ++index) {
+      const Variable &item = variable_.members(index + 1);
+      EXPECT_EQ(item.name(), "[" + std::to_string(index) + "]");
+      ASSERT_EQ(item.members_size(), 2);
+      EXPECT_EQ(item.members(0).name(), "key");
+      EXPECT_EQ(item.members(0).value(), items[index].first);
+      EXPECT_EQ(item.members(1).name(), "value");
+      EXPECT_EQ(item.members(1).value(), items[index].second);
+    }
+  }
+
+  // Arrays keep their ICorDebugValue instead of creating a strong
+  // handle while a pool is current.
+  ObjectHandlePool handle_pool_;
+  ScopedObjectHandlePool scoped_handle_pool_;
+
+  std::shared_ptr<ICorDebugHelperMock> debug_helper_ =
+      std::make_shared<ICorDebugHelperMock>();
+  std::shared_ptr<IDbgObjectFactoryMock> object_factory_ =
+      std::make_shared<IDbgObjectFactoryMock>();
+  IEvalCoordinatorMock eval_coordinator_;
+  IMetaDataImportMock metadata_import_;
+
+  // Class and type of all the objects.
+  ICorDebugClassMock debug_class_;
+  ICorDebugTypeMock debug_type_;
+  mdTypeDef class_token_ = 100;
+
+  // Type of the arrays and of their items.
+  ICorDebugTypeMock array_type_;
+  ICorDebugTypeMock item_type_;
+
+  // Tokens of the fields that were set, by name.
+  map<string, mdFieldDef> field_defs_;
+  mdFieldDef first_field_def_ = 200;
+
+  // Value of the fields that are null.
+  ICorDebugReferenceValueMock null_reference_;
+
+  // Values created by the tests.
+  vector<unique_ptr<ICorDebugGenericValueMock>> int32_values_;
+  vector<unique_ptr<ICorDebugObjectValue2Mock>> objects_;
+  vector<unique_ptr<ICorDebugArrayValueMock>> arrays_;
+
+  // Populated collection.
+  Variable variable_;
+  VariableWrapperVector members_;
+};
+
+// Tests that the items of a Queue are read from its head and wrap around
+// at the end of its array.
+TEST_F(DbgBuiltinCollectionTest, TestQueue) {
+  ICorDebugObjectValue2Mock *queue = CreateObject();
+  SetField(queue, "_array", CreateInt32Array({10, 20, 30, 40}));
+  SetInt32Field(queue, "_head", 2);
+  SetInt32Field(queue, "_size", 3);
+
+  unique_ptr<DbgBuiltinCollection> collection =
+      CreateCollection(kQueueClassName, queue);
+  EXPECT_EQ(PopulateCollection(collection.get()), S_OK);
+  CheckItems(3, {"30", "40", "10"});
+}
+
+// Tests that the items of a Stack are read from its top and that only
+// the items counted by the stack are read from its array.
+TEST_F(DbgBuiltinCollectionTest, TestStack) {
+  ICorDebugArrayValueMock *array = CreateInt32Array({10, 20, 30, 40});
+  EXPECT_CALL(*array, GetElementAtPosition(3, _)).Times(0);
+
+  ICorDebugObjectValue2Mock *stack = CreateObject();
+  SetField(stack, "_array", array);
+  SetInt32Field(stack, "_size", 3);
+
+  unique_ptr<DbgBuiltinCollection> collection =
+      CreateCollection(kStackClassName, stack);
+  EXPECT_EQ(PopulateCollection(collection.get()), S_OK);
+  CheckItems(3, {"30", "20", "10"});
+}
+
+// Tests that the nodes of a LinkedList are read once even though the
+// list is circular.
+TEST_F(DbgBuiltinCollectionTest, TestLinkedList) {
+  vector<ICorDebugObjectValue2Mock *> nodes;
+  ICorDebugObjectValue2Mock *linked_list = CreateLinkedList(3, &nodes);
+
+  unique_ptr<DbgBuiltinCollection> collection =
+      CreateCollection(kLinkedListClassName, linked_list);
+  EXPECT_EQ(PopulateCollection(collection.get()), S_OK);
+  CheckItems(3, {"1", "2", "3"});
+}
+
+// Tests that the KeyValuePairs of a SortedDictionary are read in order
+// from the tree of its SortedSet.
+TEST_F(DbgBuiltinCollectionTest, TestSortedDictionary) {
+  vector<ICorDebugObjectValue2Mock *> nodes;
+  for (int32_t key = 1; key <= 3; ++key) {
+    ICorDebugObjectValue2Mock *pair = CreateObject();
+    SetInt32Field(pair, "key", key);
+    SetInt32Field(pair, "value", key * 100);
+
+    ICorDebugObjectValue2Mock *node = CreateObject();
+    SetField(node, "Item", pair);
+    SetField(node, "Left", &null_reference_);
+    SetField(node, "Right", &null_reference_);
+    nodes.push_back(node);
+  }
+
+  // The root of the tree is the node of key 2.
+  SetField(nodes[1], "Left", nodes[0]);
+  SetField(nodes[1], "Right", nodes[2]);
+
+  ICorDebugObjectValue2Mock *sorted_set = CreateObject();
+  SetInt32Field(sorted_set, "count", 3);
+  SetField(sorted_set, "root", nodes[1]);
+
+  ICorDebugObjectValue2Mock *sorted_dictionary = CreateObject();
+  SetField(sorted_dictionary, "_set", sorted_set);
+
+  unique_ptr<DbgBuiltinCollection> collection =
+      CreateCollection(kSortedDictionaryClassName, sorted_dictionary);
+  EXPECT_EQ(PopulateCollection(collection.get()), S_OK);
+  CheckKeyValueItems(3, {{"1", "100"}, {"2", "200"}, {"3", "300"}});
+}
+
+// Tests that the items of a ConcurrentDictionary are read from the lists
+// of its buckets, that its count is the sum of the counts of its locks
+// and that the buckets after the last item are not read.
+TEST_F(DbgBuiltinCollectionTest, TestConcurrentDictionary) {
+  vector<ICorDebugObjectValue2Mock *> nodes;
+  for (int32_t key = 1; key <= 4; ++key) {
+    ICorDebugObjectValue2Mock *node = CreateObject();
+    SetInt32Field(node, "_key", key);
+    SetInt32Field(node, "_value", key * 100);
+    SetField(node, "_next", &null_reference_);
+    nodes.push_back(node);
+  }
+
+  // The first bucket has 2 items and the second one is empty.
+  SetField(nodes[0], "_next", nodes[1]);
+  ICorDebugArrayValueMock *buckets =
+      CreateArray({nodes[0], &null_reference_, nodes[2], nodes[3]});
+  EXPECT_CALL(*buckets, GetElementAtPosition(3, _)).Times(0);
+
+  ICorDebugObjectValue2Mock *tables = CreateObject();
+  SetField(tables, "_buckets", buckets);
+  SetField(tables, "_countPerLock", CreateInt32Array({2, 1}));
+
+  ICorDebugObjectValue2Mock *concurrent_dictionary = CreateObject();
+  SetField(concurrent_dictionary, "_tables", tables);
+
+  unique_ptr<DbgBuiltinCollection> collection =
+      CreateCollection(kConcurrentDictionaryClassName, concurrent_dictionary);
+  EXPECT_EQ(PopulateCollection(collection.get()), S_OK);
+  CheckKeyValueItems(3, {{"1", "100"}, {"2", "200"}, {"3", "300"}});
+}
+
+// Tests that the items of an ImmutableArray are the items of its array.
+TEST_F(DbgBuiltinCollectionTest, TestImmutableArray) {
+  ICorDebugObjectValue2Mock *immutable_array = CreateObject();
+  SetField(immutable_array, "array", CreateInt32Array({5, 6, 7}));
+
+  unique_ptr<DbgBuiltinCollection> collection =
+      CreateCollection(kImmutableArrayClassName, immutable_array);
+  EXPECT_EQ(PopulateCollection(collection.get()), S_OK);
+  CheckItems(3, {"5", "6", "7"});
+}
+
+// Tests that a default ImmutableArray, whose array is null, is empty.
+TEST_F(DbgBuiltinCollectionTest, TestDefaultImmutableArray) {
+  ICorDebugObjectValue2Mock *immutable_array = CreateObject();
+  SetField(immutable_array, "array", &null_reference_);
+
+  unique_ptr<DbgBuiltinCollection> collection =
+      CreateCollection(kImmutableArrayClassName, immutable_array);
+  EXPECT_EQ(PopulateCollection(collection.get()), S_OK);
+  CheckItems(0, {});
+}
+
+// Tests that the items of an ImmutableList are read in order from its
+// tree and that the empty nodes are not items.
+TEST_F(DbgBuiltinCollectionTest, TestImmutableList) {
+  ICorDebugObjectValue2Mock *leaf;
+  ICorDebugObjectValue2Mock *immutable_list = CreateImmutableList(&leaf);
+
+  unique_ptr<DbgBuiltinCollection> collection =
+      CreateCollection(kImmutableListClassName, immutable_list);
+  EXPECT_EQ(PopulateCollection(collection.get()), S_OK);
+  CheckItems(3, {"1", "2", "3"});
+}
+
+// Tests that the subtrees of an ImmutableList before the window of the
+// collection are skipped without reading their items.
+TEST_F(DbgBuiltinCollectionTest, TestImmutableListWindow) {
+  ICorDebugObjectValue2Mock *leaf;
+  ICorDebugObjectValue2Mock *immutable_list = CreateImmutableList(&leaf);
+  EXPECT_CALL(*leaf, GetFieldValue(_, GetFieldDef("_key"), _)).Times(0);
+
+  unique_ptr<DbgBuiltinCollection> collection =
+      CreateCollection(kImmutableListClassName, immutable_list);
+  CollectionWindow window;
+  window.first_item = 1;
+  EXPECT_EQ(collection->SetCollectionWindow(window), S_OK);
+  EXPECT_EQ(PopulateCollection(collection.get()), S_OK);
+
+  ASSERT_EQ(variable_.members_size(), 3);
+  EXPECT_EQ(variable_.members(0).value(), "3");
+  EXPECT_EQ(variable_.members(1).name(), "[1]");
+  EXPECT_EQ(variable_.members(1).value(), "2");
+  EXPECT_EQ(variable_.members(2).name(), "[2]");
+  EXPECT_EQ(variable_.members(2).value(), "3");
+}
+
+// Tests that the items of an ArraySegment are the items of its array
+// from its offset.
+TEST_F(DbgBuiltinCollectionTest, TestArraySegment) {
+  ICorDebugObjectValue2Mock *array_segment = CreateObject();
+  SetField(array_segment, "_array", CreateInt32Array({1, 2, 3, 4, 5}));
+  SetInt32Field(array_segment, "_offset", 1);
+  SetInt32Field(array_segment, "_count", 3);
+
+  unique_ptr<DbgBuiltinCollection> collection =
+      CreateCollection(kArraySegmentClassName, array_segment);
+  EXPECT_EQ(PopulateCollection(collection.get()), S_OK);
+  CheckItems(3, {"2", "3", "4"});
+}
+
+// Tests that a collection fails to populate if one of the fields its
+// decoder reads was renamed.
+TEST_F(DbgBuiltinCollectionTest, TestRenamedField) {
+  ICorDebugObjectValue2Mock *stack = CreateObject();
+  SetField(stack, "_array", CreateInt32Array({10, 20}));
+  SetInt32Field(stack, "_count", 2);
+
+  unique_ptr<DbgBuiltinCollection> collection =
+      CreateCollection(kStackClassName, stack);
+  EXPECT_TRUE(FAILED(PopulateCollection(collection.get())));
+  EXPECT_THAT(collection->GetErrorString(),
+              HasSubstr("does not have field _size"));
+  EXPECT_TRUE(members_.empty());
+}
+
+// Tests that a field is read from the backing field of the property
+// with its name.
+TEST_F(DbgBuiltinCollectionTest, TestPropertyBackingField) {
+  ICorDebugObjectValue2Mock *node = CreateLinkedListNode(7);
+  SetField(node, "next", node);
+
+  ICorDebugObjectValue2Mock *linked_list = CreateObject();
+  SetInt32Field(linked_list, "<count>k__BackingField", 1);
+  SetField(linked_list, "head", node);
+
+  unique_ptr<DbgBuiltinCollection> collection =
+      CreateCollection(kLinkedListClassName, linked_list);
+  EXPECT_EQ(PopulateCollection(collection.get()), S_OK);
+  CheckItems(1, {"7"});
+}
+
+// Tests that no more than the maximum collection size of DbgBreakpoint
+// items are read from the array of a collection.
+TEST_F(DbgBuiltinCollectionTest, TestMaximumCollectionSize) {
+  vector<int32_t> values;
+  vector<string> items;
+  for (int32_t value = 0; value < 12; ++value) {
+    values.push_back(value);
+    if (value < 10) {
+      items.push_back(std::to_string(value));
+    }
+  }
+
+  ICorDebugArrayValueMock *array = CreateInt32Array(values);
+  EXPECT_CALL(*array, GetElementAtPosition(10, _)).Times(0);
+  EXPECT_CALL(*array, GetElementAtPosition(11, _)).Times(0);
+
+  ICorDebugObjectValue2Mock *queue = CreateObject();
+  SetField(queue, "_array", array);
+  SetInt32Field(queue, "_head", 0);
+  SetInt32Field(queue, "_size", 12);
+
+  unique_ptr<DbgBuiltinCollection> collection =
+      CreateCollection(kQueueClassName, queue);
+  EXPECT_EQ(PopulateCollection(collection.get()), S_OK);
+  CheckItems(12, items);
+}
+
+// Tests that the decoders stop reading the nodes of a collection once
+// they read the maximum collection size of DbgBreakpoint items.
+TEST_F(DbgBuiltinCollectionTest, TestMaximumCollectionSizeNodes) {
+  vector<ICorDebugObjectValue2Mock *> nodes;
+  ICorDebugObjectValue2Mock *linked_list = CreateLinkedList(12, &nodes);
+  EXPECT_CALL(*nodes[10], GetFieldValue(_, _, _)).Times(0);
+  EXPECT_CALL(*nodes[11], GetFieldValue(_, _, _)).Times(0);
+
+  vector<string> items;
+  for (int32_t value = 1; value <= 10; ++value) {
+    items.push_back(std::to_string(value));
+  }
+
+  unique_ptr<DbgBuiltinCollection> collection =
+      CreateCollection(kLinkedListClassName, linked_list);
+  EXPECT_EQ(PopulateCollection(collection.get()), S_OK);
+  CheckItems(12, items);
+}
+
+}  // namespace google_cloud_debugger_test
@@ -23,6 +23,7 @@
 #include "cor_debug_helper.h"
 #include "dbg_class_property.h"
 #include "dbg_object_factory.h"
+#include "dbg_primitive.h"
 #include "i_cor_debug_mocks.h"
 #include "i_eval_coordinator_mock.h"
 #include "i_metadata_import_mock.h"
@@ -32,7 +33,9 @@ using google_cloud_debugger::CComPtr;
 using google_cloud_debugger::ConvertStringToWCharPtr;
 using google_cloud_debugger::CorDebugHelper;
 using google_cloud_debugger::DbgClassProperty;
+using google_cloud_debugger::DbgObject;
 using google_cloud_debugger::DbgObjectFactory;
+using google_cloud_debugger::DbgPrimitive;
 using google_cloud_debugger::ICorDebugHelper;
 using google_cloud_debugger::IDbgObjectFactory;
 using std::string;
@@ -45,6 +48,33 @@ using ::testing::SetArrayArgument;
 
 namespace google_cloud_debugger_test {
 
+// Object that properties are evaluated on, whose value is a strong handle.
+class FakeHandleObject : public DbgObject {
+ public:
+  FakeHandleObject(CORDB_ADDRESS address, std::uint64_t address_eval_count,
+                   ICorDebugValue *handle)
+      : DbgObject(nullptr, 0, std::shared_ptr<ICorDebugHelper>()),
+        handle_(handle) {
+    SetAddress(address, address_eval_count);
+  }
+
+  virtual void Initialize(ICorDebugValue *debug_value, BOOL is_null) override {}
+
+  virtual HRESULT GetTypeString(std::string *type_string) override {
+    return E_NOTIMPL;
+  }
+
+  virtual HRESULT GetICorDebugValue(ICorDebugValue **debug_value,
+                                    ICorDebugEval *debug_eval) override {
+    *debug_value = handle_;
+    handle_->AddRef();
+    return S_OK;
+  }
+
+ private:
+  ICorDebugValue *handle_;
+};
+
 // Test Fixture for DbgClassField.
 class DbgClassPropertyTest : public ::testing::Test {
  protected:
@@ -140,6 +170,9 @@ class DbgClassPropertyTest : public ::testing::Test {
   // Reference to the object_value_.
   ICorDebugReferenceValueMock reference_value_;
 
+  // Strong handle to the object the property is evaluated on.
+  ICorDebugHandleValueMock handle_value_;
+
   // Object represents the value of this property.
   ICorDebugGenericValueMock generic_value_;
 
@@ -311,6 +344,74 @@ TEST_F(DbgClassPropertyTest, TestPopulateVariableValueStaticGeneric) {
   EXPECT_EQ(variable.value(), std::to_string(property_value_));
 }
 
+// Tests that Evaluate reuses the property value cached in the
+// IEvalCoordinator for the same object instead of evaluating the getter.
+TEST_F(DbgClassPropertyTest, TestEvaluateUsesCachedValue) {
+  SetUpProperty();
+
+  CORDB_ADDRESS object_address = 0x1000;
+  std::uint64_t address_eval_count = 3;
+  CORDB_ADDRESS module_address = 0x2000;
+  std::shared_ptr<DbgObject> cached_value(
+      new DbgPrimitive<int32_t>(property_value_));
+  vector<CComPtr<ICorDebugType>> generic_types;
+  FakeHandleObject object(object_address, address_eval_count,
+                          &handle_value_);
+  class_property_->SetObject(&object);
+
+  EXPECT_CALL(debug_module_, GetBaseAddress(_))
+      .WillRepeatedly(DoAll(SetArgPointee<0>(module_address), Return(S_OK)));
+  EXPECT_CALL(eval_coordinator_mock_,
+              GetCachedPropertyValue(&reference_value_, object_address,
+                                     address_eval_count, module_address, _))
+      .Times(1)
+      .WillRepeatedly(Return(cached_value));
+
+  // No function evaluation should happen.
+  EXPECT_CALL(eval_coordinator_mock_, CreateEval(_)).Times(0);
+  EXPECT_CALL(eval_coordinator_mock_, CachePropertyValue(_, _, _, _))
+      .Times(0);
+
+  EXPECT_EQ(class_property_->Evaluate(&reference_value_,
+                                      &eval_coordinator_mock_, &generic_types),
+            S_OK);
+  EXPECT_EQ(class_property_->GetMemberValue(), cached_value);
+}
+
+// Tests that Evaluate stores the evaluated property value in the
+// IEvalCoordinator cache under the handle of the object.
+TEST_F(DbgClassPropertyTest, TestEvaluateCachesValue) {
+  SetUpProperty();
+  SetUpPropertyValue();
+
+  CORDB_ADDRESS object_address = 0x1000;
+  std::uint64_t address_eval_count = 3;
+  CORDB_ADDRESS module_address = 0x2000;
+  vector<CComPtr<ICorDebugType>> generic_types;
+  FakeHandleObject object(object_address, address_eval_count,
+                          &handle_value_);
+  class_property_->SetObject(&object);
+
+  EXPECT_CALL(debug_module_, GetBaseAddress(_))
+      .WillRepeatedly(DoAll(SetArgPointee<0>(module_address), Return(S_OK)));
+  EXPECT_CALL(eval_coordinator_mock_,
+              GetCachedPropertyValue(&reference_value_, object_address,
+                                     address_eval_count, module_address, _))
+      .Times(1)
+      .WillRepeatedly(Return(std::shared_ptr<DbgObject>()));
+  EXPECT_CALL(debug_eval2_, CallParameterizedFunction(_, 0, _, 1, _))
+      .Times(1)
+      .WillRepeatedly(Return(S_OK));
+  EXPECT_CALL(eval_coordinator_mock_,
+              CachePropertyValue(&handle_value_, module_address, _, _))
+      .Times(1);
+
+  EXPECT_EQ(class_property_->Evaluate(&reference_value_,
+                                      &eval_coordinator_mock_, &generic_types),
+            S_OK);
+  EXPECT_TRUE(class_property_->GetMemberValue() != nullptr);
+}
+
 // Tests the PopulateVariableValue function of DbgClassProperty.
 TEST_F(DbgClassPropertyTest, TestPopulateVariableValueError) {
   SetUpProperty();
@@ -35,6 +35,7 @@ using google_cloud_debugger::DbgClass;
 using google_cloud_debugger::DbgObject;
 using google_cloud_debugger::DbgObjectFactory;
 using google_cloud_debugger::VariableWrapper;
+using google_cloud_debugger::VariableWrapperVector;
 using std::string;
 using std::unique_ptr;
 using std::vector;
@@ -586,7 +587,7 @@ TEST_F(DbgClassTest, TestPopulateMembers) {
   SetUpClassProperty();
 
   Variable variable;
-  vector<VariableWrapper> variable_wrappers;
+  VariableWrapperVector variable_wrappers;
   unique_ptr<DbgObject> dbgclass;
   std::ostringstream err_stream;
   HRESULT hr = object_factory_.CreateDbgClassObject(
@@ -654,7 +655,7 @@ TEST_F(DbgClassTest, TestPopulateMembersBackingField) {
   SetUpClassProperty();
 
   Variable variable;
-  vector<VariableWrapper> variable_wrappers;
+  VariableWrapperVector variable_wrappers;
   unique_ptr<DbgObject> dbgclass;
   std::ostringstream err_stream;
   HRESULT hr = object_factory_.CreateDbgClassObject(
@@ -694,7 +695,7 @@ TEST_F(DbgClassTest, TestPopulateMembersError) {
   SetUpClassProperty();
 
   Variable variable;
-  vector<VariableWrapper> variable_wrappers;
+  VariableWrapperVector variable_wrappers;
   unique_ptr<DbgObject> dbgclass;
   std::ostringstream err_stream;
   HRESULT hr = object_factory_.CreateDbgClassObject(
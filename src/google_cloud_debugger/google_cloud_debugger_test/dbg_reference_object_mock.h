@@ -42,7 +42,7 @@ class DbgReferenceObjectMock
   MOCK_METHOD3(
       PopulateMembers,
       HRESULT(google::cloud::diagnostics::debug::Variable *variable_proto,
-              std::vector<google_cloud_debugger::VariableWrapper> *members,
+              google_cloud_debugger::VariableWrapperVector *members,
               google_cloud_debugger::IEvalCoordinator *eval_coordinator));
   MOCK_METHOD2(GetICorDebugValue, HRESULT(ICorDebugValue **debug_value,
                                           ICorDebugEval *debug_eval));
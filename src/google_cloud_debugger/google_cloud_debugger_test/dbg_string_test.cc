@@ -19,11 +19,13 @@
 #include "class_names.h"
 #include "common_action_mocks.h"
 #include "cor_debug_helper.h"
+#include "dbg_breakpoint.h"
 #include "i_cor_debug_mocks.h"
 
 using google::cloud::diagnostics::debug::Variable;
 using google_cloud_debugger::ConvertStringToWCharPtr;
 using google_cloud_debugger::CorDebugHelper;
+using google_cloud_debugger::DbgBreakpoint;
 using google_cloud_debugger::DbgString;
 using google_cloud_debugger::ICorDebugHelper;
 using std::string;
@@ -146,6 +148,52 @@ TEST_F(DbgStringTest, GetString) {
   EXPECT_EQ(returned_string, test_string_value);
 }
 
+// Tests that PopulateValue only reads the start of a string that is
+// longer than the maximum string length, while GetString still returns
+// the whole string.
+TEST_F(DbgStringTest, PopulateValueTruncated) {
+  uint32_t max_length = DbgBreakpoint::GetMaximumStringLength();
+  uint32_t string_length = max_length + 100;
+  string test_string_value(string_length, 'a');
+  vector<WCHAR> wchar_string = ConvertStringToWCharPtr(test_string_value);
+
+  EXPECT_CALL(string_value_, GetLength(_))
+      .Times(2)
+      .WillRepeatedly(DoAll(SetArgPointee<0>(string_length), Return(S_OK)));
+
+  // Only the prefix is read for the variable.
+  EXPECT_CALL(string_value_, GetString(max_length + 1, _, _))
+      .Times(1)
+      .WillRepeatedly(
+          DoAll(SetArrayArgument<2>(wchar_string.data(),
+                                    wchar_string.data() + max_length + 1),
+                Return(S_OK)));
+  EXPECT_CALL(string_value_, GetString(string_length + 1, _, _))
+      .Times(1)
+      .WillRepeatedly(
+          DoAll(SetArrayArgument<2>(wchar_string.data(),
+                                    wchar_string.data() + string_length + 1),
+                Return(S_OK)));
+
+  DbgString dbg_string(nullptr, debug_helper_);
+  SetUpString();
+  dbg_string.Initialize(&string_value_, FALSE);
+
+  Variable variable;
+  EXPECT_EQ(dbg_string.PopulateValue(&variable), S_OK);
+  EXPECT_EQ(variable.value(), string(max_length, 'a'));
+  EXPECT_TRUE(dbg_string.IsTruncated());
+  EXPECT_EQ(dbg_string.GetOriginalLength(), string_length);
+  EXPECT_FALSE(variable.status().iserror());
+  EXPECT_NE(variable.status().message().find(std::to_string(string_length)),
+            string::npos);
+
+  std::string returned_string;
+  EXPECT_EQ(DbgString::GetString(&dbg_string, &returned_string), S_OK);
+  EXPECT_EQ(returned_string, test_string_value);
+  EXPECT_FALSE(dbg_string.IsTruncated());
+}
+
 // Tests error cases for GetString.
 TEST_F(DbgStringTest, GetStringError) {
   static const string test_string_value = "This is a test string";
@@ -0,0 +1,112 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "enum_table.h"
+
+using google_cloud_debugger::EnumTable;
+using google_cloud_debugger::EnumTableCache;
+using google_cloud_debugger::FieldLayout;
+using std::shared_ptr;
+using std::string;
+using std::vector;
+
+namespace google_cloud_debugger_test {
+
+// Fixture for the tests of EnumTable. The enum is
+// [Flags] enum Access { None = 0, Read = 1, Write = 2, ReadWrite = 3,
+// Read2 = 1, Execute = 4 }.
+class EnumTableTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    FieldLayout value_field;
+    value_field.name = "value__";
+    value_field.signature = &value_type_;
+    fields_.push_back(value_field);
+
+    AddConstant("None", &values_[0]);
+    AddConstant("Read", &values_[1]);
+    AddConstant("Write", &values_[2]);
+    AddConstant("ReadWrite", &values_[3]);
+    AddConstant("Read2", &values_[1]);
+    AddConstant("Execute", &values_[4]);
+  }
+
+  // Adds a static field named name with constant value.
+  void AddConstant(const string &name, const int32_t *value) {
+    FieldLayout field;
+    field.name = name;
+    field.attributes = fdStatic | fdLiteral;
+    field.default_value = value;
+    fields_.push_back(field);
+  }
+
+  // Underlying type of the enum.
+  COR_SIGNATURE value_type_ = CorElementType::ELEMENT_TYPE_I4;
+
+  // Values of the constants of the enum.
+  int32_t values_[5] = {0, 1, 2, 3, 4};
+
+  // Fields of the enum.
+  vector<FieldLayout> fields_;
+};
+
+// Tests that values that are constants get the name of the first
+// constant with that value.
+TEST_F(EnumTableTest, ConstantNames) {
+  EnumTable enum_table(fields_);
+  EXPECT_EQ(enum_table.GetEnumType(), CorElementType::ELEMENT_TYPE_I4);
+  EXPECT_EQ(enum_table.GetValueName(0), "None");
+  EXPECT_EQ(enum_table.GetValueName(1), "Read");
+  EXPECT_EQ(enum_table.GetValueName(3), "ReadWrite");
+  EXPECT_EQ(enum_table.GetValueName(4), "Execute");
+}
+
+// Tests that other values are decomposed into the constants
+// whose bits make them up.
+TEST_F(EnumTableTest, FlagNames) {
+  EnumTable enum_table(fields_);
+  EXPECT_EQ(enum_table.GetValueName(5), "Read | Execute");
+  EXPECT_EQ(enum_table.GetValueName(7), "Read | Write | Execute");
+  EXPECT_EQ(enum_table.GetValueName(8), "");
+}
+
+// Tests that an enum without a value__ field has no type and no names.
+TEST_F(EnumTableTest, NoValueField) {
+  fields_.erase(fields_.begin());
+  EnumTable enum_table(fields_);
+  EXPECT_EQ(enum_table.GetEnumType(), CorElementType::ELEMENT_TYPE_END);
+  EXPECT_EQ(enum_table.GetValueName(1), "");
+}
+
+// Tests that tables are cached by module MVID and enum token.
+TEST_F(EnumTableTest, AddAndGetTable) {
+  EnumTableCache table_cache;
+  shared_ptr<EnumTable> enum_table(new EnumTable(fields_));
+
+  EXPECT_EQ(table_cache.GetTable("module", 100), nullptr);
+  table_cache.AddTable("module", 100, enum_table);
+
+  EXPECT_EQ(table_cache.GetTable("module", 100), enum_table);
+  EXPECT_EQ(table_cache.GetTable("module", 101), nullptr);
+  EXPECT_EQ(table_cache.GetTable("other_module", 100), nullptr);
+}
+
+}  // namespace google_cloud_debugger_test
@@ -0,0 +1,65 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#include "eval_completion_channel.h"
+
+using google_cloud_debugger::EvalCompletionChannel;
+using std::chrono::milliseconds;
+using std::chrono::minutes;
+using std::chrono::steady_clock;
+
+namespace google_cloud_debugger_test {
+
+// Tests that each side consumes the token posted by the other.
+TEST(EvalCompletionChannelTest, Handoff) {
+  EvalCompletionChannel channel;
+  std::thread debugger_callback_thread([&]() {
+    channel.WaitForCaptureThread();
+    channel.SignalEvalComplete();
+  });
+
+  channel.SignalDebuggerCallback();
+  EXPECT_TRUE(channel.WaitForEvalComplete(steady_clock::now() + minutes(1)));
+  debugger_callback_thread.join();
+}
+
+// Tests that a timed out wait clears the token of the debugger callback
+// thread, so a late EvalComplete still waits for the capture thread.
+TEST(EvalCompletionChannelTest, TimeOutClearsToken) {
+  EvalCompletionChannel channel;
+  channel.SignalDebuggerCallback();
+  EXPECT_FALSE(
+      channel.WaitForEvalComplete(steady_clock::now() + milliseconds(10)));
+
+  std::atomic<bool> debugger_callback_continued(false);
+  std::thread debugger_callback_thread([&]() {
+    channel.SignalEvalComplete();
+    channel.WaitForCaptureThread();
+    debugger_callback_continued = true;
+  });
+
+  std::this_thread::sleep_for(milliseconds(100));
+  EXPECT_FALSE(debugger_callback_continued);
+
+  channel.SignalDebuggerCallback();
+  debugger_callback_thread.join();
+  EXPECT_TRUE(debugger_callback_continued);
+}
+
+}  // namespace google_cloud_debugger_test
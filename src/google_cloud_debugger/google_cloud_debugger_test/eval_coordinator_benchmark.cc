@@ -0,0 +1,95 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Micro-benchmark of the handoff between the thread capturing a
+// breakpoint and the debugger callback thread for function evaluations.
+// It is built as its own binary (make eval_coordinator_benchmark) and is
+// not part of the unit tests since it only reports a throughput.
+//
+// Each eval returns CORDBG_E_FUNC_EVAL_NOT_COMPLETE on the first
+// GetResult call so every eval goes through one round trip of
+// WaitForEval and SignalFinishedEval.
+//
+// Usage: eval_coordinator_benchmark [number_of_evals]
+
+#include <gmock/gmock.h>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+#include "ccomptr.h"
+#include "eval_coordinator.h"
+#include "i_cor_debug_mocks.h"
+
+using ::testing::_;
+using ::testing::Invoke;
+using ::testing::NiceMock;
+using google_cloud_debugger::CComPtr;
+using google_cloud_debugger::EvalCoordinator;
+using google_cloud_debugger_test::ICorDebugEvalMock;
+using google_cloud_debugger_test::ICorDebugThreadMock;
+using std::chrono::duration;
+using std::chrono::steady_clock;
+
+int main(int argc, char *argv[]) {
+  testing::InitGoogleMock(&argc, argv);
+
+  int number_of_evals = 100000;
+  if (argc > 1) {
+    number_of_evals = std::atoi(argv[1]);
+  }
+  if (number_of_evals <= 0) {
+    std::cerr << "Number of evals must be positive." << std::endl;
+    return 1;
+  }
+
+  EvalCoordinator eval_coordinator;
+  NiceMock<ICorDebugThreadMock> debug_thread;
+  NiceMock<ICorDebugEvalMock> eval;
+
+  int get_result_calls = 0;
+  ON_CALL(eval, GetResult(_))
+      .WillByDefault(Invoke([&](ICorDebugValue **result) -> HRESULT {
+        return (get_result_calls++ % 2 == 0) ? CORDBG_E_FUNC_EVAL_NOT_COMPLETE
+                                             : S_OK;
+      }));
+
+  // Simulates the EvalComplete callback for every eval.
+  std::thread debugger_callback_thread([&]() {
+    for (int i = 0; i < number_of_evals; ++i) {
+      eval_coordinator.SignalFinishedEval(&debug_thread);
+    }
+  });
+
+  CComPtr<ICorDebugValue> eval_result;
+  BOOL exception_thrown;
+  auto start = steady_clock::now();
+  for (int i = 0; i < number_of_evals; ++i) {
+    HRESULT hr =
+        eval_coordinator.WaitForEval(&exception_thrown, &eval, &eval_result);
+    if (FAILED(hr)) {
+      std::cerr << "Eval failed with HRESULT: " << std::hex << hr << std::endl;
+      debugger_callback_thread.detach();
+      return 1;
+    }
+  }
+  duration<double> elapsed = steady_clock::now() - start;
+  debugger_callback_thread.join();
+
+  std::cout << number_of_evals << " evals in " << elapsed.count() << " s: "
+            << number_of_evals / elapsed.count() << " evals per second."
+            << std::endl;
+  return 0;
+}
@@ -14,22 +14,32 @@
 
 #include <gtest/gtest.h>
 #include <algorithm>
+#include <atomic>
 #include <chrono>
 #include <memory>
 #include <string>
+#include <thread>
 
 #include "ccomptr.h"
 #include "common_action_mocks.h"
 #include "dbg_breakpoint.h"
+#include "dbg_primitive.h"
 #include "debugger_callback.h"
 #include "eval_coordinator.h"
 #include "i_breakpoint_collection_mock.h"
+#include "i_cor_debug_mocks.h"
+#include "pdb_file_index.h"
 
 using ::testing::_;
 using ::testing::DoAll;
+using ::testing::Invoke;
 using ::testing::Return;
+using ::testing::SetArgPointee;
 using google_cloud_debugger::CComPtr;
+using google_cloud_debugger::DbgObject;
+using google_cloud_debugger::DbgPrimitive;
 using google_cloud_debugger::EvalCoordinator;
+using google_cloud_debugger::PdbFileIndex;
 using std::chrono::high_resolution_clock;
 using std::chrono::minutes;
 using std::chrono::seconds;
@@ -57,9 +67,8 @@ class EvalCoordinatorTest : public ::testing::Test {
   // DbgBreakpoints passed to PrintBreakpoint function.
   std::vector<shared_ptr<google_cloud_debugger::DbgBreakpoint>> breakpoints_;
 
-  // Empty list of PDB files passed to PrintBreakpoint function.
-  vector<shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>>
-      pdb_files_;
+  // Empty index of PDB files passed to PrintBreakpoint function.
+  shared_ptr<PdbFileIndex> pdb_index_ = std::make_shared<PdbFileIndex>();
 
   // The ICorDebugEval being evaluated.
   ICorDebugEvalMock eval_;
@@ -112,6 +121,157 @@ TEST_F(EvalCoordinatorTest, TestWaitForEvalTimeOut) {
   EXPECT_EQ(hr, CORDBG_E_FUNC_EVAL_NOT_COMPLETE);
 }
 
+// Tests that WaitForEval blocks until the debugger callback thread
+// signals that the evaluation is finished.
+TEST_F(EvalCoordinatorTest, TestWaitForEvalSignalFinishedEval) {
+  std::atomic<bool> eval_finished(false);
+  EXPECT_CALL(eval_, GetResult(_))
+      .WillRepeatedly(Invoke([&](ICorDebugValue **result) -> HRESULT {
+        return eval_finished ? S_OK : CORDBG_E_FUNC_EVAL_NOT_COMPLETE;
+      }));
+
+  // Simulates the EvalComplete callback.
+  std::thread debugger_callback_thread([&]() {
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    eval_finished = true;
+    eval_coordinator_.SignalFinishedEval(&debug_thread_);
+  });
+
+  HRESULT hr =
+      eval_coordinator_.WaitForEval(&exception_thrown, &eval_, &eval_result_);
+  EXPECT_EQ(hr, S_OK);
+  EXPECT_FALSE(exception_thrown);
+  EXPECT_FALSE(eval_coordinator_.WaitingForEval());
+
+  // Lets the debugger callback thread return.
+  eval_coordinator_.SignalFinishedPrintingVariable();
+  debugger_callback_thread.join();
+}
+
+// Tests that CreateEval counts the function evaluations.
+TEST_F(EvalCoordinatorTest, TestCreateEvalCountsEvals) {
+  // SignalFinishedEval makes debug_thread_ the active thread and blocks
+  // until the capture is finished.
+  std::thread debugger_callback_thread(
+      [&]() { eval_coordinator_.SignalFinishedEval(&debug_thread_); });
+
+  CComPtr<ICorDebugThread> active_thread;
+  while (FAILED(eval_coordinator_.GetActiveDebugThread(&active_thread))) {
+    std::this_thread::yield();
+  }
+
+  EXPECT_CALL(debug_thread_, CreateEval(_))
+      .Times(1)
+      .WillRepeatedly(Return(S_OK));
+  std::uint64_t eval_count = EvalCoordinator::GetEvalCount();
+  CComPtr<ICorDebugEval> debug_eval;
+  EXPECT_EQ(eval_coordinator_.CreateEval(&debug_eval), S_OK);
+  EXPECT_EQ(EvalCoordinator::GetEvalCount(), eval_count + 1);
+
+  // Lets the debugger callback thread return.
+  eval_coordinator_.SignalFinishedPrintingVariable();
+  debugger_callback_thread.join();
+}
+
+// Tests that a property value cached for an object is found when the
+// object is reached through another variable after a function
+// evaluation moved it.
+TEST_F(EvalCoordinatorTest, TestPropertyCacheFollowsMovedObject) {
+  std::thread debugger_callback_thread(
+      [&]() { eval_coordinator_.SignalFinishedEval(&debug_thread_); });
+
+  CComPtr<ICorDebugThread> active_thread;
+  while (FAILED(eval_coordinator_.GetActiveDebugThread(&active_thread))) {
+    std::this_thread::yield();
+  }
+
+  CORDB_ADDRESS module_address = 0x8000;
+  mdMethodDef getter_token = 0x06000001;
+  shared_ptr<DbgObject> property_value(new DbgPrimitive<int32_t>(10));
+
+  // Strong handle to the object, which is at first_address until the
+  // function evaluation below moves it to second_address.
+  CORDB_ADDRESS first_address = 0x1000;
+  CORDB_ADDRESS second_address = 0x2000;
+  CORDB_ADDRESS object_address = first_address;
+  ICorDebugHandleValueMock object_handle;
+  EXPECT_CALL(object_handle, QueryInterface(_, _))
+      .WillRepeatedly(DoAll(SetArgPointee<1>(&object_handle), Return(S_OK)));
+  EXPECT_CALL(object_handle, GetValue(_))
+      .WillRepeatedly(Invoke([&](CORDB_ADDRESS *address) -> HRESULT {
+        *address = object_address;
+        return S_OK;
+      }));
+
+  // The first variable reaches the object before it moves.
+  std::uint64_t first_eval_count = EvalCoordinator::GetEvalCount();
+  EXPECT_EQ(eval_coordinator_.GetCachedPropertyValue(
+                &object_handle, first_address, first_eval_count,
+                module_address, getter_token),
+            nullptr);
+  eval_coordinator_.CachePropertyValue(&object_handle, module_address,
+                                       getter_token, property_value);
+
+  // A getter of another object is evaluated and the object moves.
+  EXPECT_CALL(debug_thread_, CreateEval(_)).WillRepeatedly(Return(S_OK));
+  CComPtr<ICorDebugEval> debug_eval;
+  EXPECT_EQ(eval_coordinator_.CreateEval(&debug_eval), S_OK);
+  object_address = second_address;
+  std::uint64_t second_eval_count = EvalCoordinator::GetEvalCount();
+
+  // The second variable reaches the object at its new address.
+  ICorDebugReferenceValueMock second_variable;
+  EXPECT_EQ(eval_coordinator_.GetCachedPropertyValue(
+                &second_variable, second_address, second_eval_count,
+                module_address, getter_token),
+            property_value);
+
+  // The address read by the first variable is stale, so the current one
+  // is read through the handle.
+  EXPECT_EQ(eval_coordinator_.GetCachedPropertyValue(
+                &object_handle, first_address, first_eval_count,
+                module_address, getter_token),
+            property_value);
+
+  // Another object now at the old address does not get the value.
+  ICorDebugReferenceValueMock other_variable;
+  EXPECT_EQ(eval_coordinator_.GetCachedPropertyValue(
+                &other_variable, first_address, second_eval_count,
+                module_address, getter_token),
+            nullptr);
+
+  // Lets the debugger callback thread return.
+  eval_coordinator_.SignalFinishedPrintingVariable();
+  debugger_callback_thread.join();
+}
+
+// Tests that a breakpoint hit is only captured once the stack sample
+// in progress ends.
+TEST_F(EvalCoordinatorTest, TestProcessBreakpointWaitsForSample) {
+  EXPECT_CALL(debug_stack_walk_, GetFrame(_)).WillRepeatedly(Return(S_FALSE));
+  EXPECT_CALL(breakpoint_collection_, WriteBreakpoint(_)).Times(0);
+
+  ASSERT_TRUE(eval_coordinator_.TryBeginSample());
+
+  std::atomic<bool> processed(false);
+  std::thread debugger_callback_thread([&]() {
+    eval_coordinator_.ProcessBreakpoints(
+        &debug_thread_, &breakpoint_collection_, breakpoints_, pdb_index_);
+    processed = true;
+  });
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(100));
+  EXPECT_FALSE(processed);
+
+  eval_coordinator_.EndSample();
+  debugger_callback_thread.join();
+  EXPECT_TRUE(processed);
+
+  // The capture is done so the next sample can start.
+  EXPECT_TRUE(eval_coordinator_.TryBeginSample());
+  eval_coordinator_.EndSample();
+}
+
 // Tests that ProcessBreakpoint will return.
 TEST_F(EvalCoordinatorTest, TestProcessBreakpoint) {
   EXPECT_CALL(debug_stack_walk_, GetFrame(_)).WillRepeatedly(Return(S_FALSE));
@@ -120,8 +280,7 @@ TEST_F(EvalCoordinatorTest, TestProcessBreakpoint) {
   EXPECT_CALL(breakpoint_collection_, WriteBreakpoint(_))
       .Times(0);
   HRESULT hr = eval_coordinator_.ProcessBreakpoints(
-      &debug_thread_, &breakpoint_collection_, breakpoints_,
-      pdb_files_);
+      &debug_thread_, &breakpoint_collection_, breakpoints_, pdb_index_);
 
   // PrintBreakpoint going to call a task that will call WriteBreakpoint
   // function of breakpoint_collection_ so we should give it some time to
@@ -0,0 +1,88 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <memory>
+
+#include "dbg_primitive.h"
+#include "frame_variable.h"
+#include "i_cor_debug_mocks.h"
+#include "i_dbg_object_factory_mock.h"
+
+using google_cloud_debugger::DbgObject;
+using google_cloud_debugger::DbgPrimitive;
+using google_cloud_debugger::FrameVariable;
+using std::shared_ptr;
+using ::testing::_;
+using ::testing::DoAll;
+using ::testing::Return;
+using ::testing::SetArgPointee;
+
+namespace google_cloud_debugger_test {
+
+// Tests that the DbgObject of a variable is only created the first
+// time it is needed.
+TEST(FrameVariableTest, CreatesValueOnce) {
+  ICorDebugGenericValueMock debug_value;
+  IDbgObjectFactoryMock object_factory;
+
+  FrameVariable variable("variable", &debug_value);
+  EXPECT_EQ(variable.GetName(), "variable");
+  EXPECT_TRUE(variable.IsPending());
+
+  DbgObject *created_obj = new DbgPrimitive<int32_t>(20);
+  EXPECT_CALL(object_factory,
+              CreateDbgObjectMockHelper(&debug_value, 3, _, _))
+      .Times(1)
+      .WillRepeatedly(DoAll(SetArgPointee<2>(created_obj), Return(S_OK)));
+
+  shared_ptr<DbgObject> value = variable.GetValue(&object_factory, 3);
+  EXPECT_EQ(value.get(), created_obj);
+  EXPECT_FALSE(variable.IsPending());
+
+  EXPECT_EQ(variable.GetValue(&object_factory, 3).get(), created_obj);
+  variable.CreateValue(&object_factory, 3);
+}
+
+// Tests that a variable whose DbgObject fails to be created is not
+// retried.
+TEST(FrameVariableTest, CreateValueFailed) {
+  ICorDebugGenericValueMock debug_value;
+  IDbgObjectFactoryMock object_factory;
+
+  FrameVariable variable("variable", &debug_value);
+  EXPECT_CALL(object_factory, CreateDbgObjectMockHelper(&debug_value, _, _, _))
+      .Times(1)
+      .WillRepeatedly(Return(E_FAIL));
+
+  variable.CreateValue(&object_factory, 3);
+  EXPECT_FALSE(variable.IsPending());
+  EXPECT_EQ(variable.GetValue(&object_factory, 3), nullptr);
+}
+
+// Tests that a variable created with its DbgObject does not use
+// the object factory.
+TEST(FrameVariableTest, CreatedValue) {
+  IDbgObjectFactoryMock object_factory;
+  shared_ptr<DbgObject> created_obj(new DbgPrimitive<int32_t>(20));
+
+  FrameVariable variable("constant", created_obj);
+  EXPECT_FALSE(variable.IsPending());
+
+  EXPECT_CALL(object_factory, CreateDbgObjectMockHelper(_, _, _, _)).Times(0);
+  EXPECT_EQ(variable.GetValue(&object_factory, 3), created_obj);
+}
+
+}  // namespace google_cloud_debugger_test
@@ -52,9 +52,8 @@ class IBreakpointCollectionMock
       HRESULT(mdMethodDef function_token, ULONG32 il_offset,
               google_cloud_debugger::IEvalCoordinator *eval_coordinator,
               ICorDebugThread *debug_thread,
-              const std::vector<std::shared_ptr<
-                  google_cloud_debugger_portable_pdb::IPortablePdbFile>>
-                  &pdb_files));
+              std::shared_ptr<const google_cloud_debugger::PdbFileIndex>
+                  pdb_index));
 };
 
 }  // namespace google_cloud_debugger_test
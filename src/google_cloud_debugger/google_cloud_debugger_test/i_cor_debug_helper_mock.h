@@ -64,9 +64,10 @@ class ICorDebugHelperMock : public google_cloud_debugger::ICorDebugHelper {
   MOCK_METHOD3(CreateStrongHandle, HRESULT(ICorDebugValue *debug_value,
                                            ICorDebugHandleValue **handle,
                                            std::ostream *err_stream));
-  MOCK_METHOD3(ExtractStringFromICorDebugStringValue,
-               HRESULT(ICorDebugStringValue *debug_string,
-                       std::string *returned_string, std::ostream *err_stream));
+  MOCK_METHOD5(ExtractStringFromICorDebugStringValue,
+               HRESULT(ICorDebugStringValue *debug_string, ULONG32 max_length,
+                       std::string *returned_string, ULONG32 *original_length,
+                       std::ostream *err_stream));
   MOCK_METHOD4(ExtractParamName,
                HRESULT(IMetaDataImport *metadata_import, mdParamDef param_token,
                        std::string *param_name, std::ostream *err_stream));
@@ -109,6 +109,33 @@ class ICorDebugObjectValueMock : public ICorDebugObjectValue {
   MOCK_METHOD1(SetFromManagedCopy, HRESULT(IUnknown *pObject));
 };
 
+// Mock class for an object that implements both ICorDebugObjectValue
+// and ICorDebugValue2.
+class ICorDebugObjectValue2Mock : public ICorDebugObjectValue,
+                                  public ICorDebugValue2 {
+ public:
+  ICORDEBUG_MOCK
+
+  MOCK_METHOD1(GetClass, HRESULT(ICorDebugClass **ppClass));
+
+  MOCK_METHOD3(GetFieldValue,
+               HRESULT(ICorDebugClass *pClass, mdFieldDef fieldDef,
+                       ICorDebugValue **ppValue));
+
+  MOCK_METHOD2(GetVirtualMethod,
+               HRESULT(mdMemberRef memberRef, ICorDebugFunction **ppFunction));
+
+  MOCK_METHOD1(GetContext, HRESULT(ICorDebugContext **ppContext));
+
+  MOCK_METHOD1(IsValueClass, HRESULT(BOOL *pbIsValueClass));
+
+  MOCK_METHOD1(GetManagedCopy, HRESULT(IUnknown **ppObject));
+
+  MOCK_METHOD1(SetFromManagedCopy, HRESULT(IUnknown *pObject));
+
+  MOCK_METHOD1(GetExactType, HRESULT(ICorDebugType **ppType));
+};
+
 // Mock class for ICorDebugClass.
 class ICorDebugClassMock : public ICorDebugClass {
  public:
@@ -382,6 +409,56 @@ class ICorDebugAppDomainMock : public ICorDebugAppDomain {
   MOCK_METHOD1(GetObject, HRESULT(ICorDebugValue **ppObject));
 };
 
+class ICorDebugProcessMock : public ICorDebugProcess {
+ public:
+  IUNKNOWN_MOCK
+
+  MOCK_METHOD1(Stop, HRESULT(DWORD dwTimeoutIgnored));
+  MOCK_METHOD1(Continue, HRESULT(BOOL fIsOutOfBand));
+  MOCK_METHOD1(IsRunning, HRESULT(BOOL *pbRunning));
+  MOCK_METHOD2(HasQueuedCallbacks,
+               HRESULT(ICorDebugThread *pThread, BOOL *pbQueued));
+  MOCK_METHOD1(EnumerateThreads, HRESULT(ICorDebugThreadEnum **ppThreads));
+  MOCK_METHOD2(SetAllThreadsDebugState,
+               HRESULT(CorDebugThreadState state,
+                       ICorDebugThread *pExceptThisThread));
+  MOCK_METHOD0(Detach, HRESULT(void));
+  MOCK_METHOD1(Terminate, HRESULT(UINT exitCode));
+  MOCK_METHOD3(CanCommitChanges,
+               HRESULT(ULONG cSnapshots,
+                       ICorDebugEditAndContinueSnapshot *pSnapshots[],
+                       ICorDebugErrorInfoEnum **pError));
+  MOCK_METHOD3(CommitChanges,
+               HRESULT(ULONG cSnapshots,
+                       ICorDebugEditAndContinueSnapshot *pSnapshots[],
+                       ICorDebugErrorInfoEnum **pError));
+  MOCK_METHOD1(GetID, HRESULT(DWORD *pdwProcessId));
+  MOCK_METHOD1(GetHandle, HRESULT(HPROCESS *phProcessHandle));
+  MOCK_METHOD2(GetThread,
+               HRESULT(DWORD dwThreadId, ICorDebugThread **ppThread));
+  MOCK_METHOD1(EnumerateObjects, HRESULT(ICorDebugObjectEnum **ppObjects));
+  MOCK_METHOD2(IsTransitionStub,
+               HRESULT(CORDB_ADDRESS address, BOOL *pbTransitionStub));
+  MOCK_METHOD2(IsOSSuspended, HRESULT(DWORD threadID, BOOL *pbSuspended));
+  MOCK_METHOD3(GetThreadContext,
+               HRESULT(DWORD threadID, ULONG32 contextSize, BYTE context[]));
+  MOCK_METHOD3(SetThreadContext,
+               HRESULT(DWORD threadID, ULONG32 contextSize, BYTE context[]));
+  MOCK_METHOD4(ReadMemory, HRESULT(CORDB_ADDRESS address, DWORD size,
+                                   BYTE buffer[], SIZE_T *read));
+  MOCK_METHOD4(WriteMemory, HRESULT(CORDB_ADDRESS address, DWORD size,
+                                    BYTE buffer[], SIZE_T *written));
+  MOCK_METHOD1(ClearCurrentException, HRESULT(DWORD threadID));
+  MOCK_METHOD1(EnableLogMessages, HRESULT(BOOL fOnOff));
+  MOCK_METHOD2(ModifyLogSwitch, HRESULT(WCHAR *pLogSwitchName, LONG lLevel));
+  MOCK_METHOD1(EnumerateAppDomains,
+               HRESULT(ICorDebugAppDomainEnum **ppAppDomains));
+  MOCK_METHOD1(GetObject, HRESULT(ICorDebugValue **ppObject));
+  MOCK_METHOD2(ThreadForFiberCookie,
+               HRESULT(DWORD fiberCookie, ICorDebugThread **ppThread));
+  MOCK_METHOD1(GetHelperThreadID, HRESULT(DWORD *pThreadID));
+};
+
 class ICorDebugThread3Mock : public ICorDebugThread3 {
  public:
   IUNKNOWN_MOCK
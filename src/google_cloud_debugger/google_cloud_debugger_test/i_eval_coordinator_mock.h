@@ -41,9 +41,8 @@ class IEvalCoordinatorMock : public google_cloud_debugger::IEvalCoordinator {
           ICorDebugThread *debug_thread,
           google_cloud_debugger::IBreakpointCollection *breakpoint_collection,
           std::vector<std::shared_ptr<google_cloud_debugger::DbgBreakpoint>> breakpoint,
-          const std::vector<std::shared_ptr<
-              google_cloud_debugger_portable_pdb::IPortablePdbFile>>
-              &pdb_files));
+          std::shared_ptr<const google_cloud_debugger::PdbFileIndex>
+              pdb_index));
 
   MOCK_METHOD0(WaitForReadySignal, void());
 
@@ -64,6 +63,24 @@ class IEvalCoordinatorMock : public google_cloud_debugger::IEvalCoordinator {
   MOCK_METHOD1(SetMethodEvaluation, void(BOOL eval));
 
   MOCK_METHOD1(CreateStackWalk, HRESULT(ICorDebugStackWalk **debug_stack_walk));
+
+  MOCK_METHOD5(GetCachedPropertyValue,
+               std::shared_ptr<google_cloud_debugger::DbgObject>(
+                   ICorDebugValue *object_value, CORDB_ADDRESS object_address,
+                   std::uint64_t address_eval_count,
+                   CORDB_ADDRESS module_base_address,
+                   mdMethodDef getter_token));
+
+  MOCK_METHOD4(CachePropertyValue,
+               void(ICorDebugValue *object_handle,
+                    CORDB_ADDRESS module_base_address, mdMethodDef getter_token,
+                    std::shared_ptr<google_cloud_debugger::DbgObject> value));
+
+  MOCK_METHOD1(AddBeforeEvalCallback, void(std::function<void()> callback));
+
+  MOCK_METHOD0(TryBeginSample, BOOL());
+
+  MOCK_METHOD0(EndSample, void());
 };
 
 }  // namespace google_cloud_debugger_test
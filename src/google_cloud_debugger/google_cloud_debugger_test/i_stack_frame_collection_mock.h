@@ -30,15 +30,16 @@ class IStackFrameCollectionMock
   MOCK_METHOD3(
       ProcessBreakpoint,
       HRESULT(
-          const std::vector<std::shared_ptr<
-              google_cloud_debugger_portable_pdb::IPortablePdbFile>> &pdb_files,
+          const google_cloud_debugger::PdbFileIndex &pdb_index,
           google_cloud_debugger::DbgBreakpoint *breakpoint,
           google_cloud_debugger::IEvalCoordinator *eval_coordinator));
-  MOCK_METHOD2(
+  MOCK_METHOD3(
       PopulateStackFrames,
       HRESULT(
           google::cloud::diagnostics::debug::Breakpoint *breakpoint,
+          const google_cloud_debugger::CaptureProfile &capture_profile,
           google_cloud_debugger::IEvalCoordinator *eval_coordinator));
+  MOCK_CONST_METHOD0(GetStackFingerprint, std::uint64_t());
 };
 
 }  // namespace google_cloud_debugger_test
@@ -0,0 +1,150 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+
+#include "metrics.h"
+
+using google_cloud_debugger::LatencyHistogram;
+using google_cloud_debugger::MetricCounter;
+using google_cloud_debugger::MetricPhase;
+using google_cloud_debugger::Metrics;
+using google_cloud_debugger::ScopedPhaseTimer;
+using std::string;
+
+namespace google_cloud_debugger_test {
+
+// Tests that an empty histogram reports zeroes.
+TEST(LatencyHistogramTest, Empty) {
+  LatencyHistogram histogram;
+  EXPECT_EQ(histogram.GetCount(), 0);
+  EXPECT_EQ(histogram.GetTotal(), 0);
+  EXPECT_EQ(histogram.GetMax(), 0);
+  EXPECT_EQ(histogram.GetPercentile(50), 0);
+}
+
+// Tests the count, total, max and percentiles of a histogram.
+TEST(LatencyHistogramTest, Record) {
+  LatencyHistogram histogram;
+  for (int i = 0; i < 90; ++i) {
+    histogram.Record(10);
+  }
+  for (int i = 0; i < 10; ++i) {
+    histogram.Record(1000);
+  }
+
+  EXPECT_EQ(histogram.GetCount(), 100);
+  EXPECT_EQ(histogram.GetTotal(), 90 * 10 + 10 * 1000);
+  EXPECT_EQ(histogram.GetMax(), 1000);
+
+  // 10 falls into the bucket below 16 and 1000 into the bucket below 1024,
+  // which is capped by the max.
+  EXPECT_EQ(histogram.GetPercentile(50), 16);
+  EXPECT_EQ(histogram.GetPercentile(90), 16);
+  EXPECT_EQ(histogram.GetPercentile(99), 1000);
+}
+
+// Tests that negative latencies are recorded as 0.
+TEST(LatencyHistogramTest, RecordNegative) {
+  LatencyHistogram histogram;
+  histogram.Record(-5);
+  EXPECT_EQ(histogram.GetCount(), 1);
+  EXPECT_EQ(histogram.GetTotal(), 0);
+  EXPECT_EQ(histogram.GetPercentile(100), 0);
+}
+
+// Tests that the report contains the global and per-breakpoint
+// histograms that are recorded.
+TEST(MetricsTest, WriteReport) {
+  Metrics metrics;
+  metrics.Record(MetricPhase::kStackWalk, 100, "");
+  metrics.Record(MetricPhase::kFuncEval, 200, "breakpoint-id");
+
+  EXPECT_EQ(metrics.GetHistogram(MetricPhase::kStackWalk).GetCount(), 1);
+  EXPECT_EQ(metrics.GetHistogram(MetricPhase::kFuncEval).GetCount(), 1);
+  EXPECT_EQ(metrics.GetHistogram(MetricPhase::kPipeWrite).GetCount(), 0);
+
+  std::ostringstream report;
+  metrics.WriteReport(&report);
+  string report_string = report.str();
+
+  EXPECT_NE(report_string.find("[global]"), string::npos);
+  EXPECT_NE(report_string.find("stack_walk 1 100 100"), string::npos);
+  EXPECT_NE(report_string.find("[breakpoint breakpoint-id]\nfunc_eval 1 200"),
+            string::npos);
+  EXPECT_EQ(report_string.find("pipe_write"), string::npos);
+}
+
+// Tests that the per-hit counters are recorded and reported.
+TEST(MetricsTest, RecordCount) {
+  Metrics metrics;
+  metrics.RecordCount(MetricCounter::kStrongHandles, 3);
+  metrics.RecordCount(MetricCounter::kStrongHandles, 5);
+
+  const LatencyHistogram &histogram =
+      metrics.GetCountHistogram(MetricCounter::kStrongHandles);
+  EXPECT_EQ(histogram.GetCount(), 2);
+  EXPECT_EQ(histogram.GetTotal(), 8);
+  EXPECT_EQ(histogram.GetMax(), 5);
+  EXPECT_EQ(
+      metrics.GetCountHistogram(MetricCounter::kReferenceObjects).GetCount(),
+      0);
+
+  std::ostringstream report;
+  metrics.WriteReport(&report);
+  EXPECT_NE(report.str().find("[per_hit]\nstrong_handles 2 8 5"),
+            string::npos);
+  EXPECT_EQ(report.str().find("reference_objects"), string::npos);
+}
+
+// Tests that the histograms of a removed breakpoint are dropped from
+// the report and that its slot is reused.
+TEST(MetricsTest, RemoveBreakpoint) {
+  Metrics metrics;
+  for (std::size_t i = 0; i < Metrics::kMaximumTrackedBreakpoints; ++i) {
+    metrics.Record(MetricPhase::kFuncEval, 200, "bp-" + std::to_string(i));
+  }
+  metrics.Record(MetricPhase::kFuncEval, 200, "extra-bp");
+
+  std::ostringstream report;
+  metrics.WriteReport(&report);
+  EXPECT_NE(report.str().find("[breakpoint bp-0]"), string::npos);
+  EXPECT_EQ(report.str().find("[breakpoint extra-bp]"), string::npos);
+
+  metrics.RemoveBreakpoint("bp-0");
+  metrics.Record(MetricPhase::kFuncEval, 200, "extra-bp");
+
+  report.str("");
+  metrics.WriteReport(&report);
+  EXPECT_EQ(report.str().find("[breakpoint bp-0]"), string::npos);
+  EXPECT_NE(report.str().find("[breakpoint extra-bp]"), string::npos);
+
+  // Removing an unknown breakpoint is a no-op.
+  metrics.RemoveBreakpoint("unknown-bp");
+}
+
+// Tests that ScopedPhaseTimer records into the global metrics.
+TEST(MetricsTest, ScopedPhaseTimer) {
+  const LatencyHistogram &histogram =
+      Metrics::GetInstance()->GetHistogram(MetricPhase::kSerialize);
+  std::uint64_t count = histogram.GetCount();
+  {
+    ScopedPhaseTimer timer(MetricPhase::kSerialize);
+  }
+  EXPECT_EQ(histogram.GetCount(), count + 1);
+}
+
+}  // namespace google_cloud_debugger_test
@@ -0,0 +1,186 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+
+#include "i_cor_debug_helper_mock.h"
+#include "i_cor_debug_mocks.h"
+#include "module_registry.h"
+#include "string_stream_wrapper.h"
+
+using ::testing::_;
+using ::testing::DoAll;
+using ::testing::InvokeWithoutArgs;
+using ::testing::Return;
+using ::testing::SetArgPointee;
+using google_cloud_debugger::ConvertStringToWCharPtr;
+using google_cloud_debugger::ModuleRegistry;
+using std::string;
+
+namespace google_cloud_debugger_test {
+
+// Test Fixture for ModuleRegistry.
+class ModuleRegistryTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    debug_helper_ = std::make_shared<ICorDebugHelperMock>();
+    module_registry_.reset(new ModuleRegistry(debug_helper_));
+  }
+
+  // Sets up debug_module so it has the name module_name and is
+  // loaded at base_address. The base address is only read once the
+  // PDB file of the module is initialized, so it is read exactly once
+  // per registered module. The threads the module is read on are
+  // added to module_read_threads_.
+  void SetUpModule(ICorDebugModuleMock *debug_module,
+                   const string &module_name, CORDB_ADDRESS base_address) {
+    auto record_thread = [this]() {
+      std::lock_guard<std::mutex> lk(mutex_);
+      module_read_threads_.insert(std::this_thread::get_id());
+    };
+    EXPECT_CALL(*debug_helper_,
+                GetMetadataImportFromICorDebugModule(debug_module, _, _))
+        .WillRepeatedly(DoAll(InvokeWithoutArgs(record_thread), Return(S_OK)));
+    EXPECT_CALL(*debug_helper_,
+                GetModuleNameFromICorDebugModule(debug_module, _, _))
+        .WillRepeatedly(DoAll(
+            InvokeWithoutArgs(record_thread),
+            SetArgPointee<1>(ConvertStringToWCharPtr(module_name)),
+            Return(S_OK)));
+    EXPECT_CALL(*debug_module, GetBaseAddress(_))
+        .Times(1)
+        .WillRepeatedly(DoAll(InvokeWithoutArgs(record_thread),
+                              SetArgPointee<0>(base_address), Return(S_OK)));
+  }
+
+  // The modules are declared first so they outlive the PDB files
+  // held by module_registry_.
+  ICorDebugModuleMock first_module_;
+
+  ICorDebugModuleMock second_module_;
+
+  std::shared_ptr<ICorDebugHelperMock> debug_helper_;
+
+  std::unique_ptr<ModuleRegistry> module_registry_;
+
+  // Threads the modules are read on.
+  std::set<std::thread::id> module_read_threads_;
+
+  // Guards module_read_threads_.
+  std::mutex mutex_;
+};
+
+// Tests that modules added to the registry are processed before the
+// index is returned. The modules do not have PDB files on disk so none
+// of them should end up in the PDB file index.
+TEST_F(ModuleRegistryTest, AddModule) {
+  SetUpModule(&first_module_, "First.dll", 0x1000);
+  SetUpModule(&second_module_, "Second.dll", 0x2000);
+
+  module_registry_->AddModule(&first_module_);
+  module_registry_->AddModule(&second_module_);
+
+  auto pdb_index = module_registry_->GetPdbFileIndex();
+  ASSERT_NE(pdb_index, nullptr);
+  EXPECT_TRUE(pdb_index->GetPdbFiles().empty());
+  EXPECT_EQ(pdb_index->GetPdbFile(0x1000), nullptr);
+}
+
+// Tests that the modules are only read on the thread that adds them,
+// which is the thread of the LoadModule callback, and not on the
+// background thread that parses their PDB files.
+TEST_F(ModuleRegistryTest, ModulesReadOnCallingThread) {
+  SetUpModule(&first_module_, "First.dll", 0x1000);
+  SetUpModule(&second_module_, "Second.dll", 0x2000);
+
+  module_registry_->AddModule(&first_module_);
+  module_registry_->AddModule(&second_module_);
+  module_registry_->GetPdbFileIndex();
+
+  std::lock_guard<std::mutex> lk(mutex_);
+  ASSERT_EQ(module_read_threads_.size(), 1);
+  EXPECT_EQ(*module_read_threads_.begin(), std::this_thread::get_id());
+}
+
+// Tests that modules can be looked up by name whether or not their
+// PDB files are parsed, until they are removed.
+TEST_F(ModuleRegistryTest, GetPdbFileByModuleName) {
+  SetUpModule(&first_module_, "First.dll", 0x1000);
+  SetUpModule(&second_module_, "Second.dll", 0x2000);
+
+  module_registry_->AddModule(&first_module_);
+  module_registry_->AddModule(&second_module_);
+
+  auto pdb_file = module_registry_->GetPdbFileByModuleName("First.dll");
+  ASSERT_NE(pdb_file, nullptr);
+  EXPECT_EQ(pdb_file->GetModuleName(), "First.dll");
+
+  pdb_file = module_registry_->GetPdbFileByModuleName("Second.dll");
+  ASSERT_NE(pdb_file, nullptr);
+  EXPECT_EQ(pdb_file->GetModuleName(), "Second.dll");
+
+  EXPECT_EQ(module_registry_->GetPdbFileByModuleName("Third.dll"), nullptr);
+
+  module_registry_->RemoveModule(0x1000);
+  EXPECT_EQ(module_registry_->GetPdbFileByModuleName("First.dll"), nullptr);
+  EXPECT_NE(module_registry_->GetPdbFileByModuleName("Second.dll"), nullptr);
+}
+
+// Tests that a module that fails to initialize is not registered.
+TEST_F(ModuleRegistryTest, AddModuleError) {
+  SetUpModule(&first_module_, "First.dll", 0x1000);
+  EXPECT_CALL(*debug_helper_,
+              GetMetadataImportFromICorDebugModule(&second_module_, _, _))
+      .WillRepeatedly(Return(E_FAIL));
+
+  EXPECT_CALL(second_module_, GetBaseAddress(_)).Times(0);
+
+  module_registry_->AddModule(&first_module_);
+  module_registry_->AddModule(&second_module_);
+
+  auto pdb_index = module_registry_->GetPdbFileIndex();
+  ASSERT_NE(pdb_index, nullptr);
+  EXPECT_TRUE(pdb_index->GetPdbFiles().empty());
+  EXPECT_NE(module_registry_->GetPdbFileByModuleName("First.dll"), nullptr);
+  EXPECT_EQ(module_registry_->GetPdbFileByModuleName("Second.dll"), nullptr);
+}
+
+// Tests that removing a module waits for the queued modules and
+// ignores modules that do not have a PDB file.
+TEST_F(ModuleRegistryTest, RemoveModule) {
+  SetUpModule(&first_module_, "First.dll", 0x1000);
+
+  module_registry_->AddModule(&first_module_);
+  module_registry_->RemoveModule(0x1000);
+  module_registry_->RemoveModule(0x2000);
+
+  auto pdb_index = module_registry_->GetPdbFileIndex();
+  ASSERT_NE(pdb_index, nullptr);
+  EXPECT_TRUE(pdb_index->GetPdbFiles().empty());
+}
+
+// Tests that the registry returns nothing when no modules are added.
+TEST_F(ModuleRegistryTest, NoModules) {
+  auto pdb_index = module_registry_->GetPdbFileIndex();
+  ASSERT_NE(pdb_index, nullptr);
+  EXPECT_TRUE(pdb_index->GetPdbFiles().empty());
+}
+
+}  // namespace google_cloud_debugger_test
@@ -0,0 +1,155 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+
+#include "i_cor_debug_helper_mock.h"
+#include "i_cor_debug_mocks.h"
+#include "i_metadata_import_mock.h"
+#include "module_type_cache.h"
+
+using ::testing::_;
+using ::testing::DoAll;
+using ::testing::Return;
+using ::testing::SetArgPointee;
+using ::testing::SetArrayArgument;
+using google_cloud_debugger::ModuleTypeCache;
+using google_cloud_debugger::ModuleTypeDict;
+using std::shared_ptr;
+using std::string;
+
+namespace google_cloud_debugger_test {
+
+// Test Fixture for ModuleTypeCache.
+class ModuleTypeCacheTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    ON_CALL(debug_module_, GetBaseAddress(_))
+        .WillByDefault(DoAll(SetArgPointee<0>(0x1000), Return(S_OK)));
+    ON_CALL(debug_helper_, GetTypeNameFromMdTypeDef(type_def_, _, _, _, _))
+        .WillByDefault(
+            DoAll(SetArgPointee<2>(type_def_name_), Return(S_OK)));
+    ON_CALL(debug_helper_, GetTypeNameFromMdTypeRef(type_ref_, _, _, _))
+        .WillByDefault(
+            DoAll(SetArgPointee<2>(type_ref_name_), Return(S_OK)));
+  }
+
+  // Sets up metadata_import_ to enumerate type_def_ and type_ref_ once.
+  void SetUpTypeEnumeration() {
+    EXPECT_CALL(metadata_import_, EnumTypeDefs(_, _, _, _))
+        .WillOnce(DoAll(SetArrayArgument<1>(&type_def_, &type_def_ + 1),
+                        SetArgPointee<3>(1), Return(S_OK)))
+        .WillOnce(DoAll(SetArgPointee<3>(0), Return(S_FALSE)));
+    EXPECT_CALL(metadata_import_, EnumTypeRefs(_, _, _, _))
+        .WillOnce(DoAll(SetArrayArgument<1>(&type_ref_, &type_ref_ + 1),
+                        SetArgPointee<3>(1), Return(S_OK)))
+        .WillOnce(DoAll(SetArgPointee<3>(0), Return(S_FALSE)));
+  }
+
+  ICorDebugModuleMock debug_module_;
+
+  IMetaDataImportMock metadata_import_;
+
+  ICorDebugHelperMock debug_helper_;
+
+  ModuleTypeCache type_cache_;
+
+  mdTypeDef type_def_ = 0x02000002;
+
+  string type_def_name_ = "MyNamespace.MyClass";
+
+  mdTypeRef type_ref_ = 0x01000003;
+
+  string type_ref_name_ = "System.String";
+};
+
+// Tests that the types of a module are enumerated once and then
+// returned from the cache.
+TEST_F(ModuleTypeCacheTest, GetTypeDict) {
+  SetUpTypeEnumeration();
+
+  shared_ptr<const ModuleTypeDict> type_dict;
+  EXPECT_EQ(type_cache_.GetTypeDict(&debug_module_, &metadata_import_,
+                                    &debug_helper_, &type_dict),
+            S_OK);
+  ASSERT_NE(type_dict, nullptr);
+  ASSERT_EQ(type_dict->type_defs.size(), 1);
+  EXPECT_EQ(type_dict->type_defs.at(type_def_name_), type_def_);
+  ASSERT_EQ(type_dict->type_refs.size(), 1);
+  EXPECT_EQ(type_dict->type_refs.at(type_ref_name_), type_ref_);
+
+  shared_ptr<const ModuleTypeDict> cached_type_dict;
+  EXPECT_EQ(type_cache_.GetTypeDict(&debug_module_, &metadata_import_,
+                                    &debug_helper_, &cached_type_dict),
+            S_OK);
+  EXPECT_EQ(cached_type_dict, type_dict);
+}
+
+// Tests that the types of a module are enumerated again after
+// the module is removed.
+TEST_F(ModuleTypeCacheTest, RemoveModule) {
+  SetUpTypeEnumeration();
+
+  shared_ptr<const ModuleTypeDict> type_dict;
+  EXPECT_EQ(type_cache_.GetTypeDict(&debug_module_, &metadata_import_,
+                                    &debug_helper_, &type_dict),
+            S_OK);
+
+  type_cache_.RemoveModule(0x1000);
+  SetUpTypeEnumeration();
+
+  shared_ptr<const ModuleTypeDict> new_type_dict;
+  EXPECT_EQ(type_cache_.GetTypeDict(&debug_module_, &metadata_import_,
+                                    &debug_helper_, &new_type_dict),
+            S_OK);
+  ASSERT_NE(new_type_dict, nullptr);
+  EXPECT_NE(new_type_dict, type_dict);
+  EXPECT_EQ(new_type_dict->type_defs.size(), 1);
+}
+
+// Tests that a failed enumeration is not cached.
+TEST_F(ModuleTypeCacheTest, GetTypeDictError) {
+  EXPECT_CALL(metadata_import_, EnumTypeDefs(_, _, _, _))
+      .WillOnce(Return(E_FAIL));
+
+  shared_ptr<const ModuleTypeDict> type_dict;
+  EXPECT_EQ(type_cache_.GetTypeDict(&debug_module_, &metadata_import_,
+                                    &debug_helper_, &type_dict),
+            E_FAIL);
+  EXPECT_EQ(type_dict, nullptr);
+
+  SetUpTypeEnumeration();
+  EXPECT_EQ(type_cache_.GetTypeDict(&debug_module_, &metadata_import_,
+                                    &debug_helper_, &type_dict),
+            S_OK);
+  EXPECT_NE(type_dict, nullptr);
+}
+
+// Tests null arguments.
+TEST_F(ModuleTypeCacheTest, NullArguments) {
+  shared_ptr<const ModuleTypeDict> type_dict;
+  EXPECT_EQ(type_cache_.GetTypeDict(nullptr, &metadata_import_,
+                                    &debug_helper_, &type_dict),
+            E_INVALIDARG);
+  EXPECT_EQ(type_cache_.GetTypeDict(&debug_module_, &metadata_import_,
+                                    &debug_helper_, nullptr),
+            E_INVALIDARG);
+  EXPECT_EQ(type_cache_.GetDebugAssemblies(nullptr, &debug_helper_, nullptr),
+            E_INVALIDARG);
+}
+
+}  // namespace google_cloud_debugger_test
@@ -0,0 +1,139 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+
+#include "common_action_mocks.h"
+#include "cor_debug_helper.h"
+#include "dbg_string.h"
+#include "i_cor_debug_mocks.h"
+#include "object_handle_pool.h"
+
+using google_cloud_debugger::ConvertStringToWCharPtr;
+using google_cloud_debugger::CorDebugHelper;
+using google_cloud_debugger::DbgString;
+using google_cloud_debugger::ICorDebugHelper;
+using google_cloud_debugger::ObjectHandlePool;
+using google_cloud_debugger::ScopedObjectHandlePool;
+using std::string;
+using std::vector;
+using ::testing::_;
+using ::testing::Return;
+using ::testing::SetArgPointee;
+using ::testing::SetArrayArgument;
+
+namespace google_cloud_debugger_test {
+
+// Test Fixture for ObjectHandlePool. Strings are used as the reference
+// objects.
+class ObjectHandlePoolTest : public ::testing::Test {
+ protected:
+  virtual void SetUp() {
+    debug_helper_ = std::shared_ptr<ICorDebugHelper>(new CorDebugHelper());
+
+    ON_CALL(string_value_, QueryInterface(__uuidof(ICorDebugHeapValue2), _))
+        .WillByDefault(DoAll(SetArgPointee<1>(&heap_value_), Return(S_OK)));
+    ON_CALL(handle_value_, Dereference(_))
+        .WillByDefault(DoAll(SetArgPointee<0>(&string_value_), Return(S_OK)));
+    ON_CALL(string_value_, QueryInterface(__uuidof(ICorDebugStringValue), _))
+        .WillByDefault(DoAll(SetArgPointee<1>(&string_value_), Return(S_OK)));
+  }
+
+  // ICorDebugValue that represents the string.
+  ICorDebugStringValueMock string_value_;
+
+  // Heap and handle value created for the string.
+  ICorDebugHeapValue2Mock heap_value_;
+  ICorDebugHandleValueMock handle_value_;
+
+  std::shared_ptr<ICorDebugHelper> debug_helper_;
+};
+
+// Tests that objects created while a pool is current only get a handle
+// when the pool creates the pending handles, and that the handles are
+// disposed when the pool is closed.
+TEST_F(ObjectHandlePoolTest, DefersHandles) {
+  std::unique_ptr<ObjectHandlePool> pool(new ObjectHandlePool());
+  ScopedObjectHandlePool scoped_pool(pool.get());
+  EXPECT_EQ(ObjectHandlePool::GetCurrent(), pool.get());
+
+  EXPECT_CALL(heap_value_, CreateHandle(_, _)).Times(0);
+  DbgString dbg_string(nullptr, debug_helper_);
+  dbg_string.Initialize(&string_value_, FALSE);
+  EXPECT_EQ(dbg_string.GetInitializeHr(), S_OK);
+  EXPECT_EQ(pool->GetObjectCount(), 1);
+
+  // The value is read without a handle.
+  static const string test_string_value = "test";
+  vector<WCHAR> wchar_string = ConvertStringToWCharPtr(test_string_value);
+  uint32_t string_size = wchar_string.size();
+  EXPECT_CALL(string_value_, GetLength(_))
+      .WillRepeatedly(DoAll(SetArgPointee<0>(string_size - 1), Return(S_OK)));
+  EXPECT_CALL(string_value_, GetString(string_size, _, _))
+      .WillRepeatedly(
+          DoAll(SetArrayArgument<2>(wchar_string.data(),
+                                    wchar_string.data() + string_size),
+                Return(S_OK)));
+  string returned_string;
+  EXPECT_EQ(DbgString::GetString(&dbg_string, &returned_string), S_OK);
+  EXPECT_EQ(returned_string, test_string_value);
+  ::testing::Mock::VerifyAndClearExpectations(&heap_value_);
+
+  EXPECT_CALL(heap_value_, CreateHandle(_, _))
+      .Times(1)
+      .WillRepeatedly(DoAll(SetArgPointee<1>(&handle_value_), Return(S_OK)));
+  pool->CreatePendingHandles();
+  EXPECT_EQ(pool->GetHandleCount(), 1);
+
+  // Handles are only created once.
+  pool->CreatePendingHandles();
+  EXPECT_EQ(pool->GetHandleCount(), 1);
+
+  EXPECT_CALL(handle_value_, Dispose()).Times(1).WillOnce(Return(S_OK));
+  pool.reset();
+}
+
+// Tests that objects deleted before their handle is needed never get
+// one.
+TEST_F(ObjectHandlePoolTest, DeletedObject) {
+  ObjectHandlePool pool;
+  ScopedObjectHandlePool scoped_pool(&pool);
+
+  EXPECT_CALL(heap_value_, CreateHandle(_, _)).Times(0);
+  {
+    DbgString dbg_string(nullptr, debug_helper_);
+    dbg_string.Initialize(&string_value_, FALSE);
+  }
+
+  pool.CreatePendingHandles();
+  EXPECT_EQ(pool.GetObjectCount(), 1);
+  EXPECT_EQ(pool.GetHandleCount(), 0);
+}
+
+// Tests that handles are created right away without a current pool.
+TEST_F(ObjectHandlePoolTest, NoPool) {
+  EXPECT_EQ(ObjectHandlePool::GetCurrent(), nullptr);
+
+  EXPECT_CALL(heap_value_, CreateHandle(_, _))
+      .Times(1)
+      .WillRepeatedly(DoAll(SetArgPointee<1>(&handle_value_), Return(S_OK)));
+  DbgString dbg_string(nullptr, debug_helper_);
+  dbg_string.Initialize(&string_value_, FALSE);
+  EXPECT_EQ(dbg_string.GetInitializeHr(), S_OK);
+}
+
+}  // namespace google_cloud_debugger_test
@@ -0,0 +1,132 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+#include "i_portable_pdb_mocks.h"
+#include "pdb_file_index.h"
+
+using google_cloud_debugger::PdbFileIndex;
+using std::shared_ptr;
+using std::vector;
+
+namespace google_cloud_debugger_test {
+
+// Tests that PDB files are looked up by the base address they are
+// added with.
+TEST(PdbFileIndexTest, GetPdbFile) {
+  PdbFileIndex pdb_index;
+  shared_ptr<IPortablePdbFileMock> first_pdb_file =
+      std::make_shared<IPortablePdbFileMock>();
+  shared_ptr<IPortablePdbFileMock> second_pdb_file =
+      std::make_shared<IPortablePdbFileMock>();
+
+  pdb_index.AddPdbFile(0x1000, first_pdb_file);
+  pdb_index.AddPdbFile(0x2000, second_pdb_file);
+
+  EXPECT_EQ(pdb_index.GetPdbFile(0x1000), first_pdb_file);
+  EXPECT_EQ(pdb_index.GetPdbFile(0x2000), second_pdb_file);
+  EXPECT_EQ(pdb_index.GetPdbFile(0x3000), nullptr);
+
+  ASSERT_EQ(pdb_index.GetPdbFiles().size(), 2);
+  EXPECT_EQ(pdb_index.GetPdbFiles()[0], first_pdb_file);
+  EXPECT_EQ(pdb_index.GetPdbFiles()[1], second_pdb_file);
+}
+
+// Tests that adding a PDB file at the base address of another one
+// replaces it.
+TEST(PdbFileIndexTest, AddPdbFileReplaces) {
+  PdbFileIndex pdb_index;
+  shared_ptr<IPortablePdbFileMock> first_pdb_file =
+      std::make_shared<IPortablePdbFileMock>();
+  shared_ptr<IPortablePdbFileMock> second_pdb_file =
+      std::make_shared<IPortablePdbFileMock>();
+
+  pdb_index.AddPdbFile(0x1000, first_pdb_file);
+  pdb_index.AddPdbFile(0x1000, second_pdb_file);
+
+  EXPECT_EQ(pdb_index.GetPdbFile(0x1000), second_pdb_file);
+  ASSERT_EQ(pdb_index.GetPdbFiles().size(), 1);
+  EXPECT_EQ(pdb_index.GetPdbFiles()[0], second_pdb_file);
+}
+
+// Tests that removed PDB files are no longer looked up.
+TEST(PdbFileIndexTest, RemovePdbFile) {
+  PdbFileIndex pdb_index;
+  shared_ptr<IPortablePdbFileMock> first_pdb_file =
+      std::make_shared<IPortablePdbFileMock>();
+  shared_ptr<IPortablePdbFileMock> second_pdb_file =
+      std::make_shared<IPortablePdbFileMock>();
+
+  pdb_index.AddPdbFile(0x1000, first_pdb_file);
+  pdb_index.AddPdbFile(0x2000, second_pdb_file);
+
+  EXPECT_TRUE(pdb_index.RemovePdbFile(0x1000));
+  EXPECT_FALSE(pdb_index.RemovePdbFile(0x1000));
+  EXPECT_FALSE(pdb_index.RemovePdbFile(0x3000));
+
+  EXPECT_EQ(pdb_index.GetPdbFile(0x1000), nullptr);
+  EXPECT_EQ(pdb_index.GetPdbFile(0x2000), second_pdb_file);
+  ASSERT_EQ(pdb_index.GetPdbFiles().size(), 1);
+  EXPECT_EQ(pdb_index.GetPdbFiles()[0], second_pdb_file);
+}
+
+// Tests that null PDB files are not added.
+TEST(PdbFileIndexTest, AddNullPdbFile) {
+  PdbFileIndex pdb_index;
+  pdb_index.AddPdbFile(0x1000, nullptr);
+
+  EXPECT_EQ(pdb_index.GetPdbFile(0x1000), nullptr);
+  EXPECT_TRUE(pdb_index.GetPdbFiles().empty());
+}
+
+// Tests that modifying a copy of an index does not change the index
+// and that the PDB files added in many batches stay in few segments.
+TEST(PdbFileIndexTest, CopyOnWrite) {
+  vector<shared_ptr<IPortablePdbFileMock>> pdb_files;
+  PdbFileIndex published_index;
+  for (CORDB_ADDRESS batch = 0; batch < 100; ++batch) {
+    PdbFileIndex pdb_index(published_index);
+    for (CORDB_ADDRESS i = 0; i < 3; ++i) {
+      pdb_files.push_back(std::make_shared<IPortablePdbFileMock>());
+      pdb_index.AddPdbFile(batch * 3 + i, pdb_files.back());
+    }
+    published_index = pdb_index;
+  }
+
+  ASSERT_EQ(published_index.GetPdbFiles().size(), pdb_files.size());
+  for (CORDB_ADDRESS i = 0; i < pdb_files.size(); ++i) {
+    EXPECT_EQ(published_index.GetPdbFile(i), pdb_files[i]);
+    EXPECT_EQ(published_index.GetPdbFiles()[i], pdb_files[i]);
+  }
+  EXPECT_LE(published_index.GetSegmentCount(), 10);
+
+  PdbFileIndex pdb_index(published_index);
+  EXPECT_TRUE(pdb_index.RemovePdbFile(5));
+  shared_ptr<IPortablePdbFileMock> replacement =
+      std::make_shared<IPortablePdbFileMock>();
+  pdb_index.AddPdbFile(7, replacement);
+
+  EXPECT_EQ(pdb_index.GetPdbFile(5), nullptr);
+  EXPECT_EQ(pdb_index.GetPdbFile(7), replacement);
+  EXPECT_EQ(pdb_index.GetPdbFiles().size(), pdb_files.size() - 1);
+  EXPECT_EQ(published_index.GetPdbFile(5), pdb_files[5]);
+  EXPECT_EQ(published_index.GetPdbFile(7), pdb_files[7]);
+  EXPECT_EQ(published_index.GetPdbFiles().size(), pdb_files.size());
+}
+
+}  // namespace google_cloud_debugger_test
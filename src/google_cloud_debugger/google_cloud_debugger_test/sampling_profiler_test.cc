@@ -0,0 +1,76 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "sampling_profiler.h"
+
+using google_cloud_debugger::FoldedStacks;
+using std::string;
+using std::vector;
+
+namespace google_cloud_debugger_test {
+
+// Tests that stacks are folded from the outermost frame and that
+// the samples of the same stack are counted together.
+TEST(FoldedStacksTest, AddSample) {
+  FoldedStacks folded_stacks;
+  folded_stacks.AddSample({"App!Worker.Compute", "App!Program.Main"});
+  folded_stacks.AddSample({"App!Worker.Compute", "App!Program.Main"});
+  folded_stacks.AddSample({"App!Program.Main"});
+
+  EXPECT_EQ(folded_stacks.GetSampleCount(), 3);
+
+  std::ostringstream out;
+  folded_stacks.Write(&out);
+  EXPECT_EQ(out.str(),
+            "App!Program.Main 1\n"
+            "App!Program.Main;App!Worker.Compute 2\n");
+}
+
+// Tests that empty stacks are not sampled.
+TEST(FoldedStacksTest, EmptyStack) {
+  FoldedStacks folded_stacks;
+  folded_stacks.AddSample({});
+  EXPECT_EQ(folded_stacks.GetSampleCount(), 0);
+
+  std::ostringstream out;
+  folded_stacks.Write(&out);
+  EXPECT_TRUE(out.str().empty());
+}
+
+// Tests that the samples of new stacks are counted together once
+// the maximum number of stacks is reached.
+TEST(FoldedStacksTest, MaximumStacks) {
+  FoldedStacks folded_stacks;
+  for (std::size_t i = 0; i < FoldedStacks::kMaximumStacks + 2; ++i) {
+    folded_stacks.AddSample({"App!Program.Method" + std::to_string(i)});
+  }
+  folded_stacks.AddSample({"App!Program.Method0"});
+
+  EXPECT_EQ(folded_stacks.GetSampleCount(), FoldedStacks::kMaximumStacks + 3);
+
+  std::ostringstream out;
+  folded_stacks.Write(&out);
+  string folded = out.str();
+  EXPECT_NE(folded.find("App!Program.Method0 2\n"), string::npos);
+  EXPECT_NE(folded.find(string(FoldedStacks::kOtherStacks) + " 2\n"),
+            string::npos);
+}
+
+}  // namespace google_cloud_debugger_test
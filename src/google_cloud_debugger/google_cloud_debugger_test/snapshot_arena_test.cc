@@ -0,0 +1,127 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include "snapshot_arena.h"
+
+using google_cloud_debugger::ScopedSnapshotArena;
+using google_cloud_debugger::SnapshotAllocator;
+using google_cloud_debugger::SnapshotAllocated;
+using google_cloud_debugger::SnapshotArena;
+using std::unique_ptr;
+using std::vector;
+
+namespace google_cloud_debugger_test {
+
+// Object allocated from the current arena that counts its destructions.
+class FakeArenaObject : public SnapshotAllocated {
+ public:
+  explicit FakeArenaObject(int *destroyed) : destroyed_(destroyed) {}
+  ~FakeArenaObject() { ++*destroyed_; }
+
+ private:
+  int *destroyed_;
+  char payload_[100];
+};
+
+// Tests that objects created without an arena are not counted.
+TEST(SnapshotArenaTest, NoArena) {
+  EXPECT_EQ(SnapshotArena::GetCurrent(), nullptr);
+
+  int destroyed = 0;
+  unique_ptr<FakeArenaObject> object(new FakeArenaObject(&destroyed));
+  object.reset();
+  EXPECT_EQ(destroyed, 1);
+}
+
+// Tests that objects created in the scope are allocated from chunks
+// of the arena.
+TEST(SnapshotArenaTest, AllocatesFromChunks) {
+  int destroyed = 0;
+  {
+    ScopedSnapshotArena scope;
+    SnapshotArena *arena = scope.GetArena();
+    ASSERT_NE(arena, nullptr);
+    EXPECT_EQ(SnapshotArena::GetCurrent(), arena);
+
+    vector<unique_ptr<FakeArenaObject>> objects;
+    for (int i = 0; i < 1000; ++i) {
+      objects.push_back(unique_ptr<FakeArenaObject>(
+          new (std::nothrow) FakeArenaObject(&destroyed)));
+      ASSERT_NE(objects.back(), nullptr);
+    }
+
+    EXPECT_EQ(arena->GetAllocationCount(), 1000);
+    EXPECT_LT(arena->GetChunkCount(), 10);
+  }
+
+  EXPECT_EQ(destroyed, 1000);
+  EXPECT_EQ(SnapshotArena::GetCurrent(), nullptr);
+}
+
+// Tests that nested scopes restore the previous arena.
+TEST(SnapshotArenaTest, NestedScopes) {
+  ScopedSnapshotArena outer;
+  {
+    ScopedSnapshotArena inner;
+    EXPECT_EQ(SnapshotArena::GetCurrent(), inner.GetArena());
+  }
+  EXPECT_EQ(SnapshotArena::GetCurrent(), outer.GetArena());
+}
+
+// Tests that an object can outlive the scope of its arena.
+TEST(SnapshotArenaTest, ObjectOutlivesScope) {
+  int destroyed = 0;
+  unique_ptr<FakeArenaObject> object;
+  {
+    ScopedSnapshotArena scope;
+    object.reset(new FakeArenaObject(&destroyed));
+  }
+
+  EXPECT_EQ(destroyed, 0);
+  object.reset();
+  EXPECT_EQ(destroyed, 1);
+}
+
+// Tests that containers using SnapshotAllocator allocate from the arena
+// and can be used after the scope of the arena.
+TEST(SnapshotArenaTest, Allocator) {
+  std::deque<int, SnapshotAllocator<int>> outliving_queue;
+  {
+    ScopedSnapshotArena scope;
+    SnapshotArena *arena = scope.GetArena();
+    ASSERT_NE(arena, nullptr);
+
+    vector<int, SnapshotAllocator<int>> values;
+    values.reserve(100);
+    EXPECT_EQ(arena->GetAllocationCount(), 1);
+
+    for (int i = 0; i < 1000; ++i) {
+      outliving_queue.push_back(i);
+    }
+    EXPECT_GT(arena->GetAllocationCount(), 1);
+  }
+
+  EXPECT_EQ(outliving_queue.size(), 1000);
+  EXPECT_EQ(outliving_queue.back(), 999);
+  outliving_queue.clear();
+  outliving_queue.shrink_to_fit();
+}
+
+}  // namespace google_cloud_debugger_test
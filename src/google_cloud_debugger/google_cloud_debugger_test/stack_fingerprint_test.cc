@@ -0,0 +1,154 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <chrono>
+#include <utility>
+#include <vector>
+
+#include "stack_fingerprint.h"
+
+using google_cloud_debugger::StackFingerprint;
+using google_cloud_debugger::StackHitCounter;
+using std::chrono::milliseconds;
+using std::chrono::steady_clock;
+
+namespace google_cloud_debugger_test {
+
+// Tests that frames with a different module, method or IL offset
+// have different fingerprints.
+TEST(StackFingerprintTest, HashFrame) {
+  std::uint64_t frame = StackFingerprint::HashFrame(0x1000, 0x6000001, 10);
+  EXPECT_EQ(frame, StackFingerprint::HashFrame(0x1000, 0x6000001, 10));
+  EXPECT_NE(frame, StackFingerprint::HashFrame(0x2000, 0x6000001, 10));
+  EXPECT_NE(frame, StackFingerprint::HashFrame(0x1000, 0x6000002, 10));
+  EXPECT_NE(frame, StackFingerprint::HashFrame(0x1000, 0x6000001, 11));
+}
+
+// Tests that the fingerprint of a stack depends on the order of its frames.
+TEST(StackFingerprintTest, Combine) {
+  std::uint64_t first = StackFingerprint::HashFrame(0x1000, 0x6000001, 10);
+  std::uint64_t second = StackFingerprint::HashFrame(0x1000, 0x6000002, 20);
+
+  std::uint64_t stack = StackFingerprint::Combine(
+      StackFingerprint::Combine(StackFingerprint::kEmptyStack, first), second);
+  std::uint64_t reversed_stack = StackFingerprint::Combine(
+      StackFingerprint::Combine(StackFingerprint::kEmptyStack, second), first);
+
+  EXPECT_NE(stack, StackFingerprint::kEmptyStack);
+  EXPECT_NE(stack, reversed_stack);
+}
+
+// Tests that hits within the window are counted and that a hit after
+// the window starts a new one.
+TEST(StackHitCounterTest, RecordHit) {
+  StackHitCounter counter;
+  steady_clock::time_point now = steady_clock::now();
+  milliseconds window(100);
+
+  EXPECT_EQ(counter.RecordHit(1, window, now), 1);
+  EXPECT_EQ(counter.RecordHit(1, window, now + milliseconds(10)), 2);
+  EXPECT_EQ(counter.RecordHit(1, window, now + milliseconds(99)), 3);
+
+  // Another call stack is counted separately.
+  EXPECT_EQ(counter.RecordHit(2, window, now + milliseconds(50)), 1);
+
+  EXPECT_EQ(counter.RecordHit(1, window, now + milliseconds(100)), 1);
+  EXPECT_EQ(counter.RecordHit(1, window, now + milliseconds(110)), 2);
+}
+
+// Tests that a window of 0 captures every hit.
+TEST(StackHitCounterTest, NoWindow) {
+  StackHitCounter counter;
+  steady_clock::time_point now = steady_clock::now();
+  EXPECT_EQ(counter.RecordHit(1, milliseconds(0), now), 1);
+  EXPECT_EQ(counter.RecordHit(1, milliseconds(0), now), 1);
+}
+
+// Tests that new call stacks are captured once the counter is full
+// and that expired windows make room for them.
+TEST(StackHitCounterTest, Full) {
+  StackHitCounter counter;
+  steady_clock::time_point now = steady_clock::now();
+  milliseconds window(100);
+  for (std::uint64_t i = 0; i < StackHitCounter::kMaximumFingerprints; ++i) {
+    EXPECT_EQ(counter.RecordHit(i, window, now), 1);
+  }
+
+  std::uint64_t new_stack = StackHitCounter::kMaximumFingerprints;
+  EXPECT_EQ(counter.RecordHit(new_stack, window, now), 1);
+  EXPECT_EQ(counter.RecordHit(new_stack, window, now), 1);
+
+  // Once the windows expire, the new call stack is tracked.
+  now += window;
+  EXPECT_EQ(counter.RecordHit(new_stack, window, now), 1);
+  EXPECT_EQ(counter.RecordHit(new_stack, window, now), 2);
+}
+
+// Tests that the counts of the windows that ended with more than one hit
+// are taken once.
+TEST(StackHitCounterTest, TakeEndedWindows) {
+  StackHitCounter counter;
+  steady_clock::time_point now = steady_clock::now();
+  milliseconds window(100);
+
+  counter.RecordHit(1, window, now);
+  counter.RecordHit(1, window, now + milliseconds(10));
+  counter.RecordHit(1, window, now + milliseconds(20));
+  counter.RecordHit(2, window, now + milliseconds(50));
+
+  std::vector<std::pair<std::uint64_t, std::uint32_t>> ended_windows;
+  counter.TakeEndedWindows(window, now + milliseconds(60), false,
+                           &ended_windows);
+  EXPECT_TRUE(ended_windows.empty());
+
+  // Only the window of the first stack ended and the second stack
+  // was only hit once.
+  counter.TakeEndedWindows(window, now + milliseconds(100), false,
+                           &ended_windows);
+  ASSERT_EQ(ended_windows.size(), 1);
+  EXPECT_EQ(ended_windows[0].first, 1);
+  EXPECT_EQ(ended_windows[0].second, 3);
+
+  ended_windows.clear();
+  counter.TakeEndedWindows(window, now + milliseconds(200), false,
+                           &ended_windows);
+  EXPECT_TRUE(ended_windows.empty());
+}
+
+// Tests that a window restarted by a hit keeps the count of the window
+// that ended and that flushing takes the windows that did not end.
+TEST(StackHitCounterTest, TakeEndedWindowsFlushAll) {
+  StackHitCounter counter;
+  steady_clock::time_point now = steady_clock::now();
+  milliseconds window(100);
+
+  counter.RecordHit(1, window, now);
+  counter.RecordHit(1, window, now + milliseconds(10));
+  EXPECT_EQ(counter.RecordHit(1, window, now + milliseconds(100)), 1);
+  counter.RecordHit(1, window, now + milliseconds(110));
+  counter.RecordHit(1, window, now + milliseconds(120));
+
+  std::vector<std::pair<std::uint64_t, std::uint32_t>> ended_windows;
+  counter.TakeEndedWindows(window, now + milliseconds(130), true,
+                           &ended_windows);
+  ASSERT_EQ(ended_windows.size(), 2);
+  EXPECT_EQ(ended_windows[0].second, 2);
+  EXPECT_EQ(ended_windows[1].second, 3);
+
+  // The next hit starts a new window.
+  EXPECT_EQ(counter.RecordHit(1, window, now + milliseconds(140)), 1);
+}
+
+}  // namespace google_cloud_debugger_test
@@ -28,11 +28,13 @@
 #include "i_eval_coordinator_mock.h"
 #include "i_metadata_import_mock.h"
 #include "i_portable_pdb_mocks.h"
+#include "pdb_file_index.h"
 #include "stack_frame_collection.h"
 
 using google::cloud::diagnostics::debug::Breakpoint;
 using google::cloud::diagnostics::debug::StackFrame;
 using google::cloud::diagnostics::debug::Variable;
+using google_cloud_debugger::CaptureProfile;
 using google_cloud_debugger::CComPtr;
 using google_cloud_debugger::ConvertStringToWCharPtr;
 using google_cloud_debugger::CorDebugHelper;
@@ -42,7 +44,10 @@ using google_cloud_debugger::DbgObjectFactory;
 using google_cloud_debugger::DbgPrimitive;
 using google_cloud_debugger::ICorDebugHelper;
 using google_cloud_debugger::IDbgObjectFactory;
+using google_cloud_debugger::PdbFileIndex;
 using google_cloud_debugger::StackFrameCollection;
+using google_cloud_debugger::StackFrameMethod;
+using google_cloud_debugger::StackFrameMethodCache;
 using google_cloud_debugger_portable_pdb::LocalVariableInfo;
 using google_cloud_debugger_portable_pdb::MethodInfo;
 using google_cloud_debugger_portable_pdb::Scope;
@@ -270,6 +275,10 @@ class StackFrameCollectionTest : public ::testing::Test {
   // Sets up debug_module_ so it will return module_name_
   // when queried.
   virtual void SetUpDebugModule() {
+    ON_CALL(debug_module_, GetBaseAddress(_))
+        .WillByDefault(
+            DoAll(SetArgPointee<0>(module_base_address_), Return(S_OK)));
+
     ON_CALL(debug_module_, GetMetaDataInterface(IID_IMetaDataImport, _))
         .WillByDefault(
             DoAll(SetArgPointee<1>(&metadata_import_), Return(S_OK)));
@@ -299,13 +308,13 @@ class StackFrameCollectionTest : public ::testing::Test {
 
   virtual void SetUpPDBFile() {
     // Creates a Portable PDB file, sets up mock calls
-    // and pushes it into the pdb_files_.
+    // and adds it to pdb_index_.
     unique_ptr<IPortablePdbFileMock> pdb_file =
         unique_ptr<IPortablePdbFileMock>(new IPortablePdbFileMock());
     pdb_file_fixture_.module_name_ = module_name_;
     pdb_file_fixture_.SetUpIPortablePDBFile(pdb_file.get());
 
-    pdb_files_.push_back(std::move(pdb_file));
+    pdb_index_.AddPdbFile(module_base_address_, std::move(pdb_file));
 
     MethodInfo method;
     // Method def can just be some random number, not important here.
@@ -341,12 +350,11 @@ class StackFrameCollectionTest : public ::testing::Test {
   // IDbgObjectFactory used for StackFrameCollection constructor.
   std::shared_ptr<IDbgObjectFactory> dbg_object_factory_;
 
-  // Vector of PDB files that will be fed to the Initialize function
+  // Index of PDB files that will be fed to the ProcessBreakpoint function
   // of StackFrameCollection.
-  std::vector<shared_ptr<google_cloud_debugger_portable_pdb::IPortablePdbFile>>
-      pdb_files_;
+  PdbFileIndex pdb_index_;
 
-  // The PDB file fixture for the first PDB file in pdb_files_ vector.
+  // The PDB file fixture for the first PDB file in pdb_index_.
   PortablePDBFileFixture pdb_file_fixture_;
 
   // Stack walk used by the stack frame collection.
@@ -370,6 +378,9 @@ class StackFrameCollectionTest : public ::testing::Test {
   // Name of the module above.
   string module_name_ = "MyModule";
 
+  // Base address of the module above.
+  CORDB_ADDRESS module_base_address_ = 0x10000;
+
   // Eval coordinator used to evaluate breakpoint.
   IEvalCoordinatorMock eval_coordinator_;
 
@@ -390,7 +401,7 @@ TEST_F(StackFrameCollectionTest, TestInitializeWithoutPDBFile) {
                                               dbg_object_factory_);
   SetUpStackWalk();
   HRESULT hr = stack_frame_collection.ProcessBreakpoint(
-      pdb_files_, &dbg_breakpoint_, &eval_coordinator_);
+      pdb_index_, &dbg_breakpoint_, &eval_coordinator_);
   EXPECT_TRUE(SUCCEEDED(hr)) << "Failed with hr: " << hr;
 }
 
@@ -402,7 +413,7 @@ TEST_F(StackFrameCollectionTest, TestInitializeWithPDBFile) {
   SetUpStackWalk();
   SetUpPDBFile();
   HRESULT hr = stack_frame_collection.ProcessBreakpoint(
-      pdb_files_, &dbg_breakpoint_, &eval_coordinator_);
+      pdb_index_, &dbg_breakpoint_, &eval_coordinator_);
   EXPECT_TRUE(SUCCEEDED(hr)) << "Failed with hr: " << hr;
 }
 
@@ -416,7 +427,7 @@ TEST_F(StackFrameCollectionTest, TestInitializeError) {
     StackFrameCollection stack_frame_collection(debug_helper_,
                                                 dbg_object_factory_);
     EXPECT_EQ(stack_frame_collection.ProcessBreakpoint(
-                  pdb_files_, &dbg_breakpoint_, &eval_coordinator_),
+                  pdb_index_, &dbg_breakpoint_, &eval_coordinator_),
               E_ACCESSDENIED);
   }
 
@@ -424,11 +435,11 @@ TEST_F(StackFrameCollectionTest, TestInitializeError) {
   {
     StackFrameCollection stack_frame_collection(debug_helper_,
                                                 dbg_object_factory_);
-    EXPECT_EQ(stack_frame_collection.ProcessBreakpoint(pdb_files_, nullptr,
+    EXPECT_EQ(stack_frame_collection.ProcessBreakpoint(pdb_index_, nullptr,
                                                        &eval_coordinator_),
               E_INVALIDARG);
     EXPECT_EQ(stack_frame_collection.ProcessBreakpoint(
-                  pdb_files_, &dbg_breakpoint_, nullptr),
+                  pdb_index_, &dbg_breakpoint_, nullptr),
               E_INVALIDARG);
   }
 }
@@ -452,7 +463,7 @@ TEST_F(StackFrameCollectionTest, TestInitializeWithMoreThan20Frames) {
       .WillRepeatedly(Return(CORDBG_E_CODE_NOT_AVAILABLE));
 
   HRESULT hr = stack_frame_collection.ProcessBreakpoint(
-      pdb_files_, &dbg_breakpoint_, &eval_coordinator_);
+      pdb_index_, &dbg_breakpoint_, &eval_coordinator_);
   EXPECT_TRUE(SUCCEEDED(hr)) << "Failed with hr: " << hr;
 }
 
@@ -504,7 +515,7 @@ TEST_F(StackFrameCollectionTest, TestInitializeWithFourILFrames) {
   StackFrameCollection stack_frame_collection(debug_helper_,
                                               dbg_object_factory_);
   HRESULT hr = stack_frame_collection.ProcessBreakpoint(
-      pdb_files_, &dbg_breakpoint_, &eval_coordinator_);
+      pdb_index_, &dbg_breakpoint_, &eval_coordinator_);
   EXPECT_TRUE(SUCCEEDED(hr)) << "Failed with hr: " << hr;
 }
 
@@ -515,13 +526,13 @@ TEST_F(StackFrameCollectionTest, TestPopulateStackFrames) {
   SetUpStackWalk();
   SetUpPDBFile();
   HRESULT hr = stack_frame_collection.ProcessBreakpoint(
-      pdb_files_, &dbg_breakpoint_, &eval_coordinator_);
+      pdb_index_, &dbg_breakpoint_, &eval_coordinator_);
   EXPECT_TRUE(SUCCEEDED(hr)) << "Failed with hr: " << hr;
 
   Breakpoint breakpoint;
   IEvalCoordinatorMock eval_coordinator;
-  hr = stack_frame_collection.PopulateStackFrames(&breakpoint,
-                                                  &eval_coordinator);
+  hr = stack_frame_collection.PopulateStackFrames(
+      &breakpoint, CaptureProfile(), &eval_coordinator);
   EXPECT_TRUE(SUCCEEDED(hr)) << "Failed with hr: " << hr;
 
   // Should have 3 frames.
@@ -563,17 +574,237 @@ TEST_F(StackFrameCollectionTest, TestPopulateStackFramesError) {
   SetUpStackWalk();
   SetUpPDBFile();
   HRESULT hr = stack_frame_collection.ProcessBreakpoint(
-      pdb_files_, &dbg_breakpoint_, &eval_coordinator_);
+      pdb_index_, &dbg_breakpoint_, &eval_coordinator_);
   EXPECT_TRUE(SUCCEEDED(hr)) << "Failed with hr: " << hr;
 
   Breakpoint breakpoint;
   IEvalCoordinatorMock eval_coordinator;
-  EXPECT_EQ(stack_frame_collection.PopulateStackFrames(nullptr,
-                                                       &eval_coordinator),
+  EXPECT_EQ(stack_frame_collection.PopulateStackFrames(
+                nullptr, CaptureProfile(), &eval_coordinator),
             E_INVALIDARG);
-  EXPECT_EQ(stack_frame_collection.PopulateStackFrames(&breakpoint,
-                                                       nullptr),
+  EXPECT_EQ(stack_frame_collection.PopulateStackFrames(
+                &breakpoint, CaptureProfile(), nullptr),
             E_INVALIDARG);
 }
 
+// Tests that PopulateStackFrames only reports the number of frames
+// allowed by the capture profile of the breakpoint.
+TEST_F(StackFrameCollectionTest, TestPopulateStackFramesProfile) {
+  StackFrameCollection stack_frame_collection(debug_helper_,
+                                              dbg_object_factory_);
+  SetUpStackWalk();
+  SetUpPDBFile();
+  HRESULT hr = stack_frame_collection.ProcessBreakpoint(
+      pdb_index_, &dbg_breakpoint_, &eval_coordinator_);
+  EXPECT_TRUE(SUCCEEDED(hr)) << "Failed with hr: " << hr;
+
+  CaptureProfile capture_profile;
+  capture_profile.max_stack_frames = 2;
+  capture_profile.max_stack_frames_with_variables = 0;
+
+  Breakpoint breakpoint;
+  IEvalCoordinatorMock eval_coordinator;
+  hr = stack_frame_collection.PopulateStackFrames(&breakpoint, capture_profile,
+                                                  &eval_coordinator);
+  EXPECT_TRUE(SUCCEEDED(hr)) << "Failed with hr: " << hr;
+
+  ASSERT_EQ(breakpoint.stack_frames_size(), 2);
+  EXPECT_EQ(breakpoint.stack_frames(0).method_name(),
+            first_frame_.GetFullMethodName(module_name_));
+  // The location is still reported for frames without variables.
+  EXPECT_EQ(breakpoint.stack_frames(0).location().path(),
+            pdb_file_fixture_.first_doc_.file_name_);
+  EXPECT_EQ(breakpoint.stack_frames(0).locals_size(), 0);
+  EXPECT_EQ(breakpoint.stack_frames(0).arguments_size(), 0);
+}
+
+// Tests that a stack-only breakpoint gets the names and locations of
+// all the frames but none of their variables.
+TEST_F(StackFrameCollectionTest, TestPopulateStackFramesStackOnly) {
+  StackFrameCollection stack_frame_collection(debug_helper_,
+                                              dbg_object_factory_);
+  SetUpStackWalk();
+  SetUpPDBFile();
+  HRESULT hr = stack_frame_collection.ProcessBreakpoint(
+      pdb_index_, &dbg_breakpoint_, &eval_coordinator_);
+  EXPECT_TRUE(SUCCEEDED(hr)) << "Failed with hr: " << hr;
+
+  CaptureProfile capture_profile;
+  capture_profile.stack_only = true;
+
+  Breakpoint breakpoint;
+  IEvalCoordinatorMock eval_coordinator;
+  hr = stack_frame_collection.PopulateStackFrames(&breakpoint, capture_profile,
+                                                  &eval_coordinator);
+  EXPECT_TRUE(SUCCEEDED(hr)) << "Failed with hr: " << hr;
+
+  ASSERT_EQ(breakpoint.stack_frames_size(), 3);
+  EXPECT_EQ(breakpoint.stack_frames(0).location().path(),
+            pdb_file_fixture_.first_doc_.file_name_);
+  for (const StackFrame &frame : breakpoint.stack_frames()) {
+    EXPECT_EQ(frame.locals_size(), 0);
+    EXPECT_EQ(frame.arguments_size(), 0);
+  }
+}
+
+// Tests that the methods of the frames are cached and that another
+// stack frame collection sharing the cache does not resolve them again.
+TEST_F(StackFrameCollectionTest, TestMethodCache) {
+  std::shared_ptr<StackFrameMethodCache> method_cache =
+      std::make_shared<StackFrameMethodCache>();
+  {
+    StackFrameCollection stack_frame_collection(
+        debug_helper_, dbg_object_factory_, method_cache);
+    SetUpStackWalk();
+    SetUpPDBFile();
+    HRESULT hr = stack_frame_collection.ProcessBreakpoint(
+        pdb_index_, &dbg_breakpoint_, &eval_coordinator_);
+    EXPECT_TRUE(SUCCEEDED(hr)) << "Failed with hr: " << hr;
+  }
+
+  std::shared_ptr<const StackFrameMethod> method = method_cache->GetMethod(
+      module_base_address_, first_frame_.frame_function_token_);
+  ASSERT_NE(method, nullptr);
+  EXPECT_EQ(method->module_name, module_name_);
+  EXPECT_EQ(method->class_name, first_frame_.frame_class_name_);
+  EXPECT_EQ(method->method_name, first_frame_.frame_function_name_);
+  EXPECT_EQ(method->class_token, first_frame_.frame_class_token_);
+  EXPECT_EQ(method->virtual_address, first_frame_.frame_func_virtual_addr_);
+
+  method = method_cache->GetMethod(module_base_address_,
+                                   second_frame_.frame_function_token_);
+  ASSERT_NE(method, nullptr);
+  EXPECT_EQ(method->method_name, second_frame_.frame_function_name_);
+
+  // The second walk gets all the names from the cache.
+  EXPECT_CALL(debug_module_, GetName(_, _, _)).Times(0);
+  EXPECT_CALL(debug_stack_walk_, GetFrame(_))
+      .WillOnce(DoAll(SetArgPointee<0>(&first_frame_.frame_), Return(S_OK)))
+      .WillOnce(DoAll(SetArgPointee<0>(&second_frame_.frame_), Return(S_OK)))
+      .WillOnce(DoAll(SetArgPointee<0>(&third_frame_.frame_), Return(S_OK)))
+      .WillOnce(Return(S_FALSE));
+
+  StackFrameCollection stack_frame_collection(debug_helper_,
+                                              dbg_object_factory_,
+                                              method_cache);
+  HRESULT hr = stack_frame_collection.ProcessBreakpoint(
+      pdb_index_, &dbg_breakpoint_, &eval_coordinator_);
+  EXPECT_TRUE(SUCCEEDED(hr)) << "Failed with hr: " << hr;
+
+  Breakpoint breakpoint;
+  IEvalCoordinatorMock eval_coordinator;
+  hr = stack_frame_collection.PopulateStackFrames(
+      &breakpoint, CaptureProfile(), &eval_coordinator);
+  EXPECT_TRUE(SUCCEEDED(hr)) << "Failed with hr: " << hr;
+  ASSERT_EQ(breakpoint.stack_frames_size(), 3);
+  EXPECT_EQ(breakpoint.stack_frames(2).method_name(),
+            third_frame_.GetFullMethodName(module_name_));
+}
+
+// Tests that a method cached while its module has no PDB file gets
+// its location once the PDB file of the module is registered.
+TEST_F(StackFrameCollectionTest, TestMethodCachedBeforePdbFile) {
+  std::shared_ptr<StackFrameMethodCache> method_cache =
+      std::make_shared<StackFrameMethodCache>();
+  {
+    StackFrameCollection stack_frame_collection(
+        debug_helper_, dbg_object_factory_, method_cache);
+    SetUpStackWalk();
+    PdbFileIndex empty_index;
+    HRESULT hr = stack_frame_collection.ProcessBreakpoint(
+        empty_index, &dbg_breakpoint_, &eval_coordinator_);
+    EXPECT_TRUE(SUCCEEDED(hr)) << "Failed with hr: " << hr;
+  }
+
+  ASSERT_NE(method_cache->GetMethod(module_base_address_,
+                                    first_frame_.frame_function_token_),
+            nullptr);
+
+  SetUpPDBFile();
+  EXPECT_CALL(debug_stack_walk_, GetFrame(_))
+      .WillOnce(DoAll(SetArgPointee<0>(&first_frame_.frame_), Return(S_OK)))
+      .WillOnce(DoAll(SetArgPointee<0>(&second_frame_.frame_), Return(S_OK)))
+      .WillOnce(DoAll(SetArgPointee<0>(&third_frame_.frame_), Return(S_OK)))
+      .WillOnce(Return(S_FALSE));
+
+  StackFrameCollection stack_frame_collection(debug_helper_,
+                                              dbg_object_factory_,
+                                              method_cache);
+  HRESULT hr = stack_frame_collection.ProcessBreakpoint(
+      pdb_index_, &dbg_breakpoint_, &eval_coordinator_);
+  EXPECT_TRUE(SUCCEEDED(hr)) << "Failed with hr: " << hr;
+
+  Breakpoint breakpoint;
+  IEvalCoordinatorMock eval_coordinator;
+  hr = stack_frame_collection.PopulateStackFrames(
+      &breakpoint, CaptureProfile(), &eval_coordinator);
+  EXPECT_TRUE(SUCCEEDED(hr)) << "Failed with hr: " << hr;
+  ASSERT_EQ(breakpoint.stack_frames_size(), 3);
+  EXPECT_EQ(breakpoint.stack_frames(0).location().path(),
+            pdb_file_fixture_.first_doc_.file_name_);
+}
+
+// Tests that the frame of an async state machine is reported as its
+// kickoff method, resolved from the metadata of the state machine.
+TEST_F(StackFrameCollectionTest, TestStateMachineFrame) {
+  mdTypeDef state_machine_token = 3000;
+  mdTypeDef kickoff_class_token = 5000;
+  string kickoff_class_name = "MyClass";
+
+  EXPECT_CALL(debug_stack_walk_, GetFrame(_))
+      .WillOnce(DoAll(SetArgPointee<0>(&first_frame_.frame_), Return(S_OK)))
+      .WillOnce(Return(S_FALSE));
+  first_frame_.SetUpFrame(&debug_module_, &metadata_import_, 1000, 2000,
+                          "MoveNext", state_machine_token, "<Compute>d__3");
+  first_frame_.SetUpILFrame(false, 0);
+  SetUpDebugModule();
+
+  // The state machine is nested in the class of the kickoff method.
+  EXPECT_CALL(metadata_import_, GetNestedClassProps(state_machine_token, _))
+      .WillOnce(DoAll(SetArgPointee<1>(kickoff_class_token), Return(S_OK)));
+  EXPECT_CALL(metadata_import_,
+              EnumMethodsWithName(_, kickoff_class_token, _, _, 1, _))
+      .WillOnce(DoAll(SetArgPointee<5>(1), Return(S_OK)));
+
+  vector<WCHAR> wchar_kickoff_class_name =
+      ConvertStringToWCharPtr(kickoff_class_name);
+  size_t kickoff_class_name_len = wchar_kickoff_class_name.size();
+  EXPECT_CALL(metadata_import_,
+              GetTypeDefProps(kickoff_class_token, nullptr, 0, _, _, _))
+      .WillRepeatedly(
+          DoAll(SetArgPointee<3>(kickoff_class_name_len), Return(S_OK)));
+  EXPECT_CALL(metadata_import_,
+              GetTypeDefProps(kickoff_class_token, _, kickoff_class_name_len,
+                              _, _, _))
+      .WillRepeatedly(
+          DoAll(SetArg1ToWcharArray(wchar_kickoff_class_name.data(),
+                                    kickoff_class_name_len),
+                SetArgPointee<3>(kickoff_class_name_len), Return(S_OK)));
+
+  std::shared_ptr<StackFrameMethodCache> method_cache =
+      std::make_shared<StackFrameMethodCache>();
+  StackFrameCollection stack_frame_collection(
+      debug_helper_, dbg_object_factory_, method_cache);
+  HRESULT hr = stack_frame_collection.ProcessBreakpoint(
+      pdb_index_, &dbg_breakpoint_, &eval_coordinator_);
+  EXPECT_TRUE(SUCCEEDED(hr)) << "Failed with hr: " << hr;
+
+  std::shared_ptr<const StackFrameMethod> method = method_cache->GetMethod(
+      module_base_address_, first_frame_.frame_function_token_);
+  ASSERT_NE(method, nullptr);
+  EXPECT_TRUE(method->is_state_machine);
+  EXPECT_EQ(method->kickoff_method_name, "Compute");
+  EXPECT_EQ(method->kickoff_class_name, kickoff_class_name);
+  EXPECT_EQ(method->kickoff_class_token, kickoff_class_token);
+
+  Breakpoint breakpoint;
+  IEvalCoordinatorMock eval_coordinator;
+  hr = stack_frame_collection.PopulateStackFrames(
+      &breakpoint, CaptureProfile(), &eval_coordinator);
+  EXPECT_TRUE(SUCCEEDED(hr)) << "Failed with hr: " << hr;
+  ASSERT_EQ(breakpoint.stack_frames_size(), 1);
+  EXPECT_EQ(breakpoint.stack_frames(0).method_name(),
+            module_name_ + "!" + kickoff_class_name + ".Compute");
+}
+
 }  // namespace google_cloud_debugger_test
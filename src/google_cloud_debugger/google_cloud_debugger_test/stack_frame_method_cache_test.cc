@@ -0,0 +1,65 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <memory>
+
+#include "stack_frame_method_cache.h"
+
+using google_cloud_debugger::StackFrameMethod;
+using google_cloud_debugger::StackFrameMethodCache;
+using std::shared_ptr;
+
+namespace google_cloud_debugger_test {
+
+// Tests that methods are cached by module base address and method token.
+TEST(StackFrameMethodCacheTest, AddAndGetMethod) {
+  StackFrameMethodCache method_cache;
+  shared_ptr<StackFrameMethod> method(new StackFrameMethod);
+  method->method_name = "MyMethod";
+
+  EXPECT_EQ(method_cache.GetMethod(0x1000, 100), nullptr);
+  method_cache.AddMethod(0x1000, 100, method);
+
+  shared_ptr<const StackFrameMethod> cached_method =
+      method_cache.GetMethod(0x1000, 100);
+  ASSERT_NE(cached_method, nullptr);
+  EXPECT_EQ(cached_method->method_name, "MyMethod");
+
+  EXPECT_EQ(method_cache.GetMethod(0x1000, 101), nullptr);
+  EXPECT_EQ(method_cache.GetMethod(0x2000, 100), nullptr);
+}
+
+// Tests that RemoveModule only removes the methods of that module.
+TEST(StackFrameMethodCacheTest, RemoveModule) {
+  StackFrameMethodCache method_cache;
+  shared_ptr<StackFrameMethod> method(new StackFrameMethod);
+  method_cache.AddMethod(0x1000, 100, method);
+  method_cache.AddMethod(0x1000, 101, method);
+  method_cache.AddMethod(0x2000, 100, method);
+  method_cache.AddMethod(0x3000, 100, method);
+
+  method_cache.RemoveModule(0x2000);
+  EXPECT_NE(method_cache.GetMethod(0x1000, 100), nullptr);
+  EXPECT_NE(method_cache.GetMethod(0x1000, 101), nullptr);
+  EXPECT_EQ(method_cache.GetMethod(0x2000, 100), nullptr);
+  EXPECT_NE(method_cache.GetMethod(0x3000, 100), nullptr);
+
+  method_cache.RemoveModule(0x1000);
+  EXPECT_EQ(method_cache.GetMethod(0x1000, 100), nullptr);
+  EXPECT_EQ(method_cache.GetMethod(0x1000, 101), nullptr);
+  EXPECT_NE(method_cache.GetMethod(0x3000, 100), nullptr);
+}
+
+}  // namespace google_cloud_debugger_test
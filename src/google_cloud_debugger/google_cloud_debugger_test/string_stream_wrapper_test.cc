@@ -0,0 +1,69 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+#include <string>
+
+#include "string_stream_wrapper.h"
+
+using google_cloud_debugger::ErrorStream;
+using google_cloud_debugger::StringStreamWrapper;
+using std::string;
+
+namespace google_cloud_debugger_test {
+
+// Tests that the error stream is only allocated when an error is written.
+TEST(StringStreamWrapperTest, AllocatesOnFirstError) {
+  StringStreamWrapper wrapper;
+  EXPECT_FALSE(wrapper.HasErrorStream());
+  EXPECT_EQ(wrapper.GetErrorString(), "");
+
+  wrapper.ResetErrorStream();
+  EXPECT_FALSE(wrapper.HasErrorStream());
+
+  wrapper.WriteError("error");
+  EXPECT_TRUE(wrapper.HasErrorStream());
+  EXPECT_EQ(wrapper.GetErrorString(), "error\n");
+
+  wrapper.ResetErrorStream();
+  EXPECT_EQ(wrapper.GetErrorString(), "");
+}
+
+// Tests that an ErrorStream nothing is written to does not allocate
+// the error stream of its owner.
+TEST(StringStreamWrapperTest, ErrorStreamNotWritten) {
+  StringStreamWrapper wrapper;
+  {
+    ErrorStream error_stream(&wrapper);
+    std::ostream *stream = error_stream;
+    EXPECT_NE(stream, nullptr);
+  }
+  EXPECT_FALSE(wrapper.HasErrorStream());
+}
+
+// Tests that what is written to an ErrorStream is appended to the errors
+// of its owner.
+TEST(StringStreamWrapperTest, ErrorStreamWritten) {
+  StringStreamWrapper wrapper;
+  wrapper.WriteError("first");
+  {
+    ErrorStream error_stream(&wrapper);
+    std::ostream *stream = error_stream;
+    *stream << "second";
+  }
+  EXPECT_EQ(wrapper.GetErrorString(), "first\nsecond");
+}
+
+}  // namespace google_cloud_debugger_test
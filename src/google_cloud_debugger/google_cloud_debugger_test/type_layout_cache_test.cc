@@ -0,0 +1,148 @@
+// Copyright 2017 Google Inc. All Rights Reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "common_action_mocks.h"
+#include "i_metadata_import_mock.h"
+#include "string_stream_wrapper.h"
+#include "type_layout_cache.h"
+
+using google_cloud_debugger::ConvertStringToWCharPtr;
+using google_cloud_debugger::FieldLayout;
+using google_cloud_debugger::PropertyLayout;
+using google_cloud_debugger::TypeLayout;
+using google_cloud_debugger::TypeLayoutCache;
+using std::shared_ptr;
+using std::string;
+using std::vector;
+using ::testing::_;
+using ::testing::DoAll;
+using ::testing::Return;
+using ::testing::SetArgPointee;
+
+namespace google_cloud_debugger_test {
+
+// Tests that layouts are cached by module base address and class token.
+TEST(TypeLayoutCacheTest, AddAndGetLayout) {
+  TypeLayoutCache layout_cache;
+  shared_ptr<TypeLayout> layout(new TypeLayout);
+  layout->class_name = "MyClass";
+
+  EXPECT_EQ(layout_cache.GetLayout(0x1000, 100), nullptr);
+  layout_cache.AddLayout(0x1000, 100, layout);
+
+  shared_ptr<const TypeLayout> cached_layout =
+      layout_cache.GetLayout(0x1000, 100);
+  ASSERT_NE(cached_layout, nullptr);
+  EXPECT_EQ(cached_layout->class_name, "MyClass");
+
+  EXPECT_EQ(layout_cache.GetLayout(0x1000, 101), nullptr);
+  EXPECT_EQ(layout_cache.GetLayout(0x2000, 100), nullptr);
+}
+
+// Tests that RemoveModule only removes the layouts of that module.
+TEST(TypeLayoutCacheTest, RemoveModule) {
+  TypeLayoutCache layout_cache;
+  shared_ptr<TypeLayout> layout(new TypeLayout);
+  layout_cache.AddLayout(0x1000, 100, layout);
+  layout_cache.AddLayout(0x2000, 100, layout);
+  layout_cache.AddLayout(0x2000, 101, layout);
+  layout_cache.AddLayout(0x3000, 100, layout);
+
+  layout_cache.RemoveModule(0x2000);
+  EXPECT_NE(layout_cache.GetLayout(0x1000, 100), nullptr);
+  EXPECT_EQ(layout_cache.GetLayout(0x2000, 100), nullptr);
+  EXPECT_EQ(layout_cache.GetLayout(0x2000, 101), nullptr);
+  EXPECT_NE(layout_cache.GetLayout(0x3000, 100), nullptr);
+}
+
+// Tests that the members of a layout are only read from the metadata
+// the first time they are needed, including when reading them fails.
+TEST(TypeLayoutCacheTest, ReadMembersOnce) {
+  IMetaDataImportMock metadata_import;
+  TypeLayout layout;
+  layout.class_token = 100;
+
+  EXPECT_CALL(metadata_import, EnumFields(_, 100, _, _, _))
+      .Times(1)
+      .WillOnce(DoAll(SetArgPointee<4>(0), Return(S_FALSE)));
+  EXPECT_CALL(metadata_import, EnumProperties(_, 100, _, _, _))
+      .Times(1)
+      .WillOnce(Return(E_ACCESSDENIED));
+
+  for (int i = 0; i < 2; ++i) {
+    const vector<FieldLayout> *fields = nullptr;
+    EXPECT_EQ(layout.GetFields(&metadata_import, &fields), S_OK);
+    ASSERT_NE(fields, nullptr);
+    EXPECT_TRUE(fields->empty());
+
+    const vector<PropertyLayout> *properties = nullptr;
+    EXPECT_EQ(layout.GetProperties(&metadata_import, &properties),
+              E_ACCESSDENIED);
+  }
+}
+
+// Tests that the name of a backing field is replaced with the name
+// of its property.
+TEST(TypeLayoutCacheTest, ReadBackingFieldLayout) {
+  IMetaDataImportMock metadata_import;
+  mdFieldDef field_def = 10;
+  vector<WCHAR> field_name =
+      ConvertStringToWCharPtr("<MyProperty>k__BackingField");
+  ULONG field_name_len = field_name.size();
+
+  EXPECT_CALL(metadata_import, GetFieldPropsFirst(field_def, _, _, _, _, _))
+      .Times(2)
+      .WillOnce(DoAll(SetArgPointee<4>(field_name_len), Return(S_OK)))
+      .WillOnce(DoAll(SetArg2ToWcharArray(field_name.data(), field_name_len),
+                      SetArgPointee<4>(field_name_len), Return(S_OK)));
+  EXPECT_CALL(metadata_import, GetFieldPropsSecond(field_def, _, _, _, _, _))
+      .Times(2)
+      .WillRepeatedly(Return(S_OK));
+
+  FieldLayout field;
+  EXPECT_EQ(
+      TypeLayoutCache::ReadFieldLayout(&metadata_import, field_def, &field),
+      S_OK);
+  EXPECT_EQ(field.field_def, field_def);
+  EXPECT_EQ(field.hr, S_OK);
+  EXPECT_EQ(field.name, "MyProperty");
+  EXPECT_TRUE(field.is_backing_field);
+}
+
+// Tests that a field whose metadata cannot be read keeps the error.
+TEST(TypeLayoutCacheTest, ReadFieldLayoutFailed) {
+  IMetaDataImportMock metadata_import;
+  mdFieldDef field_def = 10;
+
+  EXPECT_CALL(metadata_import, GetFieldPropsFirst(field_def, _, _, _, _, _))
+      .WillRepeatedly(Return(E_ACCESSDENIED));
+  EXPECT_CALL(metadata_import, GetFieldPropsSecond(field_def, _, _, _, _, _))
+      .WillRepeatedly(Return(E_ACCESSDENIED));
+
+  FieldLayout field;
+  EXPECT_EQ(
+      TypeLayoutCache::ReadFieldLayout(&metadata_import, field_def, &field),
+      E_ACCESSDENIED);
+  EXPECT_EQ(field.hr, E_ACCESSDENIED);
+  EXPECT_TRUE(field.name.empty());
+}
+
+}  // namespace google_cloud_debugger_test
@@ -36,6 +36,8 @@ using google_cloud_debugger::ICorDebugHelper;
 using google_cloud_debugger::IDbgObjectFactory;
 using google_cloud_debugger::IEvalCoordinator;
 using google_cloud_debugger::VariableWrapper;
+using google_cloud_debugger::VariableWrapperQueue;
+using google_cloud_debugger::VariableWrapperVector;
 using std::queue;
 using std::shared_ptr;
 using std::string;
@@ -87,7 +89,7 @@ class FakeDbgObjectValue : public FakeDbgObjectBase {
   }
 
   virtual HRESULT PopulateMembers(Variable *variable_proto,
-                                  std::vector<VariableWrapper> *members,
+                                  VariableWrapperVector *members,
                                   IEvalCoordinator *eval_coordinator) override {
     return S_FALSE;
   }
@@ -112,7 +114,7 @@ class FakeDbgObjectMembers : public FakeDbgObjectBase {
   virtual HRESULT PopulateValue(Variable *variable) override { return S_FALSE; }
 
   virtual HRESULT PopulateMembers(Variable *variable_proto,
-                                  std::vector<VariableWrapper> *members,
+                                  VariableWrapperVector *members,
                                   IEvalCoordinator *eval_coordinator) override {
     members->insert(members->begin(), members_.begin(), members_.end());
     return S_OK;
@@ -127,7 +129,7 @@ class FakeDbgObjectMembers : public FakeDbgObjectBase {
   }
 
   // Members of the object.
-  vector<VariableWrapper> members_;
+  VariableWrapperVector members_;
 };
 
 // Test Fixture for DbgClass.
@@ -213,7 +215,7 @@ TEST_F(VariableWrapperTest, TestPopulateMembers) {
   AddMembers(&members_wrapper_, value_wrapper_);
   AddMembers(&members_wrapper_, value_wrapper_2_);
 
-  vector<VariableWrapper> members;
+  VariableWrapperVector members;
   HRESULT hr = members_wrapper_.PopulateMembers(&members, &eval_coordinator_);
 
   EXPECT_TRUE(SUCCEEDED(hr)) << "Failed with hr: " << hr;
@@ -224,7 +226,7 @@ TEST_F(VariableWrapperTest, TestPopulateMembers) {
 
 // Tests the error cases for PopulateMember function of VariableWrapper.
 TEST_F(VariableWrapperTest, TestPopulateMembersError) {
-  vector<VariableWrapper> members;
+  VariableWrapperVector members;
 
   EXPECT_EQ(members_wrapper_.PopulateMembers(nullptr, &eval_coordinator_),
             E_INVALIDARG);
@@ -233,7 +235,7 @@ TEST_F(VariableWrapperTest, TestPopulateMembersError) {
 
 // Tests PerformBFS method when there is only 1 item.
 TEST_F(VariableWrapperTest, TestBFSOneItem) {
-  queue<VariableWrapper> bfs_queue;
+  VariableWrapperQueue bfs_queue;
   bfs_queue.push(value_wrapper_);
   HRESULT hr = VariableWrapper::PerformBFS(&bfs_queue, []() { return false; },
                                            &eval_coordinator_);
@@ -249,7 +251,7 @@ TEST_F(VariableWrapperTest, TestBFSTwoChildren) {
   AddMembers(&members_wrapper_, value_wrapper_);
   AddMembers(&members_wrapper_, value_wrapper_2_);
 
-  queue<VariableWrapper> bfs_queue;
+  VariableWrapperQueue bfs_queue;
   bfs_queue.push(members_wrapper_);
   HRESULT hr = VariableWrapper::PerformBFS(&bfs_queue, []() { return false; },
                                            &eval_coordinator_);
@@ -274,7 +276,7 @@ TEST_F(VariableWrapperTest, TestBFSTwoChildrenWithTerminatingCondition) {
   AddMembers(&members_wrapper_, value_wrapper_2_);
 
   bool first_time = true;
-  queue<VariableWrapper> bfs_queue;
+  VariableWrapperQueue bfs_queue;
   bfs_queue.push(members_wrapper_);
   HRESULT hr = VariableWrapper::PerformBFS(&bfs_queue,
                                            [&first_time]() {
@@ -310,7 +312,7 @@ TEST_F(VariableWrapperTest, TestBFSTwoLevels) {
   members_wrapper_.SetBFSLevel(google_cloud_debugger::kDefaultObjectEvalDepth -
                                2);
 
-  queue<VariableWrapper> bfs_queue;
+  VariableWrapperQueue bfs_queue;
   bfs_queue.push(members_wrapper_);
   HRESULT hr = VariableWrapper::PerformBFS(&bfs_queue, []() { return false; },
                                            &eval_coordinator_);
@@ -345,7 +347,7 @@ TEST_F(VariableWrapperTest, TestBFSThreeLevels) {
   AddMembers(&members_wrapper_3_, value_wrapper_3_);
   AddMembers(&members_wrapper_3_, value_wrapper_4_);
 
-  queue<VariableWrapper> bfs_queue;
+  VariableWrapperQueue bfs_queue;
   bfs_queue.push(members_wrapper_);
   HRESULT hr = VariableWrapper::PerformBFS(&bfs_queue, []() { return false; },
                                            &eval_coordinator_);
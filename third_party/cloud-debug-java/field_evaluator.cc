@@ -266,6 +266,7 @@ HRESULT FieldEvaluator::EvaluateNonStaticMember(
     return hr;
   }
 
+  class_property_->SetObjectAddress(source_obj->GetAddress());
   hr = class_property_->Evaluate(
       source_object_handle, eval_coordinator,
       const_cast<std::vector<CComPtr<ICorDebugType>> *>(generic_class_types));
@@ -124,6 +124,8 @@ HRESULT IdentifierEvaluator::Evaluate(
       *err_stream << "Failed to get 'this' object.";
       return hr;
     }
+
+    class_property_->SetObjectAddress(this_object_->GetAddress());
   }
 
   if (!eval_coordinator->MethodEvaluation()) {